@@ -0,0 +1,618 @@
+// BallPhysics.cpp - BallScene physics step and grid broad-phase.
+
+#include "BallPhysics.h"
+
+#include <math.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Constants
+// -----------------------------------------------------------------------------
+
+static const float GRAVITY = 980.0f;       // pixels/sec^2
+
+// Collision tuning (stability / stack settling)
+static const float COLLISION_SLOP = 0.5f;      // pixels
+static const float POSITION_CORRECT_PCT = 0.60f;
+static const float RESTING_VEL_EPS = 6.0f;     // px/s
+static const float RESTING_DAMP = 0.80f;       // extra damp when nearly resting on floor
+
+// Broad-phase grid. The collision pass walks the same rows as the all-pairs
+// sweep (ball i against every j > i, in order) but takes each row's
+// candidates from the grid cells around ball i: the balls within touching
+// distance plus a margin, by where they are now. Only ball i moves while its
+// row is resolved, so the row is gathered again once it has moved that
+// margin. A ball that positional correction pushes the margin away from
+// where the grid binned it goes on a short list every row checks, as do
+// balls too big for the cells (cells are sized from the typical ball, so a
+// few large ones don't coarsen the grid for the rest). No contact
+// the sweep would resolve is missed and the step is bit-identical to it.
+// The margin only trades candidates per row against re-gathers. It is set
+// each step from the largest distance a ball moved: that decides how deep
+// the step drove balls into each other, and so how far correction pushes
+// them back out.
+static const float GRID_MARGIN_MIN = 0.5f;     // pixels, when nothing moved
+static const int   GRID_MIN_BALLS = 96;        // fewer -> plain all-pairs is cheaper
+static const int   GRID_MAX_CELLS = 1024;
+
+// -----------------------------------------------------------------------------
+// State (one step at a time)
+// -----------------------------------------------------------------------------
+
+static Ball* s_balls = 0;
+static int   s_ballCount = 0;
+
+// Broad-phase grid (rebuilt every physics step, counting sort by cell)
+static int   s_gridW = 1;
+static int   s_gridH = 1;
+static float s_gridInvCell = 1.0f;
+static float s_moveLimit2 = 0.0f;      // squared move that re-gathers a row / marks a ball far
+static float s_cellR = 1.0f;           // largest radius binned normally; bigger balls are far
+static int   s_ballCell[BALL_MAX];
+static int   s_cellStart[GRID_MAX_CELLS + 1];
+static int   s_cellFill[GRID_MAX_CELLS];
+static int   s_cellBalls[BALL_MAX];
+static float s_gridX[BALL_MAX];        // where the grid binned each ball
+static float s_gridY[BALL_MAX];
+
+// Each ball's current position and radius, packed for the row scans
+static float s_posX[BALL_MAX];
+static float s_posY[BALL_MAX];
+static float s_rad[BALL_MAX];
+
+// Balls too big for the cells, or moved the margin away from their grid
+// position during the pass
+static bool  s_isFar[BALL_MAX];
+static int   s_far[BALL_MAX];
+static int   s_farCount = 0;
+
+// The current row's candidates, ascending
+static int   s_row[BALL_MAX];
+static int   s_rowCount = 0;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static float Clamp(float v, float min, float max)
+{
+    if (v < min) return min;
+    if (v > max) return max;
+    return v;
+}
+
+static float SqrtSafe(float v)
+{
+    return (v <= 0.0f) ? 0.0f : sqrtf(v);
+}
+
+// -----------------------------------------------------------------------------
+// Balls
+// -----------------------------------------------------------------------------
+
+static float MaterialDensity(MaterialType mat)
+{
+    // "Weight feel" knob: higher => heavier for same radius.
+    // (2D sim uses area ~ r^2, so density scales mass nicely.)
+    switch (mat)
+    {
+    case MAT_RUBBER: return 1.00f;
+    case MAT_CHROME: return 2.40f; // heavy metal
+    case MAT_GLASS:  return 1.60f; // medium-heavy
+    case MAT_PLASMA: return 0.65f; // floaty
+    default:         return 1.00f;
+    }
+}
+
+void BallPhysics_InitBall(Ball* pb, float x, float y, float vx, float vy, float radius,
+                          MaterialType mat)
+{
+    Ball& b = *pb;
+
+    b.x = x;
+    b.y = y;
+    b.prevX = x;
+    b.prevY = y;
+    b.vx = vx;
+    b.vy = vy;
+    b.radius = radius;
+
+    // Mass = area * density (2D)
+    float dens = MaterialDensity(mat);
+    b.mass = (radius * radius) * dens;
+    if (b.mass < 1.0f) b.mass = 1.0f;
+
+    b.squashX = 1.0f;
+    b.squashY = 1.0f;
+    b.targetSquashX = 1.0f;
+    b.targetSquashY = 1.0f;
+    b.rotAngle = 0.0f;
+    b.material = mat;
+    b.baseColor = 0;
+    b.glowIntensity = 0.0f;
+    b.active = true;
+
+    // Physics properties by material
+    switch (mat)
+    {
+    case MAT_RUBBER:
+        b.restitution = 0.85f;   // very bouncy
+        b.friction = 0.92f;      // grippy
+        break;
+    case MAT_CHROME:
+        b.restitution = 0.55f;   // heavy metal: loses energy
+        b.friction = 0.985f;     // slippery
+        break;
+    case MAT_GLASS:
+        b.restitution = 0.65f;   // hard bounce, but not "springy"
+        b.friction = 0.97f;      // smooth
+        break;
+    default:
+        b.restitution = 0.80f;   // lively
+        b.friction = 0.99f;      // near frictionless
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Ball-to-ball collision (impulse + friction, stable)
+// -----------------------------------------------------------------------------
+
+// Returns true if positional correction moved the two balls.
+static bool ResolvePair(Ball& a, Ball& b)
+{
+    if (!a.active || !b.active) return false;
+
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+
+    float dist2 = dx * dx + dy * dy;
+    float minDist = a.radius + b.radius;
+    float minDist2 = minDist * minDist;
+
+    if (dist2 >= minDist2)
+        return false;
+
+    float dist = SqrtSafe(dist2);
+    if (dist < 0.0001f)
+    {
+        // Prevent NaN normals if perfectly overlapping
+        dx = 1.0f;
+        dy = 0.0f;
+        dist = 1.0f;
+    }
+
+    // Normal
+    float nx = dx / dist;
+    float ny = dy / dist;
+
+    // Positional correction (prevents sinking + reduces jitter)
+    float overlap = (minDist - dist);
+    float corr = (overlap - COLLISION_SLOP);
+    if (corr < 0.0f) corr = 0.0f;
+    corr *= POSITION_CORRECT_PCT;
+
+    float invMa = 1.0f / a.mass;
+    float invMb = 1.0f / b.mass;
+    float invSum = invMa + invMb;
+    if (invSum <= 0.0f) invSum = 1.0f;
+
+    a.x -= nx * (corr * (invMa / invSum));
+    a.y -= ny * (corr * (invMa / invSum));
+    b.x += nx * (corr * (invMb / invSum));
+    b.y += ny * (corr * (invMb / invSum));
+
+    // Relative velocity
+    float rvx = b.vx - a.vx;
+    float rvy = b.vy - a.vy;
+
+    // Velocity along normal
+    float velAlongNormal = rvx * nx + rvy * ny;
+
+    // If they are separating, do nothing
+    if (velAlongNormal > 0.0f)
+        return corr > 0.0f;
+
+    // Restitution: mix (use the "bouncier limit" but keep stable)
+    float e = (a.restitution < b.restitution) ? a.restitution : b.restitution;
+
+    // Impulse scalar
+    float jn = -(1.0f + e) * velAlongNormal;
+    jn /= invSum;
+
+    float impX = jn * nx;
+    float impY = jn * ny;
+
+    a.vx -= impX * invMa;
+    a.vy -= impY * invMa;
+    b.vx += impX * invMb;
+    b.vy += impY * invMb;
+
+    // Tangential friction impulse (simple Coulomb-ish)
+    // Compute tangent
+    float tvx = rvx - velAlongNormal * nx;
+    float tvy = rvy - velAlongNormal * ny;
+    float tLen = SqrtSafe(tvx * tvx + tvy * tvy);
+
+    if (tLen > 0.0001f)
+    {
+        float tx = tvx / tLen;
+        float ty = tvy / tLen;
+
+        float velAlongT = rvx * tx + rvy * ty;
+
+        // Friction coefficient: combine surfaces (grippier dominates)
+        float mu = a.friction * b.friction; // 0..1-ish
+
+        float jt = -velAlongT;
+        jt /= invSum;
+
+        // Clamp friction by normal impulse magnitude
+        float maxF = fabsf(jn) * (1.0f - mu);
+        if (jt > maxF) jt = maxF;
+        if (jt < -maxF) jt = -maxF;
+
+        float fX = jt * tx;
+        float fY = jt * ty;
+
+        a.vx -= fX * invMa;
+        a.vy -= fY * invMa;
+        b.vx += fX * invMb;
+        b.vy += fY * invMb;
+    }
+
+    // Kill tiny jitter when both are essentially resting on the floor
+    bool aOnFloor = (a.y + a.radius >= BALL_FLOOR_Y - 0.5f);
+    bool bOnFloor = (b.y + b.radius >= BALL_FLOOR_Y - 0.5f);
+    if (aOnFloor && bOnFloor)
+    {
+        if (fabsf(a.vx) < 2.0f) a.vx = 0.0f;
+        if (fabsf(b.vx) < 2.0f) b.vx = 0.0f;
+        if (fabsf(a.vy) < 2.0f) a.vy = 0.0f;
+        if (fabsf(b.vy) < 2.0f) b.vy = 0.0f;
+    }
+
+    return corr > 0.0f;
+}
+
+// -----------------------------------------------------------------------------
+// Broad-phase: uniform grid over the play area
+// -----------------------------------------------------------------------------
+
+static int CellCoord(float p, int cells)
+{
+    int c = (int)(p * s_gridInvCell);
+    if (c < 0) return 0;
+    if (c >= cells) return cells - 1;
+    return c;
+}
+
+static void BuildGrid(float margin)
+{
+    float maxR = 1.0f;
+    float sumR = 0.0f;
+    int active = 0;
+    for (int i = 0; i < s_ballCount; ++i)
+    {
+        if (!s_balls[i].active)
+            continue;
+        if (s_balls[i].radius > maxR)
+            maxR = s_balls[i].radius;
+        sumR += s_balls[i].radius;
+        active++;
+    }
+
+    // Cells fit balls up to twice the mean radius
+    s_cellR = active ? 2.0f * sumR / (float)active : maxR;
+    if (s_cellR > maxR)
+        s_cellR = maxR;
+
+    // A cell spans the reach between two such balls plus the margin a ball
+    // may drift from its grid position, so a row's candidates are all in
+    // the 3x3 cells around ball i. Off-screen balls clamp into the border
+    // cells; clamping never pulls two nearby balls more than one cell apart.
+    float cell = 2.0f * s_cellR + 2.0f * margin;
+    s_gridW = (int)(BALL_AREA_W / cell) + 1;
+    s_gridH = (int)(BALL_FLOOR_Y / cell) + 1;
+    while (s_gridW * s_gridH > GRID_MAX_CELLS)
+    {
+        cell *= 1.5f;
+        s_gridW = (int)(BALL_AREA_W / cell) + 1;
+        s_gridH = (int)(BALL_FLOOR_Y / cell) + 1;
+    }
+    s_gridInvCell = 1.0f / cell;
+
+    // A little short of the margin, for rounding
+    s_moveLimit2 = 0.81f * margin * margin;
+
+    const int cells = s_gridW * s_gridH;
+    memset(s_cellStart, 0, sizeof(int) * (cells + 1));
+
+    s_farCount = 0;
+    for (int i = 0; i < s_ballCount; ++i)
+    {
+        const Ball& b = s_balls[i];
+        s_gridX[i] = s_posX[i] = b.x;
+        s_gridY[i] = s_posY[i] = b.y;
+        s_rad[i] = b.radius;
+        s_isFar[i] = b.radius > s_cellR;
+        if (s_isFar[i])
+            s_far[s_farCount++] = i;
+
+        int c = CellCoord(b.y, s_gridH) * s_gridW + CellCoord(b.x, s_gridW);
+        s_ballCell[i] = c;
+        s_cellStart[c + 1]++;
+    }
+
+    for (int c = 0; c < cells; ++c)
+        s_cellStart[c + 1] += s_cellStart[c];
+
+    // Scatter in index order, so each cell lists its balls ascending
+    memcpy(s_cellFill, s_cellStart, sizeof(int) * cells);
+
+    for (int i = 0; i < s_ballCount; ++i)
+        s_cellBalls[s_cellFill[s_ballCell[i]]++] = i;
+}
+
+// Ball i was moved by positional correction
+static void MoveBall(int i)
+{
+    s_posX[i] = s_balls[i].x;
+    s_posY[i] = s_balls[i].y;
+
+    if (!s_isFar[i])
+    {
+        float dx = s_posX[i] - s_gridX[i];
+        float dy = s_posY[i] - s_gridY[i];
+        if (dx * dx + dy * dy >= s_moveLimit2)
+        {
+            s_isFar[i] = true;
+            s_far[s_farCount++] = i;
+        }
+    }
+}
+
+// Fills s_row with the balls j >= from (from > i) within touching distance of
+// ball i plus margin, ascending
+static void GatherRow(int i, int from, float margin)
+{
+    const float ax = s_posX[i];
+    const float ay = s_posY[i];
+    const float ar = s_rad[i] + margin;
+    const int cx = CellCoord(ax, s_gridW);
+    const int cy = CellCoord(ay, s_gridH);
+
+    // One cell each way, more for a ball too big for the cells
+    int span = 1;
+    if (s_rad[i] > s_cellR)
+        span = (int)((s_rad[i] + s_cellR + 2.0f * margin) * s_gridInvCell) + 1;
+
+    const int x0 = cx > span ? cx - span : 0;
+    const int x1 = cx + span < s_gridW ? cx + span : s_gridW - 1;
+    const int y0 = cy > span ? cy - span : 0;
+    const int y1 = cy + span < s_gridH ? cy + span : s_gridH - 1;
+
+    // No branch on the distance test: a rejected ball is overwritten
+    int n = 0;
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const int c = y * s_gridW + x;
+
+            // Descending, so the first ball before 'from' ends the cell
+            for (int p = s_cellStart[c + 1] - 1; p >= s_cellStart[c]; --p)
+            {
+                int j = s_cellBalls[p];
+                if (j < from)
+                    break;
+
+                float dx = s_posX[j] - ax;
+                float dy = s_posY[j] - ay;
+                float reach = ar + s_rad[j];
+                s_row[n] = j;
+                n += (int)(dx * dx + dy * dy < reach * reach) & (int)!s_isFar[j];
+            }
+        }
+    }
+
+    for (int k = 0; k < s_farCount; ++k)
+    {
+        int j = s_far[k];
+        float dx = s_posX[j] - ax;
+        float dy = s_posY[j] - ay;
+        float reach = ar + s_rad[j];
+        s_row[n] = j;
+        n += (int)(j >= from) & (int)(dx * dx + dy * dy < reach * reach);
+    }
+
+    // Insertion sort: rows are a handful of balls
+    for (int k = 1; k < n; ++k)
+    {
+        int j = s_row[k];
+        int m = k;
+        for (; m > 0 && s_row[m - 1] > j; --m)
+            s_row[m] = s_row[m - 1];
+        s_row[m] = j;
+    }
+    s_rowCount = n;
+}
+
+// The all-pairs sweep
+static void ResolveAllPairs()
+{
+    for (int i = 0; i < s_ballCount; ++i)
+    {
+        for (int j = i + 1; j < s_ballCount; ++j)
+            ResolvePair(s_balls[i], s_balls[j]);
+    }
+}
+
+// The same sweep with each row taken from the grid
+static void ResolveGridPairs(float margin)
+{
+    BuildGrid(margin);
+
+    for (int i = 0; i < s_ballCount; ++i)
+    {
+        Ball& a = s_balls[i];
+        if (!a.active)
+            continue;
+
+        float rowX = a.x;
+        float rowY = a.y;
+        GatherRow(i, i + 1, margin);
+
+        for (int k = 0; k < s_rowCount; ++k)
+        {
+            int j = s_row[k];
+            if (!ResolvePair(a, s_balls[j]))
+                continue;
+
+            MoveBall(i);
+            MoveBall(j);
+
+            float dx = a.x - rowX;
+            float dy = a.y - rowY;
+            if (dx * dx + dy * dy >= s_moveLimit2)
+            {
+                rowX = a.x;
+                rowY = a.y;
+                GatherRow(i, j + 1, margin);
+                k = -1;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Physics step
+// -----------------------------------------------------------------------------
+
+void BallPhysics_Step(Ball* balls, int count, float dt, BallBroadPhase mode)
+{
+    s_balls = balls;
+    s_ballCount = count;
+
+    float maxMove2 = 0.0f;
+
+    // Integrate + floor/walls
+    for (int i = 0; i < s_ballCount; ++i)
+    {
+        Ball& b = s_balls[i];
+        if (!b.active) continue;
+
+        b.prevX = b.x;
+        b.prevY = b.y;
+
+        // Apply gravity
+        b.vy += GRAVITY * dt;
+
+        // Update position
+        b.x += b.vx * dt;
+        b.y += b.vy * dt;
+
+        // Update rotation based on horizontal velocity
+        b.rotAngle += b.vx * dt * 0.01f;
+
+        // Floor collision
+        if (b.y + b.radius > BALL_FLOOR_Y)
+        {
+            b.y = BALL_FLOOR_Y - b.radius;
+
+            // Only bounce if moving downward
+            if (b.vy > 0.0f)
+            {
+                float preImpact = b.vy;
+
+                b.vy = -b.vy * b.restitution;
+                b.vx *= b.friction;
+
+                // Extra damping when nearly resting (reduces endless jitter)
+                if (fabsf(preImpact) < 120.0f && fabsf(b.vy) < RESTING_VEL_EPS)
+                {
+                    b.vy *= RESTING_DAMP;
+                    b.vx *= RESTING_DAMP;
+                    if (fabsf(b.vy) < 2.0f) b.vy = 0.0f;
+                    if (fabsf(b.vx) < 2.0f) b.vx = 0.0f;
+                }
+
+                // Squash on impact - varies by material
+                float impactSpeed = fabsf(preImpact);
+                float baseSquash = Clamp(impactSpeed / 500.0f, 0.0f, 0.5f);
+
+                // Material squash multipliers
+                float squashMult = 1.0f;
+                if (b.material == MAT_RUBBER) squashMult = 1.5f;      // very squashy
+                else if (b.material == MAT_GLASS) squashMult = 0.3f;  // rigid
+                else if (b.material == MAT_CHROME) squashMult = 0.5f; // hard metal
+                else if (b.material == MAT_PLASMA) squashMult = 1.2f; // soft/fluid
+
+                float squashAmount = baseSquash * squashMult;
+                b.targetSquashX = 1.0f + squashAmount;
+                b.targetSquashY = 1.0f - squashAmount * 0.7f;
+
+                // Glow pulse on impact
+                b.glowIntensity = Clamp(impactSpeed / 300.0f, 0.0f, 1.0f);
+            }
+        }
+
+        // Wall collisions
+        if (b.x - b.radius < 0.0f)
+        {
+            b.x = b.radius;
+            b.vx = -b.vx * b.restitution;
+        }
+        if (b.x + b.radius > BALL_AREA_W)
+        {
+            b.x = BALL_AREA_W - b.radius;
+            b.vx = -b.vx * b.restitution;
+        }
+
+        // Stretch during flight (inverse of squash)
+        if (b.y + b.radius < BALL_FLOOR_Y - 5.0f)
+        {
+            float speedY = fabsf(b.vy);
+            float stretchAmount = Clamp(speedY / 800.0f, 0.0f, 0.3f);
+            b.targetSquashX = 1.0f - stretchAmount * 0.5f;
+            b.targetSquashY = 1.0f + stretchAmount;
+        }
+
+        // Smoothly interpolate squash values
+        b.squashX += (b.targetSquashX - b.squashX) * 0.2f;
+        b.squashY += (b.targetSquashY - b.squashY) * 0.2f;
+
+        // Gradually return to sphere
+        b.targetSquashX += (1.0f - b.targetSquashX) * 0.1f;
+        b.targetSquashY += (1.0f - b.targetSquashY) * 0.1f;
+
+        // Fade glow
+        b.glowIntensity *= 0.95f;
+
+        // Hard stop very slow balls on the floor
+        if (fabsf(b.vx) < 2.5f && fabsf(b.vy) < 2.5f && b.y + b.radius >= BALL_FLOOR_Y - 0.5f)
+        {
+            b.vx = 0.0f;
+            b.vy = 0.0f;
+        }
+
+        float mx = b.x - b.prevX;
+        float my = b.y - b.prevY;
+        if (mx * mx + my * my > maxMove2)
+            maxMove2 = mx * mx + my * my;
+    }
+
+    // Ball-to-ball collisions, in the all-pairs sweep's (i, j) order either way
+    bool useGrid = mode == BALL_BROAD_GRID ||
+                   (mode == BALL_BROAD_AUTO && s_ballCount >= GRID_MIN_BALLS);
+
+    if (useGrid)
+    {
+        float margin = sqrtf(maxMove2);
+        ResolveGridPairs(margin > GRID_MARGIN_MIN ? margin : GRID_MARGIN_MIN);
+    }
+    else
+    {
+        ResolveAllPairs();
+    }
+}
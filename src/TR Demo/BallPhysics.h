@@ -0,0 +1,67 @@
+#pragma once
+// BallPhysics.h - Platform-neutral BallScene physics (no D3D / xtl).
+//
+// One fixed step: gravity, floor and wall bounces, squash/glow targets, then
+// ball-to-ball impulse + friction resolution. Candidate pairs come from a
+// uniform grid over the play area and are resolved in the same (i, j) order
+// as the all-pairs sweep, so a scene steps bit-identically either way.
+// tools/ballbench checks and times both.
+
+static const int   BALL_MAX = 1024;             // balls per step
+static const float BALL_AREA_W = 640.0f;        // walls at 0 and BALL_AREA_W
+static const float BALL_FLOOR_Y = 420.0f;
+
+// Material types
+enum MaterialType
+{
+    MAT_RUBBER = 0,
+    MAT_CHROME,
+    MAT_GLASS,
+    MAT_PLASMA,
+    MAT_COUNT
+};
+
+struct Ball
+{
+    float x, y;           // Position
+    float prevX, prevY;   // Position before the last physics step (render lerp)
+    float vx, vy;         // Velocity
+    float radius;
+    float mass;
+
+    // Visual deformation
+    float squashX;
+    float squashY;
+    float targetSquashX;
+    float targetSquashY;
+
+    // Rotation
+    float rotAngle;
+
+    // Material
+    MaterialType material;
+    unsigned int baseColor;     // ARGB, set by the scene
+
+    // Material physics properties
+    float restitution;    // Bounciness (0.0 - 1.0)
+    float friction;       // Surface friction (0.0 - 1.0)
+
+    // Effects
+    float glowIntensity;
+    bool active;
+};
+
+enum BallBroadPhase
+{
+    BALL_BROAD_AUTO = 0,        // grid from 96 balls, all-pairs below (the scene)
+    BALL_BROAD_GRID,            // grid at any count
+    BALL_BROAD_ALL_PAIRS        // the plain O(n^2) sweep
+};
+
+// A resting-shape ball at (x, y): mass from radius and material density,
+// restitution and friction from the material. baseColor is left 0.
+void BallPhysics_InitBall(Ball* b, float x, float y, float vx, float vy, float radius,
+                          MaterialType mat);
+
+// One step of dt seconds over balls[0..count), count <= BALL_MAX.
+void BallPhysics_Step(Ball* balls, int count, float dt, BallBroadPhase mode);
@@ -8,8 +8,13 @@
 // - Physics simulation with collisions
 
 #include "BallScene.h"
+#include "BallPhysics.h"
 #include "font.h"
 #include "input.h"
+#include "clock.h"
+#include "devstate.h"
+#include "vring.h"
+#include "music.h"
 
 #include <xtl.h>
 #include <xgraphics.h>
@@ -26,30 +31,16 @@ static const DWORD SCENE_DURATION_MS = 30000;
 static const float SCREEN_W = 640.0f;
 static const float SCREEN_H = 480.0f;
 
-static const int MAX_BALLS = 16;
-static const float GRAVITY = 980.0f;       // pixels/sec^2
-static const float FLOOR_Y = 420.0f;
+static const float FLOOR_Y = BALL_FLOOR_Y;
+
+// D-pad up drops this many small balls at once, up to BALL_MAX: a few
+// presses take the scene past the count where BallPhysics switches to the grid
+static const int BURST_BALLS = 128;
 
 // Sphere mesh resolution
 static const int SPHERE_SLICES = 24;
 static const int SPHERE_STACKS = 16;
 
-// Collision tuning (stability / stack settling)
-static const float COLLISION_SLOP = 0.5f;      // pixels
-static const float POSITION_CORRECT_PCT = 0.60f;
-static const float RESTING_VEL_EPS = 6.0f;     // px/s
-static const float RESTING_DAMP = 0.80f;       // extra damp when nearly resting on floor
-
-// Material types
-enum MaterialType
-{
-    MAT_RUBBER = 0,
-    MAT_CHROME,
-    MAT_GLASS,
-    MAT_PLASMA,
-    MAT_COUNT
-};
-
 static const char* g_materialNames[] =
 {
     "RUBBER",
@@ -108,39 +99,6 @@ struct Vertex
 
 #define FVF_VERTEX (D3DFVF_XYZ | D3DFVF_NORMAL | D3DFVF_DIFFUSE)
 
-// -----------------------------------------------------------------------------
-// Ball physics state
-// -----------------------------------------------------------------------------
-
-struct Ball
-{
-    float x, y;           // Position
-    float vx, vy;         // Velocity
-    float radius;
-    float mass;
-
-    // Visual deformation
-    float squashX;
-    float squashY;
-    float targetSquashX;
-    float targetSquashY;
-
-    // Rotation
-    float rotAngle;
-
-    // Material
-    MaterialType material;
-    DWORD baseColor;
-
-    // Material physics properties
-    float restitution;    // Bounciness (0.0 - 1.0)
-    float friction;       // Surface friction (0.0 - 1.0)
-
-    // Effects
-    float glowIntensity;
-    bool active;
-};
-
 // -----------------------------------------------------------------------------
 // Scene state
 // -----------------------------------------------------------------------------
@@ -148,8 +106,9 @@ struct Ball
 static bool s_active = false;
 static DWORD s_startTime = 0;
 static WORD s_lastButtons = 0;
+static DWORD s_beatCursor = 0;
 
-static Ball s_balls[MAX_BALLS];
+static Ball s_balls[BALL_MAX];
 static int s_ballCount = 0;
 
 static LPDIRECT3DVERTEXBUFFER8 s_sphereVB = NULL;
@@ -159,13 +118,19 @@ static int s_sphereIndexCount = 0;
 
 static int s_currentMaterial = 0;
 
+// Fixed overlay text (built at Init, only the ball count is formatted per frame)
+static TextMesh s_lblBalls;
+static TextMesh s_lblMaterial;
+static TextMesh s_lblControls;
+static TextMesh s_lblMaterialName[MAT_COUNT];
+
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
 
 static DWORD TimeMs()
 {
-    return GetTickCount() - s_startTime;
+    return Clock_Ms() - s_startTime;
 }
 
 static float Clamp(float v, float min, float max)
@@ -175,11 +140,6 @@ static float Clamp(float v, float min, float max)
     return v;
 }
 
-static float SqrtSafe(float v)
-{
-    return (v <= 0.0f) ? 0.0f : sqrtf(v);
-}
-
 // -----------------------------------------------------------------------------
 // Sphere mesh generation
 // -----------------------------------------------------------------------------
@@ -268,294 +228,39 @@ static void CreateSphereMesh()
 // Ball management
 // -----------------------------------------------------------------------------
 
-static float MaterialDensity(MaterialType mat)
-{
-    // Weight feel knob: higher => heavier for same radius.
-    // (2D sim uses area ~ r^2, so density scales mass nicely.)
-    switch (mat)
-    {
-    case MAT_RUBBER: return 1.00f;
-    case MAT_CHROME: return 2.40f; // heavy metal
-    case MAT_GLASS:  return 1.60f; // medium-heavy
-    case MAT_PLASMA: return 0.65f; // floaty
-    default:         return 1.00f;
-    }
-}
-
 static void SpawnBall(float x, float y, float vx, float vy, float radius, MaterialType mat)
 {
-    if (s_ballCount >= MAX_BALLS) return;
+    if (s_ballCount >= BALL_MAX) return;
 
     Ball& b = s_balls[s_ballCount++];
+    BallPhysics_InitBall(&b, x, y, vx, vy, radius, mat);
 
-    b.x = x;
-    b.y = y;
-    b.vx = vx;
-    b.vy = vy;
-    b.radius = radius;
-
-    // Mass = area * density (2D)
-    float dens = MaterialDensity(mat);
-    b.mass = (radius * radius) * dens;
-    if (b.mass < 1.0f) b.mass = 1.0f;
-
-    b.squashX = 1.0f;
-    b.squashY = 1.0f;
-    b.targetSquashX = 1.0f;
-    b.targetSquashY = 1.0f;
-    b.rotAngle = 0.0f;
-    b.material = mat;
-    b.glowIntensity = 0.0f;
-    b.active = true;
-
-    // Set base color and physics properties based on material
     switch (mat)
     {
-    case MAT_RUBBER:
-        b.baseColor = D3DCOLOR_XRGB(200, 50, 50);
-        b.restitution = 0.85f;   // very bouncy
-        b.friction = 0.92f;      // grippy
-        break;
-    case MAT_CHROME:
-        b.baseColor = D3DCOLOR_XRGB(200, 200, 220);
-        b.restitution = 0.55f;   // heavy metal: loses energy
-        b.friction = 0.985f;     // slippery
-        break;
-    case MAT_GLASS:
-        b.baseColor = D3DCOLOR_ARGB(128, 150, 200, 255);
-        b.restitution = 0.65f;   // hard bounce, but not springy
-        b.friction = 0.97f;      // smooth
-        break;
-    case MAT_PLASMA:
-        b.baseColor = D3DCOLOR_XRGB(100, 255, 200);
-        b.restitution = 0.80f;   // lively
-        b.friction = 0.99f;      // near frictionless
-        break;
+    case MAT_RUBBER: b.baseColor = D3DCOLOR_XRGB(200, 50, 50); break;
+    case MAT_CHROME: b.baseColor = D3DCOLOR_XRGB(200, 200, 220); break;
+    case MAT_GLASS:  b.baseColor = D3DCOLOR_ARGB(128, 150, 200, 255); break;
+    case MAT_PLASMA: b.baseColor = D3DCOLOR_XRGB(100, 255, 200); break;
     }
 }
 
-// -----------------------------------------------------------------------------
-// Physics update
-// -----------------------------------------------------------------------------
-
-static void UpdatePhysics(float dt)
+// A lattice of small balls just above the play area, dropped in together
+static void SpawnBurst()
 {
-    // Integrate + floor/walls
-    for (int i = 0; i < s_ballCount; ++i)
-    {
-        Ball& b = s_balls[i];
-        if (!b.active) continue;
-
-        // Apply gravity
-        b.vy += GRAVITY * dt;
-
-        // Update position
-        b.x += b.vx * dt;
-        b.y += b.vy * dt;
-
-        // Update rotation based on horizontal velocity
-        b.rotAngle += b.vx * dt * 0.01f;
-
-        // Floor collision
-        if (b.y + b.radius > FLOOR_Y)
-        {
-            b.y = FLOOR_Y - b.radius;
-
-            // Only bounce if moving downward
-            if (b.vy > 0.0f)
-            {
-                float preImpact = b.vy;
-
-                b.vy = -b.vy * b.restitution;
-                b.vx *= b.friction;
-
-                // Extra damping when nearly resting (reduces endless jitter)
-                if (fabsf(preImpact) < 120.0f && fabsf(b.vy) < RESTING_VEL_EPS)
-                {
-                    b.vy *= RESTING_DAMP;
-                    b.vx *= RESTING_DAMP;
-                    if (fabsf(b.vy) < 2.0f) b.vy = 0.0f;
-                    if (fabsf(b.vx) < 2.0f) b.vx = 0.0f;
-                }
-
-                // Squash on impact - varies by material
-                float impactSpeed = fabsf(preImpact);
-                float baseSquash = Clamp(impactSpeed / 500.0f, 0.0f, 0.5f);
-
-                // Material squash multipliers
-                float squashMult = 1.0f;
-                if (b.material == MAT_RUBBER) squashMult = 1.5f;      // very squashy
-                else if (b.material == MAT_GLASS) squashMult = 0.3f;  // rigid
-                else if (b.material == MAT_CHROME) squashMult = 0.5f; // hard metal
-                else if (b.material == MAT_PLASMA) squashMult = 1.2f; // soft/fluid
-
-                float squashAmount = baseSquash * squashMult;
-                b.targetSquashX = 1.0f + squashAmount;
-                b.targetSquashY = 1.0f - squashAmount * 0.7f;
-
-                // Glow pulse on impact
-                b.glowIntensity = Clamp(impactSpeed / 300.0f, 0.0f, 1.0f);
-            }
-        }
-
-        // Wall collisions
-        if (b.x - b.radius < 0.0f)
-        {
-            b.x = b.radius;
-            b.vx = -b.vx * b.restitution;
-        }
-        if (b.x + b.radius > SCREEN_W)
-        {
-            b.x = SCREEN_W - b.radius;
-            b.vx = -b.vx * b.restitution;
-        }
-
-        // Stretch during flight (inverse of squash)
-        if (b.y + b.radius < FLOOR_Y - 5.0f)
-        {
-            float speedY = fabsf(b.vy);
-            float stretchAmount = Clamp(speedY / 800.0f, 0.0f, 0.3f);
-            b.targetSquashX = 1.0f - stretchAmount * 0.5f;
-            b.targetSquashY = 1.0f + stretchAmount;
-        }
-
-        // Smoothly interpolate squash values
-        b.squashX += (b.targetSquashX - b.squashX) * 0.2f;
-        b.squashY += (b.targetSquashY - b.squashY) * 0.2f;
-
-        // Gradually return to sphere
-        b.targetSquashX += (1.0f - b.targetSquashX) * 0.1f;
-        b.targetSquashY += (1.0f - b.targetSquashY) * 0.1f;
-
-        // Fade glow
-        b.glowIntensity *= 0.95f;
-
-        // Hard stop very slow balls on the floor
-        if (fabsf(b.vx) < 2.5f && fabsf(b.vy) < 2.5f && b.y + b.radius >= FLOOR_Y - 0.5f)
-        {
-            b.vx = 0.0f;
-            b.vy = 0.0f;
-        }
-    }
+    const float pitch = 16.0f;
+    const int cols = (int)(SCREEN_W / pitch);
 
-    // Ball-to-ball collisions (impulse + friction, stable)
-    for (int i = 0; i < s_ballCount; ++i)
+    for (int i = 0; i < BURST_BALLS && s_ballCount < BALL_MAX; ++i)
     {
-        for (int j = i + 1; j < s_ballCount; ++j)
-        {
-            Ball& a = s_balls[i];
-            Ball& b = s_balls[j];
-            if (!a.active || !b.active) continue;
-
-            float dx = b.x - a.x;
-            float dy = b.y - a.y;
-
-            float dist2 = dx * dx + dy * dy;
-            float minDist = a.radius + b.radius;
-            float minDist2 = minDist * minDist;
-
-            if (dist2 >= minDist2)
-                continue;
-
-            float dist = SqrtSafe(dist2);
-            if (dist < 0.0001f)
-            {
-                // Prevent NaN normals if perfectly overlapping
-                dx = 1.0f;
-                dy = 0.0f;
-                dist = 1.0f;
-            }
-
-            // Normal
-            float nx = dx / dist;
-            float ny = dy / dist;
-
-            // Positional correction (prevents sinking + reduces jitter)
-            float overlap = (minDist - dist);
-            float corr = (overlap - COLLISION_SLOP);
-            if (corr < 0.0f) corr = 0.0f;
-            corr *= POSITION_CORRECT_PCT;
-
-            float invMa = 1.0f / a.mass;
-            float invMb = 1.0f / b.mass;
-            float invSum = invMa + invMb;
-            if (invSum <= 0.0f) invSum = 1.0f;
-
-            a.x -= nx * (corr * (invMa / invSum));
-            a.y -= ny * (corr * (invMa / invSum));
-            b.x += nx * (corr * (invMb / invSum));
-            b.y += ny * (corr * (invMb / invSum));
-
-            // Relative velocity
-            float rvx = b.vx - a.vx;
-            float rvy = b.vy - a.vy;
-
-            // Velocity along normal
-            float velAlongNormal = rvx * nx + rvy * ny;
-
-            // If they are separating, do nothing
-            if (velAlongNormal > 0.0f)
-                continue;
-
-            // Restitution: mix (use the bouncier limit but keep stable)
-            float e = (a.restitution < b.restitution) ? a.restitution : b.restitution;
-
-            // Impulse scalar
-            float jn = -(1.0f + e) * velAlongNormal;
-            jn /= invSum;
-
-            float impX = jn * nx;
-            float impY = jn * ny;
-
-            a.vx -= impX * invMa;
-            a.vy -= impY * invMa;
-            b.vx += impX * invMb;
-            b.vy += impY * invMb;
-
-            // Tangential friction impulse (simple Coulomb-ish)
-            // Compute tangent
-            float tvx = rvx - velAlongNormal * nx;
-            float tvy = rvy - velAlongNormal * ny;
-            float tLen = SqrtSafe(tvx * tvx + tvy * tvy);
-
-            if (tLen > 0.0001f)
-            {
-                float tx = tvx / tLen;
-                float ty = tvy / tLen;
-
-                float velAlongT = rvx * tx + rvy * ty;
-
-                // Friction coefficient: combine surfaces (grippier dominates)
-                float mu = a.friction * b.friction; // 0..1-ish
-
-                float jt = -velAlongT;
-                jt /= invSum;
-
-                // Clamp friction by normal impulse magnitude
-                float maxF = fabsf(jn) * (1.0f - mu);
-                if (jt > maxF) jt = maxF;
-                if (jt < -maxF) jt = -maxF;
-
-                float fX = jt * tx;
-                float fY = jt * ty;
-
-                a.vx -= fX * invMa;
-                a.vy -= fY * invMa;
-                b.vx += fX * invMb;
-                b.vy += fY * invMb;
-            }
-
-            // Kill tiny jitter when both are essentially resting on the floor
-            bool aOnFloor = (a.y + a.radius >= FLOOR_Y - 0.5f);
-            bool bOnFloor = (b.y + b.radius >= FLOOR_Y - 0.5f);
-            if (aOnFloor && bOnFloor)
-            {
-                if (fabsf(a.vx) < 2.0f) a.vx = 0.0f;
-                if (fabsf(b.vx) < 2.0f) b.vx = 0.0f;
-                if (fabsf(a.vy) < 2.0f) a.vy = 0.0f;
-                if (fabsf(b.vy) < 2.0f) b.vy = 0.0f;
-            }
-        }
+        int randX = rand() % 5;
+        int randVX = rand() % 120;
+        int randRadius = rand() % 4;
+
+        float x = pitch * ((float)(i % cols) + 0.5f) + (float)(randX - 2);
+        float y = -pitch * ((float)(i / cols) + 0.5f);
+        float vx = -60.0f + (float)randVX;
+        float radius = 4.0f + (float)randRadius;
+        SpawnBall(x, y, vx, 0.0f, radius, (MaterialType)(i % MAT_COUNT));
     }
 }
 
@@ -575,10 +280,10 @@ static void DrawFloor()
         { SCREEN_W, SCREEN_H, 0.0f, 1.0f, D3DCOLOR_XRGB(20, 20, 25) },
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(FV));
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(FV));
 }
 
 static void DrawBackground()
@@ -592,18 +297,22 @@ static void DrawBackground()
         { SCREEN_W, FLOOR_Y,  0.0f, 1.0f, D3DCOLOR_XRGB(50, 60, 80) },
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(BV));
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(BV));
 }
 
-static void RenderBall(const Ball& ball)
+static void RenderBall(const Ball& ball, float alpha)
 {
+    // Between the last two physics steps
+    float x = ball.prevX + (ball.x - ball.prevX) * alpha;
+    float y = ball.prevY + (ball.y - ball.prevY) * alpha;
+
     // Setup world transform with squash and position
     D3DXMATRIX world, scale, trans;
     D3DXMatrixScaling(&scale, ball.radius * ball.squashX, ball.radius * ball.squashY, ball.radius);
-    D3DXMatrixTranslation(&trans, ball.x, ball.y, 0.0f);
+    D3DXMatrixTranslation(&trans, x, y, 0.0f);
     D3DXMatrixMultiply(&world, &scale, &trans);
 
     g_pDevice->SetTransform(D3DTS_WORLD, &world);
@@ -660,9 +369,9 @@ static void RenderBall(const Ball& ball)
     g_pDevice->SetMaterial(&mtrl);
 
     // Lighting
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, TRUE);
-    g_pDevice->SetRenderState(D3DRS_AMBIENT, D3DCOLOR_XRGB(50, 50, 60));
-    g_pDevice->SetRenderState(D3DRS_SPECULARENABLE,
+    DevState_SetRenderState(D3DRS_LIGHTING, TRUE);
+    DevState_SetRenderState(D3DRS_AMBIENT, D3DCOLOR_XRGB(50, 50, 60));
+    DevState_SetRenderState(D3DRS_SPECULARENABLE,
         (ball.material == MAT_CHROME || ball.material == MAT_GLASS) ? TRUE : FALSE);
 
     // Simple directional light
@@ -681,52 +390,72 @@ static void RenderBall(const Ball& ball)
     // Alpha blending for glass
     if (ball.material == MAT_GLASS)
     {
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
     }
     else
     {
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
     }
 
     // Additive blending for plasma
     if (ball.material == MAT_PLASMA)
     {
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
     }
 
     // Render sphere
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(FVF_VERTEX);
-    g_pDevice->SetStreamSource(0, s_sphereVB, sizeof(Vertex));
-    g_pDevice->SetIndices(s_sphereIB, 0);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_VERTEX);
+    DevState_SetStreamSource(0, s_sphereVB, sizeof(Vertex));
+    DevState_SetIndices(s_sphereIB, 0);
     g_pDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, s_sphereVertCount, 0, s_sphereIndexCount / 3);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
 }
 
 static void DrawStats()
 {
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
     char buf[64];
 
     // Ball count
     IntToStr(s_ballCount, buf, sizeof(buf));
-    DrawText(10.0f, 10.0f, "BALLS: ", 2.0f, D3DCOLOR_XRGB(200, 220, 255));
+    TextMesh_Draw(&s_lblBalls, 10.0f, 10.0f, 2.0f, D3DCOLOR_XRGB(200, 220, 255));
     DrawText(120.0f, 10.0f, buf, 2.0f, D3DCOLOR_XRGB(200, 220, 255));
 
     // Current material
-    DrawText(10.0f, 30.0f, "MATERIAL: ", 2.0f, D3DCOLOR_XRGB(255, 200, 100));
-    DrawText(180.0f, 30.0f, g_materialNames[s_currentMaterial], 2.0f, D3DCOLOR_XRGB(255, 200, 100));
+    TextMesh_Draw(&s_lblMaterial, 10.0f, 30.0f, 2.0f, D3DCOLOR_XRGB(255, 200, 100));
+    TextMesh_Draw(&s_lblMaterialName[s_currentMaterial], 180.0f, 30.0f, 2.0f, D3DCOLOR_XRGB(255, 200, 100));
 
     // Controls
-    DrawText(10.0f, 450.0f, "X: SPAWN  Y: MATERIAL", 1.5f, D3DCOLOR_XRGB(150, 150, 150));
+    TextMesh_Draw(&s_lblControls, 10.0f, 450.0f, 1.5f, D3DCOLOR_XRGB(150, 150, 150));
+}
+
+static void BuildLabels()
+{
+    TextMesh_Build(&s_lblBalls, "BALLS: ");
+    TextMesh_Build(&s_lblMaterial, "MATERIAL: ");
+    TextMesh_Build(&s_lblControls, "X: SPAWN  Y: MATERIAL  UP: BURST");
+
+    for (int i = 0; i < MAT_COUNT; ++i)
+        TextMesh_Build(&s_lblMaterialName[i], g_materialNames[i]);
+}
+
+static void ReleaseLabels()
+{
+    TextMesh_Release(&s_lblBalls);
+    TextMesh_Release(&s_lblMaterial);
+    TextMesh_Release(&s_lblControls);
+
+    for (int i = 0; i < MAT_COUNT; ++i)
+        TextMesh_Release(&s_lblMaterialName[i]);
 }
 
 // -----------------------------------------------------------------------------
@@ -736,12 +465,19 @@ static void DrawStats()
 void BallScene_Init()
 {
     s_active = true;
-    s_startTime = GetTickCount();
+    s_startTime = Clock_Ms();
     s_ballCount = 0;
     s_currentMaterial = 0;
 
+    MusicBeat beat;
+    Music_GetBeat(&beat);
+    s_beatCursor = beat.beats;
+
     CreateSphereMesh();
 
+    ReleaseLabels();
+    BuildLabels();
+
     // Spawn initial balls with variety
     SpawnBall(150.0f, 80.0f, 200.0f, 0.0f, 45.0f, MAT_RUBBER);
     SpawnBall(400.0f, 120.0f, -150.0f, 0.0f, 40.0f, MAT_CHROME);
@@ -755,6 +491,8 @@ void BallScene_Shutdown()
 
     if (s_sphereVB) { s_sphereVB->Release(); s_sphereVB = NULL; }
     if (s_sphereIB) { s_sphereIB->Release(); s_sphereIB = NULL; }
+
+    ReleaseLabels();
 }
 
 void BallScene_Update()
@@ -764,7 +502,26 @@ void BallScene_Update()
     static DWORD lastSpawnTime = 0;
     static int autoSpawnMaterial = 0;  // Cycle through materials
 
-    if (s_ballCount < 12 && tMs - lastSpawnTime > 2500) // Spawn every 2.5 seconds up to 12 balls
+    // On every fourth beat while the music has a tempo, else every 2.5
+    // seconds (and always in synthetic-clock perf runs, to stay repeatable)
+    MusicBeat beat;
+    Music_GetBeat(&beat);
+
+    bool spawnDue;
+    if (beat.bpm && !Clock_IsSynthetic())
+    {
+        // Several beats can land in one poll: spawn when the cursor crosses
+        // into a new group of four, not only when it stops on one
+        DWORD oldCursor = s_beatCursor;
+        spawnDue = Music_PollBeats(&s_beatCursor) > 0 && oldCursor / 4 != s_beatCursor / 4;
+    }
+    else
+    {
+        spawnDue = tMs - lastSpawnTime > 2500;
+        s_beatCursor = beat.beats;
+    }
+
+    if (s_ballCount < 12 && spawnDue) // up to 12 balls
     {
         lastSpawnTime = tMs;
 
@@ -808,10 +565,16 @@ void BallScene_Update()
         s_currentMaterial = (s_currentMaterial + 1) % MAT_COUNT;
     }
 
+    // D-pad up - stress burst of small balls
+    if ((buttons & BTN_DPAD_UP) && !(s_lastButtons & BTN_DPAD_UP))
+    {
+        SpawnBurst();
+    }
+
     s_lastButtons = buttons;
 
-    // Physics update (60 FPS)
-    UpdatePhysics(1.0f / 60.0f);
+    // Physics update (one fixed step per call)
+    BallPhysics_Step(s_balls, s_ballCount, CLOCK_STEP_SECONDS, BALL_BROAD_AUTO);
 }
 
 void BallScene_Render()
@@ -823,10 +586,11 @@ void BallScene_Render()
     DrawFloor();
 
     // Render all balls
+    const float alpha = Clock_StepAlpha();
     for (int i = 0; i < s_ballCount; ++i)
     {
         if (s_balls[i].active)
-            RenderBall(s_balls[i]);
+            RenderBall(s_balls[i], alpha);
     }
 
     DrawStats();
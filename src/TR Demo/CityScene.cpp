@@ -19,10 +19,14 @@
 #include "CityScene.h"
 
 #include <xtl.h>
-#include <xgraphics.h>
 #include <math.h>
 #include <stdlib.h>
 
+#include "clock.h"
+#include "devstate.h"
+#include "texcache.h"
+#include "vring.h"
+
 extern LPDIRECT3DDEVICE8 g_pDevice;
 
 // ------------------------------------------------------------
@@ -34,49 +38,13 @@ static DWORD s_startTicks = 0;
 static const DWORD SCENE_DURATION_MS = 24000;
 
 // ------------------------------------------------------------
-// DDS Logo texture (ADDED)
+// DDS Logo texture (ADDED, shared with Intro through the texture cache)
 // ------------------------------------------------------------
 
 static LPDIRECT3DTEXTURE8 s_logoTex = NULL;
 static int s_logoW = 0;
 static int s_logoH = 0;
 
-// ------------------------------------------------------------
-// DDS header structures (ADDED - from IntroScene.cpp)
-// ------------------------------------------------------------
-
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
-
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
-
 // ------------------------------------------------------------
 // LUT
 // ------------------------------------------------------------
@@ -99,146 +67,6 @@ static void BuildLUT()
     s_lutReady = true;
 }
 
-// ------------------------------------------------------------
-// DDS Loader (ADDED - from IntroScene.cpp)
-// ------------------------------------------------------------
-
-static LPDIRECT3DTEXTURE8 LoadTextureFromDDS(const char* path, int& outW, int& outH)
-{
-    outW = 0;
-    outH = 0;
-
-    if (!g_pDevice || !path)
-        return NULL;
-
-    HANDLE hFile = CreateFileA(
-        path, GENERIC_READ, FILE_SHARE_READ, NULL,
-        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-
-    if (hFile == INVALID_HANDLE_VALUE)
-        return NULL;
-
-    DWORD bytesRead = 0;
-
-    DWORD magic = 0;
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
-        bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
-
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
-
-    if (w <= 0 || h <= 0 || w != h)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if ((w & (w - 1)) != 0)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DWORD pixelBytes = (DWORD)(w * h * 4);
-
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) ||
-        bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    CloseHandle(hFile);
-
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture(
-        (UINT)w,
-        (UINT)h,
-        1,
-        0,
-        D3DFMT_A8R8G8B8,
-        0,
-        &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
-
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
-
-    XGSwizzleRect(
-        pixels,
-        w * 4,
-        NULL,
-        lr.pBits,
-        w,
-        h,
-        NULL,
-        4
-    );
-
-    tex->UnlockRect(0);
-    free(pixels);
-
-    outW = w;
-    outH = h;
-    return tex;
-}
-
 // ------------------------------------------------------------
 // Helpers
 // ------------------------------------------------------------
@@ -301,24 +129,63 @@ struct Vtx2DT
 
 static void Begin2D(bool additive)
 {
-    g_pDevice->SetVertexShader(FVF_2D);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_2D);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
 
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, additive ? D3DBLEND_ONE : D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, additive ? D3DBLEND_ONE : D3DBLEND_INVSRCALPHA);
 }
 
 static void End2D()
 {
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+}
+
+// ------------------------------------------------------------
+// Quad passes: a pass's quads go into one vertex ring reservation
+// as a triangle list and draw once at EndQuads. Nothing else may
+// draw between BeginQuads and EndQuads.
+// ------------------------------------------------------------
+
+static Vtx2D* s_quadV = NULL;
+static int    s_quadCount = 0;
+static int    s_quadMax = 0;
+
+static void BeginQuads(int maxQuads)
+{
+    s_quadV = (Vtx2D*)VRing_BeginVerts(maxQuads * 6, sizeof(Vtx2D));
+    s_quadCount = 0;
+    s_quadMax = s_quadV ? maxQuads : 0;
+}
+
+// q: four corners in triangle strip order
+static void EmitQuad(const Vtx2D* q)
+{
+    if (s_quadCount >= s_quadMax) return;
+
+    Vtx2D* v = s_quadV + s_quadCount * 6;
+    v[0] = q[0];
+    v[1] = q[1];
+    v[2] = q[2];
+    v[3] = q[2];
+    v[4] = q[1];
+    v[5] = q[3];
+    s_quadCount++;
+}
+
+static void EndQuads()
+{
+    VRing_EndVerts(D3DPT_TRIANGLELIST, s_quadCount * 6, s_quadCount * 2);
+    s_quadV = NULL;
+    s_quadMax = 0;
 }
 
 // ------------------------------------------------------------
@@ -336,14 +203,14 @@ static void DrawSky(DWORD tMs)
     q[2] = { 0.0f,     SCREEN_H,  0.0f, 1.0f, ARGB(255,  95,  8,  70) };
     q[3] = { SCREEN_W, SCREEN_H,  0.0f, 1.0f, ARGB(255,  95,  8,  70) };
 
-    g_pDevice->SetVertexShader(FVF_2D);
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+    DevState_SetVertexShader(FVF_2D);
+    DevState_SetTexture(0, NULL);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
 }
 
 // ------------------------------------------------------------
@@ -362,10 +229,13 @@ static void DrawStars()
         { 156, 110 }, { 230,  98 }, { 392, 112 }, { 468,  92 }, { 546, 116 },
     };
 
+    const int count = (int)(sizeof(s_xy) / sizeof(s_xy[0]));
+
     Begin2D(false);
+    BeginQuads(count);
 
     Vtx2D q[4];
-    for (int i = 0; i < (int)(sizeof(s_xy) / sizeof(s_xy[0])); ++i)
+    for (int i = 0; i < count; ++i)
     {
         float x = s_xy[i][0];
         float y = s_xy[i][1];
@@ -375,9 +245,10 @@ static void DrawStars()
         q[2] = { x,     y + 2, 0, 1, ARGB(0,   220, 220, 240) };
         q[3] = { x + 2, y + 2, 0, 1, ARGB(0,   220, 220, 240) };
 
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+        EmitQuad(q);
     }
 
+    EndQuads();
     End2D();
 }
 
@@ -412,7 +283,7 @@ static void DrawSunFan(float cx, float cy, float r, DWORD col, bool additive)
         fan[i + 1] = { cx + s_sunUx[i] * r, cy + s_sunUy[i] * r, 0.0f, 1.0f, col };
 
     Begin2D(additive);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLEFAN, SUN_SEGS, fan, sizeof(Vtx2D));
+    VRing_DrawUP(D3DPT_TRIANGLEFAN, SUN_SEGS, fan, sizeof(Vtx2D));
     End2D();
 }
 
@@ -427,6 +298,9 @@ static void DrawSunStripes(float cx, float cy, float r, DWORD tMs, bool isReflec
     int idx = (int)((tMs / 26u) & 1023u);
     float wob = 0.5f + 0.5f * s_sin[idx]; // 0..1
 
+    Begin2D(false);
+    BeginQuads(stripes);
+
     for (int i = 0; i < stripes; ++i)
     {
         float tt = (float)i / (float)(stripes - 1);
@@ -446,10 +320,11 @@ static void DrawSunStripes(float cx, float cy, float r, DWORD tMs, bool isReflec
         stripe[2] = { cx - halfW, yy + hh, 0.0f, 1.0f, cBot };
         stripe[3] = { cx + halfW, yy + hh, 0.0f, 1.0f, cBot };
 
-        Begin2D(false);
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, stripe, sizeof(Vtx2D));
-        End2D();
+        EmitQuad(stripe);
     }
+
+    EndQuads();
+    End2D();
 }
 
 static void DrawSunAndReflection(float sunX, float sunY, float sunR, DWORD tMs)
@@ -509,40 +384,41 @@ static void DrawLogoOnSun(float cx, float cy, float scale, DWORD tMs)
     vLogo[3].x = right; vLogo[3].y = bottom; vLogo[3].z = 0.0f; vLogo[3].rhw = 1.0f;
     vLogo[3].c = logoColor; vLogo[3].u = 1.0f; vLogo[3].v = 1.0f;
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
 
-    g_pDevice->SetTexture(0, s_logoTex);
-    g_pDevice->SetVertexShader(FVF_2DT);
+    DevState_SetTexture(0, s_logoTex);
+    DevState_SetVertexShader(FVF_2DT);
 
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, vLogo, sizeof(Vtx2DT));
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, vLogo, sizeof(Vtx2DT));
 
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetTexture(0, NULL);
 }
 
 // ------------------------------------------------------------
 // Procedural "TR" mark centered in sun (no font, no textures)
 // ------------------------------------------------------------
 
-static void DrawQuad(float x0, float y0, float x1, float y1, DWORD c0, DWORD c1)
+// Rectangle into the open quad pass, c0 along the top edge, c1 the bottom
+static void EmitRect(float x0, float y0, float x1, float y1, DWORD c0, DWORD c1)
 {
     Vtx2D q[4];
     q[0] = { x0, y0, 0, 1, c0 };
     q[1] = { x1, y0, 0, 1, c0 };
     q[2] = { x0, y1, 0, 1, c1 };
     q[3] = { x1, y1, 0, 1, c1 };
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+    EmitQuad(q);
 }
 
 static void DrawTRMark(float cx, float cy, float scale, DWORD tMs)
@@ -571,38 +447,42 @@ static void DrawTRMark(float cx, float cy, float scale, DWORD tMs)
 
     // Glow pass (additive, offset)
     Begin2D(true);
+    BeginQuads(7);
     {
         // T: top bar
-        DrawQuad(x0 + 0.0f, y0 + 0.0f, x0 + 38.0f * s, y0 + t, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 0.0f, y0 + 0.0f, x0 + 38.0f * s, y0 + t, glow, ARGB(0, 0, 0, 0));
         // T: stem
-        DrawQuad(x0 + 16.0f * s, y0 + 0.0f, x0 + 16.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 16.0f * s, y0 + 0.0f, x0 + 16.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
 
         // R: left stem
-        DrawQuad(x0 + 50.0f * s, y0 + 0.0f, x0 + 50.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 0.0f, x0 + 50.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
         // R: top bar
-        DrawQuad(x0 + 50.0f * s, y0 + 0.0f, x0 + 92.0f * s, y0 + t, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 0.0f, x0 + 92.0f * s, y0 + t, glow, ARGB(0, 0, 0, 0));
         // R: mid bar
-        DrawQuad(x0 + 50.0f * s, y0 + 24.0f * s, x0 + 86.0f * s, y0 + 24.0f * s + t, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 24.0f * s, x0 + 86.0f * s, y0 + 24.0f * s + t, glow, ARGB(0, 0, 0, 0));
         // R: diagonal leg (approx as 2 quads)
-        DrawQuad(x0 + 68.0f * s, y0 + 30.0f * s, x0 + 92.0f * s, y0 + 30.0f * s + t, glow, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 80.0f * s, y0 + 30.0f * s, x0 + 80.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 68.0f * s, y0 + 30.0f * s, x0 + 92.0f * s, y0 + 30.0f * s + t, glow, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 80.0f * s, y0 + 30.0f * s, x0 + 80.0f * s + t, y0 + 52.0f * s, glow, ARGB(0, 0, 0, 0));
     }
+    EndQuads();
     End2D();
 
     // Core pass (normal)
     Begin2D(false);
+    BeginQuads(7);
     {
         // T
-        DrawQuad(x0 + 0.0f, y0 + 0.0f, x0 + 38.0f * s, y0 + t, core, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 16.0f * s, y0 + 0.0f, x0 + 16.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 0.0f, y0 + 0.0f, x0 + 38.0f * s, y0 + t, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 16.0f * s, y0 + 0.0f, x0 + 16.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
 
         // R
-        DrawQuad(x0 + 50.0f * s, y0 + 0.0f, x0 + 50.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 50.0f * s, y0 + 0.0f, x0 + 92.0f * s, y0 + t, core, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 50.0f * s, y0 + 24.0f * s, x0 + 86.0f * s, y0 + 24.0f * s + t, core, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 68.0f * s, y0 + 30.0f * s, x0 + 92.0f * s, y0 + 30.0f * s + t, core, ARGB(0, 0, 0, 0));
-        DrawQuad(x0 + 80.0f * s, y0 + 30.0f * s, x0 + 80.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 0.0f, x0 + 50.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 0.0f, x0 + 92.0f * s, y0 + t, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 50.0f * s, y0 + 24.0f * s, x0 + 86.0f * s, y0 + 24.0f * s + t, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 68.0f * s, y0 + 30.0f * s, x0 + 92.0f * s, y0 + 30.0f * s + t, core, ARGB(0, 0, 0, 0));
+        EmitRect(x0 + 80.0f * s, y0 + 30.0f * s, x0 + 80.0f * s + t, y0 + 52.0f * s, core, ARGB(0, 0, 0, 0));
     }
+    EndQuads();
     End2D();
 }
 
@@ -683,6 +563,7 @@ static void DrawSkylineLayer(const Bldg* buildings, int count, float sweepX, BYT
     const float baseY = HORIZON_Y;
 
     Begin2D(false);
+    BeginQuads(count);
 
     for (int i = 0; i < count; ++i)
     {
@@ -698,13 +579,15 @@ static void DrawSkylineLayer(const Bldg* buildings, int count, float sweepX, BYT
         r[1] = { x1, y0, 0, 1, fill };
         r[2] = { x0, y1, 0, 1, ARGB(fillA, baseR * 0.5f, baseG * 0.5f, baseB * 0.5f) };
         r[3] = { x1, y1, 0, 1, ARGB(fillA, baseR * 0.5f, baseG * 0.5f, baseB * 0.5f) };
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, r, sizeof(Vtx2D));
+        EmitQuad(r);
     }
 
+    EndQuads();
     End2D();
 
     // Magenta tops + cyan side accents (additive)
     Begin2D(true);
+    BeginQuads(count * 2);
 
     for (int i = 0; i < count; ++i)
     {
@@ -714,16 +597,17 @@ static void DrawSkylineLayer(const Bldg* buildings, int count, float sweepX, BYT
 
         // top magenta bar
         DWORD topC = ARGB(topA, 255, 40, 200);
-        DrawQuad(x0, yT, x1, yT + 2.0f, topC, ARGB(0, 0, 0, 0));
+        EmitRect(x0, yT, x1, yT + 2.0f, topC, ARGB(0, 0, 0, 0));
 
         // subtle cyan side accent on some buildings
         if (buildings[i].style == 2)
         {
             DWORD sideC = ARGB(sideA, 60, 220, 255);
-            DrawQuad(x0, yT + 6.0f, x0 + 2.0f, baseY - 4.0f, sideC, ARGB(0, 0, 0, 0));
+            EmitRect(x0, yT + 6.0f, x0 + 2.0f, baseY - 4.0f, sideC, ARGB(0, 0, 0, 0));
         }
     }
 
+    EndQuads();
     End2D();
 }
 
@@ -744,23 +628,27 @@ static void DrawMountainRange(float sweep)
         { 600, 100 },
     };
 
+    const int count = (int)(sizeof(peaks) / sizeof(peaks[0]));
+
     Begin2D(false);
 
-    for (int i = 0; i < (int)(sizeof(peaks) / sizeof(peaks[0])); ++i)
+    Vtx2D* v = (Vtx2D*)VRing_BeginVerts(count * 3, sizeof(Vtx2D));
+
+    for (int i = 0; i < count; ++i)
     {
         float cx = peaks[i].x + sweep * 5.0f;  // subtle parallax
         float h = peaks[i].h;
         float w = 95.0f;  // even wider mountains
 
         // Triangle for mountain - much darker for high contrast
-        Vtx2D tri[3];
+        Vtx2D* tri = v + i * 3;
         tri[0].x = cx;       tri[0].y = baseY - h;         tri[0].z = 0; tri[0].rhw = 1; tri[0].c = ARGB(255, 35, 25, 55);  // peak - fully opaque
         tri[1].x = cx - w;   tri[1].y = baseY;             tri[1].z = 0; tri[1].rhw = 1; tri[1].c = ARGB(255, 25, 18, 45);  // left base
         tri[2].x = cx + w;   tri[2].y = baseY;             tri[2].z = 0; tri[2].rhw = 1; tri[2].c = ARGB(255, 25, 18, 45);  // right base
-
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, 1, tri, sizeof(Vtx2D));
     }
 
+    VRing_EndVerts(D3DPT_TRIANGLELIST, count * 3, count);
+
     End2D();
 }
 
@@ -792,6 +680,8 @@ static void DrawSkylineAndReflection(DWORD tMs, float sweep)
     };
     float sweeps[] = { backSweep, midSweep, frontSweep };
 
+    BeginQuads(layerCounts[0] + layerCounts[1] + layerCounts[2]);
+
     for (int layer = 0; layer < 3; ++layer)
     {
         for (int i = 0; i < layerCounts[layer]; ++i)
@@ -806,9 +696,10 @@ static void DrawSkylineAndReflection(DWORD tMs, float sweep)
             DWORD c0 = ARGB(70, 8, 4, 16);
             DWORD c1 = ARGB(0, 8, 4, 16);
 
-            DrawQuad(x0, yTop, x1, yBot, c0, c1);
+            EmitRect(x0, yTop, x1, yBot, c0, c1);
         }
     }
+    EndQuads();
     End2D();
 
     // Reflection tint band (magenta water glow)
@@ -819,15 +710,18 @@ static void DrawSkylineAndReflection(DWORD tMs, float sweep)
         band[1] = { SCREEN_W, HORIZON_Y,       0, 1, ARGB(75, 255, 40, 200) };
         band[2] = { 0.0f,     HORIZON_Y + 120, 0, 1, ARGB(0,  255, 40, 200) };
         band[3] = { SCREEN_W, HORIZON_Y + 120, 0, 1, ARGB(0,  255, 40, 200) };
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, band, sizeof(Vtx2D));
+        VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, band, sizeof(Vtx2D));
     }
     End2D();
 
     // Rooftop blinking red beacons (only on foreground buildings)
     Begin2D(true);
     {
+        const int count = (int)(sizeof(s_bldgFront) / sizeof(s_bldgFront[0]));
+        BeginQuads(count);
+
         unsigned tick = (tMs / 140u);
-        for (int i = 0; i < (int)(sizeof(s_bldgFront) / sizeof(s_bldgFront[0])); ++i)
+        for (int i = 0; i < count; ++i)
         {
             if (!s_bldgFront[i].beacon) continue;
 
@@ -842,8 +736,10 @@ static void DrawSkylineAndReflection(DWORD tMs, float sweep)
             q[1] = { x + 1.5f, y - 1.5f, 0, 1, ARGB(220, 255, 40, 40) };
             q[2] = { x - 1.5f, y + 1.5f, 0, 1, ARGB(0,   255, 40, 40) };
             q[3] = { x + 1.5f, y + 1.5f, 0, 1, ARGB(0,   255, 40, 40) };
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+            EmitQuad(q);
         }
+
+        EndQuads();
     }
     End2D();
 }
@@ -862,12 +758,15 @@ static void DrawGridAndWater(DWORD tMs, float sweep)
 
     float botY = WATER_BOTTOM_Y;
 
+    const int vcount = 19;
+    const int hcount = 18;
+    const int mid = (vcount - 1) / 2; // 9
+
     // Vertical perspective lines - BRIGHTER to match concept
     Begin2D(true);
+    BeginQuads(vcount + hcount);
 
-    static Vtx2D v[4];
-    const int vcount = 19;
-    const int mid = (vcount - 1) / 2; // 9
+    Vtx2D v[4];
 
     for (int i = 0; i < vcount; ++i)
     {
@@ -888,12 +787,11 @@ static void DrawGridAndWater(DWORD tMs, float sweep)
         v[2] = { botX - 2.0f, botY,  0, 1, ARGB(0,0,0,0) };
         v[3] = { botX + 2.0f, botY,  0, 1, ARGB(0,0,0,0) };
 
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(Vtx2D));
+        EmitQuad(v);
     }
 
     // Horizontal grid lines scrolling down (gives motion) - BRIGHTER
-    static Vtx2D h[4];
-    const int hcount = 18;
+    Vtx2D h[4];
 
     unsigned sc = (tMs / 12u) & 1023u;
     float scrollF = (float)sc * (1.0f / 1023.0f);
@@ -917,9 +815,10 @@ static void DrawGridAndWater(DWORD tMs, float sweep)
         h[2] = { apexX - halfW, y + 0.8f, 0, 1, ARGB(0,0,0,0) };
         h[3] = { apexX + halfW, y + 0.8f, 0, 1, ARGB(0,0,0,0) };
 
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, h, sizeof(Vtx2D));
+        EmitQuad(h);
     }
 
+    EndQuads();
     End2D();
 
     // Water darkening toward bottom
@@ -930,7 +829,7 @@ static void DrawGridAndWater(DWORD tMs, float sweep)
         fade[1] = { SCREEN_W, apexY, 0, 1, ARGB(0,   0, 0, 0) };
         fade[2] = { 0.0f,     botY,  0, 1, ARGB(200, 0, 0, 0) };
         fade[3] = { SCREEN_W, botY,  0, 1, ARGB(200, 0, 0, 0) };
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, fade, sizeof(Vtx2D));
+        VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, fade, sizeof(Vtx2D));
     }
     End2D();
 }
@@ -942,13 +841,13 @@ static void DrawGridAndWater(DWORD tMs, float sweep)
 void CityScene_Init()
 {
     s_active = true;
-    s_startTicks = GetTickCount();
+    s_startTicks = Clock_Ms();
 
     BuildLUT();
     BuildSunCircle();
 
     // ADDED: Load logo texture
-    s_logoTex = LoadTextureFromDDS("D:\\tex\\tr.dds", s_logoW, s_logoH);
+    s_logoTex = TexCache_Acquire("D:\\tex\\tr.dds", 1, &s_logoW, &s_logoH);
 }
 
 void CityScene_Shutdown()
@@ -956,17 +855,14 @@ void CityScene_Shutdown()
     s_active = false;
 
     // ADDED: Release logo texture
-    if (s_logoTex)
-    {
-        s_logoTex->Release();
-        s_logoTex = NULL;
-    }
+    TexCache_Release(s_logoTex);
+    s_logoTex = NULL;
 }
 
 bool CityScene_IsFinished()
 {
     if (!s_active) return true;
-    return (GetTickCount() - s_startTicks) >= SCENE_DURATION_MS;
+    return (Clock_Ms() - s_startTicks) >= SCENE_DURATION_MS;
 }
 
 void CityScene_Render(float)
@@ -974,7 +870,7 @@ void CityScene_Render(float)
     if (!s_active || !g_pDevice)
         return;
 
-    DWORD tMs = GetTickCount() - s_startTicks;
+    DWORD tMs = Clock_Ms() - s_startTicks;
 
     // Camera sweep (gentle) + parallax driver
     int idxA = (int)((tMs / 34u) & 1023u);
@@ -15,6 +15,9 @@
 #include <string.h>
 
 #include "font.h"
+#include "clock.h"
+#include "devstate.h"
+#include "vring.h"
 
 // ------------------------------------------------------------
 // Scene control
@@ -56,7 +59,7 @@ static void InitStarfield()
 {
     if (s_starsInit) return;
 
-    s_starSeed ^= GetTickCount();
+    s_starSeed ^= Clock_Ms();
 
     for (int i = 0; i < STAR_COUNT; ++i)
     {
@@ -157,7 +160,7 @@ static void RenderStarfield()
     extern LPDIRECT3DDEVICE8 g_pDevice;
     if (!g_pDevice) return;
 
-    DWORD now = GetTickCount();
+    DWORD now = Clock_Ms();
     float time = (float)(now - s_startTicks) * 0.001f;
 
     struct StarVtx
@@ -166,16 +169,19 @@ static void RenderStarfield()
         DWORD color;
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+
+    // Draw stars as points (2x2 pixels for visibility), every quad into one
+    // ring reservation as a triangle list, one draw for the field
+    StarVtx* v = (StarVtx*)VRing_BeginVerts(STAR_COUNT * 6, sizeof(StarVtx));
 
-    // Draw stars as points (2x2 pixels for visibility)
     for (int i = 0; i < STAR_COUNT; ++i)
     {
         const Star& s = s_stars[i];
@@ -189,16 +195,16 @@ static void RenderStarfield()
         float twinkle = 0.9f + 0.2f * sinf(time * 2.0f + (float)i * 0.3f);
         size *= twinkle;
 
-        StarVtx quad[4] =
-        {
-            { s.x,        s.y,        0.0f, 1.0f, col },
-            { s.x + size, s.y,        0.0f, 1.0f, col },
-            { s.x,        s.y + size, 0.0f, 1.0f, col },
-            { s.x + size, s.y + size, 0.0f, 1.0f, col },
-        };
-
-        g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(StarVtx));
+        StarVtx* q = v + i * 6;
+        q[0] = { s.x,        s.y,        0.0f, 1.0f, col };
+        q[1] = { s.x + size, s.y,        0.0f, 1.0f, col };
+        q[2] = { s.x,        s.y + size, 0.0f, 1.0f, col };
+        q[3] = q[2];
+        q[4] = q[1];
+        q[5] = { s.x + size, s.y + size, 0.0f, 1.0f, col };
     }
+
+    VRing_EndVerts(D3DPT_TRIANGLELIST, STAR_COUNT * 6, STAR_COUNT * 2);
 }
 
 // ------------------------------------------------------------
@@ -217,30 +223,22 @@ static inline DWORD ARGB(BYTE a, BYTE r, BYTE g, BYTE b)
     return D3DCOLOR_ARGB(a, r, g, b);
 }
 
-// Approximate text width for centering (5x7 font, typically 6px advance incl spacing)
-static float MeasureTextWidth(const char* text, float scale)
-{
-    if (!text) return 0.0f;
-    const size_t n = strlen(text);
-    return (float)n * 6.0f * scale;
-}
-
 // Render states for 2D text (font.cpp likely uses XYZRHW internally; keep it safe)
 static void Setup2DTextStates()
 {
     extern LPDIRECT3DDEVICE8 g_pDevice;
     if (!g_pDevice) return;
 
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 }
 
 static void End2DTextStates()
@@ -248,8 +246,8 @@ static void End2DTextStates()
     extern LPDIRECT3DDEVICE8 g_pDevice;
     if (!g_pDevice) return;
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
 }
 
 // ------------------------------------------------------------
@@ -326,6 +324,27 @@ static const CreditLine s_lines[] =
 
 static const int LINE_COUNT = (int)(sizeof(s_lines) / sizeof(s_lines[0]));
 
+// Pre-built text meshes (one per line, built at Init; blank lines stay empty)
+static TextMesh s_lineMesh[LINE_COUNT];
+
+static void BuildLineMeshes()
+{
+    for (int i = 0; i < LINE_COUNT; ++i)
+    {
+        const CreditLine& L = s_lines[i];
+        if (L.type == LT_Blank || !L.text || L.text[0] == '\0')
+            continue;
+
+        TextMesh_Build(&s_lineMesh[i], L.text);
+    }
+}
+
+static void ReleaseLineMeshes()
+{
+    for (int i = 0; i < LINE_COUNT; ++i)
+        TextMesh_Release(&s_lineMesh[i]);
+}
+
 // ------------------------------------------------------------
 // Scroll / perspective settings
 // ------------------------------------------------------------
@@ -383,21 +402,26 @@ static void GetPerspectiveForY(float y, float* outScale, float* outPull)
 void Credits_Init()
 {
     s_active = true;
-    s_startTicks = GetTickCount();
+    s_startTicks = Clock_Ms();
     InitStarfield();
+
+    ReleaseLineMeshes();
+    BuildLineMeshes();
 }
 
 void Credits_Shutdown()
 {
     s_active = false;
     s_starsInit = false;
+
+    ReleaseLineMeshes();
 }
 
 bool Credits_IsFinished()
 {
     if (!s_active) return true;
 
-    const DWORD now = GetTickCount();
+    const DWORD now = Clock_Ms();
     const float tSec = (float)(now - s_startTicks) * (1.0f / 1000.0f);
 
     // When the last line has passed beyond the horizon, end.
@@ -412,7 +436,7 @@ void Credits_Render(float)
     extern LPDIRECT3DDEVICE8 g_pDevice;
     if (!s_active || !g_pDevice) return;
 
-    const DWORD now = GetTickCount();
+    const DWORD now = Clock_Ms();
     const float tSec = (float)(now - s_startTicks) * (1.0f / 1000.0f);
 
     // Base Y for first line
@@ -458,7 +482,8 @@ void Credits_Render(float)
         float sFinal = scale * sMul;
 
         // Center + "pull in" towards center as it recedes
-        const float w = MeasureTextWidth(L.text, sFinal);
+        const TextMesh& M = s_lineMesh[i];
+        const float w = TextMesh_Width(&M, sFinal);
         float x = s_centerX - (w * 0.5f);
 
         x = s_centerX + (x - s_centerX) * pull;
@@ -477,7 +502,7 @@ void Credits_Render(float)
         BYTE g = (BYTE)((c >> 8) & 0xFF);
         BYTE b = (BYTE)((c) & 0xFF);
 
-        DrawText(x, y, L.text, sFinal, ARGB(a, r, g, b));
+        TextMesh_Draw(&M, x, y, sFinal, ARGB(a, r, g, b));
 
         y += gap;
     }
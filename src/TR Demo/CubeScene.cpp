@@ -18,6 +18,8 @@
 #include <math.h>
 
 #include "font.h"
+#include "clock.h"
+#include "devstate.h"
 
 extern LPDIRECT3DDEVICE8 g_pDevice;
 
@@ -168,7 +170,7 @@ static void BuildStreams()
 {
     if (s_built) return;
 
-    s_rng ^= GetTickCount();
+    s_rng ^= Clock_Ms();
 
     for (int f = 0; f < 6; ++f)
     {
@@ -250,7 +252,7 @@ static void DrawGlowTextAdaptive(float x, float y, const char* s, float scale, D
 void CubeScene_Init()
 {
     s_active = true;
-    s_startTicks = GetTickCount();
+    s_startTicks = Clock_Ms();
 
     BuildLUT();
     BuildStreams();
@@ -264,7 +266,7 @@ void CubeScene_Shutdown()
 bool CubeScene_IsFinished()
 {
     if (!s_active) return true;
-    return (GetTickCount() - s_startTicks) >= SCENE_DURATION_MS;
+    return (Clock_Ms() - s_startTicks) >= SCENE_DURATION_MS;
 }
 
 void CubeScene_Render(float)
@@ -272,7 +274,7 @@ void CubeScene_Render(float)
     if (!s_active || !g_pDevice)
         return;
 
-    DWORD tMs = GetTickCount() - s_startTicks;
+    DWORD tMs = Clock_Ms() - s_startTicks;
 
     // camera
     D3DXMATRIX view, proj;
@@ -294,10 +296,10 @@ void CubeScene_Render(float)
     D3DXMATRIX wvp = world * view * proj;
 
     // text overlay states
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
 
     // layout
     const float cubeS = 2.15f;
@@ -429,5 +431,5 @@ void CubeScene_Render(float)
         }
     }
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
 }
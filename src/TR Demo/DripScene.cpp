@@ -4,6 +4,7 @@
 // 
 // Controls:
 //   Y Button - Toggle rain effect on/off
+//   X Button - Toggle active-tile stats overlay
 //
 // Features:
 //   - Real-time water ripple simulation with damping
@@ -16,6 +17,7 @@
 //   - Rain mode for continuous droplet generation
 //   - Random ambient droplets
 //   - Splash highlights at impact points
+//   - 16x16 activity tiles: flat water sleeps (no sim, color-only refresh)
 //
 // ============================================================================
 
@@ -26,6 +28,9 @@
 #include <string.h>
 
 #include "input.h"
+#include "font.h"
+#include "RippleKernel.h"
+#include "devstate.h"
 
 extern IDirect3DDevice8* g_pd3dDevice;
 
@@ -52,7 +57,7 @@ namespace
     // Ripple solver (integer)
     // -------------------------------------------------------------------------
     static const int DAMP = 247;
-    static const int STEPS_PER_FRAME = 2;
+    static const int STEPS_PER_UPDATE = 2;   // solver steps per DripScene_Update (CLOCK_STEP_HZ)
 
     // Visual lift
     static const int HEIGHT_SCALE = 6;
@@ -81,6 +86,32 @@ namespace
 
     __forceinline int IDX(int x, int y) { return y * GRID_W + x; }
 
+    // -------------------------------------------------------------------------
+    // Activity tiles
+    // -------------------------------------------------------------------------
+    // Tiles with no energy are zeroed and skipped by the solver; the vertex
+    // build only refreshes their (caustic) colors. Any awake tile carrying
+    // energy keeps its 8 neighbours awake so waves can travel into them.
+    static const int TILE = 16;                 // GRID_W / GRID_H are multiples
+    static const int TILES_X = GRID_W / TILE;
+    static const int TILES_Y = GRID_H / TILE;
+    static const int TILE_COUNT = TILES_X * TILES_Y;
+
+    static const int TILE_SLEEP_PEAK = 64;      // |h| below this: lift 0 / -1 px
+    static const int TILE_SLEEP_SPLASH = 8;     // splash >> SPLASH_SCALE == 0
+    static const int TILE_SLEEP_STEPS = 8;      // quiet steps before sleeping
+
+    static BYTE g_tileAwake[TILE_COUNT];
+    static BYTE g_tileQuiet[TILE_COUNT];        // consecutive quiet steps
+    static BYTE g_tileFlat[TILE_COUNT];         // VB already holds the flat tile
+    static BYTE g_tileWake[TILE_COUNT];         // scratch for wake propagation
+    static int  g_tilePeak[2][TILE_COUNT];      // max |h| per buffer (A, B)
+
+    // Per-frame instrumentation (X toggles the overlay)
+    static RippleStats g_simStats;
+    static int  g_simActiveTiles = 0;           // summed over the frame's steps
+    static bool g_showStats = false;
+
     // -------------------------------------------------------------------------
     // RNG
     // -------------------------------------------------------------------------
@@ -124,6 +155,41 @@ namespace
         g_ping = 0;
         g_windPhase = 0;
         g_rainCounter = 0;
+
+        memset(g_tileAwake, 0, sizeof(g_tileAwake));
+        memset(g_tileQuiet, 0, sizeof(g_tileQuiet));
+        memset(g_tileFlat, 0, sizeof(g_tileFlat));
+        memset(g_tilePeak, 0, sizeof(g_tilePeak));
+    }
+
+    static void WakeTile(int t)
+    {
+        if (!g_tileAwake[t])
+        {
+            g_tileAwake[t] = 1;
+            g_tileFlat[t] = 0;
+        }
+        g_tileQuiet[t] = 0;
+    }
+
+    static void SleepTile(int t)
+    {
+        int x0 = (t % TILES_X) * TILE;
+        int y0 = (t / TILES_X) * TILE;
+
+        for (int y = y0; y < y0 + TILE; ++y)
+        {
+            int i = IDX(x0, y);
+            memset(&g_bufA[i], 0, TILE * sizeof(SHORT));
+            memset(&g_bufB[i], 0, TILE * sizeof(SHORT));
+            memset(&g_splash[i], 0, TILE * sizeof(SHORT));
+        }
+
+        g_tileAwake[t] = 0;
+        g_tileQuiet[t] = 0;
+        g_tileFlat[t] = 0;      // one more full vertex build, then color-only
+        g_tilePeak[0][t] = 0;
+        g_tilePeak[1][t] = 0;
     }
 
     static void AddDrop(int cx, int cy, int radius, int strength)
@@ -131,15 +197,17 @@ namespace
         int r2 = radius * radius;
         SHORT* cur = (g_ping == 0) ? g_bufA : g_bufB;
 
+        // Border cells are fixed (never stepped or damped), so drops skip
+        // them instead of leaving permanent spikes along the edges.
         for (int y = cy - radius; y <= cy + radius; ++y)
         {
-            if ((unsigned)y >= (unsigned)GRID_H) continue;
+            if ((unsigned)(y - 1) >= (unsigned)(GRID_H - 2)) continue;
             int dy = y - cy;
             int dy2 = dy * dy;
 
             for (int x = cx - radius; x <= cx + radius; ++x)
             {
-                if ((unsigned)x >= (unsigned)GRID_W) continue;
+                if ((unsigned)(x - 1) >= (unsigned)(GRID_W - 2)) continue;
                 int dx = x - cx;
                 int d2 = dx * dx + dy2;
                 if (d2 > r2) continue;
@@ -154,6 +222,22 @@ namespace
                     g_splash[i] = 2400;
             }
         }
+
+        // Wake the covered tiles; their cur peak is unknown until stepped.
+        int tx0 = (cx - radius) / TILE, tx1 = (cx + radius) / TILE;
+        int ty0 = (cy - radius) / TILE, ty1 = (cy + radius) / TILE;
+        if (tx0 < 0) tx0 = 0;
+        if (ty0 < 0) ty0 = 0;
+        if (tx1 > TILES_X - 1) tx1 = TILES_X - 1;
+        if (ty1 > TILES_Y - 1) ty1 = TILES_Y - 1;
+
+        for (int ty = ty0; ty <= ty1; ++ty)
+            for (int tx = tx0; tx <= tx1; ++tx)
+            {
+                int t = ty * TILES_X + tx;
+                WakeTile(t);
+                g_tilePeak[g_ping][t] = 32767;
+            }
     }
 
     static void StepSimOnce()
@@ -161,78 +245,202 @@ namespace
         SHORT* cur = (g_ping == 0) ? g_bufA : g_bufB;
         SHORT* prev = (g_ping == 0) ? g_bufB : g_bufA;
 
-        for (int y = 1; y < GRID_H - 1; ++y)
-        {
-            int row = y * GRID_W;
-            for (int x = 1; x < GRID_W - 1; ++x)
+        const int curBuf = g_ping;
+        const int prevBuf = g_ping ^ 1;
+
+        // 1) Tiles carrying energy wake their neighbours before the step.
+        // Neighbours already awake restart their quiet count too, or a
+        // wavefront still arriving would see them sleep and wake again.
+        memset(g_tileWake, 0, sizeof(g_tileWake));
+
+        for (int ty = 0; ty < TILES_Y; ++ty)
+            for (int tx = 0; tx < TILES_X; ++tx)
             {
-                int i = row + x;
-                int n =
-                    cur[i - 1] +
-                    cur[i + 1] +
-                    cur[i - GRID_W] +
-                    cur[i + GRID_W];
-
-                int next = (n >> 1) - prev[i];
-                prev[i] = (SHORT)((next * DAMP) >> 8);
+                int t = ty * TILES_X + tx;
+                if (!g_tileAwake[t])
+                    continue;
+
+                if (g_tilePeak[0][t] < TILE_SLEEP_PEAK && g_tilePeak[1][t] < TILE_SLEEP_PEAK)
+                    continue;
+
+                for (int ny = ty - 1; ny <= ty + 1; ++ny)
+                    for (int nx = tx - 1; nx <= tx + 1; ++nx)
+                        if ((unsigned)nx < (unsigned)TILES_X && (unsigned)ny < (unsigned)TILES_Y)
+                            g_tileWake[ny * TILES_X + nx] = 1;
             }
+
+        for (int t = 0; t < TILE_COUNT; ++t)
+            if (g_tileWake[t])
+                WakeTile(t);
+
+        // 2) Wave step + splash decay per awake tile (RippleKernel, MMX)
+        for (int t = 0; t < TILE_COUNT; ++t)
+        {
+            if (!g_tileAwake[t])
+                continue;
+
+            int x0 = (t % TILES_X) * TILE;
+            int y0 = (t / TILES_X) * TILE;
+
+            RipplePeak pk;
+            Ripple_Step(cur, prev, g_splash, GRID_W, GRID_H, DAMP,
+                x0, y0, x0 + TILE, y0 + TILE, &pk, &g_simStats);
+
+            g_tilePeak[prevBuf][t] = pk.wave;
+            g_simActiveTiles++;
+
+            bool quiet =
+                pk.wave < TILE_SLEEP_PEAK &&
+                g_tilePeak[curBuf][t] < TILE_SLEEP_PEAK &&
+                pk.splash < TILE_SLEEP_SPLASH;
+
+            if (!quiet)
+                g_tileQuiet[t] = 0;
+            else if (g_tileQuiet[t] < TILE_SLEEP_STEPS)
+                g_tileQuiet[t]++;
         }
 
-        for (int i = 0; i < GRID_W * GRID_H; ++i)
-            if (g_splash[i] > 0)
-                g_splash[i] -= (g_splash[i] >> 2) + 1;
+        // 3) Sleep after the sweep (cur is still being read above)
+        for (int t = 0; t < TILE_COUNT; ++t)
+            if (g_tileAwake[t] && g_tileQuiet[t] >= TILE_SLEEP_STEPS)
+                SleepTile(t);
 
         g_ping ^= 1;
     }
 
-    // Polished water color with depth, foam, highlights, and caustics
-    static DWORD WaterColorFromSlope(int slope, int height, int x, int y)
+    // -------------------------------------------------------------------------
+    // Projection / shading tables (built at Init)
+    // -------------------------------------------------------------------------
+    // Water color (depth, specular, foam, height light, caustics) as
+    // additive layers:
+    //   row base (depth) + caustic      - never exceeds 255, plain add
+    //   slope (specular + foam)         - pre-clamped per channel
+    //   height light                    - blue only
+    // All layers are >= 0, so chained per-byte saturating adds give exactly
+    // the original min(sum, 255) per channel.
+    static const int SLOPE_LUT_MAX = 1280;      // specular and foam both saturated
+    static const int HEIGHT_LUT_MAX = 42;       // height light saturated
+
+    static const int OVERSCAN_NUM = 110;        // 10% vertical overscan
+    static const int OVERSCAN_DEN = 100;
+
+    static int   g_rowScale[GRID_H];            // perspective, 8.8
+    static int   g_rowSy[GRID_H];               // screen y before height lift
+    static int   g_colDx[GRID_W];               // column x relative to screen center
+    static DWORD g_rowBase[GRID_H];
+    static DWORD g_causticAdd[256];
+    static DWORD g_slopeAdd[SLOPE_LUT_MAX + 1];
+    static DWORD g_heightAdd[HEIGHT_LUT_MAX + 1];
+
+    static void BuildTables()
     {
-        // Calculate slope magnitude and direction
-        int s = slope < 0 ? -slope : slope;
+        const int horizon = 0; // Start at top of screen instead of 1/5 down
+        const int cx = SCREEN_W / 2;
 
-        // Base depth color - darker blue in deeper areas
-        int depthFactor = 255 - ((y * 180) / GRID_H); // Darker as we go down
-        int baseR = (depthFactor * 40) / 255;
-        int baseG = (depthFactor * 80) / 255;
-        int baseB = (depthFactor * 140) / 255;
-
-        // Specular highlights on steep slopes (wave peaks)
-        int specular = 0;
-        if (s > 400) {
-            specular = ((s - 400) >> 1);
-            if (specular > 180) specular = 180;
+        for (int y = 0; y < GRID_H; ++y)
+        {
+            int depth = y + 32;
+            g_rowScale[y] = (256 * (GRID_H + 32)) / depth;
+
+            // 10% vertical overscan to prevent top-edge clipping/tearing when height lifts
+            int sy = horizon + ((y * (SCREEN_H * OVERSCAN_NUM / OVERSCAN_DEN)) / (GRID_H - 1));
+            sy -= (SCREEN_H * (OVERSCAN_NUM - OVERSCAN_DEN)) / (2 * OVERSCAN_DEN); // shift up by half overscan
+            g_rowSy[y] = sy;
+
+            int depthFactor = 255 - ((y * 180) / GRID_H);
+            int baseR = (depthFactor * 40) / 255;
+            int baseG = (depthFactor * 80) / 255;
+            int baseB = (depthFactor * 140) / 255;
+            g_rowBase[y] = D3DCOLOR_XRGB(baseR, baseG, baseB);
         }
 
-        // Foam on very sharp peaks
-        int foam = 0;
-        if (s > 800) {
-            foam = ((s - 800) >> 2);
-            if (foam > 120) foam = 120;
+        for (int x = 0; x < GRID_W; ++x)
+            g_colDx[x] = (x * SCREEN_W) / (GRID_W - 1) - cx;
+
+        for (int phase = 0; phase < 256; ++phase)
+        {
+            int caustic = (phase > 128) ? ((phase - 128) >> 3) : 0;
+            g_causticAdd[phase] = (DWORD)((caustic << 8) | (caustic >> 1));
         }
 
-        // Caustics simulation - subtle light patterns
-        int causticPhase = (x * 7 + y * 11 + g_windPhase) & 255;
-        int caustic = (causticPhase > 128) ? ((causticPhase - 128) >> 3) : 0;
+        for (int s = 0; s <= SLOPE_LUT_MAX; ++s)
+        {
+            int specular = 0;
+            if (s > 400) {
+                specular = ((s - 400) >> 1);
+                if (specular > 180) specular = 180;
+            }
+
+            int foam = 0;
+            if (s > 800) {
+                foam = ((s - 800) >> 2);
+                if (foam > 120) foam = 120;
+            }
 
-        // Height-based highlights (crests catch light)
-        int heightLight = 0;
-        if (height > 8) {
-            heightLight = ((height - 8) * 3);
-            if (heightLight > 100) heightLight = 100;
+            int r = (specular >> 1) + foam;
+            int g = specular + foam;
+            int b = specular + foam;
+            if (g > 255) g = 255;
+            if (b > 255) b = 255;
+
+            g_slopeAdd[s] = (DWORD)((r << 16) | (g << 8) | b);
         }
 
-        // Combine all layers
-        int r = baseR + (specular >> 1) + foam;
-        int g = baseG + specular + foam + caustic;
-        int b = baseB + specular + foam + heightLight + (caustic >> 1);
+        for (int height = 0; height <= HEIGHT_LUT_MAX; ++height)
+        {
+            int heightLight = 0;
+            if (height > 8) {
+                heightLight = ((height - 8) * 3);
+                if (heightLight > 100) heightLight = 100;
+            }
 
-        // Clamp values
-        if (r > 255) r = 255;
-        if (g > 255) g = 255;
-        if (b > 255) b = 255;
+            g_heightAdd[height] = (DWORD)heightLight;
+        }
+    }
 
-        return D3DCOLOR_XRGB(r, g, b);
+    // Per-byte saturating add (SWAR)
+    __forceinline DWORD AddSat8(DWORD a, DWORD b)
+    {
+        DWORD sum = (a & 0x7F7F7F7F) + (b & 0x7F7F7F7F);
+        DWORD top = (a ^ b) & 0x80808080;
+        DWORD carry = ((a & b) | (top & sum)) & 0x80808080;
+        return (sum ^ top) | ((carry >> 7) * 0xFF);
+    }
+
+    // Water color for one vertex; base = g_rowBase[y] + caustic.
+    __forceinline DWORD WaterColorFromTables(int slope, int height, DWORD base)
+    {
+        int s = slope < 0 ? -slope : slope;
+        if (s > SLOPE_LUT_MAX) s = SLOPE_LUT_MAX;
+
+        if (height < 0) height = 0;
+        if (height > HEIGHT_LUT_MAX) height = HEIGHT_LUT_MAX;
+
+        return AddSat8(base, AddSat8(g_slopeAdd[s], g_heightAdd[height]));
+    }
+
+    static LONGLONG g_perfFreq = 0;
+    static int      g_vertexBuildUs = 0;
+
+    // Tiny formatters for the stats overlay (no CRT printf)
+    static char* AppendStr(char* p, const char* s)
+    {
+        while (*s) *p++ = *s++;
+        *p = '\0';
+        return p;
+    }
+
+    static char* AppendInt(char* p, int val)
+    {
+        char tmp[12];
+        int n = 0;
+
+        if (val < 0) { *p++ = '-'; val = -val; }
+        do { tmp[n++] = (char)('0' + (val % 10)); val /= 10; } while (val > 0);
+        while (n > 0) *p++ = tmp[--n];
+
+        *p = '\0';
+        return p;
     }
 
     // height-based color scheme
@@ -256,6 +464,10 @@ namespace
 void DripScene_Init()
 {
     ClearSim();
+    BuildTables();
+
+    LARGE_INTEGER freq;
+    g_perfFreq = QueryPerformanceFrequency(&freq) ? freq.QuadPart : 0;
 
     const int cx = GRID_W - 1;
     const int cy = GRID_H - 1;
@@ -336,6 +548,10 @@ void DripScene_Update()
     if ((buttons & BTN_Y) && !(g_lastButtons & BTN_Y))
         g_rainEnabled = !g_rainEnabled;
 
+    // X button - toggle stats overlay
+    if ((buttons & BTN_X) && !(g_lastButtons & BTN_X))
+        g_showStats = !g_showStats;
+
     g_lastButtons = buttons;
 
     // Rain effect
@@ -357,7 +573,11 @@ void DripScene_Update()
     if ((r & 255) == 0)
         AddDrop(r % GRID_W, (r >> 16) % GRID_H, 7, -4200);
 
-    for (int i = 0; i < STEPS_PER_FRAME; ++i)
+    g_simStats.cells = 0;
+    g_simStats.scalarCells = 0;
+    g_simActiveTiles = 0;
+
+    for (int i = 0; i < STEPS_PER_UPDATE; ++i)
         StepSimOnce();
 
     g_windPhase += WIND_SPEED;
@@ -365,59 +585,115 @@ void DripScene_Update()
 
 void DripScene_Render()
 {
-    g_pd3dDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pd3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pd3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
     const SHORT* h = (g_ping == 0) ? g_bufA : g_bufB;
 
     Vtx* v;
     g_vb->Lock(0, 0, (BYTE**)&v, 0);
 
-    const int horizon = 0; // Start at top of screen instead of 1/5 down
+    LARGE_INTEGER t0;
+    QueryPerformanceCounter(&t0);
+
     const int cx = SCREEN_W / 2;
 
     for (int y = 0; y < GRID_H; ++y)
     {
-        int depth = y + 32;
-        int scale = (256 * (GRID_H + 32)) / depth;
-        // 10% vertical overscan to prevent top-edge clipping/tearing when height lifts
-        const int OVERSCAN_NUM = 110;
-        const int OVERSCAN_DEN = 100;
+        const int scale = g_rowScale[y];
+        const int sy = g_rowSy[y];
 
-        int sy = horizon + ((y * (SCREEN_H * OVERSCAN_NUM / OVERSCAN_DEN)) / (GRID_H - 1));
-        sy -= (SCREEN_H * (OVERSCAN_NUM - OVERSCAN_DEN)) / (2 * OVERSCAN_DEN); // shift up by half overscan
+        const BYTE* flat = &g_tileFlat[(y / TILE) * TILES_X];
+        const DWORD rowBase = g_rowBase[y];
+        const int causticRow = y * 11 + g_windPhase;
 
-        for (int x = 0; x < GRID_W; ++x)
+        for (int tx = 0; tx < TILES_X; ++tx)
         {
-            int i = IDX(x, y);
-            int lx = (x * SCREEN_W) / (GRID_W - 1);
-            int sx = cx + (((lx - cx) * scale) >> 8);
-
-            int height =
-                (h[i] >> HEIGHT_SCALE) +
-                (g_splash[i] >> SPLASH_SCALE);
-
-            SHORT hL = (x > 0) ? h[i - 1] : h[i];
-            SHORT hR = (x < GRID_W - 1) ? h[i + 1] : h[i];
-            SHORT hU = (y > 0) ? h[i - GRID_W] : h[i];
-            SHORT hD = (y < GRID_H - 1) ? h[i + GRID_W] : h[i];
-
-            int slope = (hR - hL) + (hD - hU);
-
-            v[i].x = (float)sx;
-            v[i].y = (float)(sy - height);
-            v[i].z = 0.0f;
-            v[i].rhw = 1.0f;
-            v[i].diffuse = WaterColorFromSlope(slope, height, x, y);
+            int x0 = tx * TILE;
+            int x1 = x0 + TILE;
+
+            // Sleeping tile already in the VB: only the caustics move
+            if (flat[tx])
+            {
+                for (int x = x0; x < x1; ++x)
+                    v[IDX(x, y)].diffuse = rowBase + g_causticAdd[(x * 7 + causticRow) & 255];
+                continue;
+            }
+
+            for (int x = x0; x < x1; ++x)
+            {
+                int i = IDX(x, y);
+                int sx = cx + ((g_colDx[x] * scale) >> 8);
+
+                int height =
+                    (h[i] >> HEIGHT_SCALE) +
+                    (g_splash[i] >> SPLASH_SCALE);
+
+                SHORT hL = (x > 0) ? h[i - 1] : h[i];
+                SHORT hR = (x < GRID_W - 1) ? h[i + 1] : h[i];
+                SHORT hU = (y > 0) ? h[i - GRID_W] : h[i];
+                SHORT hD = (y < GRID_H - 1) ? h[i + GRID_W] : h[i];
+
+                int slope = (hR - hL) + (hD - hU);
+
+                DWORD base = rowBase + g_causticAdd[(x * 7 + causticRow) & 255];
+
+                v[i].x = (float)sx;
+                v[i].y = (float)(sy - height);
+                v[i].z = 0.0f;
+                v[i].rhw = 1.0f;
+                v[i].diffuse = WaterColorFromTables(slope, height, base);
+            }
         }
     }
 
+    // Tiles that went to sleep were just written flat; color-only from now on
+    for (int t = 0; t < TILE_COUNT; ++t)
+        if (!g_tileAwake[t])
+            g_tileFlat[t] = 1;
+
+    LARGE_INTEGER t1;
+    QueryPerformanceCounter(&t1);
+    g_vertexBuildUs = g_perfFreq ? (int)(((t1.QuadPart - t0.QuadPart) * 1000000) / g_perfFreq) : 0;
+
     g_vb->Unlock();
 
-    g_pd3dDevice->SetVertexShader(FVF_VTX);
-    g_pd3dDevice->SetStreamSource(0, g_vb, sizeof(Vtx));
-    g_pd3dDevice->SetIndices(g_ibTri, 0);
+    DevState_SetVertexShader(FVF_VTX);
+    DevState_SetStreamSource(0, g_vb, sizeof(Vtx));
+    DevState_SetIndices(g_ibTri, 0);
     g_pd3dDevice->DrawIndexedPrimitive(
         D3DPT_TRIANGLELIST, 0, GRID_W * GRID_H, 0, g_triCount);
+
+    if (g_showStats)
+    {
+        DripStats st;
+        DripScene_GetStats(&st);
+
+        char buf[64];
+        char* p = buf;
+        p = AppendStr(p, "TILES ");
+        p = AppendInt(p, st.activeTiles);
+        p = AppendStr(p, "/");
+        p = AppendInt(p, st.totalTiles);
+        p = AppendStr(p, "  CELLS ");
+        p = AppendInt(p, st.simCells);
+        p = AppendStr(p, "  VB ");
+        p = AppendInt(p, st.vertexBuildUs);
+        p = AppendStr(p, "US");
+
+        DrawText(10.0f, 10.0f, buf, 2.0f, D3DCOLOR_XRGB(200, 220, 255));
+    }
+}
+
+void DripScene_GetStats(DripStats* out)
+{
+    if (!out)
+        return;
+
+    out->activeTiles = g_simActiveTiles / STEPS_PER_UPDATE;
+    out->totalTiles = TILE_COUNT;
+    out->simCells = g_simStats.cells;
+    out->scalarCells = g_simStats.scalarCells;
+    out->vertexBuildUs = g_vertexBuildUs;
 }
\ No newline at end of file
@@ -4,3 +4,16 @@ void DripScene_Init();
 void DripScene_Shutdown();
 void DripScene_Update();
 void DripScene_Render();
+
+// Per-frame instrumentation: ripple activity for the last DripScene_Update,
+// vertex build time for the last DripScene_Render.
+struct DripStats
+{
+    int activeTiles;    // awake 16x16 tiles (averaged over the frame's steps)
+    int totalTiles;
+    int simCells;       // cells stepped this frame (all steps)
+    int scalarCells;    // of those, stepped by the scalar fallback
+    int vertexBuildUs;  // last DripScene_Render vertex build (inside Lock)
+};
+
+void DripScene_GetStats(DripStats* out);
@@ -0,0 +1,229 @@
+// GalaxyKernel.cpp - Galaxy layer transform + cull (SSE + scalar fallback)
+//
+// The old per-star loop did, per particle and per frame:
+//   a  = (ang + rot) & (LUT_N - 1)
+//   gx = cos[a] * r + jx,  gy = sin[a] * r * E + jy
+// With px = r cos(ang) and py = r sin(ang) baked at Init this is
+//   gx = px * cos(rot) - py * sin(rot) + jx
+//   gy = (py * cos(rot) + px * sin(rot)) * E + jy
+// so the table gather disappears and only the rotation constants change per
+// frame.
+//
+// Cull: the old code rejected past a per-layer pad and then again wherever
+// the edge fade was 0, i.e. anywhere outside [0, W] x [0, H]. Only the second
+// test matters, so that is the one kept here: a particle is visible when the
+// distance to the nearest screen edge is >= 0.
+
+#include "GalaxyKernel.h"
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GALAXY_SSE 1
+#else
+#define GALAXY_SSE 0
+#endif
+
+// -----------------------------------------------------------------------------
+// Init / Free
+// -----------------------------------------------------------------------------
+
+bool GalaxyLayer_Init(GalaxyLayer* l, int count)
+{
+    if (!l || count <= 0)
+        return false;
+
+    memset(l, 0, sizeof(*l));
+
+    int cap = (count + 3) & ~3;
+
+    // 6 float planes + 4 vis planes (floats / ints) + base + tw
+    size_t bytes =
+        (size_t)cap * sizeof(float) * 6 +
+        (size_t)cap * sizeof(float) * 4 +
+        (size_t)cap * sizeof(unsigned int) +
+        (size_t)cap;
+
+    void* block = malloc(bytes + 16);
+    if (!block)
+        return false;
+
+    unsigned char* p = (unsigned char*)(((size_t)block + 15) & ~(size_t)15);
+    memset(p, 0, bytes);
+
+    l->count = count;
+    l->cap = cap;
+    l->block = block;
+
+    l->px = (float*)p;      p += cap * sizeof(float);
+    l->py = (float*)p;      p += cap * sizeof(float);
+    l->jx = (float*)p;      p += cap * sizeof(float);
+    l->jy = (float*)p;      p += cap * sizeof(float);
+    l->dz = (float*)p;      p += cap * sizeof(float);
+    l->size = (float*)p;    p += cap * sizeof(float);
+
+    l->visIdx = (int*)p;    p += cap * sizeof(int);
+    l->visX = (float*)p;    p += cap * sizeof(float);
+    l->visY = (float*)p;    p += cap * sizeof(float);
+    l->visEdge = (float*)p; p += cap * sizeof(float);
+
+    l->base = (unsigned int*)p; p += cap * sizeof(unsigned int);
+    l->tw = p;
+
+    return true;
+}
+
+void GalaxyLayer_Free(GalaxyLayer* l)
+{
+    if (!l)
+        return;
+
+    if (l->block)
+        free(l->block);
+
+    memset(l, 0, sizeof(*l));
+}
+
+// -----------------------------------------------------------------------------
+// Scalar
+// -----------------------------------------------------------------------------
+
+static __inline float MinF(float a, float b) { return (a < b) ? a : b; }
+
+// Transforms [i0, i1) and appends the visible ones at n. Returns the new n.
+static int TransformScalar(GalaxyLayer* l, const GalaxyView* v, int i0, int i1, int n)
+{
+    const float cS = v->cosSpin;
+    const float sS = v->sinSpin;
+    const float eC = v->ellipseY * v->cosSpin;
+    const float eS = v->ellipseY * v->sinSpin;
+
+    for (int i = i0; i < i1; ++i)
+    {
+        float gx = l->px[i] * cS - l->py[i] * sS + l->jx[i];
+        float gy = l->px[i] * eS + l->py[i] * eC + l->jy[i];
+
+        float k = v->zoom * l->dz[i];
+
+        float sx = v->cx + (gx * v->cosRoll - gy * v->sinRoll) * k;
+        float sy = v->cy + (gx * v->sinRoll + gy * v->cosRoll) * k;
+
+        float edge = MinF(MinF(sx, v->screenW - sx), MinF(sy, v->screenH - sy));
+        if (!(edge >= 0.0f))
+            continue;
+
+        l->visIdx[n] = i;
+        l->visX[n] = sx;
+        l->visY[n] = sy;
+        l->visEdge[n] = edge;
+        n++;
+    }
+
+    return n;
+}
+
+int GalaxyLayer_TransformRef(GalaxyLayer* l, const GalaxyView* v)
+{
+    if (!l || !v || !l->block)
+        return 0;
+
+    l->visible = TransformScalar(l, v, 0, l->count, 0);
+    return l->visible;
+}
+
+// -----------------------------------------------------------------------------
+// SSE
+// -----------------------------------------------------------------------------
+
+#if GALAXY_SSE
+
+int GalaxyLayer_Transform(GalaxyLayer* l, const GalaxyView* v)
+{
+    if (!l || !v || !l->block)
+        return 0;
+
+    const __m128 cS = _mm_set1_ps(v->cosSpin);
+    const __m128 sS = _mm_set1_ps(v->sinSpin);
+    const __m128 eC = _mm_set1_ps(v->ellipseY * v->cosSpin);
+    const __m128 eS = _mm_set1_ps(v->ellipseY * v->sinSpin);
+    const __m128 cR = _mm_set1_ps(v->cosRoll);
+    const __m128 sR = _mm_set1_ps(v->sinRoll);
+    const __m128 zoom = _mm_set1_ps(v->zoom);
+    const __m128 cx = _mm_set1_ps(v->cx);
+    const __m128 cy = _mm_set1_ps(v->cy);
+    const __m128 sw = _mm_set1_ps(v->screenW);
+    const __m128 sh = _mm_set1_ps(v->screenH);
+    const __m128 zero = _mm_setzero_ps();
+
+    // Lanes are written unconditionally and the cursor advances only for
+    // visible ones, so compaction has no branches. visIdx/visX/... have cap
+    // entries, which always covers n + 3.
+    float tx[4], ty[4], te[4];
+
+    const int count4 = l->count & ~3;
+    int n = 0;
+
+    for (int i = 0; i < count4; i += 4)
+    {
+        __m128 px = _mm_load_ps(l->px + i);
+        __m128 py = _mm_load_ps(l->py + i);
+
+        __m128 gx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(px, cS), _mm_mul_ps(py, sS)), _mm_load_ps(l->jx + i));
+        __m128 gy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, eS), _mm_mul_ps(py, eC)), _mm_load_ps(l->jy + i));
+
+        __m128 k = _mm_mul_ps(zoom, _mm_load_ps(l->dz + i));
+
+        __m128 sx = _mm_add_ps(cx, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(gx, cR), _mm_mul_ps(gy, sR)), k));
+        __m128 sy = _mm_add_ps(cy, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(gx, sR), _mm_mul_ps(gy, cR)), k));
+
+        __m128 edge = _mm_min_ps(
+            _mm_min_ps(sx, _mm_sub_ps(sw, sx)),
+            _mm_min_ps(sy, _mm_sub_ps(sh, sy)));
+
+        int m = _mm_movemask_ps(_mm_cmpge_ps(edge, zero));
+        if (!m)
+            continue;
+
+        // All four on screen (most of the disc and the core): straight stores
+        if (m == 15)
+        {
+            _mm_storeu_ps(l->visX + n, sx);
+            _mm_storeu_ps(l->visY + n, sy);
+            _mm_storeu_ps(l->visEdge + n, edge);
+            l->visIdx[n] = i;
+            l->visIdx[n + 1] = i + 1;
+            l->visIdx[n + 2] = i + 2;
+            l->visIdx[n + 3] = i + 3;
+            n += 4;
+            continue;
+        }
+
+        _mm_storeu_ps(tx, sx);
+        _mm_storeu_ps(ty, sy);
+        _mm_storeu_ps(te, edge);
+
+        for (int j = 0; j < 4; ++j)
+        {
+            l->visIdx[n] = i + j;
+            l->visX[n] = tx[j];
+            l->visY[n] = ty[j];
+            l->visEdge[n] = te[j];
+            n += (m >> j) & 1;
+        }
+    }
+
+    l->visible = TransformScalar(l, v, count4, l->count, n);
+    return l->visible;
+}
+
+#else
+
+int GalaxyLayer_Transform(GalaxyLayer* l, const GalaxyView* v)
+{
+    return GalaxyLayer_TransformRef(l, v);
+}
+
+#endif
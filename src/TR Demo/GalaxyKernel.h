@@ -0,0 +1,62 @@
+#pragma once
+// GalaxyKernel.h - Platform-neutral galaxy particle transform (no D3D / xtl).
+//
+// GalaxyLayer keeps one particle layer as structure-of-arrays. Everything that
+// does not change per frame is baked at Init: the particle's position on the
+// (unrotated) galaxy plane, its jitter, depth scale, sprite size, twinkle
+// phase and base color.
+//
+// The per-frame spin is an angle-sum rotation of (px, py), so the transform
+// is pure multiply-adds with no table lookups, 4 particles per SSE op. The
+// kernel culls against the screen rect and writes the survivors compacted:
+// particle index, screen position and distance to the nearest screen edge
+// (for the edge fade). Vertex emission is a separate pass over that list.
+
+struct GalaxyLayer
+{
+    int             count;
+    int             cap;        // count rounded up to a multiple of 4
+
+    // Static, per particle (Init-only)
+    float*          px;         // r * cos(ang)
+    float*          py;         // r * sin(ang)
+    float*          jx;         // jitter, px
+    float*          jy;
+    float*          dz;         // depth scale (0.62 .. 1.32)
+    float*          size;       // sprite half-size, px
+    unsigned int*   base;       // base ARGB
+    unsigned char*  tw;         // twinkle phase 0..255
+
+    // Per frame: visible particles, compacted
+    int             visible;
+    int*            visIdx;
+    float*          visX;
+    float*          visY;
+    float*          visEdge;    // min distance to a screen edge, >= 0
+
+    void*           block;      // single allocation backing the arrays above
+};
+
+struct GalaxyView
+{
+    float cx, cy;               // screen center of the galaxy
+    float zoom;
+    float cosRoll, sinRoll;     // camera roll
+    float cosSpin, sinSpin;     // layer rotation
+    float ellipseY;             // vertical squash of the galaxy plane
+    float screenW, screenH;     // cull rect is [0, W] x [0, H]
+};
+
+// Init-only: allocates the arrays (static attributes zeroed).
+bool GalaxyLayer_Init(GalaxyLayer* l, int count);
+void GalaxyLayer_Free(GalaxyLayer* l);
+
+// Per-frame: transform + cull. Fills visIdx/visX/visY/visEdge in particle
+// order and returns (and stores in l->visible) the visible count.
+int GalaxyLayer_Transform(GalaxyLayer* l, const GalaxyView* v);
+
+// Reference: one particle at a time, scalar, the same operations in the same
+// order. Bit-identical to the above where scalar float math is plain SSE
+// single precision (x86-64 g++ -O2, as tools/galaxybench checks); an x87
+// build or one that fuses multiply-adds may differ in the last float bits.
+int GalaxyLayer_TransformRef(GalaxyLayer* l, const GalaxyView* v);
@@ -10,10 +10,14 @@
 // - No float->int casts in Render
 
 #include "GalaxyScene.h"
+#include "GalaxyKernel.h"
 #include "font.h"
+#include "clock.h"
+#include "devstate.h"
+#include "texcache.h"
+#include "vring.h"
 
 #include <xtl.h>
-#include <xgraphics.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -50,42 +54,28 @@ static LayerStats s_statLarge;
 
 static __forceinline void Stats_Reset(LayerStats& s) { s.total = s.culled = s.drawn = 0; }
 
+// Fixed overlay labels (built at Init, only the numbers are formatted per frame)
+static TextMesh s_lblStars;
+static TextMesh s_lblNebulae;
+static TextMesh s_lblDust;
+
 // -----------------------------------------------------------------------------
 // Step fade-in near edges (NO float->int casts; comparisons only)
-// scale256: 256=full, 192=75%, 128=50%, 64=25%, 0=skip
+// edge: distance to the nearest screen edge (>= 0, from GalaxyLayer_Transform)
+// scale256: 256=full, 192=75%, 128=50%, 64=25%
 // -----------------------------------------------------------------------------
-static __forceinline unsigned EdgeScale256_1D(float p, float minP, float maxP)
+static __forceinline unsigned EdgeFade256(float edge)
 {
     const float FADE1 = 16.0f;
     const float FADE2 = 32.0f;
     const float FADE3 = 48.0f;
 
-    if (p < minP) return 0u;
-    if (p > maxP) return 0u;
-
-    // left edge
-    float dL = p - minP;
-    if (dL < FADE3)
-    {
-        if (dL < FADE1) return 64u;
-        if (dL < FADE2) return 128u;
-        return 192u;
-    }
-
-    // right edge
-    float dR = maxP - p;
-    if (dR < FADE3)
-    {
-        if (dR < FADE1) return 64u;
-        if (dR < FADE2) return 128u;
-        return 192u;
-    }
-
+    if (edge < FADE1) return 64u;
+    if (edge < FADE2) return 128u;
+    if (edge < FADE3) return 192u;
     return 256u;
 }
 
-static __forceinline unsigned MinU(unsigned a, unsigned b) { return (a < b) ? a : b; }
-
 static __forceinline DWORD ApplyAlphaScale256(DWORD argb, unsigned scale256)
 {
     unsigned a = (unsigned)(argb >> 24) & 255u;
@@ -189,158 +179,6 @@ static void BuildTables()
     s_tablesReady = true;
 }
 
-// -----------------------------------------------------------------------------
-// DDS loader
-// -----------------------------------------------------------------------------
-
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
-
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
-
-static LPDIRECT3DTEXTURE8 LoadDDS_A8R8G8B8_Swizzled(const char* path)
-{
-    if (!g_pDevice || !path)
-        return NULL;
-
-    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
-        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-
-    if (hFile == INVALID_HANDLE_VALUE)
-        return NULL;
-
-    DWORD bytesRead = 0;
-    DWORD magic = 0;
-
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
-        bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
-
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
-
-    if (w <= 0 || h <= 0)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DWORD pixelBytes = (DWORD)(w * h * 4);
-
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) ||
-        bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    CloseHandle(hFile);
-
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, D3DFMT_A8R8G8B8, 0, &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
-
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
-
-    XGSwizzleRect(
-        pixels,
-        w * 4,
-        NULL,
-        lr.pBits,
-        w,
-        h,
-        NULL,
-        4);
-
-    tex->UnlockRect(0);
-    free(pixels);
-
-    return tex;
-}
-
 // -----------------------------------------------------------------------------
 // RNG
 // -----------------------------------------------------------------------------
@@ -368,6 +206,10 @@ static bool   s_active = false;
 static DWORD  s_startTicks = 0;
 
 static LPDIRECT3DTEXTURE8 s_texSprite = NULL;
+static const char* const  SPRITE_PATH = "D:\\tex\\cloud_256.dds";
+
+// Prepare -> Init handoff
+static bool  s_prepared = false;
 
 // -----------------------------------------------------------------------------
 // 2D batch
@@ -382,98 +224,114 @@ struct Vtx
 
 #define FVF_2D_TEX (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
 
-static Vtx* s_batch = NULL;
-static int  s_batchCapVerts = 0;
-static int  s_batchCountVerts = 0;
-
-static void EnsureBatch(int quads)
+// Point sprite vertex: texcoords are generated by the hardware
+struct PointVtx
 {
-    int wantVerts = quads * 6;
-    if (s_batch && s_batchCapVerts >= wantVerts)
-        return;
-
-    if (s_batch)
-        free(s_batch);
+    float x, y, z, rhw;
+    float size;
+    DWORD c;
+};
 
-    s_batch = (Vtx*)malloc(sizeof(Vtx) * wantVerts);
-    s_batchCapVerts = s_batch ? wantVerts : 0;
-    s_batchCountVerts = 0;
-}
+#define FVF_2D_POINT (D3DFVF_XYZRHW | D3DFVF_PSIZE | D3DFVF_DIFFUSE)
 
-static void Batch_Begin()
-{
-    s_batchCountVerts = 0;
-}
+// Layer emitters write straight into the vertex ring, one BATCH_QUADS
+// reservation per draw; the point path reserves the same number of bytes.
+static const int BATCH_POINTS = BATCH_QUADS * 6 * (int)sizeof(Vtx) / (int)sizeof(PointVtx);
 
-static void Batch_Flush()
-{
-    if (!g_pDevice || !s_batch || s_batchCountVerts <= 0)
-        return;
+// Index list shared by every INDEXED4 batch: 0,1,2, 0,2,3 per quad. It lives
+// in a static index buffer (created in Init) so a batch only writes its
+// vertices; the copy in memory feeds the UP fallback.
+static WORD                   s_quadIndices[BATCH_QUADS * 6];
+static IDirect3DIndexBuffer8* s_quadIB = NULL;
 
-    g_pDevice->SetVertexShader(FVF_2D_TEX);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, s_batchCountVerts / 3, s_batch, sizeof(Vtx));
-    s_batchCountVerts = 0;
-}
+// -----------------------------------------------------------------------------
+// Render states
+// -----------------------------------------------------------------------------
 
-static void Batch_End()
+static void SetupSpriteStates(LPDIRECT3DTEXTURE8 tex)
 {
-    Batch_Flush();
+    DevState_SetTexture(0, tex);
+    DevState_SetVertexShader(FVF_2D_TEX);
+
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+
+    DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_LINEAR);
+
+    DevState_SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+    DevState_SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
 }
 
-static __forceinline void EmitQuad6(float cx, float cy, float half, DWORD col)
-{
-    if (s_batchCountVerts + 6 > s_batchCapVerts)
-        Batch_Flush();
-
-    Vtx* v = s_batch + s_batchCountVerts;
+// Xbox generates point sprite texcoords for texture stage 3 only, so the
+// sprite texture moves there and stages 0-2 pass the diffuse color through.
+static const DWORD POINT_SPRITE_STAGE = 3;
 
-    float x0 = cx - half;
-    float y0 = cy - half;
-    float x1 = cx + half;
-    float y1 = cy + half;
-
-    v[0] = { x0, y0, 0.0f, 1.0f, col, 0.0f, 0.0f };
-    v[1] = { x1, y0, 0.0f, 1.0f, col, 1.0f, 0.0f };
-    v[2] = { x1, y1, 0.0f, 1.0f, col, 1.0f, 1.0f };
+static void BindPointSpriteStates(LPDIRECT3DTEXTURE8 tex)
+{
+    DevState_SetTexture(0, NULL);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_DIFFUSE);
 
-    v[3] = { x0, y0, 0.0f, 1.0f, col, 0.0f, 0.0f };
-    v[4] = { x1, y1, 0.0f, 1.0f, col, 1.0f, 1.0f };
-    v[5] = { x0, y1, 0.0f, 1.0f, col, 0.0f, 1.0f };
+    for (DWORD st = 1; st < POINT_SPRITE_STAGE; ++st)
+    {
+        DevState_SetTextureStageState(st, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+        DevState_SetTextureStageState(st, D3DTSS_COLORARG1, D3DTA_CURRENT);
+        DevState_SetTextureStageState(st, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+        DevState_SetTextureStageState(st, D3DTSS_ALPHAARG1, D3DTA_CURRENT);
+    }
 
-    s_batchCountVerts += 6;
+    DevState_SetTexture(POINT_SPRITE_STAGE, tex);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_COLORARG2, D3DTA_CURRENT);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ALPHAARG2, D3DTA_CURRENT);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_MIPFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+
+    DevState_SetRenderState(D3DRS_POINTSPRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_POINTSCALEENABLE, FALSE);
 }
 
-// -----------------------------------------------------------------------------
-// Render states
-// -----------------------------------------------------------------------------
-
-static void SetupSpriteStates(LPDIRECT3DTEXTURE8 tex)
+// Back to the stage 0 quad setup (SetupSpriteStates) with stages 1+ off.
+static void UnbindPointSpriteStates(LPDIRECT3DTEXTURE8 tex)
 {
-    g_pDevice->SetTexture(0, tex);
-    g_pDevice->SetVertexShader(FVF_2D_TEX);
-
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+    DevState_SetRenderState(D3DRS_POINTSPRITEENABLE, FALSE);
+
+    DevState_SetTexture(POINT_SPRITE_STAGE, NULL);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    DevState_SetTextureStageState(POINT_SPRITE_STAGE, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    DevState_SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    DevState_SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+
+    DevState_SetTexture(0, tex);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
 }
 
 static void DrawBackdrop()
@@ -487,15 +345,15 @@ static void DrawBackdrop()
         { SCREEN_W, SCREEN_H, 0.0f, 1.0f, D3DCOLOR_XRGB(0,0,5) },
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(BV));
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(BV));
 }
 
 static DWORD TwinkleColor(DWORD baseARGB, unsigned add)
@@ -518,6 +376,8 @@ static DWORD TwinkleColor(DWORD baseARGB, unsigned add)
 // Star data
 // -----------------------------------------------------------------------------
 
+// Star is the Init-time generator output only. It is packed into the SoA
+// GalaxyLayer stores below (static attributes precomputed) and discarded.
 struct Star
 {
     int   rPix;
@@ -531,11 +391,11 @@ struct Star
     DWORD base;       // base ARGB (integer, init-only)
 };
 
-static Star* s_small = NULL;
-static Star* s_large = NULL;
-static Star* s_dust = NULL;
-static Star* s_nebula = NULL;
-static Star* s_disc = NULL;
+static GalaxyLayer s_small;
+static GalaxyLayer s_large;
+static GalaxyLayer s_dust;
+static GalaxyLayer s_nebula;
+static GalaxyLayer s_disc;
 
 // -----------------------------------------------------------------------------
 // Init-only distribution with realistic galaxy colors
@@ -789,7 +649,7 @@ struct Cam
 
 static DWORD TimeMs()
 {
-    DWORD now = GetTickCount();
+    DWORD now = Clock_Ms();
     return now - s_startTicks;
 }
 
@@ -818,340 +678,317 @@ static Cam BuildCamera(DWORD tMs, DWORD durMs)
 }
 
 // -----------------------------------------------------------------------------
-// Render star set
+// Pack (Init-only): Star -> SoA layer with the per-frame constants baked in
 // -----------------------------------------------------------------------------
 
-static void RenderStars(const Star* stars, int count, DWORD tMs, int isLarge,
-    const Cam& cam, float cr, float sr, int rot,
-    LayerStats& st)
+enum LayerKind
 {
-    if (!stars || count <= 0 || !s_batch || s_batchCapVerts < (BATCH_QUADS * 6))
-        return;
-    int i = 0;
-    while (i < count)
-    {
-        int quadsThis = 0;
-        Vtx* out = s_batch;
-
-        while (i < count && quadsThis < BATCH_QUADS)
-        {
-            const Star& s = stars[i++];
-
-            int a = (s.ang + rot) & (LUT_N - 1);
-
-            float cs = s_cos[a];
-            float sn = s_sin[a];
-
-            float gx = cs * (float)s.rPix + s.jx;
-            float gy = sn * (float)s.rPix * ELLIPSE_Y + s.jy;
-
-            float dz = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
-            float scale = cam.zoom * dz;
+    LAYER_SMALL,
+    LAYER_LARGE,
+    LAYER_DUST,
+    LAYER_NEBULA,
+    LAYER_DISC
+};
 
-            float rx = gx * cr - gy * sr;
-            float ry = gx * sr + gy * cr;
+static float SpriteSize(const Star& s, LayerKind kind)
+{
+    if (kind == LAYER_SMALL || kind == LAYER_LARGE)
+    {
+        int isLarge = (kind == LAYER_LARGE);
+        float size = isLarge ? 2.6f : 1.2f;
 
-            float sx = cam.cx + rx * scale;
-            float sy = cam.cy + ry * scale;
+        if (s.rPix < 60) size *= isLarge ? 1.0f : 1.05f;
+        else if (s.rPix > 280) size *= isLarge ? 0.82f : 0.90f;
 
-            st.total++;
+        return size * (0.90f + (float)s.depth * (0.18f / 255.0f));
+    }
 
-            const float CULL_PAD = 32.0f;
-            if (sx < -CULL_PAD || sx >(SCREEN_W + CULL_PAD) ||
-                sy < -CULL_PAD || sy >(SCREEN_H + CULL_PAD))
-            {
-                st.culled++;
-                continue;
-            }
+    float k = (float)(s.depth & 31) * (1.0f / 31.0f);
 
-            unsigned sxScale = EdgeScale256_1D(sx, 0.0f, SCREEN_W);
-            unsigned syScale = EdgeScale256_1D(sy, 0.0f, SCREEN_H);
-            unsigned scale256 = MinU(sxScale, syScale);
-            if (scale256 == 0u)
-            {
-                st.culled++;
-                continue;
-            }
+    if (kind == LAYER_DUST)   return DUST_SIZE_MIN + (DUST_SIZE_MAX - DUST_SIZE_MIN) * k;
+    if (kind == LAYER_NEBULA) return NEBULA_SIZE_MIN + (NEBULA_SIZE_MAX - NEBULA_SIZE_MIN) * k;
+    return DISC_SIZE_MIN + (DISC_SIZE_MAX - DISC_SIZE_MIN) * k;
+}
 
-            float size = isLarge ? 2.6f : 1.2f;
+static void PackLayer(const Star* src, LayerKind kind, GalaxyLayer* l)
+{
+    for (int i = 0; i < l->count; ++i)
+    {
+        const Star& s = src[i];
+
+        l->px[i] = s_cos[s.ang] * (float)s.rPix;
+        l->py[i] = s_sin[s.ang] * (float)s.rPix;
+        l->jx[i] = s.jx;
+        l->jy[i] = s.jy;
+        l->dz[i] = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
+        l->size[i] = SpriteSize(s, kind);
+        l->base[i] = s.base;
+        l->tw[i] = (unsigned char)s.tw;
+    }
+}
 
-            if (s.rPix < 60) size *= isLarge ? 1.0f : 1.05f;
-            else if (s.rPix > 280) size *= isLarge ? 0.82f : 0.90f;
+static void BuildLayer(GalaxyLayer* l, int count, LayerKind kind, Star* scratch)
+{
+    GalaxyLayer_Free(l);
 
-            size *= (0.90f + (float)s.depth * (0.18f / 255.0f));
+    if (!scratch || !GalaxyLayer_Init(l, count))
+        return;
 
-            unsigned tw = (unsigned)((s.tw + (int)((tMs / 16) & 255u)) & 255);
-            unsigned add = (tw >> 2); // 0..63
+    switch (kind)
+    {
+    case LAYER_SMALL:  InitStars(scratch, count, 0); break;
+    case LAYER_LARGE:  InitStars(scratch, count, 1); break;
+    case LAYER_DUST:   InitDust(scratch, count); break;
+    case LAYER_NEBULA: InitNebula(scratch, count); break;
+    default:           InitDisc(scratch, count); break;
+    }
 
-            DWORD col = TwinkleColor(s.base, add);
-            col = ApplyAlphaScale256(col, scale256);
-            if (((col >> 24) & 255u) < 6u) { st.culled++; continue; }
+    PackLayer(scratch, kind, l);
+}
 
+// -----------------------------------------------------------------------------
+// Render layer: SIMD transform + cull, then a tight emission pass over the
+// compacted visible list
+// -----------------------------------------------------------------------------
 
-            out[0] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[1] = { sx + size, sy - size, 0.0f, 1.0f, col, 1.0f, 0.0f };
-            out[2] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
+// Per-layer submission path + counters (see GalaxyScene.h)
+// Small sprites go out as points; the big dust / nebula clouds (up to 56 px
+// across) stay quads, clear of the point size limit.
+static GalaxySpritePath  s_layerPath[GALAXY_LAYER_COUNT] =
+{
+    GALAXY_PATH_INDEXED4,   // dust
+    GALAXY_PATH_POINT,      // disc
+    GALAXY_PATH_POINT,      // small stars
+    GALAXY_PATH_INDEXED4,   // nebula
+    GALAXY_PATH_POINT,      // large stars
+};
 
-            out[3] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[4] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
-            out[5] = { sx - size, sy + size, 0.0f, 1.0f, col, 0.0f, 1.0f };
+static GalaxyLayerSubmit s_submit[GALAXY_LAYER_COUNT];
+static bool              s_pointStatesBound = false;
 
-            out += 6;
-            quadsThis++;
-            st.drawn++;
-        }
+static void BuildQuadIndices()
+{
+    for (int q = 0; q < BATCH_QUADS; ++q)
+    {
+        WORD v = (WORD)(q * 4);
+        WORD* idx = s_quadIndices + q * 6;
 
-        if (quadsThis > 0)
-        {
-            g_pDevice->SetVertexShader(FVF_2D_TEX);
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, quadsThis * 2, s_batch, sizeof(Vtx));
-        }
+        idx[0] = v; idx[1] = (WORD)(v + 1); idx[2] = (WORD)(v + 2);
+        idx[3] = v; idx[4] = (WORD)(v + 2); idx[5] = (WORD)(v + 3);
     }
 }
 
-static void RenderDust(const Star* dust, int count, DWORD tMs,
-    const Cam& cam, float cr, float sr, int rot,
-    LayerStats& st)
+// Render thread only; without it INDEXED4 batches go out as UP draws
+static void CreateQuadIB()
 {
-    if (!dust || count <= 0 || !s_batch || s_batchCapVerts < (BATCH_QUADS * 6))
+    if (s_quadIB || !g_pDevice)
         return;
 
-    int i = 0;
-    while (i < count)
+    if (FAILED(g_pDevice->CreateIndexBuffer(sizeof(s_quadIndices), D3DUSAGE_WRITEONLY,
+                                            D3DFMT_INDEX16, D3DPOOL_DEFAULT, &s_quadIB)))
     {
-        int quadsThis = 0;
-        Vtx* out = s_batch;
-
-        while (i < count && quadsThis < BATCH_QUADS)
-        {
-            const Star& s = dust[i++];
-
-            int a = (s.ang + rot) & (LUT_N - 1);
-            float cs = s_cos[a];
-            float sn = s_sin[a];
-
-            float gx = cs * (float)s.rPix + s.jx;
-            float gy = sn * (float)s.rPix * ELLIPSE_Y + s.jy;
+        s_quadIB = NULL;
+        return;
+    }
 
-            float dz = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
-            float scale = cam.zoom * dz;
+    BYTE* p = NULL;
+    if (FAILED(s_quadIB->Lock(0, sizeof(s_quadIndices), &p, 0)))
+    {
+        s_quadIB->Release();
+        s_quadIB = NULL;
+        return;
+    }
 
-            float rx = gx * cr - gy * sr;
-            float ry = gx * sr + gy * cr;
+    memcpy(p, s_quadIndices, sizeof(s_quadIndices));
+    s_quadIB->Unlock();
+}
 
-            float sx = cam.cx + rx * scale;
-            float sy = cam.cy + ry * scale;
+// Final color for visible entry k; false if it faded out (alphaCull only).
+static __forceinline bool ShadeVisible(const GalaxyLayer& l, int k, unsigned twPhase,
+    unsigned twShift, bool alphaCull, DWORD& col)
+{
+    int i = l.visIdx[k];
+    unsigned add = ((l.tw[i] + twPhase) & 255u) >> twShift;
 
-            st.total++;
+    col = TwinkleColor(l.base[i], add);
+    col = ApplyAlphaScale256(col, EdgeFade256(l.visEdge[k]));
 
-            const float CULL_PAD = 80.0f;
-            if (sx < -CULL_PAD || sx >(SCREEN_W + CULL_PAD) ||
-                sy < -CULL_PAD || sy >(SCREEN_H + CULL_PAD))
-            {
-                st.culled++;
-                continue;
-            }
+    return !(alphaCull && ((col >> 24) & 255u) < 6u);
+}
 
-            unsigned sxScale = EdgeScale256_1D(sx, 0.0f, SCREEN_W);
-            unsigned syScale = EdgeScale256_1D(sy, 0.0f, SCREEN_H);
-            unsigned scale256 = MinU(sxScale, syScale);
-            if (scale256 == 0u)
-            {
-                st.culled++;
-                continue;
-            }
+static void EmitQuad6Layer(const GalaxyLayer& l, unsigned twPhase, unsigned twShift,
+    bool alphaCull, LayerStats& st, GalaxyLayerSubmit& sub)
+{
+    const int visible = l.visible;
 
-            unsigned tw = (unsigned)((s.tw + (int)((tMs / 48) & 255u)) & 255);
-            unsigned add = (tw >> 3); // 0..31
+    int k = 0;
+    while (k < visible)
+    {
+        int quadsThis = 0;
+        Vtx* out = (Vtx*)VRing_BeginVerts(BATCH_QUADS * 6, sizeof(Vtx));
 
-            DWORD col = TwinkleColor(s.base, add);
-            col = ApplyAlphaScale256(col, scale256);
+        while (k < visible && quadsThis < BATCH_QUADS)
+        {
+            DWORD col;
+            if (!ShadeVisible(l, k, twPhase, twShift, alphaCull, col)) { k++; st.culled++; continue; }
 
-            float k = (float)(s.depth & 31) * (1.0f / 31.0f);
-            float size = DUST_SIZE_MIN + (DUST_SIZE_MAX - DUST_SIZE_MIN) * k;
+            float size = l.size[l.visIdx[k]];
+            float x0 = l.visX[k] - size;
+            float y0 = l.visY[k] - size;
+            float x1 = l.visX[k] + size;
+            float y1 = l.visY[k] + size;
+            k++;
 
-            out[0] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[1] = { sx + size, sy - size, 0.0f, 1.0f, col, 1.0f, 0.0f };
-            out[2] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
+            out[0] = { x0, y0, 0.0f, 1.0f, col, 0.0f, 0.0f };
+            out[1] = { x1, y0, 0.0f, 1.0f, col, 1.0f, 0.0f };
+            out[2] = { x1, y1, 0.0f, 1.0f, col, 1.0f, 1.0f };
 
-            out[3] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[4] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
-            out[5] = { sx - size, sy + size, 0.0f, 1.0f, col, 0.0f, 1.0f };
+            out[3] = { x0, y0, 0.0f, 1.0f, col, 0.0f, 0.0f };
+            out[4] = { x1, y1, 0.0f, 1.0f, col, 1.0f, 1.0f };
+            out[5] = { x0, y1, 0.0f, 1.0f, col, 0.0f, 1.0f };
 
             out += 6;
             quadsThis++;
-            st.drawn++;
         }
 
+        DevState_SetVertexShader(FVF_2D_TEX);
+        VRing_EndVerts(D3DPT_TRIANGLELIST, quadsThis * 6, quadsThis * 2);
+
         if (quadsThis > 0)
         {
-            g_pDevice->SetVertexShader(FVF_2D_TEX);
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, quadsThis * 2, s_batch, sizeof(Vtx));
+            st.drawn += quadsThis;
+            sub.sprites += quadsThis;
+            sub.vertices += quadsThis * 6;
+            sub.bytes += quadsThis * 6 * (int)sizeof(Vtx);
+            sub.drawCalls++;
         }
     }
 }
 
-static void RenderNebula(const Star* nebula, int count, DWORD tMs,
-    const Cam& cam, float cr, float sr, int rot,
-    LayerStats& st)
+static void EmitIndexed4Layer(const GalaxyLayer& l, unsigned twPhase, unsigned twShift,
+    bool alphaCull, LayerStats& st, GalaxyLayerSubmit& sub)
 {
-    if (!nebula || count <= 0 || !s_batch || s_batchCapVerts < (BATCH_QUADS * 6))
-        return;
+    const int visible = l.visible;
 
-    int i = 0;
-    while (i < count)
+    int k = 0;
+    while (k < visible)
     {
         int quadsThis = 0;
-        Vtx* out = s_batch;
+        Vtx* out = (Vtx*)VRing_BeginVerts(BATCH_QUADS * 4, sizeof(Vtx));
 
-        while (i < count && quadsThis < BATCH_QUADS)
+        while (k < visible && quadsThis < BATCH_QUADS)
         {
-            const Star& s = nebula[i++];
-
-            int a = (s.ang + rot) & (LUT_N - 1);
-            float cs = s_cos[a];
-            float sn = s_sin[a];
-
-            float gx = cs * (float)s.rPix + s.jx;
-            float gy = sn * (float)s.rPix * ELLIPSE_Y + s.jy;
-
-            float dz = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
-            float scale = cam.zoom * dz;
-
-            float rx = gx * cr - gy * sr;
-            float ry = gx * sr + gy * cr;
-
-            float sx = cam.cx + rx * scale;
-            float sy = cam.cy + ry * scale;
-
-            st.total++;
-
-            const float CULL_PAD = 60.0f;
-            if (sx < -CULL_PAD || sx >(SCREEN_W + CULL_PAD) ||
-                sy < -CULL_PAD || sy >(SCREEN_H + CULL_PAD))
-            {
-                st.culled++;
-                continue;
-            }
-
-            unsigned sxScale = EdgeScale256_1D(sx, 0.0f, SCREEN_W);
-            unsigned syScale = EdgeScale256_1D(sy, 0.0f, SCREEN_H);
-            unsigned scale256 = MinU(sxScale, syScale);
-            if (scale256 == 0u)
-            {
-                st.culled++;
-                continue;
-            }
-
-            unsigned tw = (unsigned)((s.tw + (int)((tMs / 35) & 255u)) & 255);
-            unsigned add = (tw >> 3); // 0..31
-
-            DWORD col = TwinkleColor(s.base, add);
-            col = ApplyAlphaScale256(col, scale256);
-
-            float k = (float)(s.depth & 31) * (1.0f / 31.0f);
-            float size = NEBULA_SIZE_MIN + (NEBULA_SIZE_MAX - NEBULA_SIZE_MIN) * k;
-
-            out[0] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[1] = { sx + size, sy - size, 0.0f, 1.0f, col, 1.0f, 0.0f };
-            out[2] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
-
-            out[3] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[4] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
-            out[5] = { sx - size, sy + size, 0.0f, 1.0f, col, 0.0f, 1.0f };
-
-            out += 6;
+            DWORD col;
+            if (!ShadeVisible(l, k, twPhase, twShift, alphaCull, col)) { k++; st.culled++; continue; }
+
+            float size = l.size[l.visIdx[k]];
+            float x0 = l.visX[k] - size;
+            float y0 = l.visY[k] - size;
+            float x1 = l.visX[k] + size;
+            float y1 = l.visY[k] + size;
+            k++;
+
+            out[0] = { x0, y0, 0.0f, 1.0f, col, 0.0f, 0.0f };
+            out[1] = { x1, y0, 0.0f, 1.0f, col, 1.0f, 0.0f };
+            out[2] = { x1, y1, 0.0f, 1.0f, col, 1.0f, 1.0f };
+            out[3] = { x0, y1, 0.0f, 1.0f, col, 0.0f, 1.0f };
+
+            out += 4;
             quadsThis++;
-            st.drawn++;
         }
 
+        DevState_SetVertexShader(FVF_2D_TEX);
+        VRing_EndVertsStaticIndexed(D3DPT_TRIANGLELIST, quadsThis * 4, quadsThis * 2,
+            s_quadIB, s_quadIndices);
+
         if (quadsThis > 0)
         {
-            g_pDevice->SetVertexShader(FVF_2D_TEX);
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, quadsThis * 2, s_batch, sizeof(Vtx));
+            st.drawn += quadsThis;
+            sub.sprites += quadsThis;
+            sub.vertices += quadsThis * 4;
+            sub.indices += quadsThis * 6;
+            sub.bytes += quadsThis * 4 * (int)sizeof(Vtx);
+            sub.drawCalls++;
         }
     }
 }
 
-static void RenderDisc(const Star* disc, int count, DWORD tMs,
-    const Cam& cam, float cr, float sr, int rot,
-    LayerStats& st)
+static void EmitPointLayer(const GalaxyLayer& l, unsigned twPhase, unsigned twShift,
+    bool alphaCull, LayerStats& st, GalaxyLayerSubmit& sub)
 {
-    if (!disc || count <= 0 || !s_batch || s_batchCapVerts < (BATCH_QUADS * 6))
-        return;
+    const int visible = l.visible;
 
-    int i = 0;
-    while (i < count)
+    int k = 0;
+    while (k < visible)
     {
-        int quadsThis = 0;
-        Vtx* out = s_batch;
+        int pointsThis = 0;
+        PointVtx* out = (PointVtx*)VRing_BeginVerts(BATCH_POINTS, sizeof(PointVtx));
 
-        while (i < count && quadsThis < BATCH_QUADS)
+        while (k < visible && pointsThis < BATCH_POINTS)
         {
-            const Star& s = disc[i++];
-
-            int a = (s.ang + rot) & (LUT_N - 1);
-            float cs = s_cos[a];
-            float sn = s_sin[a];
-
-            float gx = cs * (float)s.rPix + s.jx;
-            float gy = sn * (float)s.rPix * ELLIPSE_Y + s.jy;
-
-            float dz = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
-            float scale = cam.zoom * dz;
-
-            float rx = gx * cr - gy * sr;
-            float ry = gx * sr + gy * cr;
-
-            float sx = cam.cx + rx * scale;
-            float sy = cam.cy + ry * scale;
+            DWORD col;
+            if (!ShadeVisible(l, k, twPhase, twShift, alphaCull, col)) { k++; st.culled++; continue; }
+
+            out->x = l.visX[k];
+            out->y = l.visY[k];
+            out->z = 0.0f;
+            out->rhw = 1.0f;
+            out->size = l.size[l.visIdx[k]] * 2.0f;
+            out->c = col;
+            k++;
+
+            out++;
+            pointsThis++;
+        }
 
-            st.total++;
+        DevState_SetVertexShader(FVF_2D_POINT);
+        VRing_EndVerts(D3DPT_POINTLIST, pointsThis, pointsThis);
 
-            const float CULL_PAD = 40.0f;
-            if (sx < -CULL_PAD || sx >(SCREEN_W + CULL_PAD) ||
-                sy < -CULL_PAD || sy >(SCREEN_H + CULL_PAD))
-            {
-                st.culled++;
-                continue;
-            }
+        if (pointsThis > 0)
+        {
+            st.drawn += pointsThis;
+            sub.sprites += pointsThis;
+            sub.vertices += pointsThis;
+            sub.bytes += pointsThis * (int)sizeof(PointVtx);
+            sub.drawCalls++;
+        }
+    }
+}
 
-            unsigned sxScale = EdgeScale256_1D(sx, 0.0f, SCREEN_W);
-            unsigned syScale = EdgeScale256_1D(sy, 0.0f, SCREEN_H);
-            unsigned scale256 = MinU(sxScale, syScale);
-            if (scale256 == 0u)
-            {
-                st.culled++;
-                continue;
-            }
+// twDiv / twShift: twinkle phase speed (ms per step) and depth (0..255 >> shift)
+static void RenderLayer(GalaxyLayer& l, GalaxyLayerId id, DWORD tMs, GalaxyView& view, int rot,
+    unsigned twDiv, unsigned twShift, bool alphaCull, LayerStats& st)
+{
+    GalaxyLayerSubmit& sub = s_submit[id];
+    memset(&sub, 0, sizeof(sub));
+    sub.path = s_layerPath[id];
 
-            unsigned tw = (unsigned)((s.tw + (int)((tMs / 40) & 255u)) & 255);
-            unsigned add = (tw >> 3); // 0..31
+    if (!l.block)
+        return;
 
-            DWORD col = TwinkleColor(s.base, add);
-            col = ApplyAlphaScale256(col, scale256);
+    view.cosSpin = s_cos[rot];
+    view.sinSpin = s_sin[rot];
 
-            float k = (float)(s.depth & 31) * (1.0f / 31.0f);
-            float size = DISC_SIZE_MIN + (DISC_SIZE_MAX - DISC_SIZE_MIN) * k;
+    int visible = GalaxyLayer_Transform(&l, &view);
 
-            out[0] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[1] = { sx + size, sy - size, 0.0f, 1.0f, col, 1.0f, 0.0f };
-            out[2] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
+    st.total += l.count;
+    st.culled += l.count - visible;
 
-            out[3] = { sx - size, sy - size, 0.0f, 1.0f, col, 0.0f, 0.0f };
-            out[4] = { sx + size, sy + size, 0.0f, 1.0f, col, 1.0f, 1.0f };
-            out[5] = { sx - size, sy + size, 0.0f, 1.0f, col, 0.0f, 1.0f };
+    unsigned twPhase = (unsigned)((tMs / twDiv) & 255u);
 
-            out += 6;
-            quadsThis++;
-            st.drawn++;
-        }
+    bool wantPoints = (s_layerPath[id] == GALAXY_PATH_POINT);
+    if (wantPoints != s_pointStatesBound)
+    {
+        if (wantPoints) BindPointSpriteStates(s_texSprite);
+        else            UnbindPointSpriteStates(s_texSprite);
+        s_pointStatesBound = wantPoints;
+    }
 
-        if (quadsThis > 0)
-        {
-            g_pDevice->SetVertexShader(FVF_2D_TEX);
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, quadsThis * 2, s_batch, sizeof(Vtx));
-        }
+    switch (s_layerPath[id])
+    {
+    case GALAXY_PATH_POINT:    EmitPointLayer(l, twPhase, twShift, alphaCull, st, sub); break;
+    case GALAXY_PATH_INDEXED4: EmitIndexed4Layer(l, twPhase, twShift, alphaCull, st, sub); break;
+    default:                   EmitQuad6Layer(l, twPhase, twShift, alphaCull, st, sub); break;
     }
 }
 
@@ -1159,52 +996,74 @@ static void RenderDisc(const Star* disc, int count, DWORD tMs,
 // Public API
 // -----------------------------------------------------------------------------
 
-void GalaxyScene_Init()
+void GalaxyScene_Prepare()
 {
-    s_active = true;
-    s_startTicks = GetTickCount();
+    if (s_prepared)
+        return;
 
     BuildTables();
+    BuildQuadIndices();
 
-    if (s_texSprite) { s_texSprite->Release(); s_texSprite = NULL; }
-    s_texSprite = LoadDDS_A8R8G8B8_Swizzled("D:\\tex\\cloud_256.dds");
+    // Staged for Init; a no-op once the texture is cached
+    TexCache_Preload(SPRITE_PATH, TEXCACHE_ALL_LEVELS);
 
-    if (s_small) { free(s_small); s_small = NULL; }
-    if (s_large) { free(s_large); s_large = NULL; }
-    if (s_dust) { free(s_dust);  s_dust = NULL; }
-    if (s_nebula) { free(s_nebula); s_nebula = NULL; }
-    if (s_disc) { free(s_disc); s_disc = NULL; }
+    s_rng = 0xC0FFEE11u ^ Clock_Ms();
 
-    s_small = (Star*)malloc(sizeof(Star) * STAR_SMALL_COUNT);
-    s_large = (Star*)malloc(sizeof(Star) * STAR_LARGE_COUNT);
-    s_dust = (Star*)malloc(sizeof(Star) * DUST_COUNT);
-    s_nebula = (Star*)malloc(sizeof(Star) * NEBULA_COUNT);
-    s_disc = (Star*)malloc(sizeof(Star) * DISC_COUNT);
+    // One scratch buffer for the generators (largest layer), freed once packed
+    Star* scratch = (Star*)malloc(sizeof(Star) * STAR_SMALL_COUNT);
 
-    EnsureBatch(BATCH_QUADS);
+    BuildLayer(&s_small, STAR_SMALL_COUNT, LAYER_SMALL, scratch);
+    BuildLayer(&s_large, STAR_LARGE_COUNT, LAYER_LARGE, scratch);
+    BuildLayer(&s_dust, DUST_COUNT, LAYER_DUST, scratch);
+    BuildLayer(&s_nebula, NEBULA_COUNT, LAYER_NEBULA, scratch);
+    BuildLayer(&s_disc, DISC_COUNT, LAYER_DISC, scratch);
 
-    s_rng = 0xC0FFEE11u ^ GetTickCount();
+    if (scratch) free(scratch);
 
-    if (s_small) InitStars(s_small, STAR_SMALL_COUNT, 0);
-    if (s_large) InitStars(s_large, STAR_LARGE_COUNT, 1);
-    if (s_dust)  InitDust(s_dust, DUST_COUNT);
-    if (s_nebula) InitNebula(s_nebula, NEBULA_COUNT);
-    if (s_disc) InitDisc(s_disc, DISC_COUNT);
+    s_prepared = true;
+}
+
+void GalaxyScene_Init()
+{
+    s_active = true;
+    s_startTicks = Clock_Ms();
+
+    // Normally done already, on the loader thread during the fade-out
+    GalaxyScene_Prepare();
+    s_prepared = false;
+
+    TexCache_Release(s_texSprite);
+    s_texSprite = TexCache_Acquire(SPRITE_PATH, TEXCACHE_ALL_LEVELS, NULL, NULL);
+
+    CreateQuadIB();
+
+    TextMesh_Release(&s_lblStars);
+    TextMesh_Release(&s_lblNebulae);
+    TextMesh_Release(&s_lblDust);
+    TextMesh_Build(&s_lblStars, "STARS ON-SCREEN: ");
+    TextMesh_Build(&s_lblNebulae, "NEBULAE ON-SCREEN: ");
+    TextMesh_Build(&s_lblDust, "DUST ON-SCREEN: ");
 }
 
 void GalaxyScene_Shutdown()
 {
     s_active = false;
 
-    if (s_texSprite) { s_texSprite->Release(); s_texSprite = NULL; }
+    TexCache_Release(s_texSprite);
+    s_texSprite = NULL;
+    s_prepared = false;
+
+    GalaxyLayer_Free(&s_small);
+    GalaxyLayer_Free(&s_large);
+    GalaxyLayer_Free(&s_dust);
+    GalaxyLayer_Free(&s_nebula);
+    GalaxyLayer_Free(&s_disc);
 
-    if (s_small) { free(s_small); s_small = NULL; }
-    if (s_large) { free(s_large); s_large = NULL; }
-    if (s_dust) { free(s_dust);  s_dust = NULL; }
-    if (s_nebula) { free(s_nebula); s_nebula = NULL; }
-    if (s_disc) { free(s_disc); s_disc = NULL; }
+    if (s_quadIB) { s_quadIB->Release(); s_quadIB = NULL; }
 
-    if (s_batch) { free(s_batch); s_batch = NULL; s_batchCapVerts = 0; }
+    TextMesh_Release(&s_lblStars);
+    TextMesh_Release(&s_lblNebulae);
+    TextMesh_Release(&s_lblDust);
 }
 
 bool GalaxyScene_IsFinished()
@@ -1223,7 +1082,8 @@ void GalaxyScene_Render(float)
 
     DrawBackdrop();
 
-    if (!s_texSprite || !s_small || !s_large || !s_dust || !s_nebula || !s_disc || !s_batch)
+    if (!s_texSprite || !s_small.block || !s_large.block || !s_dust.block ||
+        !s_nebula.block || !s_disc.block)
         return;
 
     // Per-frame stats
@@ -1234,40 +1094,83 @@ void GalaxyScene_Render(float)
     Stats_Reset(s_statLarge);
 
     Cam cam = BuildCamera(tMs, SCENE_DURATION_MS);
-    float cr = cosf(cam.roll);
-    float sr = sinf(cam.roll);
+
+    GalaxyView view;
+    view.cx = cam.cx;
+    view.cy = cam.cy;
+    view.zoom = cam.zoom;
+    view.cosRoll = cosf(cam.roll);
+    view.sinRoll = sinf(cam.roll);
+    view.cosSpin = 1.0f;
+    view.sinSpin = 0.0f;
+    view.ellipseY = ELLIPSE_Y;
+    view.screenW = SCREEN_W;
+    view.screenH = SCREEN_H;
 
     int rotStars = (int)((tMs / 19) & (LUT_N - 1));
     int rotDust = (int)((tMs / 31) & (LUT_N - 1));
     int rotNeb = (int)((tMs / 25) & (LUT_N - 1));
     int rotDisc = (int)((tMs / 22) & (LUT_N - 1));
 
-    // One-time state bind
+    // One-time state bind (point sprite layers switch stages on demand)
     SetupSpriteStates(s_texSprite);
+    s_pointStatesBound = false;
 
     // Layer order: dust -> disc -> small stars -> nebula -> large stars
-    RenderDust(s_dust, DUST_COUNT, tMs, cam, cr, sr, rotDust, s_statDust);
-    RenderDisc(s_disc, DISC_COUNT, tMs, cam, cr, sr, rotDisc, s_statDisc);
-    RenderStars(s_small, STAR_SMALL_COUNT, tMs, 0, cam, cr, sr, rotStars, s_statSmall);
-    RenderNebula(s_nebula, NEBULA_COUNT, tMs, cam, cr, sr, rotNeb, s_statNeb);
-    RenderStars(s_large, STAR_LARGE_COUNT, tMs, 1, cam, cr, sr, rotStars, s_statLarge);
+    RenderLayer(s_dust, GALAXY_LAYER_DUST, tMs, view, rotDust, 48, 3, false, s_statDust);
+    RenderLayer(s_disc, GALAXY_LAYER_DISC, tMs, view, rotDisc, 40, 3, false, s_statDisc);
+    RenderLayer(s_small, GALAXY_LAYER_SMALL, tMs, view, rotStars, 16, 2, true, s_statSmall);
+    RenderLayer(s_nebula, GALAXY_LAYER_NEBULA, tMs, view, rotNeb, 35, 3, false, s_statNeb);
+    RenderLayer(s_large, GALAXY_LAYER_LARGE, tMs, view, rotStars, 16, 2, true, s_statLarge);
+
+    if (s_pointStatesBound)
+    {
+        UnbindPointSpriteStates(s_texSprite);
+        s_pointStatesBound = false;
+    }
 
     // Stats overlay (drawn counts reflect on-screen workload)
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
 
     char buf[64];
 
     IntToStr(s_statSmall.drawn + s_statLarge.drawn, buf, sizeof(buf));
-    DrawText(10.0f, 10.0f, "STARS ON-SCREEN: ", 2.0f, D3DCOLOR_XRGB(200, 220, 255));
+    TextMesh_Draw(&s_lblStars, 10.0f, 10.0f, 2.0f, D3DCOLOR_XRGB(200, 220, 255));
     DrawText(250.0f, 10.0f, buf, 2.0f, D3DCOLOR_XRGB(200, 220, 255));
 
     IntToStr(s_statNeb.drawn, buf, sizeof(buf));
-    DrawText(10.0f, 30.0f, "NEBULAE ON-SCREEN: ", 2.0f, D3DCOLOR_XRGB(255, 140, 200));
+    TextMesh_Draw(&s_lblNebulae, 10.0f, 30.0f, 2.0f, D3DCOLOR_XRGB(255, 140, 200));
     DrawText(280.0f, 30.0f, buf, 2.0f, D3DCOLOR_XRGB(255, 140, 200));
 
     IntToStr(s_statDust.drawn, buf, sizeof(buf));
-    DrawText(10.0f, 50.0f, "DUST ON-SCREEN: ", 2.0f, D3DCOLOR_XRGB(180, 170, 160));
+    TextMesh_Draw(&s_lblDust, 10.0f, 50.0f, 2.0f, D3DCOLOR_XRGB(180, 170, 160));
     DrawText(230.0f, 50.0f, buf, 2.0f, D3DCOLOR_XRGB(180, 170, 160));
 }
+
+void GalaxyScene_SetLayerPath(GalaxyLayerId layer, GalaxySpritePath path)
+{
+    if ((unsigned)layer < (unsigned)GALAXY_LAYER_COUNT)
+        s_layerPath[layer] = path;
+}
+
+GalaxySpritePath GalaxyScene_GetLayerPath(GalaxyLayerId layer)
+{
+    if ((unsigned)layer < (unsigned)GALAXY_LAYER_COUNT)
+        return s_layerPath[layer];
+    return GALAXY_PATH_QUAD6;
+}
+
+void GalaxyScene_GetSubmitStats(GalaxySubmitStats* out)
+{
+    if (!out)
+        return;
+
+    out->totalBytes = 0;
+    for (int i = 0; i < GALAXY_LAYER_COUNT; ++i)
+    {
+        out->layer[i] = s_submit[i];
+        out->totalBytes += s_submit[i].bytes;
+    }
+}
@@ -1,5 +1,55 @@
 #pragma once
 
+// CPU-only part of Init: star layers + sprite file read. No device access,
+// so main.cpp runs it on the loader thread during the fade-out. Init calls
+// it itself if it has not run.
+void GalaxyScene_Prepare();
 void GalaxyScene_Init();
 void GalaxyScene_Shutdown();
 void GalaxyScene_Render(float demoTime);
+
+// Sprite layers, in draw order.
+enum GalaxyLayerId
+{
+    GALAXY_LAYER_DUST,
+    GALAXY_LAYER_DISC,
+    GALAXY_LAYER_SMALL,
+    GALAXY_LAYER_NEBULA,
+    GALAXY_LAYER_LARGE,
+    GALAXY_LAYER_COUNT
+};
+
+// How a layer's sprites are submitted:
+//   QUAD6    - 6 textured vertices per sprite (two triangles)
+//   INDEXED4 - 4 textured vertices per sprite + a static shared index list
+//   POINT    - 1 vertex per sprite with a point size (point sprites)
+enum GalaxySpritePath
+{
+    GALAXY_PATH_QUAD6,
+    GALAXY_PATH_INDEXED4,
+    GALAXY_PATH_POINT
+};
+
+void GalaxyScene_SetLayerPath(GalaxyLayerId layer, GalaxySpritePath path);
+GalaxySpritePath GalaxyScene_GetLayerPath(GalaxyLayerId layer);
+
+// Per-layer submission counters for the last GalaxyScene_Render: what was
+// handed to the device and the bytes written for it. INDEXED4 draws from a
+// static index buffer, so its indices cost no bytes per frame.
+struct GalaxyLayerSubmit
+{
+    int path;           // GalaxySpritePath
+    int sprites;
+    int vertices;
+    int indices;        // indices drawn
+    int bytes;          // vertex + index bytes written
+    int drawCalls;
+};
+
+struct GalaxySubmitStats
+{
+    GalaxyLayerSubmit layer[GALAXY_LAYER_COUNT];
+    int totalBytes;
+};
+
+void GalaxyScene_GetSubmitStats(GalaxySubmitStats* out);
@@ -3,12 +3,14 @@
 #include "IntroScene.h"
 
 #include <xtl.h>
-#include <xgraphics.h>   // for XGSwizzleRect
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "font.h"        // DrawText from Xbox-RGB font
+#include "devstate.h"
+#include "texcache.h"
+#include "vring.h"
 
 // Device provided by main.cpp
 extern LPDIRECT3DDEVICE8 g_pDevice;
@@ -38,42 +40,6 @@ struct GradVertex
 
 #define GRAD_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
 
-// -----------------------------------------------------------------------------
-// DDS header (subset)
-// -----------------------------------------------------------------------------
-
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
-
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
-
 // -----------------------------------------------------------------------------
 // Scene state
 // -----------------------------------------------------------------------------
@@ -140,16 +106,16 @@ static void DrawFullscreenGradient()
     v[3].z = z;        v[3].rhw = rhw;
     v[3].color = bottomColor;
 
-    g_pDevice->SetVertexShader(GRAD_FVF);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetVertexShader(GRAD_FVF);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-    g_pDevice->DrawPrimitiveUP(
+    VRing_DrawUP(
         D3DPT_TRIANGLESTRIP,
         2,
         v,
@@ -207,156 +173,6 @@ static int ComputeFadeAlphaInt(int frame, int fadeInFrames, int holdFrames, int
     return 0;
 }
 
-// -----------------------------------------------------------------------------
-// Super-strict DDS loader for OG Xbox
-// Only supports square, power-of-two, uncompressed A8R8G8B8 textures.
-// Uses XGSwizzleRect to match the GPUs swizzle layout.
-// -----------------------------------------------------------------------------
-
-static LPDIRECT3DTEXTURE8 LoadTextureFromDDS(const char* path, int& outW, int& outH)
-{
-    outW = 0;
-    outH = 0;
-
-    if (!g_pDevice || !path)
-        return NULL;
-
-    HANDLE hFile = CreateFileA(
-        path, GENERIC_READ, FILE_SHARE_READ, NULL,
-        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-
-    if (hFile == INVALID_HANDLE_VALUE)
-        return NULL;
-
-    DWORD bytesRead = 0;
-
-    // --- Read magic ---
-    DWORD magic = 0;
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444)  // "DDS "
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    // --- Read header ---
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
-        bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    // Validate header sizes
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
-
-    // Must NOT be FOURCC (compressed)
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    // 32-bit ARGB with expected masks
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
-
-    // Require square, power-of-two
-    if (w <= 0 || h <= 0 || w != h)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if ((w & (w - 1)) != 0)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DWORD pixelBytes = (DWORD)(w * h * 4);
-
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) ||
-        bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    CloseHandle(hFile);
-
-    // --- Create swizzled Xbox texture (default behaviour) ---
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture(
-        (UINT)w,
-        (UINT)h,
-        1,
-        0,                  // default usage -> swizzled
-        D3DFMT_A8R8G8B8,
-        0,
-        &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
-
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
-
-    // Swizzle from linear BGRA into Xbox texture layout
-    XGSwizzleRect(
-        pixels,          // pSource
-        w * 4,           // pitch in bytes
-        NULL,            // pRect (NULL -> full surface)
-        lr.pBits,        // pDest (swizzled texture memory)
-        w,               // width in texels
-        h,               // height in texels
-        NULL,            // pPoint (NULL -> dest origin)
-        4                // bytes per pixel
-    );
-
-    tex->UnlockRect(0);
-    free(pixels);
-
-    outW = w;
-    outH = h;
-    return tex;
-}
-
 // -----------------------------------------------------------------------------
 // Public API
 // -----------------------------------------------------------------------------
@@ -370,25 +186,19 @@ void IntroScene_Init()
     s_phaseFrame = 0;
 
     // Expects square, power-of-two A8R8G8B8 DDS (e.g. 512x512)
-    s_logoTex = LoadTextureFromDDS("D:\\tex\\tr.dds", s_logoW, s_logoH);
-    s_xbsTex = LoadTextureFromDDS("D:\\tex\\xbs.dds", s_xbsW, s_xbsH);
+    s_logoTex = TexCache_Acquire("D:\\tex\\tr.dds", 1, &s_logoW, &s_logoH);
+    s_xbsTex = TexCache_Acquire("D:\\tex\\xbs.dds", 1, &s_xbsW, &s_xbsH);
 }
 
 void IntroScene_Shutdown()
 {
     s_introActive = false;
 
-    if (s_logoTex)
-    {
-        s_logoTex->Release();
-        s_logoTex = NULL;
-    }
-
-    if (s_xbsTex)
-    {
-        s_xbsTex->Release();
-        s_xbsTex = NULL;
-    }
+    // Cached: tr.dds is picked up again by City and the next loop
+    TexCache_Release(s_logoTex);
+    TexCache_Release(s_xbsTex);
+    s_logoTex = NULL;
+    s_xbsTex = NULL;
 }
 
 void IntroScene_Render(float demoTime)
@@ -530,28 +340,28 @@ void IntroScene_Render(float demoTime)
             v[3].z = 0.0f; v[3].rhw = 1.0f;
             v[3].color = colLogo; v[3].u = 1.0f; v[3].v = 1.0f;
 
-            g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-            g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-            g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-            g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-            g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-            g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-            g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+            DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+            DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+            DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+            DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+            DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+            DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+            DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-            g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-            g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+            DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+            DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
 
-            g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
-            g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+            DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+            DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
 
-            g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
-            g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
-            g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+            DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
+            DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
+            DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
 
-            g_pDevice->SetTexture(0, s_logoTex);
-            g_pDevice->SetVertexShader(INTRO_FVF);
+            DevState_SetTexture(0, s_logoTex);
+            DevState_SetVertexShader(INTRO_FVF);
 
-            g_pDevice->DrawPrimitiveUP(
+            VRing_DrawUP(
                 D3DPT_TRIANGLESTRIP,
                 2,
                 v,
@@ -645,28 +455,28 @@ void IntroScene_Render(float demoTime)
                 v[3].x = right; v[3].y = bottom; v[3].z = 0.0f; v[3].rhw = 1.0f;
                 v[3].color = texCol; v[3].u = 1.0f; v[3].v = 1.0f;
 
-                g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-                g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-                g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-                g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-                g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-                g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-                g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+                DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+                DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+                DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+                DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+                DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+                DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+                DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-                g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-                g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+                DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+                DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
 
-                g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
-                g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+                DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+                DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
 
-                g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
-                g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
-                g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+                DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
+                DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
+                DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
 
-                g_pDevice->SetTexture(0, s_xbsTex);
-                g_pDevice->SetVertexShader(INTRO_FVF);
+                DevState_SetTexture(0, s_xbsTex);
+                DevState_SetVertexShader(INTRO_FVF);
 
-                g_pDevice->DrawPrimitiveUP(
+                VRing_DrawUP(
                     D3DPT_TRIANGLESTRIP,
                     2,
                     v,
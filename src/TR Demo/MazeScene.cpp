@@ -18,6 +18,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "clock.h"
+#include "devstate.h"
+
 extern LPDIRECT3DDEVICE8 g_pd3dDevice;
 
 namespace
@@ -105,6 +108,8 @@ namespace
     static float g_wallRiseTime = 0.0f;
     static const float WALL_RISE_DURATION = 2.0f;
 
+    static bool g_mazePrepared = false;     // MazeScene_Prepare ran, Init not yet
+
     // =======================================================================
     // HELPERS
     // =======================================================================
@@ -459,28 +464,28 @@ namespace
 
     void SetupOutlineFixedFunction()
     {
-        g_pd3dDevice->SetTexture(0, NULL);
+        DevState_SetTexture(0, NULL);
 
-        g_pd3dDevice->SetRenderState(D3DRS_TEXTUREFACTOR, OUTLINE_COLOR);
+        DevState_SetRenderState(D3DRS_TEXTUREFACTOR, OUTLINE_COLOR);
 
-        g_pd3dDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-        g_pd3dDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TFACTOR);
-        g_pd3dDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+        DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+        DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TFACTOR);
+        DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
 
-        g_pd3dDevice->SetRenderState(D3DRS_COLORVERTEX, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_CW);
+        DevState_SetRenderState(D3DRS_COLORVERTEX, FALSE);
+        DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_CW);
 
-        g_pd3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+        DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
     }
 
     void RestoreColorVertex()
     {
-        g_pd3dDevice->SetRenderState(D3DRS_COLORVERTEX, TRUE);
-        g_pd3dDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-        g_pd3dDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+        DevState_SetRenderState(D3DRS_COLORVERTEX, TRUE);
+        DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+        DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
     }
 
 } // namespace
@@ -489,9 +494,18 @@ namespace
 // PUBLIC API
 // =======================================================================
 
-void MazeScene_Init()
+void MazeScene_Prepare()
 {
     GenerateMaze();
+    g_mazePrepared = true;
+}
+
+void MazeScene_Init()
+{
+    if (!g_mazePrepared)
+        GenerateMaze();
+    g_mazePrepared = false;
+
     CreateWallGeometry();
 
     g_interpStep = 0.0f;
@@ -513,11 +527,11 @@ void MazeScene_Update()
 {
     if (g_wallRiseTime < WALL_RISE_DURATION)
     {
-        g_wallRiseTime += 1.0f / 60.0f;
+        g_wallRiseTime += CLOCK_STEP_SECONDS;
         return;
     }
 
-    g_interpStep += 1.0f / 60.0f;
+    g_interpStep += CLOCK_STEP_SECONDS;
 
     if (g_interpStep >= 1.0f)
     {
@@ -532,19 +546,24 @@ void MazeScene_Update()
 void MazeScene_Render()
 {
     // hard reset
-    g_pd3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pd3dDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
 
-    g_pd3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-    g_pd3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-    g_pd3dDevice->SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+    DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
 
-    g_pd3dDevice->SetTexture(0, NULL);
-    g_pd3dDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pd3dDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
 
-    // interpolate
+    // interpolate (plus the part of a step that has elapsed since the last Update)
     float t = g_interpStep;
+    if (g_wallRiseTime >= WALL_RISE_DURATION)
+    {
+        t += Clock_StepAlpha() * CLOCK_STEP_SECONDS;
+        if (t > 1.0f) t = 1.0f;
+    }
     float camPos[3];
     camPos[0] = g_posStart[0] + (g_posEnd[0] - g_posStart[0]) * t;
     camPos[1] = g_posStart[1] + (g_posEnd[1] - g_posStart[1]) * t;
@@ -570,11 +589,11 @@ void MazeScene_Render()
     g_pd3dDevice->SetTransform(D3DTS_PROJECTION, &matProj);
 
     // cel-ish
-    g_pd3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pd3dDevice->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_FLAT);
-    g_pd3dDevice->SetRenderState(D3DRS_COLORVERTEX, TRUE);
-    g_pd3dDevice->SetRenderState(D3DRS_DIFFUSEMATERIALSOURCE, D3DMCS_COLOR1);
-    g_pd3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_SHADEMODE, D3DSHADE_FLAT);
+    DevState_SetRenderState(D3DRS_COLORVERTEX, TRUE);
+    DevState_SetRenderState(D3DRS_DIFFUSEMATERIALSOURCE, D3DMCS_COLOR1);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW);
 
     // -------------------------------------------------------------------
     // MOODY FOG (TABLE FOG)
@@ -582,27 +601,27 @@ void MazeScene_Render()
     // -------------------------------------------------------------------
     if (ENABLE_FOG)
     {
-        g_pd3dDevice->SetRenderState(D3DRS_FOGENABLE, TRUE);
-        g_pd3dDevice->SetRenderState(D3DRS_FOGCOLOR, FOG_COLOR);
+        DevState_SetRenderState(D3DRS_FOGENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_FOGCOLOR, FOG_COLOR);
 
         // EXP2 fog (stronger mood). Mode enum is defined in headers. :contentReference[oaicite:7]{index=7}
-        g_pd3dDevice->SetRenderState(D3DRS_FOGTABLEMODE, FOG_MODE);
+        DevState_SetRenderState(D3DRS_FOGTABLEMODE, FOG_MODE);
 
         // Density drives EXP/EXP2
         float d = FOG_DENSITY;
-        g_pd3dDevice->SetRenderState(D3DRS_FOGDENSITY, *(DWORD*)(&d));
+        DevState_SetRenderState(D3DRS_FOGDENSITY, *(DWORD*)(&d));
 
         // Also set start/end (harmless, and helps if the pipeline leans on them)
         float s = FOG_START;
         float e = FOG_END;
-        g_pd3dDevice->SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&s));
-        g_pd3dDevice->SetRenderState(D3DRS_FOGEND, *(DWORD*)(&e));
+        DevState_SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&s));
+        DevState_SetRenderState(D3DRS_FOGEND, *(DWORD*)(&e));
 
-        g_pd3dDevice->SetRenderState(D3DRS_RANGEFOGENABLE, (ENABLE_RANGE_FOG ? TRUE : FALSE));
+        DevState_SetRenderState(D3DRS_RANGEFOGENABLE, (ENABLE_RANGE_FOG ? TRUE : FALSE));
     }
     else
     {
-        g_pd3dDevice->SetRenderState(D3DRS_FOGENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_FOGENABLE, FALSE);
     }
 
     // world
@@ -610,9 +629,9 @@ void MazeScene_Render()
     D3DXMatrixIdentity(&matWorld);
 
     // bind
-    g_pd3dDevice->SetVertexShader(FVF_WALL);
-    g_pd3dDevice->SetStreamSource(0, g_vbWalls, sizeof(WallVertex));
-    g_pd3dDevice->SetIndices(g_ibWalls, 0);
+    DevState_SetVertexShader(FVF_WALL);
+    DevState_SetStreamSource(0, g_vbWalls, sizeof(WallVertex));
+    DevState_SetIndices(g_ibWalls, 0);
 
     // outline
     if (ENABLE_OUTLINE)
@@ -633,12 +652,12 @@ void MazeScene_Render()
         g_pd3dDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, g_numWallVerts, 0, g_numWallIndices / 3);
 
         RestoreColorVertex();
-        g_pd3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-        g_pd3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-        g_pd3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-        g_pd3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        g_pd3dDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+        DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+        DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
     }
 
     // main
@@ -646,7 +665,7 @@ void MazeScene_Render()
     g_pd3dDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, g_numWallVerts, 0, g_numWallIndices / 3);
 
     // restore
-    g_pd3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW);
-    g_pd3dDevice->SetRenderState(D3DRS_FOGENABLE, FALSE);
-    g_pd3dDevice->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW);
+    DevState_SetRenderState(D3DRS_FOGENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+// Maze generation only (no device access); safe on the loader thread.
+void MazeScene_Prepare();
 void MazeScene_Init();
 void MazeScene_Shutdown();
 void MazeScene_Update();
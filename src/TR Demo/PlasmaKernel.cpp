@@ -0,0 +1,714 @@
+// PlasmaKernel.cpp - Separable plasma field evaluator (SSE + scalar fallback)
+//
+// The PlasmaScene field is a sum of 16 sine/cosine terms. Every term is
+// rewritten with the angle-sum identities so that per frame we only evaluate
+// trig once per column and once per row:
+//
+//   sin(a(nx) + b(ny)) = sin a * cos b + cos a * sin b
+//   cos(a(nx) + b(ny)) = cos a * cos b - sin a * sin b
+//
+// The rotating-wave terms stay linear in nx/ny (the rotation only changes the
+// coefficients), so they separate the same way. The three radial terms and
+// the nx*ny term do not separate, but their spatial part is time-invariant,
+// so sin/cos of it are tabled per cell at Init and combined with one
+// sin/cos of the time phase per frame.
+//
+// Banding uses clamp + round-to-nearest via the 1.5*2^23 magic add instead of
+// a compare ladder or float->int casts.
+
+#include "PlasmaKernel.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PLASMA_SSE 1
+#else
+#define PLASMA_SSE 0
+#endif
+
+// Separable product terms: P[i] * R[j] + Q[i] * S[j]
+static const int PLASMA_PAIRS = 7;
+
+// Non-separable, time-invariant cell terms: A[c] * cos(w t) + B[c] * sin(w t)
+static const int PLASMA_STATIC = 4;
+
+static const int PLASMA_COL_PLANES = 1 + PLASMA_PAIRS * 2;   // colSum, P0,Q0..P6,Q6
+static const int PLASMA_ROW_PLANES = 1 + PLASMA_PAIRS * 2;   // rowSum, R0,S0..R6,S6
+static const int PLASMA_CELL_PLANES = PLASMA_STATIC * 2;     // A0,B0..A3,B3
+
+// Band = ceil(v / 0.375) + 7, clamped to 0..15 (same edges as the old ladder)
+static const float BAND_INV_STEP = 1.0f / 0.375f;
+static const float BAND_BIAS = 7.5f;
+static const float BAND_MAX = 15.0f;
+
+static const float ROUND_MAGIC = 12582912.0f;           // 1.5 * 2^23
+static const unsigned int ROUND_MAGIC_BITS = 0x4B400000u;
+
+static __inline float CoordX(int i, int w) { return (float)i * (4.0f / (float)(w - 1)) - 2.0f; }
+static __inline float CoordY(int j, int h) { return (float)j * (4.0f / (float)(h - 1)) - 2.0f; }
+
+// -----------------------------------------------------------------------------
+// Init / Free
+// -----------------------------------------------------------------------------
+
+bool PlasmaField_Init(PlasmaField* f, int w, int h)
+{
+    if (!f || w < 2 || h < 2)
+        return false;
+
+    memset(f, 0, sizeof(*f));
+
+    int stride = (w + 3) & ~3;
+    int hPad = (h + 3) & ~3;
+
+    size_t floats =
+        (size_t)PLASMA_COL_PLANES * stride +
+        (size_t)PLASMA_CELL_PLANES * stride * h +
+        (size_t)PLASMA_ROW_PLANES * hPad;
+
+    void* block = malloc(floats * sizeof(float) + 16);
+    if (!block)
+        return false;
+
+    float* base = (float*)(((size_t)block + 15) & ~(size_t)15);
+    memset(base, 0, floats * sizeof(float));
+
+    f->w = w;
+    f->h = h;
+    f->stride = stride;
+    f->block = block;
+    f->colTerms = base;
+    f->cellTerms = f->colTerms + PLASMA_COL_PLANES * stride;
+    f->rowTerms = f->cellTerms + PLASMA_CELL_PLANES * stride * h;
+
+    const int plane = stride * h;
+
+    for (int j = 0; j < h; ++j)
+    {
+        float ny = CoordY(j, h);
+
+        for (int i = 0; i < w; ++i)
+        {
+            float nx = CoordX(i, w);
+
+            float r0 = sqrtf(nx * nx + ny * ny);
+            float r1 = sqrtf((nx - 0.5f) * (nx - 0.5f) + (ny + 0.3f) * (ny + 0.3f));
+            float r2 = sqrtf((nx + 0.7f) * (nx + 0.7f) + (ny - 0.6f) * (ny - 0.6f));
+            float p = nx * ny * 3.0f;
+
+            int c = j * stride + i;
+            float* A = f->cellTerms;
+
+            // sin(7 r0 + 1.1t)
+            A[0 * plane + c] = sinf(r0 * 7.0f);
+            A[1 * plane + c] = cosf(r0 * 7.0f);
+            // cos(6 r1 - 1.4t)
+            A[2 * plane + c] = cosf(r1 * 6.0f);
+            A[3 * plane + c] = sinf(r1 * 6.0f);
+            // sin(5.5 r2 + 0.7t)
+            A[4 * plane + c] = sinf(r2 * 5.5f);
+            A[5 * plane + c] = cosf(r2 * 5.5f);
+            // sin(3 nx ny + t)
+            A[6 * plane + c] = sinf(p);
+            A[7 * plane + c] = cosf(p);
+        }
+    }
+
+    return true;
+}
+
+void PlasmaField_Free(PlasmaField* f)
+{
+    if (!f)
+        return;
+
+    if (f->block)
+        free(f->block);
+
+    memset(f, 0, sizeof(*f));
+}
+
+// -----------------------------------------------------------------------------
+// Per-frame column / row terms
+// -----------------------------------------------------------------------------
+
+static void BuildLineTerms(PlasmaField* f, float t)
+{
+    const int w = f->w;
+    const int h = f->h;
+    const int stride = f->stride;
+    const int hPad = (h + 3) & ~3;
+
+    // Rotating wave 1: angle = 0.5t, coefficients 4.5 / 3.5
+    float c1 = cosf(t * 0.5f), s1 = sinf(t * 0.5f);
+    float kx1 = 4.5f * c1 + 3.5f * s1;
+    float ky1 = -4.5f * s1 + 3.5f * c1;
+
+    // Rotating wave 2: angle = -0.7t + 1.5, coefficients 5.5 / -4.0
+    float a2 = t * -0.7f + 1.5f;
+    float c2 = cosf(a2), s2 = sinf(a2);
+    float kx2 = 5.5f * c2 - 4.0f * s2;
+    float ky2 = -5.5f * s2 - 4.0f * c2;
+
+    // Interference: (3nx + 2ny) * sin(0.2t)
+    float k6 = sinf(t * 0.2f);
+
+    float offX = sinf(t * 0.3f);
+    float offY = cosf(t * 0.4f);
+
+    float* C = f->colTerms;
+    for (int i = 0; i < w; ++i)
+    {
+        float nx = CoordX(i, w);
+
+        C[0 * stride + i] = sinf(nx * 5.0f + t * 1.2f) + cosf((nx + offX) * 7.0f);
+
+        float a;
+        a = nx * 4.0f + t * 0.8f;      C[1 * stride + i] = sinf(a);  C[2 * stride + i] = cosf(a);
+        a = nx * 4.5f - t;             C[3 * stride + i] = cosf(a);  C[4 * stride + i] = sinf(a);
+        a = nx * 6.5f + t * 1.3f;      C[5 * stride + i] = sinf(a);  C[6 * stride + i] = cosf(a);
+        a = nx * 3.0f - t * 0.9f;      C[7 * stride + i] = cosf(a);  C[8 * stride + i] = sinf(a);
+        a = nx * kx1 + t * 0.6f;       C[9 * stride + i] = cosf(a);  C[10 * stride + i] = -sinf(a);
+        a = nx * kx2 - t * 0.8f;       C[11 * stride + i] = sinf(a); C[12 * stride + i] = cosf(a);
+        a = nx * 3.0f * k6 + t * 1.5f; C[13 * stride + i] = cosf(a); C[14 * stride + i] = -sinf(a);
+    }
+
+    float* R = f->rowTerms;
+    for (int j = 0; j < h; ++j)
+    {
+        float ny = CoordY(j, h);
+
+        R[0 * hPad + j] = cosf(ny * 5.0f - t * 1.5f) + sinf((ny + offY) * 7.0f);
+
+        float b;
+        b = ny * 4.0f;        R[1 * hPad + j] = cosf(b);  R[2 * hPad + j] = sinf(b);
+        b = ny * 4.5f;        R[3 * hPad + j] = cosf(b);  R[4 * hPad + j] = sinf(b);
+        b = ny * 3.5f;        R[5 * hPad + j] = cosf(b);  R[6 * hPad + j] = sinf(b);
+        b = ny * 6.0f;        R[7 * hPad + j] = cosf(b);  R[8 * hPad + j] = sinf(b);
+        b = ny * ky1;         R[9 * hPad + j] = cosf(b);  R[10 * hPad + j] = sinf(b);
+        b = ny * ky2;         R[11 * hPad + j] = cosf(b); R[12 * hPad + j] = sinf(b);
+        b = ny * 2.0f * k6;   R[13 * hPad + j] = cosf(b); R[14 * hPad + j] = sinf(b);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Per-frame evaluation
+// -----------------------------------------------------------------------------
+
+// Shared by both loops: w, h and the plane layout, the frame's line terms
+// and the time phase of the static cell terms
+struct EvalFrame
+{
+    int          w, h, stride, hPad, plane;
+    const float* C;
+    const float* R;
+    const float* A;
+    float        cw[PLASMA_STATIC];
+    float        sw[PLASMA_STATIC];
+};
+
+static bool BeginEval(PlasmaField* f, float t, unsigned char* outBands, EvalFrame* e)
+{
+    if (!f || !f->block || !outBands)
+        return false;
+
+    BuildLineTerms(f, t);
+
+    e->w = f->w;
+    e->h = f->h;
+    e->stride = f->stride;
+    e->hPad = (f->h + 3) & ~3;
+    e->plane = f->stride * f->h;
+
+    e->C = f->colTerms;
+    e->R = f->rowTerms;
+    e->A = f->cellTerms;
+
+    e->cw[0] = cosf(t * 1.1f); e->cw[1] = cosf(t * 1.4f); e->cw[2] = cosf(t * 0.7f); e->cw[3] = cosf(t);
+    e->sw[0] = sinf(t * 1.1f); e->sw[1] = sinf(t * 1.4f); e->sw[2] = sinf(t * 0.7f); e->sw[3] = sinf(t);
+    return true;
+}
+
+#if PLASMA_SSE
+static void EvalBandsSse(const EvalFrame& e, unsigned char* outBands)
+{
+    const int w = e.w, h = e.h, stride = e.stride, hPad = e.hPad, plane = e.plane;
+    const float* C = e.C;
+    const float* R = e.R;
+    const float* A = e.A;
+
+    const __m128 vInv = _mm_set1_ps(BAND_INV_STEP);
+    const __m128 vBias = _mm_set1_ps(BAND_BIAS);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vMax = _mm_set1_ps(BAND_MAX);
+    const __m128 vMagic = _mm_set1_ps(ROUND_MAGIC);
+
+    __m128 vcw[PLASMA_STATIC], vsw[PLASMA_STATIC];
+    for (int s = 0; s < PLASMA_STATIC; ++s)
+    {
+        vcw[s] = _mm_set1_ps(e.cw[s]);
+        vsw[s] = _mm_set1_ps(e.sw[s]);
+    }
+
+    union { __m128 v; unsigned int u[4]; } q;
+
+    for (int j = 0; j < h; ++j)
+    {
+        __m128 vRow = _mm_set1_ps(R[j]);
+        __m128 vR[PLASMA_PAIRS], vS[PLASMA_PAIRS];
+        for (int k = 0; k < PLASMA_PAIRS; ++k)
+        {
+            vR[k] = _mm_set1_ps(R[(1 + k * 2) * hPad + j]);
+            vS[k] = _mm_set1_ps(R[(2 + k * 2) * hPad + j]);
+        }
+
+        const float* cell = A + j * stride;
+        unsigned char* out = outBands + j * w;
+
+        for (int i = 0; i < w; i += 4)
+        {
+            __m128 acc = _mm_add_ps(_mm_load_ps(C + i), vRow);
+
+            for (int k = 0; k < PLASMA_PAIRS; ++k)
+            {
+                __m128 p = _mm_load_ps(C + (1 + k * 2) * stride + i);
+                __m128 qq = _mm_load_ps(C + (2 + k * 2) * stride + i);
+                acc = _mm_add_ps(acc, _mm_add_ps(_mm_mul_ps(p, vR[k]), _mm_mul_ps(qq, vS[k])));
+            }
+
+            for (int s = 0; s < PLASMA_STATIC; ++s)
+            {
+                __m128 a = _mm_load_ps(cell + (s * 2) * plane + i);
+                __m128 b = _mm_load_ps(cell + (s * 2 + 1) * plane + i);
+                acc = _mm_add_ps(acc, _mm_add_ps(_mm_mul_ps(a, vcw[s]), _mm_mul_ps(b, vsw[s])));
+            }
+
+            __m128 y = _mm_add_ps(_mm_mul_ps(acc, vInv), vBias);
+            y = _mm_min_ps(_mm_max_ps(y, vZero), vMax);
+            q.v = _mm_add_ps(y, vMagic);
+
+            int n = w - i; if (n > 4) n = 4;
+            for (int el = 0; el < n; ++el)
+                out[i + el] = (unsigned char)(q.u[el] - ROUND_MAGIC_BITS);
+        }
+    }
+}
+#endif
+
+static void EvalBandsScalar(const EvalFrame& e, unsigned char* outBands)
+{
+    const int w = e.w, h = e.h, stride = e.stride, hPad = e.hPad, plane = e.plane;
+    const float* C = e.C;
+    const float* R = e.R;
+    const float* A = e.A;
+
+    union { float f; unsigned int u; } q;
+
+    for (int j = 0; j < h; ++j)
+    {
+        float row = R[j];
+        float rR[PLASMA_PAIRS], rS[PLASMA_PAIRS];
+        for (int k = 0; k < PLASMA_PAIRS; ++k)
+        {
+            rR[k] = R[(1 + k * 2) * hPad + j];
+            rS[k] = R[(2 + k * 2) * hPad + j];
+        }
+
+        const float* cell = A + j * stride;
+        unsigned char* out = outBands + j * w;
+
+        for (int i = 0; i < w; ++i)
+        {
+            float v = C[i] + row;
+
+            for (int k = 0; k < PLASMA_PAIRS; ++k)
+                v += C[(1 + k * 2) * stride + i] * rR[k] + C[(2 + k * 2) * stride + i] * rS[k];
+
+            for (int s = 0; s < PLASMA_STATIC; ++s)
+                v += cell[(s * 2) * plane + i] * e.cw[s] + cell[(s * 2 + 1) * plane + i] * e.sw[s];
+
+            float y = v * BAND_INV_STEP + BAND_BIAS;
+            if (y < 0.0f) y = 0.0f;
+            if (y > BAND_MAX) y = BAND_MAX;
+
+            q.f = y + ROUND_MAGIC;
+            out[i] = (unsigned char)(q.u - ROUND_MAGIC_BITS);
+        }
+    }
+}
+
+void PlasmaField_EvalBands(PlasmaField* f, float t, unsigned char* outBands)
+{
+    EvalFrame e;
+    if (!BeginEval(f, t, outBands, &e))
+        return;
+
+#if PLASMA_SSE
+    EvalBandsSse(e, outBands);
+#else
+    EvalBandsScalar(e, outBands);
+#endif
+}
+
+void PlasmaField_EvalBandsScalar(PlasmaField* f, float t, unsigned char* outBands)
+{
+    EvalFrame e;
+    if (BeginEval(f, t, outBands, &e))
+        EvalBandsScalar(e, outBands);
+}
+
+// -----------------------------------------------------------------------------
+// Integer / LUT per-pixel kernel
+//
+// Every term is LUT[(phase) & 255] with 256 steps per turn. Pair terms that
+// depend on both nx and ny are LUT[colPhase + rowPhase] (angle addition is
+// just an 8-bit add), radial terms are LUT[cellPhase + timePhase]. Per frame
+// only the w + h line phases are rebuilt, in 8.8 fixed point by stepping
+// from a base angle.
+// -----------------------------------------------------------------------------
+
+static const int TEX_PAIRS = 7;
+static const int TEX_CELLS = 4;
+
+static const int TEX_LUT_AMP = 32;          // LUT range -32..32
+static const int TEX_SUM_MAX = 512;         // |sum| bound: 16 terms * 32
+static const int TEX_COS = 64 << 8;         // quarter turn, 8.8 fixed
+
+static const float TWO_PI = 6.28318531f;
+static const float INV_TWO_PI = 1.0f / 6.28318531f;
+
+static short         s_texSin[256];
+static unsigned char s_texIndex[TEX_SUM_MAX * 2 + 1];
+static bool          s_texTablesBuilt = false;
+
+static void BuildTexTables()
+{
+    if (s_texTablesBuilt)
+        return;
+
+    for (int a = 0; a < 256; ++a)
+    {
+        float s = sinf((float)a * (TWO_PI / 256.0f)) * (float)TEX_LUT_AMP;
+        s_texSin[a] = (short)(s < 0.0f ? s - 0.5f : s + 0.5f);
+    }
+
+    // sum (v * 32) -> index = v * 256/6 + 128, so index >> 4 is the same
+    // band the vertex path uses (v / 0.375 + 8).
+    for (int s = -TEX_SUM_MAX; s <= TEX_SUM_MAX; ++s)
+    {
+        int n = s * 4;
+        int idx = 128 + (n >= 0 ? n / 3 : -((2 - n) / 3));
+        if (idx < 0) idx = 0;
+        if (idx > 255) idx = 255;
+        s_texIndex[s + TEX_SUM_MAX] = (unsigned char)idx;
+    }
+
+    s_texTablesBuilt = true;
+}
+
+static __inline int RoundFix(float x)
+{
+    union { float f; unsigned int u; } q;
+    q.f = x + ROUND_MAGIC;
+    return (int)(q.u - ROUND_MAGIC_BITS);
+}
+
+// Radians -> 8.8 fixed LUT angle, wrapped to one turn.
+static __inline unsigned int PhaseFix(float radians)
+{
+    float turns = radians * INV_TWO_PI;
+    turns -= floorf(turns);
+    return (unsigned int)RoundFix(turns * 65536.0f);
+}
+
+// Radians per step -> 8.8 fixed LUT angle per step (small, signed).
+static __inline unsigned int SlopeFix(float radians)
+{
+    return (unsigned int)RoundFix(radians * (65536.0f * INV_TWO_PI));
+}
+
+// phase[n * 8] = angle of (k * coord(n) + offset), coord(n) = n * step - 2
+static void FillLinePhase(unsigned char* phase, int count, float step,
+                          float k, float offset, unsigned int extra)
+{
+    unsigned int a = PhaseFix(offset - 2.0f * k) + extra;
+    unsigned int da = SlopeFix(k * step);
+
+    for (int n = 0; n < count; ++n)
+    {
+        phase[n * 8] = (unsigned char)(a >> 8);
+        a += da;
+    }
+}
+
+// sum[n] = LUT(k0 * coord + off0) + LUT(k1 * coord + off1)
+static void FillLineSum(short* sum, int count, float step,
+                        float k0, float off0, unsigned int extra0,
+                        float k1, float off1, unsigned int extra1)
+{
+    unsigned int a0 = PhaseFix(off0 - 2.0f * k0) + extra0;
+    unsigned int a1 = PhaseFix(off1 - 2.0f * k1) + extra1;
+    unsigned int d0 = SlopeFix(k0 * step);
+    unsigned int d1 = SlopeFix(k1 * step);
+
+    for (int n = 0; n < count; ++n)
+    {
+        sum[n] = (short)(s_texSin[(a0 >> 8) & 255] + s_texSin[(a1 >> 8) & 255]);
+        a0 += d0;
+        a1 += d1;
+    }
+}
+
+bool PlasmaTex_Init(PlasmaTexField* f, int w, int h)
+{
+    if (!f || w < 2 || h < 2)
+        return false;
+
+    memset(f, 0, sizeof(*f));
+
+    BuildTexTables();
+
+    size_t bytes =
+        (size_t)w * 8 + (size_t)h * 8 +
+        ((size_t)w + (size_t)h) * sizeof(short) +
+        (size_t)w * h * TEX_CELLS;
+
+    unsigned char* block = (unsigned char*)malloc(bytes);
+    if (!block)
+        return false;
+
+    f->w = w;
+    f->h = h;
+    f->block = block;
+    f->colSum = (short*)block;
+    f->rowSum = f->colSum + w;
+    f->colPhase = (unsigned char*)(f->rowSum + h);
+    f->rowPhase = f->colPhase + w * 8;
+    f->cellPhase = f->rowPhase + h * 8;
+
+    memset(f->colPhase, 0, (size_t)(w + h) * 8);
+
+    const float toLut = 256.0f * INV_TWO_PI;
+
+    for (int j = 0; j < h; ++j)
+    {
+        float ny = CoordY(j, h);
+
+        for (int i = 0; i < w; ++i)
+        {
+            float nx = CoordX(i, w);
+
+            float r0 = sqrtf(nx * nx + ny * ny);
+            float r1 = sqrtf((nx - 0.5f) * (nx - 0.5f) + (ny + 0.3f) * (ny + 0.3f));
+            float r2 = sqrtf((nx + 0.7f) * (nx + 0.7f) + (ny - 0.6f) * (ny - 0.6f));
+            float p = nx * ny * 3.0f;
+
+            unsigned char* c = f->cellPhase + (j * w + i) * TEX_CELLS;
+
+            // Spatial angle in LUT units; p can be negative, hence the +256.
+            c[0] = (unsigned char)(int)(r0 * 7.0f * toLut + 0.5f);
+            c[1] = (unsigned char)((int)(r1 * 6.0f * toLut + 0.5f) + 64);
+            c[2] = (unsigned char)(int)(r2 * 5.5f * toLut + 0.5f);
+            c[3] = (unsigned char)(int)(p * toLut + 256.0f + 0.5f);
+        }
+    }
+
+    return true;
+}
+
+void PlasmaTex_Free(PlasmaTexField* f)
+{
+    if (!f)
+        return;
+
+    if (f->block)
+        free(f->block);
+
+    memset(f, 0, sizeof(*f));
+}
+
+void PlasmaTex_Eval(PlasmaTexField* f, float t, unsigned char* dst, int dstPitch)
+{
+    if (!f || !f->block || !dst)
+        return;
+
+    const int w = f->w;
+    const int h = f->h;
+    const float sx = 4.0f / (float)(w - 1);
+    const float sy = 4.0f / (float)(h - 1);
+
+    // Same coefficients as BuildLineTerms / the reference
+    float c1 = cosf(t * 0.5f), s1 = sinf(t * 0.5f);
+    float kx1 = 4.5f * c1 + 3.5f * s1;
+    float ky1 = -4.5f * s1 + 3.5f * c1;
+
+    float a2 = t * -0.7f + 1.5f;
+    float c2 = cosf(a2), s2 = sinf(a2);
+    float kx2 = 5.5f * c2 - 4.0f * s2;
+    float ky2 = -5.5f * s2 - 4.0f * c2;
+
+    float k6 = sinf(t * 0.2f);
+
+    float offX = sinf(t * 0.3f);
+    float offY = cosf(t * 0.4f);
+
+    // Pure column / row terms
+    FillLineSum(f->colSum, w, sx, 5.0f, t * 1.2f, 0, 7.0f, offX * 7.0f, TEX_COS);
+    FillLineSum(f->rowSum, h, sy, 5.0f, -t * 1.5f, TEX_COS, 7.0f, offY * 7.0f, 0);
+
+    // Pair terms: time and sin/cos offset ride on the column phase
+    unsigned char* C = f->colPhase;
+    FillLinePhase(C + 0, w, sx, 4.0f,      t * 0.8f,  0);
+    FillLinePhase(C + 1, w, sx, 4.5f,     -t,         TEX_COS);
+    FillLinePhase(C + 2, w, sx, 6.5f,      t * 1.3f,  0);
+    FillLinePhase(C + 3, w, sx, 3.0f,     -t * 0.9f,  TEX_COS);
+    FillLinePhase(C + 4, w, sx, kx1,       t * 0.6f,  TEX_COS);
+    FillLinePhase(C + 5, w, sx, kx2,      -t * 0.8f,  0);
+    FillLinePhase(C + 6, w, sx, 3.0f * k6, t * 1.5f,  TEX_COS);
+
+    unsigned char* R = f->rowPhase;
+    FillLinePhase(R + 0, h, sy, 4.0f,      0.0f, 0);
+    FillLinePhase(R + 1, h, sy, -4.5f,     0.0f, 0);
+    FillLinePhase(R + 2, h, sy, 3.5f,      0.0f, 0);
+    FillLinePhase(R + 3, h, sy, -6.0f,     0.0f, 0);
+    FillLinePhase(R + 4, h, sy, ky1,       0.0f, 0);
+    FillLinePhase(R + 5, h, sy, ky2,       0.0f, 0);
+    FillLinePhase(R + 6, h, sy, 2.0f * k6, 0.0f, 0);
+
+    // Time phases of the cell terms
+    const unsigned int t0 = PhaseFix(t * 1.1f) >> 8;
+    const unsigned int t1 = PhaseFix(t * -1.4f) >> 8;
+    const unsigned int t2 = PhaseFix(t * 0.7f) >> 8;
+    const unsigned int t3 = PhaseFix(t) >> 8;
+
+    const short* lut = s_texSin;
+    const unsigned char* idx = s_texIndex + TEX_SUM_MAX;
+
+    for (int j = 0; j < h; ++j)
+    {
+        const unsigned char* rp = R + j * 8;
+        const unsigned int r0 = rp[0], r1 = rp[1], r2 = rp[2], r3 = rp[3];
+        const unsigned int r4 = rp[4], r5 = rp[5], r6 = rp[6];
+        const int rowSum = f->rowSum[j];
+
+        const unsigned char* cp = C;
+        const unsigned char* ce = f->cellPhase + j * w * TEX_CELLS;
+        const short* cs = f->colSum;
+        unsigned char* out = dst + j * dstPitch;
+
+        for (int i = 0; i < w; ++i)
+        {
+            int s = cs[i] + rowSum
+                + lut[(cp[0] + r0) & 255]
+                + lut[(cp[1] + r1) & 255]
+                + lut[(cp[2] + r2) & 255]
+                + lut[(cp[3] + r3) & 255]
+                + lut[(cp[4] + r4) & 255]
+                + lut[(cp[5] + r5) & 255]
+                + lut[(cp[6] + r6) & 255]
+                + lut[(ce[0] + t0) & 255]
+                + lut[(ce[1] + t1) & 255]
+                + lut[(ce[2] + t2) & 255]
+                + lut[(ce[3] + t3) & 255];
+
+            out[i] = idx[s];
+
+            cp += 8;
+            ce += TEX_CELLS;
+        }
+    }
+}
+
+void PlasmaTex_Expand(const unsigned char* src, int srcPitch, int w, int h,
+                      const unsigned int* palette, void* dst, int dstPitch)
+{
+    if (!src || !palette || !dst)
+        return;
+
+    for (int j = 0; j < h; ++j)
+    {
+        const unsigned char* in = src + j * srcPitch;
+        unsigned int* out = (unsigned int*)((unsigned char*)dst + j * dstPitch);
+
+        int i = 0;
+        for (; i + 4 <= w; i += 4)
+        {
+            out[i + 0] = palette[in[i + 0]];
+            out[i + 1] = palette[in[i + 1]];
+            out[i + 2] = palette[in[i + 2]];
+            out[i + 3] = palette[in[i + 3]];
+        }
+        for (; i < w; ++i)
+            out[i] = palette[in[i]];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Reference (original PlasmaScene::UpdatePlasmaColors math)
+// -----------------------------------------------------------------------------
+
+void PlasmaField_EvalBandsRef(int w, int h, float t, unsigned char* outBands)
+{
+    if (!outBands || w < 2 || h < 2)
+        return;
+
+    for (int j = 0; j < h; ++j)
+    {
+        float ny = CoordY(j, h);
+
+        for (int i = 0; i < w; ++i)
+        {
+            float nx = CoordX(i, w);
+
+            float v =
+                sinf(nx * 5.0f + t * 1.2f) +
+                cosf(ny * 5.0f - t * 1.5f) +
+                sinf((nx + ny) * 4.0f + t * 0.8f) +
+                cosf((nx - ny) * 4.5f - t * 1.0f) +
+                sinf(nx * 6.5f + ny * 3.5f + t * 1.3f) +
+                cosf(nx * 3.0f - ny * 6.0f - t * 0.9f) +
+                sinf(sqrtf(nx * nx + ny * ny) * 7.0f + t * 1.1f) +
+                cosf(sqrtf((nx - 0.5f) * (nx - 0.5f) + (ny + 0.3f) * (ny + 0.3f)) * 6.0f - t * 1.4f) +
+                sinf(sqrtf((nx + 0.7f) * (nx + 0.7f) + (ny - 0.6f) * (ny - 0.6f)) * 5.5f + t * 0.7f);
+
+            float angle = t * 0.5f;
+            float rx1 = nx * cosf(angle) - ny * sinf(angle);
+            float ry1 = nx * sinf(angle) + ny * cosf(angle);
+            v += cosf(rx1 * 4.5f + ry1 * 3.5f + t * 0.6f);
+
+            float angle2 = t * -0.7f + 1.5f;
+            float rx2 = nx * cosf(angle2) - ny * sinf(angle2);
+            float ry2 = nx * sinf(angle2) + ny * cosf(angle2);
+            v += sinf(rx2 * 5.5f - ry2 * 4.0f - t * 0.8f);
+
+            v += sinf(nx * ny * 3.0f + t);
+            v += cosf((nx + sinf(t * 0.3f)) * 7.0f);
+            v += sinf((ny + cosf(t * 0.4f)) * 7.0f);
+            v += cosf((nx * 3.0f + ny * 2.0f) * sinf(t * 0.2f) + t * 1.5f);
+
+            int band;
+            if (v > 2.625f)      band = 15;
+            else if (v > 2.25f)  band = 14;
+            else if (v > 1.875f) band = 13;
+            else if (v > 1.5f)   band = 12;
+            else if (v > 1.125f) band = 11;
+            else if (v > 0.75f)  band = 10;
+            else if (v > 0.375f) band = 9;
+            else if (v > 0.0f)   band = 8;
+            else if (v > -0.375f) band = 7;
+            else if (v > -0.75f)  band = 6;
+            else if (v > -1.125f) band = 5;
+            else if (v > -1.5f)   band = 4;
+            else if (v > -1.875f) band = 3;
+            else if (v > -2.25f)  band = 2;
+            else if (v > -2.625f) band = 1;
+            else                  band = 0;
+
+            outBands[j * w + i] = (unsigned char)band;
+        }
+    }
+}
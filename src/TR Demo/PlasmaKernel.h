@@ -0,0 +1,67 @@
+#pragma once
+// PlasmaKernel.h - Platform-neutral plasma field evaluator (no D3D / xtl).
+//
+// PlasmaField: evaluates the PlasmaScene field on a w x h grid and writes one
+// band index (0..15) per cell. The expression is split into per-column terms,
+// per-row terms and per-cell static tables so the inner loop is only
+// multiply-adds (SSE when available, scalar otherwise).
+//
+// PlasmaTexField: same field, per pixel, integer only. Phases are 8-bit
+// angles into a sine LUT and the output is an 8-bit palette index (band =
+// index >> 4), meant for a CPU-written texture.
+
+struct PlasmaField
+{
+    int    w, h;
+    int    stride;      // w rounded up to a multiple of 4
+
+    float* colTerms;    // PLASMA_COL_PLANES planes of stride floats
+    float* rowTerms;    // PLASMA_ROW_PLANES planes of h floats
+    float* cellTerms;   // PLASMA_CELL_PLANES planes of (stride * h) floats
+
+    void*  block;       // single allocation backing the planes above
+};
+
+// Init-only: allocates and builds the static per-cell tables.
+bool PlasmaField_Init(PlasmaField* f, int w, int h);
+void PlasmaField_Free(PlasmaField* f);
+
+// Per-frame: band index per cell, row-major, w * h bytes.
+void PlasmaField_EvalBands(PlasmaField* f, float t, unsigned char* outBands);
+
+// The scalar loop EvalBands falls back to without SSE, callable either way
+// so tools/plasmabench can check and time both.
+void PlasmaField_EvalBandsScalar(PlasmaField* f, float t, unsigned char* outBands);
+
+// Reference: the original per-vertex sinf/cosf/sqrtf + 16-way ladder.
+// Slow; used to verify EvalBands (bands may differ by 1 on exact edges).
+void PlasmaField_EvalBandsRef(int w, int h, float t, unsigned char* outBands);
+
+// -----------------------------------------------------------------------------
+// Integer / LUT per-pixel kernel
+// -----------------------------------------------------------------------------
+
+struct PlasmaTexField
+{
+    int             w, h;
+
+    unsigned char*  colPhase;   // w x 8: pair-term phases (7 used)
+    unsigned char*  rowPhase;   // h x 8
+    short*          colSum;     // w: pure column terms, LUT units
+    short*          rowSum;     // h: pure row terms, LUT units
+    unsigned char*  cellPhase;  // (w * h) x 4: radial / nx*ny phases
+
+    void*           block;      // single allocation backing the arrays above
+};
+
+// Init-only: allocates and builds the per-pixel phase tables.
+bool PlasmaTex_Init(PlasmaTexField* f, int w, int h);
+void PlasmaTex_Free(PlasmaTexField* f);
+
+// Per-frame: palette index per pixel (0..255), rows dstPitch bytes apart.
+void PlasmaTex_Eval(PlasmaTexField* f, float t, unsigned char* dst, int dstPitch);
+
+// Index -> 32-bit color through a 256-entry palette (e.g. into a locked
+// linear texture).
+void PlasmaTex_Expand(const unsigned char* src, int srcPitch, int w, int h,
+                      const unsigned int* palette, void* dst, int dstPitch);
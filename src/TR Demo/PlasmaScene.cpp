@@ -1,11 +1,20 @@
 ﻿// PlasmaScene.cpp - Fullscreen vertex-colored plasma (DX8 / NV2A)
 // Swirly plasma field with camera drift (zoom + rotation).
 // This version precomputes deformed vertices to avoid strip seams.
+// Field evaluation lives in PlasmaKernel (separable terms, SSE).
+// Texture mode: per-pixel index field -> palette -> one fullscreen quad.
 
 #include "PlasmaScene.h"
+#include "PlasmaKernel.h"
+#include "input.h"
+#include "clock.h"
+#include "devstate.h"
+#include "vring.h"
+#include "music.h"
 
 #include <xtl.h>
 #include <math.h>
+#include <stdlib.h>
 
 // Device provided by main.cpp (same as IntroScene)
 extern LPDIRECT3DDEVICE8 g_pDevice;
@@ -43,9 +52,54 @@ static PlasmaVertex s_deformed[GRID_Y][GRID_X];
 // Strip buffer for one row pair
 static PlasmaVertex s_strip[GRID_X * 2];
 
+// Field evaluator + per-frame band indices (0..15)
+static PlasmaField   s_field;
+static unsigned char s_bands[GRID_Y * GRID_X];
+
+// Wobble terms (deform pass is separable in i/j)
+static float s_wobColSin[GRID_X];
+static float s_wobColCos[GRID_X];
+static float s_wobRowSin[GRID_Y];
+static float s_wobRowCos[GRID_Y];
+
+// -----------------------------------------------------------------------------
+// Texture mode
+// -----------------------------------------------------------------------------
+
+// Per-pixel field size (scaled up 2x by the quad).
+static const int TEX_W = 320;
+static const int TEX_H = 240;
+
+// Two textures so we never lock the one the GPU is still reading.
+static const int TEX_COUNT = 2;
+
+struct PlasmaTexVertex
+{
+    float x, y, z, rhw;
+    DWORD color;
+    float u, v;
+};
+
+#define PLASMA_TEX_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
+
+static PlasmaTexField     s_texField;
+static unsigned char*     s_texIndex = NULL;                // TEX_W * TEX_H
+static LPDIRECT3DTEXTURE8 s_tex[TEX_COUNT] = { NULL, NULL };
+static int                s_texCurrent = 0;
+static bool               s_texReady = false;
+
+static PlasmaMode s_mode = PLASMA_MODE_GRID;
+static WORD       s_lastButtons = 0;
+
 static bool s_plasmaActive = false;
 static int  s_frameCount = 0;
 
+// Prepare's tables (field, per-pixel phases, palettes) are built; Init
+// consumes them
+static bool s_prepared = false;
+static bool s_fieldReady = false;
+static bool s_texTablesReady = false;
+
 // -----------------------------------------------------------------------------
 // Palettes
 // -----------------------------------------------------------------------------
@@ -77,10 +131,121 @@ static const DWORD s_paletteGreen[5] =
     D3DCOLOR_XRGB(255,255,255)
 };
 
+static const DWORD* const s_palettes[3] =
+{
+    s_paletteBlue,
+    s_paletteMagenta,
+    s_paletteGreen
+};
+
+// 16 bands per palette, pre-interpolated (replaces per-vertex blend)
+static DWORD s_bandColor[3][16];
+
+// 256-entry texture palettes (index >> 4 = band)
+static DWORD s_texPalette[3][256];
+
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
 
+static void BuildBandColors()
+{
+    for (int p = 0; p < 3; ++p)
+    {
+        const DWORD* pal = s_palettes[p];
+
+        for (int band = 0; band < 16; ++band)
+        {
+            // Map 16 bands to 5 palette colors with interpolation
+            int palidx = band >> 2; // band / 4 = 0..3
+            int subband = band & 3; // band % 4 = 0..3
+
+            if (palidx > 3) palidx = 3;
+            int palidx1 = palidx + 1;
+            if (palidx1 > 4) palidx1 = 4;
+
+            DWORD c0 = pal[palidx];
+            DWORD c1 = pal[palidx1];
+
+            int red0 = (c0 >> 16) & 0xFF;
+            int red1 = (c1 >> 16) & 0xFF;
+            int grn0 = (c0 >> 8) & 0xFF;
+            int grn1 = (c1 >> 8) & 0xFF;
+            int blu0 = c0 & 0xFF;
+            int blu1 = c1 & 0xFF;
+
+            // subband is 0..3, convert to 0, 64, 128, 192 for blending
+            int blend256 = subband << 6;
+
+            int red = red0 + (((red1 - red0) * blend256) >> 8);
+            int grn = grn0 + (((grn1 - grn0) * blend256) >> 8);
+            int blu = blu0 + (((blu1 - blu0) * blend256) >> 8);
+
+            s_bandColor[p][band] = 0xFF000000 | (red << 16) | (grn << 8) | blu;
+        }
+
+        for (int i = 0; i < 256; ++i)
+            s_texPalette[p][i] = s_bandColor[p][i >> 4];
+    }
+}
+
+static void ReleaseTextureMode()
+{
+    for (int i = 0; i < TEX_COUNT; ++i)
+    {
+        if (s_tex[i])
+        {
+            s_tex[i]->Release();
+            s_tex[i] = NULL;
+        }
+    }
+
+    s_texReady = false;
+}
+
+static void FreeTables()
+{
+    PlasmaField_Free(&s_field);
+
+    if (s_texIndex)
+    {
+        free(s_texIndex);
+        s_texIndex = NULL;
+    }
+
+    PlasmaTex_Free(&s_texField);
+
+    s_fieldReady = false;
+    s_texTablesReady = false;
+}
+
+// Device half of texture mode, on top of Prepare's tables
+static bool InitTextureMode()
+{
+    ReleaseTextureMode();
+
+    if (!s_texTablesReady)
+        return false;
+
+    // Linear (unswizzled) so the CPU can write rows straight in.
+    for (int i = 0; i < TEX_COUNT; ++i)
+    {
+        if (FAILED(g_pDevice->CreateTexture(
+            TEX_W, TEX_H, 1, 0,
+            D3DFMT_LIN_X8R8G8B8,
+            0,
+            &s_tex[i])))
+        {
+            ReleaseTextureMode();
+            return false;
+        }
+    }
+
+    s_texCurrent = 0;
+    s_texReady = true;
+    return true;
+}
+
 static void InitGridPositions()
 {
     float dx = SCREEN_W / (float)(GRID_X - 1);
@@ -107,124 +272,163 @@ static void InitGridPositions()
 // Update colors based on time & position.
 static void UpdatePlasmaColors(float t, int palettePhase)
 {
-    const DWORD* pal;
-    switch (palettePhase)
-    {
-    default:
-    case 0: pal = s_paletteBlue;    break;
-    case 1: pal = s_paletteMagenta; break;
-    case 2: pal = s_paletteGreen;   break;
-    }
+    if (palettePhase < 0 || palettePhase > 2)
+        palettePhase = 0;
+
+    const DWORD* lut = s_bandColor[palettePhase];
 
-    const float sx = 4.0f / (float)(GRID_X - 1);
-    const float sy = 4.0f / (float)(GRID_Y - 1);
+    PlasmaField_EvalBands(&s_field, t, s_bands);
 
+    const unsigned char* b = s_bands;
     for (int j = 0; j < GRID_Y; ++j)
     {
-        float ny = (float)j * sy - 2.0f;
-
         for (int i = 0; i < GRID_X; ++i)
-        {
-            float nx = (float)i * sx - 2.0f;
-
-            // Dense, chaotic demo-scene style plasma
-            // Lots of high-frequency sine waves creating tight ripples
-            float v =
-                sinf(nx * 5.0f + t * 1.2f) +
-                cosf(ny * 5.0f - t * 1.5f) +
-                sinf((nx + ny) * 4.0f + t * 0.8f) +
-                cosf((nx - ny) * 4.5f - t * 1.0f) +
-                sinf(nx * 6.5f + ny * 3.5f + t * 1.3f) +
-                cosf(nx * 3.0f - ny * 6.0f - t * 0.9f) +
-                sinf(sqrtf(nx * nx + ny * ny) * 7.0f + t * 1.1f) +
-                cosf(sqrtf((nx - 0.5f) * (nx - 0.5f) + (ny + 0.3f) * (ny + 0.3f)) * 6.0f - t * 1.4f) +
-                sinf(sqrtf((nx + 0.7f) * (nx + 0.7f) + (ny - 0.6f) * (ny - 0.6f)) * 5.5f + t * 0.7f);
-
-            // Add rotating wave patterns
-            float angle = t * 0.5f;
-            float rx1 = nx * cosf(angle) - ny * sinf(angle);
-            float ry1 = nx * sinf(angle) + ny * cosf(angle);
-            v += cosf(rx1 * 4.5f + ry1 * 3.5f + t * 0.6f);
-
-            float angle2 = t * -0.7f + 1.5f;
-            float rx2 = nx * cosf(angle2) - ny * sinf(angle2);
-            float ry2 = nx * sinf(angle2) + ny * cosf(angle2);
-            v += sinf(rx2 * 5.5f - ry2 * 4.0f - t * 0.8f);
-
-            // Interference patterns
-            v += sinf(nx * ny * 3.0f + t);
-            v += cosf((nx + sinf(t * 0.3f)) * 7.0f);
-            v += sinf((ny + cosf(t * 0.4f)) * 7.0f);
-            v += cosf((nx * 3.0f + ny * 2.0f) * sinf(t * 0.2f) + t * 1.5f);
-
-            // Smoother color bands (16 bands instead of 5 for less chunky look)
-            int band;
-            if (v > 2.625f)      band = 15;
-            else if (v > 2.25f)  band = 14;
-            else if (v > 1.875f) band = 13;
-            else if (v > 1.5f)   band = 12;
-            else if (v > 1.125f) band = 11;
-            else if (v > 0.75f)  band = 10;
-            else if (v > 0.375f) band = 9;
-            else if (v > 0.0f)   band = 8;
-            else if (v > -0.375f) band = 7;
-            else if (v > -0.75f)  band = 6;
-            else if (v > -1.125f) band = 5;
-            else if (v > -1.5f)   band = 4;
-            else if (v > -1.875f) band = 3;
-            else if (v > -2.25f)  band = 2;
-            else if (v > -2.625f) band = 1;
-            else                  band = 0;
+            s_grid[j][i].color = lut[*b++];
+    }
+}
 
-            // Map 16 bands to 5 palette colors with interpolation
-            int palidx = band >> 2; // band / 4 = 0..3
-            int subband = band & 3; // band % 4 = 0..3
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
 
-            if (palidx > 3) palidx = 3;
-            int palidx1 = palidx + 1;
-            if (palidx1 > 4) palidx1 = 4;
+void PlasmaScene_Prepare()
+{
+    if (s_prepared)
+        return;
 
-            // Interpolate between palette colors
-            DWORD c0 = pal[palidx];
-            DWORD c1 = pal[palidx1];
+    FreeTables();
 
-            int red0 = (c0 >> 16) & 0xFF;
-            int red1 = (c1 >> 16) & 0xFF;
-            int grn0 = (c0 >> 8) & 0xFF;
-            int grn1 = (c1 >> 8) & 0xFF;
-            int blu0 = c0 & 0xFF;
-            int blu1 = c1 & 0xFF;
+    s_fieldReady = PlasmaField_Init(&s_field, GRID_X, GRID_Y);
 
-            // subband is 0..3, convert to 0, 64, 128, 192 for blending
-            int blend256 = subband << 6;
+    s_texIndex = (unsigned char*)malloc(TEX_W * TEX_H);
+    s_texTablesReady = s_texIndex && PlasmaTex_Init(&s_texField, TEX_W, TEX_H);
 
-            int red = red0 + (((red1 - red0) * blend256) >> 8);
-            int grn = grn0 + (((grn1 - grn0) * blend256) >> 8);
-            int blu = blu0 + (((blu1 - blu0) * blend256) >> 8);
+    InitGridPositions();
+    BuildBandColors();
 
-            s_grid[j][i].color = 0xFF000000 | (red << 16) | (grn << 8) | blu;
-        }
-    }
+    s_prepared = true;
 }
 
-// -----------------------------------------------------------------------------
-// Public API
-// -----------------------------------------------------------------------------
-
 void PlasmaScene_Init()
 {
     if (!g_pDevice)
         return;
 
+    // Normally done already, on the loader thread at startup
+    PlasmaScene_Prepare();
+    s_prepared = false;
+
+    if (!s_fieldReady)
+        return;
+
     s_plasmaActive = true;
     s_frameCount = 0;
 
-    InitGridPositions();
+    // Falls back to the vertex grid if the textures can't be created.
+    InitTextureMode();
+    s_lastButtons = GetButtons();
 }
 
 void PlasmaScene_Shutdown()
 {
     s_plasmaActive = false;
+    s_prepared = false;
+
+    ReleaseTextureMode();
+    FreeTables();
+}
+
+void PlasmaScene_SetMode(PlasmaMode mode)
+{
+    s_mode = mode;
+}
+
+PlasmaMode PlasmaScene_GetMode()
+{
+    return s_mode;
+}
+
+void PlasmaScene_Update()
+{
+    WORD buttons = GetButtons();
+
+    // Y button - toggle vertex grid / texture mode
+    if ((buttons & BTN_Y) && !(s_lastButtons & BTN_Y))
+        s_mode = (s_mode == PLASMA_MODE_TEXTURE) ? PLASMA_MODE_GRID : PLASMA_MODE_TEXTURE;
+
+    s_lastButtons = buttons;
+}
+
+// Per-pixel field into the next texture, drawn as one quad under the camera.
+static void RenderTextureMode(float t, int palettePhase, float zoom, float ca, float sa)
+{
+    if (palettePhase < 0 || palettePhase > 2)
+        palettePhase = 0;
+
+    PlasmaTex_Eval(&s_texField, t, s_texIndex, TEX_W);
+
+    s_texCurrent = (s_texCurrent + 1) % TEX_COUNT;
+    LPDIRECT3DTEXTURE8 tex = s_tex[s_texCurrent];
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
+        return;
+
+    PlasmaTex_Expand(s_texIndex, TEX_W, TEX_W, TEX_H,
+        (const unsigned int*)s_texPalette[palettePhase], lr.pBits, lr.Pitch);
+
+    tex->UnlockRect(0);
+
+    const float cx = SCREEN_W * 0.5f;
+    const float cy = SCREEN_H * 0.5f;
+
+    // Linear textures take texel coordinates, not 0..1.
+    static const float corner[4][4] =
+    {
+        { 0.0f,     0.0f,     0.0f,         0.0f         },
+        { SCREEN_W, 0.0f,     (float)TEX_W, 0.0f         },
+        { 0.0f,     SCREEN_H, 0.0f,         (float)TEX_H },
+        { SCREEN_W, SCREEN_H, (float)TEX_W, (float)TEX_H },
+    };
+
+    PlasmaTexVertex q[4];
+    for (int k = 0; k < 4; ++k)
+    {
+        float tx = (corner[k][0] - cx) * zoom;
+        float ty = (corner[k][1] - cy) * zoom;
+
+        q[k].x = tx * ca - ty * sa + cx;
+        q[k].y = tx * sa + ty * ca + cy;
+        q[k].z = 0.0f;
+        q[k].rhw = 1.0f;
+        q[k].color = 0xFFFFFFFF;
+        q[k].u = corner[k][2];
+        q[k].v = corner[k][3];
+    }
+
+    DevState_SetTexture(0, tex);
+    DevState_SetVertexShader(PLASMA_TEX_FVF);
+
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+
+    DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+    DevState_SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+    DevState_SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(PlasmaTexVertex));
+
+    DevState_SetTexture(0, NULL);
 }
 
 // This scene assumes main.cpp owns Clear / BeginScene / EndScene / Present.
@@ -238,9 +442,13 @@ void PlasmaScene_Render(float demoTime)
     s_frameCount++;
 
     float t = (float)s_frameCount * 0.06f;
-    int palettePhase = (s_frameCount / 120) % 3;
 
-    UpdatePlasmaColors(t, palettePhase);
+    // Next palette every four beats while the music has a tempo, else every
+    // 120 frames (and always in synthetic-clock perf runs)
+    MusicBeat beat;
+    Music_GetBeat(&beat);
+    int palettePhase = (beat.bpm && !Clock_IsSynthetic()) ? (int)((beat.beats / 4) % 3)
+                                                          : (s_frameCount / 120) % 3;
 
     // Camera motion
     float zoom = 1.0f + 0.06f * sinf(t * 0.25f);
@@ -248,28 +456,55 @@ void PlasmaScene_Render(float demoTime)
     float ca = cosf(angle);
     float sa = sinf(angle);
 
+    if (s_mode == PLASMA_MODE_TEXTURE && s_texReady)
+    {
+        RenderTextureMode(t, palettePhase, zoom, ca, sa);
+        return;
+    }
+
+    UpdatePlasmaColors(t, palettePhase);
+
     const float cx = SCREEN_W * 0.5f;
     const float cy = SCREEN_H * 0.5f;
 
     // -------------------------------------------------------------------------
     // 1) Compute deformed vertices ONCE into s_deformed
+    //    sin(pX + pY) / cos(pX - pY) split into per-column and per-row terms.
     // -------------------------------------------------------------------------
+    const float offX = sinf(t * 0.5f);
+    const float offY = cosf(t * 0.37f);
+
+    for (int i = 0; i < GRID_X; ++i)
+    {
+        float nx = ((float)i / (float)(GRID_X - 1)) * 2.0f - 1.0f;
+        float phaseX = nx * 3.1f + offX;
+        s_wobColSin[i] = sinf(phaseX);
+        s_wobColCos[i] = cosf(phaseX);
+    }
+
     for (int j = 0; j < GRID_Y; ++j)
     {
         float ny = ((float)j / (float)(GRID_Y - 1)) * 2.0f - 1.0f;
+        float phaseY = ny * 2.7f + offY;
+        s_wobRowSin[j] = sinf(phaseY);
+        s_wobRowCos[j] = cosf(phaseY);
+    }
+
+    for (int j = 0; j < GRID_Y; ++j)
+    {
+        const float sY = s_wobRowSin[j];
+        const float cY = s_wobRowCos[j];
 
         for (int i = 0; i < GRID_X; ++i)
         {
             const PlasmaVertex& src = s_grid[j][i];
             PlasmaVertex        v = src;
 
-            float nx = ((float)i / (float)(GRID_X - 1)) * 2.0f - 1.0f;
-
-            float phaseX = nx * 3.1f + sinf(t * 0.5f);
-            float phaseY = ny * 2.7f + cosf(t * 0.37f);
+            const float sX = s_wobColSin[i];
+            const float cX = s_wobColCos[i];
 
-            float wobbleY = sinf(phaseX + phaseY) * 4.0f;
-            float wobbleX = cosf(phaseX - phaseY) * 3.0f;
+            float wobbleY = (sX * cY + cX * sY) * 4.0f;
+            float wobbleX = (cX * cY + sX * sY) * 3.0f;
 
             v.y += wobbleY;
             v.x += wobbleX;
@@ -294,14 +529,14 @@ void PlasmaScene_Render(float demoTime)
     // -------------------------------------------------------------------------
     // 2) Render using triangle strips built from s_deformed
     // -------------------------------------------------------------------------
-    g_pDevice->SetVertexShader(PLASMA_FVF);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetVertexShader(PLASMA_FVF);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
     for (int j = 0; j < GRID_Y - 1; ++j)
     {
@@ -313,7 +548,7 @@ void PlasmaScene_Render(float demoTime)
             s_strip[idx++] = s_deformed[j + 1][i];
         }
 
-        g_pDevice->DrawPrimitiveUP(
+        VRing_DrawUP(
             D3DPT_TRIANGLESTRIP,
             (GRID_X * 2) - 2,
             s_strip,
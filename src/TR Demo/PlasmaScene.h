@@ -3,6 +3,21 @@
 // Simple NV2A plasma scene using vertex-colored grid.
 // API matches IntroScene style.
 
+// CPU-only setup (field tables, palettes); safe on a loader thread. Init
+// calls it itself if it hasn't run.
+void PlasmaScene_Prepare();
 void PlasmaScene_Init();
 void PlasmaScene_Shutdown();
 void PlasmaScene_Render(float demoTime);
+
+// Vertex-colored grid (default), or per-pixel field in a CPU-written texture.
+// Y toggles between them while the scene is running.
+enum PlasmaMode
+{
+    PLASMA_MODE_GRID = 0,
+    PLASMA_MODE_TEXTURE
+};
+
+void PlasmaScene_Update();
+void PlasmaScene_SetMode(PlasmaMode mode);
+PlasmaMode PlasmaScene_GetMode();
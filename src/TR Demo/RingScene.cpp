@@ -4,6 +4,9 @@
 // Textured ring uses D:\metal.dds
 
 #include "RingScene.h"
+#include "devstate.h"
+#include "texcache.h"
+#include "vring.h"
 #include <xtl.h>
 #include <xgraphics.h>
 #include <math.h>
@@ -215,13 +218,13 @@ static void DrawSphericalLattice(float t)
     const DWORD COL = D3DCOLOR_ARGB(70, 0, 255, 0); // faint Xbox green
 
     // Ensure this is treated as pure background (no depth)
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(FVF_LATTICE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_LATTICE);
 
     // World rotation for the whole lattice
     D3DXMATRIX mRotY;
@@ -257,7 +260,7 @@ static void DrawSphericalLattice(float t)
             verts[lon].color = COL;
         }
 
-        g_pDevice->DrawPrimitiveUP(
+        VRing_DrawUP(
             D3DPT_LINESTRIP,
             LON_LINES,
             verts,
@@ -292,7 +295,7 @@ static void DrawSphericalLattice(float t)
             verts[lat].color = COL;
         }
 
-        g_pDevice->DrawPrimitiveUP(
+        VRing_DrawUP(
             D3DPT_LINESTRIP,
             LAT_LINES,
             verts,
@@ -312,22 +315,15 @@ void RingScene_Init()
 
     CreateTorusMesh(1.2f, 0.4f, 48, 24);
 
-    // Load metal texture from disc
-    if (s_tex)
-    {
-        s_tex->Release();
-        s_tex = nullptr;
-    }
-
-    if (FAILED(D3DXCreateTextureFromFileA(g_pDevice, "D:\\tex\\metal.dds", &s_tex)))
-    {
-        s_tex = nullptr; // still runs even if texture is missing
-    }
+    // Metal texture, tiled 4x round the torus: full mip chain (from the
+    // pack, or box-filtered at load). Still runs if it's missing.
+    TexCache_Release(s_tex);
+    s_tex = TexCache_Acquire("D:\\tex\\metal.dds", TEXCACHE_ALL_LEVELS, NULL, NULL);
 
     // Texture filtering for the metal ring
-    g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_LINEAR);
 }
 
 void RingScene_Shutdown()
@@ -336,7 +332,8 @@ void RingScene_Shutdown()
 
     if (s_vb) { s_vb->Release();  s_vb = nullptr; }
     if (s_ib) { s_ib->Release();  s_ib = nullptr; }
-    if (s_tex) { s_tex->Release(); s_tex = nullptr; }
+    TexCache_Release(s_tex);
+    s_tex = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -394,19 +391,19 @@ void RingScene_Render(float demoTime)
 
     const float RING_OFFSET = 1.8f; // left/right spacing
 
-    g_pDevice->SetStreamSource(0, s_vb, sizeof(TorusVertex));
-    g_pDevice->SetIndices(s_ib, 0);
-    g_pDevice->SetVertexShader(FVF_TORUS);
+    DevState_SetStreamSource(0, s_vb, sizeof(TorusVertex));
+    DevState_SetIndices(s_ib, 0);
+    DevState_SetVertexShader(FVF_TORUS);
 
     // Reset basic texture stage
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_DIFFUSE);
 
     // *** Ring 1 - WIREFRAME (left) ***
     {
-        g_pDevice->SetRenderState(D3DRS_FILLMODE, D3DFILL_WIREFRAME);
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        g_pDevice->SetTexture(0, NULL);
+        DevState_SetRenderState(D3DRS_FILLMODE, D3DFILL_WIREFRAME);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        DevState_SetTexture(0, NULL);
 
         D3DXMATRIX mRot, mTrans, mWorld;
         D3DXMatrixRotationY(&mRot, t * 1.5f);
@@ -425,16 +422,16 @@ void RingScene_Render(float demoTime)
     {
         DWORD rgb = MakeRgbCycle(s_tick * 2);
 
-        g_pDevice->SetRenderState(D3DRS_FILLMODE, D3DFILL_SOLID);
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
-        g_pDevice->SetTexture(0, NULL);
+        DevState_SetRenderState(D3DRS_FILLMODE, D3DFILL_SOLID);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+        DevState_SetTexture(0, NULL);
 
         // Use texture factor as the color source
-        g_pDevice->SetRenderState(D3DRS_TEXTUREFACTOR, rgb);
-        g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-        g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TFACTOR);
+        DevState_SetRenderState(D3DRS_TEXTUREFACTOR, rgb);
+        DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+        DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TFACTOR);
 
         float scale = 1.1f;
         D3DXMATRIX mScale, mRot, mWorld;
@@ -451,15 +448,15 @@ void RingScene_Render(float demoTime)
     }
 
     // Restore stage for textured ring
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
 
     // *** Ring 3 - TEXTURED GLOW (right, metal.dds) ***
     {
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
-        g_pDevice->SetTexture(0, s_tex);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);
+        DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+        DevState_SetTexture(0, s_tex);
 
         D3DXMATRIX mRotY, mRotZ, mTrans, mWorldTmp, mWorld;
         D3DXMatrixRotationY(&mRotY, t * 0.5f);
@@ -495,13 +492,13 @@ void RingScene_Render(float demoTime)
             {640,480,   0,1, col }
         };
 
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-        g_pDevice->SetTexture(0, NULL);
-        g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+        DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        DevState_SetTexture(0, NULL);
+        DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
 
-        g_pDevice->DrawPrimitiveUP(
+        VRing_DrawUP(
             D3DPT_TRIANGLESTRIP,
             2, q, sizeof(QuadV));
     }
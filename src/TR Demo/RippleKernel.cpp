@@ -0,0 +1,250 @@
+// RippleKernel.cpp - DripScene ripple step (MMX + scalar reference)
+//
+// MMX plus the SSE1 integer extensions (pmaxsw, pminsw, pmovmskb) only, so it
+// runs on the Xbox P3. The damping multiply is done as
+// next + pmulhw(next, (damp - 256) * 256): for integer next,
+// floor(next * damp / 256) == next + floor(next * (damp - 256) / 256), and
+// pmulhw floors like the scalar >> 8.
+
+#include "RippleKernel.h"
+
+#if defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RIPPLE_MMX 1
+#else
+#define RIPPLE_MMX 0
+#endif
+
+// -----------------------------------------------------------------------------
+// Scalar
+// -----------------------------------------------------------------------------
+
+// Returns max |p| written.
+static __inline int StepRowScalar(const short* c, short* p, int w, int x0, int x1, int damp)
+{
+    int peak = 0;
+
+    for (int x = x0; x < x1; ++x)
+    {
+        int n =
+            c[x - 1] +
+            c[x + 1] +
+            c[x - w] +
+            c[x + w];
+
+        int next = (n >> 1) - p[x];
+        p[x] = (short)((next * damp) >> 8);
+
+        int a = p[x] < 0 ? -p[x] : p[x];
+        if (a > peak) peak = a;
+    }
+
+    return peak;
+}
+
+// Returns max splash left.
+static __inline int DecaySplashScalar(short* s, int x0, int x1)
+{
+    int peak = 0;
+
+    for (int x = x0; x < x1; ++x)
+    {
+        if (s[x] > 0)
+            s[x] -= (s[x] >> 2) + 1;
+
+        if (s[x] > peak) peak = s[x];
+    }
+
+    return peak;
+}
+
+void Ripple_StepRef(const short* cur, short* prev, short* splash,
+                    int w, int h, int damp)
+{
+    for (int y = 1; y < h - 1; ++y)
+    {
+        int row = y * w;
+        for (int x = 1; x < w - 1; ++x)
+        {
+            int i = row + x;
+            int n =
+                cur[i - 1] +
+                cur[i + 1] +
+                cur[i - w] +
+                cur[i + w];
+
+            int next = (n >> 1) - prev[i];
+            prev[i] = (short)((next * damp) >> 8);
+        }
+    }
+
+    for (int i = 0; i < w * h; ++i)
+        if (splash[i] > 0)
+            splash[i] -= (splash[i] >> 2) + 1;
+}
+
+// -----------------------------------------------------------------------------
+// Fused step
+// -----------------------------------------------------------------------------
+
+void Ripple_Step(const short* cur, short* prev, short* splash, int w, int h,
+                 int damp, int x0, int y0, int x1, int y1,
+                 RipplePeak* peak, RippleStats* stats)
+{
+    if (peak)
+    {
+        peak->wave = 0;
+        peak->splash = 0;
+    }
+
+    if (!cur || !prev || !splash || w < 3 || h < 3)
+        return;
+
+    // Splash rect: clipped to the grid. Wave rect: also off the borders.
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > w) x1 = w;
+    if (y1 > h) y1 = h;
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    const int wx0 = x0 > 1 ? x0 : 1;
+    const int wx1 = x1 < w - 1 ? x1 : w - 1;
+    const int wy0 = y0 > 1 ? y0 : 1;
+    const int wy1 = y1 < h - 1 ? y1 : h - 1;
+
+    int wavePeak = 0;
+    int splashPeak = 0;
+    int scalarCells = 0;
+
+#if RIPPLE_MMX
+    const bool simd = (damp >= 128 && damp <= 256);
+#else
+    const bool simd = false;
+#endif
+
+    if (simd)
+    {
+#if RIPPLE_MMX
+        const __m64 vDamp = _mm_set1_pi16((short)((damp - 256) * 256));
+        const __m64 vZero = _mm_setzero_si64();
+        const __m64 vOne = _mm_set1_pi16(1);
+        const __m64 vTop = _mm_set1_pi16(32767);
+        const __m64 vBot = _mm_set1_pi16(-32768);
+
+        __m64 vMax = vZero;
+        __m64 vMin = vZero;
+        __m64 vSplash = vZero;
+
+        for (int y = y0; y < y1; ++y)
+        {
+            const int row = y * w;
+
+            // Wave equation
+            if (y >= wy0 && y < wy1)
+            {
+                const short* c = cur + row;
+                short* p = prev + row;
+
+                int x = wx0;
+                for (; x + 4 <= wx1; x += 4)
+                {
+                    __m64 l = *(const __m64*)(c + x - 1);
+                    __m64 r = *(const __m64*)(c + x + 1);
+                    __m64 u = *(const __m64*)(c + x - w);
+                    __m64 d = *(const __m64*)(c + x + w);
+
+                    __m64 lr = _mm_adds_pi16(l, r);
+                    __m64 ud = _mm_adds_pi16(u, d);
+                    __m64 n = _mm_adds_pi16(lr, ud);
+                    __m64 next = _mm_subs_pi16(_mm_srai_pi16(n, 1), *(const __m64*)(p + x));
+
+                    // Any lane pinned at a limit may have saturated.
+                    __m64 hi = _mm_max_pi16(_mm_max_pi16(lr, ud), _mm_max_pi16(n, next));
+                    __m64 lo = _mm_min_pi16(_mm_min_pi16(lr, ud), _mm_min_pi16(n, next));
+                    __m64 hit = _mm_or_si64(_mm_cmpeq_pi16(hi, vTop), _mm_cmpeq_pi16(lo, vBot));
+
+                    if (_mm_movemask_pi8(hit))
+                    {
+                        int a = StepRowScalar(c, p, w, x, x + 4, damp);
+                        if (a > wavePeak) wavePeak = a;
+                        scalarCells += 4;
+                        continue;
+                    }
+
+                    __m64 out = _mm_add_pi16(next, _mm_mulhi_pi16(next, vDamp));
+                    *(__m64*)(p + x) = out;
+
+                    vMax = _mm_max_pi16(vMax, out);
+                    vMin = _mm_min_pi16(vMin, out);
+                }
+
+                int a = StepRowScalar(c, p, w, x, wx1, damp);
+                if (a > wavePeak) wavePeak = a;
+                scalarCells += wx1 - x;
+            }
+
+            // Splash decay
+            short* s = splash + row;
+
+            int x = x0;
+            for (; x + 4 <= x1; x += 4)
+            {
+                __m64 v = *(const __m64*)(s + x);
+                __m64 live = _mm_cmpgt_pi16(v, vZero);
+                __m64 dec = _mm_add_pi16(_mm_srai_pi16(v, 2), vOne);
+                v = _mm_sub_pi16(v, _mm_and_si64(dec, live));
+                *(__m64*)(s + x) = v;
+
+                vSplash = _mm_max_pi16(vSplash, v);
+            }
+
+            int a = DecaySplashScalar(s, x, x1);
+            if (a > splashPeak) splashPeak = a;
+        }
+
+        union { __m64 v; short s[4]; } hi, lo, sp;
+        hi.v = vMax;
+        lo.v = vMin;
+        sp.v = vSplash;
+        _mm_empty();
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (hi.s[k] > wavePeak) wavePeak = hi.s[k];
+            if (-(int)lo.s[k] > wavePeak) wavePeak = -(int)lo.s[k];
+            if (sp.s[k] > splashPeak) splashPeak = sp.s[k];
+        }
+#endif
+    }
+    else
+    {
+        for (int y = y0; y < y1; ++y)
+        {
+            const int row = y * w;
+
+            if (y >= wy0 && y < wy1)
+            {
+                int a = StepRowScalar(cur + row, prev + row, w, wx0, wx1, damp);
+                if (a > wavePeak) wavePeak = a;
+                scalarCells += wx1 - wx0;
+            }
+
+            int a = DecaySplashScalar(splash + row, x0, x1);
+            if (a > splashPeak) splashPeak = a;
+        }
+    }
+
+    if (peak)
+    {
+        peak->wave = wavePeak;
+        peak->splash = splashPeak;
+    }
+
+    if (stats)
+    {
+        if (wx0 < wx1 && wy0 < wy1)
+            stats->cells += (wx1 - wx0) * (wy1 - wy0);
+        stats->scalarCells += scalarCells;
+    }
+}
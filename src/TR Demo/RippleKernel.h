@@ -0,0 +1,36 @@
+#pragma once
+// RippleKernel.h - Platform-neutral int16 ripple solver (no D3D / xtl).
+//
+// One step of the DripScene 4-neighbour wave equation plus the splash decay,
+// fused into a single sweep:
+//
+//   prev[i]   = (((cur[l] + cur[r] + cur[u] + cur[d]) >> 1) - prev[i]) * damp >> 8
+//   splash[i] -= splash[i] > 0 ? (splash[i] >> 2) + 1 : 0
+//
+// The MMX path does 4 cells per instruction in 16-bit lanes with saturating
+// adds. A group whose intermediates hit the int16 limits (e.g. next to the
+// undamped border cells) is done with the scalar loop instead, so the result
+// is bit-exact with Ripple_StepRef for any input.
+
+struct RippleStats
+{
+    int cells;          // interior cells stepped
+    int scalarCells;    // of those, done in scalar (overflow / tail / no SIMD)
+};
+
+struct RipplePeak
+{
+    int wave;           // max |prev| over the stepped cells, after the step
+    int splash;         // max splash over the rect, after the decay
+};
+
+// Steps the cells of prev inside [x0, x1) x [y0, y1) (grid borders are never
+// written) and decays splash over the same rect. Pass 0, 0, w, h for the
+// whole grid. peak and stats may be NULL; stats accumulate across calls.
+void Ripple_Step(const short* cur, short* prev, short* splash, int w, int h,
+                 int damp, int x0, int y0, int x1, int y1,
+                 RipplePeak* peak, RippleStats* stats);
+
+// Reference: the original scalar loops (whole grid), for equivalence checks.
+void Ripple_StepRef(const short* cur, short* prev, short* splash,
+                    int w, int h, int damp);
@@ -12,6 +12,9 @@
 #include <string.h>
 
 #include "music.h"
+#include "clock.h"
+#include "devstate.h"
+#include "vring.h"
 
 extern LPDIRECT3DDEVICE8 g_pDevice;
 
@@ -32,7 +35,7 @@ struct Vtx2D
 };
 #define FVF_2D (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
 
-static DWORD TimeMs() { return GetTickCount() - s_startTicks; }
+static DWORD TimeMs() { return Clock_Ms() - s_startTicks; }
 
 static float ClampF(float v, float lo, float hi)
 {
@@ -54,18 +57,18 @@ static void DrawRect(float x0, float y0, float x1, float y1, DWORD c)
         { x1, y1, 0.0f, 1.0f, c },
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(FVF_2D);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_2D);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
 }
 
 // Draw a thick line as a thin quad (screen space)
@@ -94,18 +97,18 @@ static void DrawLineThick(float x0, float y0, float x1, float y1, float thicknes
         { x1 + ox, y1 + oy, 0.0f, 1.0f, c },
     };
 
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetVertexShader(FVF_2D);
+    DevState_SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_2D);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, q, sizeof(Vtx2D));
 }
 
 // Letter defined as a set of line segments in normalized 0..1 box
@@ -255,16 +258,16 @@ static void DrawLetterFillConforming(const Seg* segs, int segCount,
 
 static void SetupFrameStates()
 {
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetTexture(0, NULL);
 }
 
 void UVRXDKScene_Init()
 {
     s_active = true;
-    s_startTicks = GetTickCount();
+    s_startTicks = Clock_Ms();
 }
 
 void UVRXDKScene_Shutdown()
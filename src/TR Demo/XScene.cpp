@@ -18,6 +18,10 @@
 #include <math.h>
 
 #include "music.h"
+#include "clock.h"
+#include "devstate.h"
+#include "texcache.h"
+#include "vring.h"
 
 extern LPDIRECT3DDEVICE8 g_pDevice;
 
@@ -303,7 +307,7 @@ static void BuildFX()
 {
     if (s_fxBuilt) return;
 
-    s_rng ^= GetTickCount();
+    s_rng ^= Clock_Ms();
 
     const float ZW = X_THICK_Z * 0.48f;
     const float BOUNDS = 3.7f;
@@ -362,24 +366,23 @@ static void LoadSmokeTexture()
     const char* p0 = "D:\\tex\\cloud_256.dds";
     const char* p1 = "tex\\cloud_256.dds";
 
-    if (FAILED(D3DXCreateTextureFromFileA(g_pDevice, p0, &s_smokeTex)))
-        D3DXCreateTextureFromFileA(g_pDevice, p1, &s_smokeTex);
+    // Same texture as the galaxy sprites; the cache keeps one copy
+    s_smokeTex = TexCache_Acquire(p0, TEXCACHE_ALL_LEVELS, NULL, NULL);
+    if (!s_smokeTex)
+        s_smokeTex = TexCache_Acquire(p1, TEXCACHE_ALL_LEVELS, NULL, NULL);
 }
 
 static void ReleaseSmokeTexture()
 {
-    if (s_smokeTex)
-    {
-        s_smokeTex->Release();
-        s_smokeTex = NULL;
-    }
+    TexCache_Release(s_smokeTex);
+    s_smokeTex = NULL;
 }
 
 static void BuildSmoke()
 {
     if (s_smokeBuilt) return;
 
-    s_rng ^= (GetTickCount() + 0x6D5A2B1u);
+    s_rng ^= (Clock_Ms() + 0x6D5A2B1u);
 
     const float ZW = X_THICK_Z * 0.49f;
     const float BOUNDS = 3.7f;
@@ -417,31 +420,36 @@ static void BuildSmoke()
 
 static void SetupSmokeStates()
 {
-    g_pDevice->SetVertexShader(FVF_SMOKE);
-    g_pDevice->SetTexture(0, s_smokeTex);
+    DevState_SetVertexShader(FVF_SMOKE);
+    DevState_SetTexture(0, s_smokeTex);
+
+    DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    DevState_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+    // Puffs shrink to a few pixels with distance: trilinear from the mips
+    DevState_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+    DevState_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_LINEAR);
 }
 
 static void EndSmokeStates()
 {
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetTexture(0, NULL);
 }
 
 // ------------------------------------------------------------
@@ -578,7 +586,7 @@ static void RenderSmoke(const D3DXMATRIX& world, DWORD tMs)
     if (v <= 0) return;
 
     SetupSmokeStates();
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, v / 3, s_smokeV, sizeof(SmokeVtx));
+    VRing_DrawUP(D3DPT_TRIANGLELIST, v / 3, s_smokeV, sizeof(SmokeVtx));
     EndSmokeStates();
 }
 
@@ -603,23 +611,23 @@ static void SetupCamera()
 
 static void SetupAdditiveLines()
 {
-    g_pDevice->SetVertexShader(FVF_3D);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetVertexShader(FVF_3D);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
 }
 
 static void EndAdditive()
 {
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
 }
 
 // ------------------------------------------------------------
@@ -646,7 +654,7 @@ static void DrawBladeOutline(const D3DXMATRIX& baseWorld, DWORD col, float scale
         D3DXMATRIX w = rz * baseWorld;
         g_pDevice->SetTransform(D3DTS_WORLD, &w);
 
-        g_pDevice->DrawPrimitiveUP(D3DPT_LINELIST, s_outlineVCount / 2, tmp, sizeof(Vtx3D));
+        VRing_DrawUP(D3DPT_LINELIST, s_outlineVCount / 2, tmp, sizeof(Vtx3D));
     }
 }
 
@@ -742,7 +750,7 @@ static void RenderInteriorFX(const D3DXMATRIX& world, DWORD tMs)
     }
 
     if (v > 1)
-        g_pDevice->DrawPrimitiveUP(D3DPT_LINELIST, v / 2, s_fxV, sizeof(Vtx3D));
+        VRing_DrawUP(D3DPT_LINELIST, v / 2, s_fxV, sizeof(Vtx3D));
 }
 
 // ------------------------------------------------------------
@@ -752,7 +760,7 @@ static void RenderInteriorFX(const D3DXMATRIX& world, DWORD tMs)
 void XScene_Init()
 {
     s_active = true;
-    s_startTicks = GetTickCount();
+    s_startTicks = Clock_Ms();
 
     BuildLUT();
     BuildU8();
@@ -771,7 +779,7 @@ void XScene_Shutdown()
 bool XScene_IsFinished()
 {
     if (!s_active) return true;
-    return (GetTickCount() - s_startTicks) >= SCENE_DURATION_MS;
+    return (Clock_Ms() - s_startTicks) >= SCENE_DURATION_MS;
 }
 
 void XScene_Render(float)
@@ -779,7 +787,7 @@ void XScene_Render(float)
     if (!s_active || !g_pDevice)
         return;
 
-    DWORD tMs = GetTickCount() - s_startTicks;
+    DWORD tMs = Clock_Ms() - s_startTicks;
 
     SetupCamera();
 
@@ -0,0 +1,103 @@
+#include "adpcm.h"
+
+const short ADPCM_STEPS[89] =
+{
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const signed char ADPCM_INDEX_ADJUST[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+unsigned int Adpcm_SamplesPerBlock(unsigned int blockAlign, unsigned int channels)
+{
+    if (channels == 0 || blockAlign < 4 * channels)
+        return 0;
+    return (blockAlign / channels - 4) * 2 + 1;
+}
+
+// Per (step index, code): the signed delta, and the next index
+static int           s_delta[89][16];
+static unsigned char s_next[89][16];
+static bool          s_tablesReady = false;
+
+static void BuildTables()
+{
+    for (int i = 0; i < 89; ++i)
+    {
+        int step = ADPCM_STEPS[i];
+
+        for (int code = 0; code < 16; ++code)
+        {
+            int diff = step >> 3;
+            if (code & 4) diff += step;
+            if (code & 2) diff += step >> 1;
+            if (code & 1) diff += step >> 2;
+
+            s_delta[i][code] = (code & 8) ? -diff : diff;
+
+            int next = i + ADPCM_INDEX_ADJUST[code];
+            if (next < 0) next = 0;
+            if (next > 88) next = 88;
+            s_next[i][code] = (unsigned char)next;
+        }
+    }
+    s_tablesReady = true;
+}
+
+static inline int Clamp16(int v)
+{
+    if (v < -32768) return -32768;
+    if (v > 32767) return 32767;
+    return v;
+}
+
+void Adpcm_DecodeBlock(const unsigned char* src, unsigned int blockAlign, unsigned int channels,
+                       short* dst)
+{
+    if (!s_tablesReady)
+        BuildTables();
+
+    unsigned int words = (blockAlign / channels - 4) / 4;
+    const unsigned char* data = src + 4 * channels;
+
+    for (unsigned int ch = 0; ch < channels; ++ch)
+    {
+        const unsigned char* hdr = src + 4 * ch;
+        int pred = (short)(hdr[0] | (hdr[1] << 8));
+        unsigned int index = hdr[2];
+        if (index > 88)
+            index = 88;
+
+        short* out = dst + ch;
+        *out = (short)pred;
+        out += channels;
+
+        const unsigned char* word = data + 4 * ch;
+
+        for (unsigned int w = 0; w < words; ++w, word += 4 * channels)
+        {
+            unsigned int bits = word[0] | (word[1] << 8) | (word[2] << 16) | ((unsigned int)word[3] << 24);
+
+            for (int k = 0; k < 8; ++k, bits >>= 4)
+            {
+                unsigned int code = bits & 15;
+                pred = Clamp16(pred + s_delta[index][code]);
+                index = s_next[index][code];
+
+                *out = (short)pred;
+                out += channels;
+            }
+        }
+    }
+}
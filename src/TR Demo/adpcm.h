@@ -0,0 +1,25 @@
+#pragma once
+
+// IMA ADPCM (WAVE_FORMAT_IMA_ADPCM, 4 bits per sample) block decoding to
+// 16-bit PCM. Used by music (runtime) and tools/adpcmenc and
+// tools/adpcmbench (host), so plain C types only.
+//
+// Block layout, per the format: a 4-byte header per channel (first sample,
+// step index, pad), then 4-byte words taking turns between the channels,
+// each holding eight samples low nibble first. Output is interleaved.
+
+static const unsigned int ADPCM_FORMAT_TAG = 0x0011;
+
+// The format's step sizes and per-code step index changes
+extern const short       ADPCM_STEPS[89];
+extern const signed char ADPCM_INDEX_ADJUST[16];
+
+// Samples per channel in a block of blockAlign bytes (header sample included)
+unsigned int Adpcm_SamplesPerBlock(unsigned int blockAlign, unsigned int channels);
+
+// Decodes one block into Adpcm_SamplesPerBlock * channels samples. Integer
+// only: an 89 x 16 table gives each code's delta and next step index, so a
+// sample is two lookups, an add and a clamp. Bit-exact with the format's
+// reference decoder (tools/adpcmbench checks).
+void Adpcm_DecodeBlock(const unsigned char* src, unsigned int blockAlign, unsigned int channels,
+                       short* dst);
@@ -0,0 +1,227 @@
+#include "beat.h"
+
+#include <string.h>
+
+// Flux is scaled to 16 bands whatever the band count, so these hold for any
+static const int          ONSET_MIN = 40;       // above the mean, on top of half the mean
+static const int          ODF_MAX = 1023;       // keeps the autocorrelation in 32 bits
+static const unsigned int LOCK_Q8 = 64;         // best lag against lag 0 for a usable period
+static const unsigned int MIN_POWER = 16;       // mean square flux below this is no signal
+
+// log2(v), rounded; v > 0
+static unsigned int RoundLog2(unsigned int v)
+{
+    return (Spectrum_Log2Q8(v ? v : 1) + 128) >> 8;
+}
+
+bool Beat_Configure(BeatTracker* t, unsigned int bands, unsigned int sampleRate, unsigned int fftSize)
+{
+    if (bands < 1 || bands > SPECTRUM_MAX_BANDS || sampleRate == 0 || fftSize == 0)
+        return false;
+
+    const unsigned int rateQ8 = (unsigned int)((unsigned long long)sampleRate * 256 / fftSize);
+
+    // Frames per beat; the peak refinement also looks one lag either side
+    const unsigned int minLag = rateQ8 * 60 / (BEAT_MAX_BPM * 256);
+    const unsigned int maxLag = (rateQ8 * 60 + BEAT_MIN_BPM * 256 - 1) / (BEAT_MIN_BPM * 256);
+    if (minLag < 4 || maxLag > BEAT_MAX_LAG)
+        return false;
+
+    memset(t, 0, sizeof(*t));
+    t->bands = bands;
+    t->frameRateQ8 = rateQ8;
+    t->minLag = minLag;
+    t->maxLag = maxLag;
+    t->meanShift = RoundLog2((rateQ8 * 15 / 100) >> 8);
+    t->acfShift = RoundLog2((rateQ8 * 4) >> 8);
+    t->refractory = (rateQ8 / 10) >> 8;
+    if (t->refractory < 1)
+        t->refractory = 1;
+
+    // Falls off by half per octave from 120 BPM, so a lag and its double
+    // of similar strength resolve towards the middle of the range
+    const unsigned int log120 = Spectrum_Log2Q8(rateQ8 / 2);
+    for (unsigned int l = 1; l <= BEAT_MAX_LAG + 1; ++l)
+    {
+        unsigned int lg = Spectrum_Log2Q8(l << 8);
+        unsigned int d = lg > log120 ? lg - log120 : log120 - lg;
+        t->prior[l] = (unsigned short)(d / 2 < 240 ? 256 - d / 2 : 16);
+    }
+    return true;
+}
+
+// Lag l in Q8, moved towards the top of the parabola through its neighbours
+static unsigned int RefineLag(const BeatTracker* t, unsigned int l)
+{
+    long long a = t->acf[l - 1], b = t->acf[l], c = t->acf[l + 1];
+    long long den = a - 2 * b + c;
+    int off = 0;
+
+    if (den < 0)
+    {
+        off = (int)((a - c) * 128 / den);
+        if (off > 128) off = 128;
+        if (off < -128) off = -128;
+    }
+    return l * 256 + off;
+}
+
+// Phase now (Q16) from where the beats fall in the history: the offset
+// whose comb of teeth a period apart gathers the most flux, so the strong
+// hits on the beat outvote the weaker ones between
+static int CombPhase(const BeatTracker* t)
+{
+    const unsigned int mask = BEAT_HISTORY - 1;
+    const unsigned int p = (t->periodQ8 + 128) >> 8;
+    const unsigned int teeth = (BEAT_HISTORY - 1) / (p + 1);
+
+    unsigned int best = 0, bestSum = 0;
+    for (unsigned int o = 0; o < p; ++o)
+    {
+        unsigned int sum = 0;
+        for (unsigned int k = 0; k < teeth; ++k)
+            sum += t->odf[(t->frame - o - ((k * t->periodQ8 + 128) >> 8)) & mask];
+
+        if (sum > bestSum)
+        {
+            bestSum = sum;
+            best = o;
+        }
+    }
+    return (int)(((best << 24) / t->periodQ8) & 0xFFFF);
+}
+
+// A period estimate (Q8 frames) in, the tracked period out: small moves are
+// followed smoothly, a different tempo only once it has held for a second
+static void TrackPeriod(BeatTracker* t, unsigned int estQ8)
+{
+    if (!t->periodQ8)
+    {
+        t->periodQ8 = estQ8;
+        t->candFrames = 0;
+        t->phase = (unsigned int)CombPhase(t);
+        return;
+    }
+
+    int diff = (int)estQ8 - (int)t->periodQ8;
+    if ((diff < 0 ? -diff : diff) <= (int)(t->periodQ8 / 16))
+    {
+        t->periodQ8 = (unsigned int)((int)t->periodQ8 + diff / 8);
+        t->candFrames = 0;
+        return;
+    }
+
+    int cdiff = (int)estQ8 - (int)t->candQ8;
+    if (t->candFrames && (cdiff < 0 ? -cdiff : cdiff) <= (int)(t->candQ8 / 16))
+    {
+        if (++t->candFrames >= t->frameRateQ8 >> 8)
+        {
+            t->periodQ8 = estQ8;
+            t->candFrames = 0;
+            t->phase = (unsigned int)CombPhase(t);
+        }
+    }
+    else
+    {
+        t->candQ8 = estQ8;
+        t->candFrames = 1;
+    }
+}
+
+void Beat_Feed(BeatTracker* t, const unsigned char* raw)
+{
+    const unsigned int mask = BEAT_HISTORY - 1;
+
+    // Spectral flux: rises only, scaled to 16 bands
+    int flux = 0;
+    for (unsigned int b = 0; b < t->bands; ++b)
+    {
+        int rise = raw[b] - t->prev[b];
+        if (rise > 0)
+            flux += rise;
+        t->prev[b] = raw[b];
+    }
+    flux = flux * 16 / (int)t->bands;
+
+    // Against the mean so far, so steady texture doesn't count
+    int above = flux - (t->fluxMean >> 8);
+    t->fluxMean += ((flux << 8) - t->fluxMean) >> t->meanShift;
+    if (above < 0) above = 0;
+    if (above > ODF_MAX) above = ODF_MAX;
+
+    const unsigned int now = ++t->frame;
+    t->odf[now & mask] = (unsigned short)above;
+
+    // Onset: the last frame, if it peaked clear of the mean
+    t->onset = 0;
+    int peak = t->odf[(now - 1) & mask];
+    if (peak > t->odf[(now - 2) & mask] && peak >= above &&
+        peak >= ONSET_MIN + (t->fluxMean >> 9) && now - 1 - t->lastOnset >= t->refractory)
+    {
+        t->lastOnset = now - 1;
+        t->onset = peak >> 1 < 1 ? 1 : (peak >> 1 > 255 ? 255 : (unsigned int)(peak >> 1));
+    }
+
+    // Autocorrelation, decaying, at the lags in range and one either side
+    const unsigned int x = (unsigned int)above;
+    for (unsigned int l = t->minLag - 1; l <= t->maxLag + 1; ++l)
+    {
+        t->acf[l] -= t->acf[l] >> t->acfShift;
+        t->acf[l] += x * t->odf[(now - l) & mask];
+    }
+    t->acf0 -= t->acf0 >> t->acfShift;
+    t->acf0 += x * x;
+
+    // Strongest peak, weighted
+    unsigned int best = 0, bestScore = 0;
+    for (unsigned int l = t->minLag; l <= t->maxLag; ++l)
+    {
+        unsigned int score = (t->acf[l] >> 8) * t->prior[l];
+        if (score > bestScore && t->acf[l] >= t->acf[l - 1] && t->acf[l] >= t->acf[l + 1])
+        {
+            bestScore = score;
+            best = l;
+        }
+    }
+
+    bool confident = best && (t->acf0 >> t->acfShift) >= MIN_POWER &&
+                     (unsigned long long)t->acf[best] * 256 >= (unsigned long long)LOCK_Q8 * t->acf0;
+    if (confident)
+    {
+        TrackPeriod(t, RefineLag(t, best));
+        t->weakFrames = 0;
+    }
+    else if (t->periodQ8 && ++t->weakFrames > (t->frameRateQ8 * 2) >> 8)
+    {
+        // Two seconds without a beat to follow: hold still
+        t->periodQ8 = 0;
+        t->candFrames = 0;
+    }
+
+    if (!t->periodQ8)
+        return;
+
+    // Advance a frame, then an eighth of the way to the comb's phase
+    int phase = (int)t->phase + (int)((1u << 24) / t->periodQ8);
+    int err = ((phase - CombPhase(t) + 32768) & 0xFFFF) - 32768;
+    phase -= err / 8;
+
+    while (phase >= 65536)
+    {
+        phase -= 65536;
+        t->beats++;
+    }
+    while (phase < 0)
+    {
+        phase += 65536;
+        t->beats--;
+    }
+    t->phase = (unsigned int)phase;
+}
+
+unsigned int Beat_Bpm(const BeatTracker* t)
+{
+    if (!t->periodQ8)
+        return 0;
+    return (t->frameRateQ8 * 60 + t->periodQ8 / 2) / t->periodQ8;
+}
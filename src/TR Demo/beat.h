@@ -0,0 +1,60 @@
+#pragma once
+
+#include "spectrum.h"
+
+// Onset detection and tempo / beat phase tracking on the spectrum's band
+// levels, one frame per analysis. Used by music (runtime) and
+// tools/beatbench (host), so plain C types only, integer math throughout.
+//
+// Onsets: spectral flux, each band's rise in log level (Spectrum::raw)
+// since the last frame summed over the bands, less its running mean; a
+// local peak clear of the mean, and 100 ms after the last one, is an onset.
+// Tempo: that same flux feeds a running autocorrelation (decaying over ~4 s)
+// at the lags of BEAT_MIN_BPM..BEAT_MAX_BPM; the strongest lag, weighted
+// towards 120 BPM and refined between frames, is the beat period.
+// Phase: advances a beat per period, steered towards the offset where flux
+// peaks line up a period apart over the history (~5 beats at 120 BPM).
+
+static const unsigned int BEAT_MIN_BPM = 60;
+static const unsigned int BEAT_MAX_BPM = 180;
+static const unsigned int BEAT_MAX_LAG = 192;       // frames; 60 BPM at 256 points, 48 kHz
+static const unsigned int BEAT_HISTORY = 512;       // power of two, > 2 * (BEAT_MAX_LAG + 1)
+
+struct BeatTracker
+{
+    unsigned int   bands;
+    unsigned int   frameRateQ8;                     // frames (analyses) per second, Q8
+    unsigned int   minLag, maxLag;                  // frames per beat at BEAT_MAX/MIN_BPM
+    unsigned int   meanShift;                       // flux mean: ~0.15 s, as a shift
+    unsigned int   acfShift;                        // autocorrelation decay: ~4 s
+    unsigned int   refractory;                      // frames from one onset to the next
+    unsigned short prior[BEAT_MAX_LAG + 2];         // Q8 weight per lag, 256 at 120 BPM
+
+    unsigned int   frame;
+    unsigned char  prev[SPECTRUM_MAX_BANDS];
+    int            fluxMean;                        // Q8
+    unsigned short odf[BEAT_HISTORY];               // flux above its mean, by frame
+    unsigned int   acf[BEAT_MAX_LAG + 2];           // by lag
+    unsigned int   acf0;                            // lag 0, for the confidence
+    unsigned int   lastOnset;                       // frame
+    unsigned int   candQ8;                          // a different period, while it persists
+    unsigned int   candFrames;
+    unsigned int   weakFrames;                      // frames without a confident period
+
+    // After each Beat_Feed
+    unsigned int   onset;                           // strength 1..255 of an onset this frame, else 0
+    unsigned int   periodQ8;                        // frames per beat, Q8; 0 = no tempo
+    unsigned int   beats;                           // whole beats so far
+    unsigned int   phase;                           // into the current one, Q16
+};
+
+// For spectrum analyses of fftSize points at sampleRate. False (t
+// unchanged) if the tempo range doesn't fit BEAT_MAX_LAG.
+bool Beat_Configure(BeatTracker* t, unsigned int bands, unsigned int sampleRate, unsigned int fftSize);
+
+// One frame: the analysis's unsmoothed band levels (Spectrum::raw). An
+// onset is reported a frame after its peak; it sets t->onset.
+void Beat_Feed(BeatTracker* t, const unsigned char* raw);
+
+// Whole BPM for t->periodQ8, 0 without a tempo
+unsigned int Beat_Bpm(const BeatTracker* t);
@@ -0,0 +1,134 @@
+#include "clock.h"
+
+// Everything is kept in counter ticks. The accumulator is scaled by
+// CLOCK_STEP_HZ so a step is exactly s_freq units and never drifts against
+// the counter.
+static LONGLONG s_freq = 0;
+static LONGLONG s_start = 0;        // Clock_ReadUs origin, fixed after Clock_Init
+static LONGLONG s_origin = 0;       // scene time origin
+static LONGLONG s_now = 0;
+static LONGLONG s_frame = 0;        // ticks between the last two Clock_Tick
+static LONGLONG s_acc = 0;          // (unsimulated ticks) * CLOCK_STEP_HZ
+static bool     s_useTickCount = false;
+static bool     s_synthetic = false;
+
+static LONGLONG ReadCounter()
+{
+    if (s_useTickCount)
+        return (LONGLONG)GetTickCount();
+
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+// -----------------------------------------------------------------------------
+// Clock
+// -----------------------------------------------------------------------------
+
+void Clock_Init()
+{
+    LARGE_INTEGER freq;
+    s_useTickCount = !(QueryPerformanceFrequency(&freq) && freq.QuadPart > 0);
+    s_freq = s_useTickCount ? 1000 : freq.QuadPart;
+
+    s_start = ReadCounter();
+    s_origin = s_start;
+    s_now = s_start;
+    s_frame = 0;
+    s_acc = 0;
+}
+
+void Clock_ResetSceneTime()
+{
+    s_now = ReadCounter();
+    s_origin = s_now;
+    s_frame = 0;
+    s_acc = 0;
+}
+
+void Clock_SetSynthetic(bool on)
+{
+    s_synthetic = on;
+}
+
+bool Clock_IsSynthetic()
+{
+    return s_synthetic;
+}
+
+void Clock_Tick()
+{
+    if (s_synthetic)
+    {
+        s_frame = s_freq / CLOCK_STEP_HZ;
+        s_now += s_frame;
+        s_acc += s_freq;            // exactly one step
+        return;
+    }
+
+    LONGLONG t = ReadCounter();
+
+    s_frame = t - s_now;
+    if (s_frame < 0)
+        s_frame = 0;
+
+    s_now = t;
+    s_acc += s_frame * CLOCK_STEP_HZ;
+}
+
+DWORD Clock_Ms()
+{
+    return (DWORD)(((s_now - s_origin) * 1000) / s_freq);
+}
+
+float Clock_Seconds()
+{
+    return (float)((double)(s_now - s_origin) / (double)s_freq);
+}
+
+float Clock_FrameSeconds()
+{
+    return (float)((double)s_frame / (double)s_freq);
+}
+
+DWORD Clock_ReadUs()
+{
+    // Via double: ticks * 10^6 overflows 64 bits after a few hours at 733 MHz
+    double us = (double)(ReadCounter() - s_start) * 1000000.0 / (double)s_freq;
+    return (DWORD)(LONGLONG)us;
+}
+
+// -----------------------------------------------------------------------------
+// Fixed steps
+// -----------------------------------------------------------------------------
+
+int Clock_TakeSteps()
+{
+    int steps = (int)(s_acc / s_freq);
+
+    if (steps > CLOCK_MAX_STEPS)
+    {
+        // Drop the backlog, keep the phase
+        steps = CLOCK_MAX_STEPS;
+        s_acc %= s_freq;
+    }
+    else
+    {
+        s_acc -= (LONGLONG)steps * s_freq;
+    }
+
+    return steps;
+}
+
+void Clock_ResetSteps()
+{
+    s_acc = 0;
+}
+
+float Clock_StepAlpha()
+{
+    float a = (float)((double)s_acc / (double)s_freq);
+    if (a > 1.0f) a = 1.0f;
+    return a;
+}
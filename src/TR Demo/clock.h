@@ -0,0 +1,60 @@
+#pragma once
+#include <xtl.h>
+
+// High-resolution demo clock + fixed-step simulation accumulator.
+//
+// Scene Update functions advance by exactly one step per call, whatever the
+// render rate: main() asks the clock how many steps are due each frame and
+// runs that many. Renderers may use Clock_StepAlpha() to draw between the
+// last two simulated states.
+//
+// Usage:
+//   Clock_Init();                         once, first thing in main()
+//   Clock_ResetSceneTime();               scene time 0, just before the loop
+//   each frame:
+//     Clock_Tick();                       sample the counter
+//     n = Clock_TakeSteps();              fixed steps due (0..CLOCK_MAX_STEPS)
+//     n x Scene_Update();                 each one CLOCK_STEP_SECONDS
+//     render
+//   after a long stall (scene init):      Clock_ResetSteps();
+
+static const int   CLOCK_STEP_HZ = 60;
+static const float CLOCK_STEP_SECONDS = 1.0f / 60.0f;
+
+// Per frame. Past this the simulation runs slow rather than spending every
+// frame catching up.
+static const int   CLOCK_MAX_STEPS = 4;
+
+// Once, before any other thread reads the clock: Clock_ReadUs (used by the
+// music stream thread) counts from here and the origin never moves again.
+void  Clock_Init();
+
+// Restarts scene time (Clock_Ms, Clock_Seconds) and the step accumulator
+// at now. Main thread only; Clock_ReadUs is unaffected.
+void  Clock_ResetSceneTime();
+
+void  Clock_Tick();
+
+// Synthetic mode: every Clock_Tick advances exactly one step, whatever the
+// wall time. Scene timing (Clock_Ms) is then a pure function of the frame
+// count, for repeatable perf runs. Clock_ReadUs stays real time.
+void  Clock_SetSynthetic(bool on);
+bool  Clock_IsSynthetic();
+
+// Scene time, since Clock_ResetSceneTime (or Clock_Init), as of the last
+// Clock_Tick
+DWORD Clock_Ms();
+float Clock_Seconds();
+
+// Wall time between the last two Clock_Tick calls
+float Clock_FrameSeconds();
+
+// Reads the counter now (not the frame sample): microseconds since Clock_Init.
+// For timing work inside a frame.
+DWORD Clock_ReadUs();
+
+int   Clock_TakeSteps();
+void  Clock_ResetSteps();
+
+// 0..1: how far past the last simulated step the current frame is
+float Clock_StepAlpha();
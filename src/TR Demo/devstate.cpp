@@ -0,0 +1,213 @@
+#include "devstate.h"
+#include <string.h>
+
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+static const int MAX_STAGES = 4;
+static const int MAX_STREAMS = 2;
+
+// Shadow copies; a false valid flag means "unknown, always issue"
+static DWORD s_rs[D3DRS_MAX];
+static bool  s_rsValid[D3DRS_MAX];
+
+static DWORD s_tss[MAX_STAGES][D3DTSS_MAX];
+static bool  s_tssValid[MAX_STAGES][D3DTSS_MAX];
+
+static IDirect3DBaseTexture8* s_tex[MAX_STAGES];
+static bool                   s_texValid[MAX_STAGES];
+
+static DWORD s_vs = 0;
+static bool  s_vsValid = false;
+
+static IDirect3DVertexBuffer8* s_vb[MAX_STREAMS];
+static UINT                    s_vbStride[MAX_STREAMS];
+static bool                    s_vbValid[MAX_STREAMS];
+
+static IDirect3DIndexBuffer8* s_ib = NULL;
+static UINT                   s_ibBase = 0;
+static bool                   s_ibValid = false;
+
+static DevStateStats s_stats = { 0, 0 };
+
+// Returns true (and counts it) if the call has to go to the device.
+static __forceinline bool Issue(bool same)
+{
+    if (same)
+    {
+        s_stats.filtered++;
+        return false;
+    }
+
+    s_stats.issued++;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// State
+// -----------------------------------------------------------------------------
+
+void DevState_SetRenderState(D3DRENDERSTATETYPE state, DWORD value)
+{
+    if (!g_pDevice)
+        return;
+
+    if ((unsigned)state >= (unsigned)D3DRS_MAX)
+    {
+        Issue(false);
+        g_pDevice->SetRenderState(state, value);
+        return;
+    }
+
+    if (!Issue(s_rsValid[state] && s_rs[state] == value))
+        return;
+
+    s_rs[state] = value;
+    s_rsValid[state] = true;
+    g_pDevice->SetRenderState(state, value);
+}
+
+void DevState_SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value)
+{
+    if (!g_pDevice)
+        return;
+
+    if (stage >= (DWORD)MAX_STAGES || (unsigned)type >= (unsigned)D3DTSS_MAX)
+    {
+        Issue(false);
+        g_pDevice->SetTextureStageState(stage, type, value);
+        return;
+    }
+
+    if (!Issue(s_tssValid[stage][type] && s_tss[stage][type] == value))
+        return;
+
+    s_tss[stage][type] = value;
+    s_tssValid[stage][type] = true;
+    g_pDevice->SetTextureStageState(stage, type, value);
+}
+
+void DevState_SetTexture(DWORD stage, IDirect3DBaseTexture8* tex)
+{
+    if (!g_pDevice)
+        return;
+
+    if (stage >= (DWORD)MAX_STAGES)
+    {
+        Issue(false);
+        g_pDevice->SetTexture(stage, tex);
+        return;
+    }
+
+    if (!Issue(s_texValid[stage] && s_tex[stage] == tex))
+        return;
+
+    s_tex[stage] = tex;
+    s_texValid[stage] = true;
+    g_pDevice->SetTexture(stage, tex);
+}
+
+void DevState_SetVertexShader(DWORD handle)
+{
+    if (!g_pDevice)
+        return;
+
+    if (!Issue(s_vsValid && s_vs == handle))
+        return;
+
+    s_vs = handle;
+    s_vsValid = true;
+    g_pDevice->SetVertexShader(handle);
+}
+
+void DevState_SetStreamSource(UINT stream, IDirect3DVertexBuffer8* vb, UINT stride)
+{
+    if (!g_pDevice)
+        return;
+
+    if (stream >= (UINT)MAX_STREAMS)
+    {
+        Issue(false);
+        g_pDevice->SetStreamSource(stream, vb, stride);
+        return;
+    }
+
+    if (!Issue(s_vbValid[stream] && s_vb[stream] == vb && s_vbStride[stream] == stride))
+        return;
+
+    s_vb[stream] = vb;
+    s_vbStride[stream] = stride;
+    s_vbValid[stream] = true;
+    g_pDevice->SetStreamSource(stream, vb, stride);
+}
+
+void DevState_SetIndices(IDirect3DIndexBuffer8* ib, UINT baseVertex)
+{
+    if (!g_pDevice)
+        return;
+
+    if (!Issue(s_ibValid && s_ib == ib && s_ibBase == baseVertex))
+        return;
+
+    s_ib = ib;
+    s_ibBase = baseVertex;
+    s_ibValid = true;
+    g_pDevice->SetIndices(ib, baseVertex);
+}
+
+// -----------------------------------------------------------------------------
+// UP draws
+// -----------------------------------------------------------------------------
+
+void DevState_DrawPrimitiveUP(D3DPRIMITIVETYPE type, UINT primCount,
+                              const void* verts, UINT stride)
+{
+    if (!g_pDevice)
+        return;
+
+    g_pDevice->DrawPrimitiveUP(type, primCount, verts, stride);
+
+    // D3D leaves stream 0 and the indices unbound after a UP draw
+    s_vbValid[0] = false;
+    s_ibValid = false;
+}
+
+void DevState_DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE type, UINT minIndex,
+                                     UINT numVertices, UINT primCount,
+                                     const void* indices, D3DFORMAT indexFormat,
+                                     const void* verts, UINT stride)
+{
+    if (!g_pDevice)
+        return;
+
+    g_pDevice->DrawIndexedPrimitiveUP(type, minIndex, numVertices, primCount,
+                                      indices, indexFormat, verts, stride);
+
+    s_vbValid[0] = false;
+    s_ibValid = false;
+}
+
+// -----------------------------------------------------------------------------
+// Invalidate / stats
+// -----------------------------------------------------------------------------
+
+void DevState_Invalidate()
+{
+    memset(s_rsValid, 0, sizeof(s_rsValid));
+    memset(s_tssValid, 0, sizeof(s_tssValid));
+    memset(s_texValid, 0, sizeof(s_texValid));
+    memset(s_vbValid, 0, sizeof(s_vbValid));
+    s_vsValid = false;
+    s_ibValid = false;
+}
+
+void DevState_ResetStats()
+{
+    s_stats.issued = 0;
+    s_stats.filtered = 0;
+}
+
+void DevState_GetStats(DevStateStats* out)
+{
+    if (out)
+        *out = s_stats;
+}
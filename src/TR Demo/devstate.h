@@ -0,0 +1,44 @@
+#pragma once
+#include <xtl.h>
+
+// Shadowed device state. Every scene sets its render, texture-stage,
+// texture, vertex shader and stream state through these instead of calling
+// g_pDevice directly; a call that would not change anything is dropped
+// before it reaches the pushbuffer.
+//
+// The shadow is only right if nothing else changes the same state, so:
+//   - all Set* of the kinds below go through here (no direct device calls)
+//   - UP draws go through here too: D3D unbinds stream 0 and the index
+//     buffer after them
+//   - main.cpp calls DevState_Invalidate() after a scene swap, so a new
+//     scene's first frame is always issued in full
+//
+// Transforms, materials and lights are not shadowed.
+
+void DevState_SetRenderState(D3DRENDERSTATETYPE state, DWORD value);
+void DevState_SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value);
+void DevState_SetTexture(DWORD stage, IDirect3DBaseTexture8* tex);
+void DevState_SetVertexShader(DWORD handle);
+void DevState_SetStreamSource(UINT stream, IDirect3DVertexBuffer8* vb, UINT stride);
+void DevState_SetIndices(IDirect3DIndexBuffer8* ib, UINT baseVertex);
+
+void DevState_DrawPrimitiveUP(D3DPRIMITIVETYPE type, UINT primCount,
+                              const void* verts, UINT stride);
+void DevState_DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE type, UINT minIndex,
+                                     UINT numVertices, UINT primCount,
+                                     const void* indices, D3DFORMAT indexFormat,
+                                     const void* verts, UINT stride);
+
+// Forget everything: the next Set* of each kind is always issued.
+void DevState_Invalidate();
+
+// Set* calls passed to the device vs. dropped as redundant (accumulate until
+// reset; main.cpp resets per frame).
+struct DevStateStats
+{
+    DWORD issued;
+    DWORD filtered;
+};
+
+void DevState_ResetStats();
+void DevState_GetStats(DevStateStats* out);
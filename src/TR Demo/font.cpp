@@ -1,5 +1,8 @@
 #include "font.h"
+#include "devstate.h"
+#include "vring.h"
 #include <xtl.h>
+#include <stdlib.h>
 
 // This matches the VERTEX layout used in renderer, but is local to this TU.
 struct VERTEX
@@ -107,71 +110,144 @@ static Glyph g_font[] =
 static const int g_fontCount = sizeof(g_font) / sizeof(g_font[0]);
 
 // -----------------------------------------------------------------------------
-// Glyph lookup
+// Glyph lookup (256-entry table, built on first use)
 // -----------------------------------------------------------------------------
-static const Glyph* FindGlyph(char c)
+static const Glyph* g_glyphLUT[256];
+static bool         g_glyphLUTReady = false;
+
+static void BuildGlyphLUT()
 {
-    // Force lowercase into uppercase
-    if (c >= 'a' && c <= 'z')
-        c = char(c - 'a' + 'A');
+    // default to space
+    for (int i = 0; i < 256; ++i)
+        g_glyphLUT[i] = &g_font[0];
 
     for (int i = 0; i < g_fontCount; ++i)
+        g_glyphLUT[(unsigned char)g_font[i].ch] = &g_font[i];
+
+    // Force lowercase into uppercase
+    for (int c = 'a'; c <= 'z'; ++c)
+        g_glyphLUT[c] = g_glyphLUT[c - 'a' + 'A'];
+
+    g_glyphLUTReady = true;
+}
+
+static const Glyph* FindGlyph(char c)
+{
+    if (!g_glyphLUTReady)
+        BuildGlyphLUT();
+
+    return g_glyphLUT[(unsigned char)c];
+}
+
+// -----------------------------------------------------------------------------
+// Row runs: split one 5-bit glyph row into horizontal runs of lit pixels.
+// Returns run count (max 3); columns are [start, end).
+// -----------------------------------------------------------------------------
+static int GlyphRowRuns(unsigned char bits, int* starts, int* ends)
+{
+    int n = 0;
+    int col = 0;
+
+    while (col < 5)
     {
-        if (g_font[i].ch == c)
-            return &g_font[i];
+        if (!((bits >> (4 - col)) & 1))
+        {
+            ++col;
+            continue;
+        }
+
+        starts[n] = col;
+        while (col < 5 && ((bits >> (4 - col)) & 1))
+            ++col;
+        ends[n] = col;
+        ++n;
     }
-    // default to space
-    return &g_font[0];
+
+    return n;
 }
 
 // -----------------------------------------------------------------------------
-// Low-level raw char draw: single pass, no effects
+// Batch: one triangle list per string instead of one strip per lit pixel.
+// Static storage, so no per-frame allocation.
 // -----------------------------------------------------------------------------
-static void DrawCharRaw(float x, float y, char c, float scale, DWORD color)
+static const int FONT_BATCH_QUADS = 512;
+
+static VERTEX g_fontBatch[FONT_BATCH_QUADS * 6];
+static int    g_fontBatchVerts = 0;
+
+static FontStats g_fontStats = {};
+
+static void FlushBatch()
+{
+    if (g_fontBatchVerts <= 0)
+        return;
+
+    DevState_SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    VRing_DrawUP(D3DPT_TRIANGLELIST, g_fontBatchVerts / 3, g_fontBatch, sizeof(VERTEX));
+
+    g_fontStats.drawCalls++;
+    g_fontStats.quads += (DWORD)(g_fontBatchVerts / 6);
+    g_fontBatchVerts = 0;
+}
+
+static void EmitQuad(float x0, float y0, float x1, float y1, DWORD color)
+{
+    if (g_fontBatchVerts + 6 > FONT_BATCH_QUADS * 6)
+        FlushBatch();
+
+    VERTEX* v = g_fontBatch + g_fontBatchVerts;
+
+    v[0] = { x0, y0, 0.0f, 1.0f, color };
+    v[1] = { x1, y0, 0.0f, 1.0f, color };
+    v[2] = { x0, y1, 0.0f, 1.0f, color };
+
+    v[3] = { x1, y0, 0.0f, 1.0f, color };
+    v[4] = { x1, y1, 0.0f, 1.0f, color };
+    v[5] = { x0, y1, 0.0f, 1.0f, color };
+
+    g_fontBatchVerts += 6;
+}
+
+// -----------------------------------------------------------------------------
+// Low-level raw char emit: single pass, no effects.
+// Horizontal runs of lit pixels in a row become one quad.
+// -----------------------------------------------------------------------------
+static void EmitCharRaw(float x, float y, const Glyph* g, float scale, DWORD color)
 {
-    const Glyph* g = FindGlyph(c);
     float pw = scale;
     float ph = scale;
 
     for (int row = 0; row < 7; ++row)
     {
         unsigned char bits = g->r[row];
-        for (int col = 0; col < 5; ++col)
-        {
-            int bitIndex = 4 - col;
-            if ((bits >> bitIndex) & 1)
-            {
-                float px = x + col * pw;
-                float py = y + row * ph;
-
-                VERTEX v[4] =
-                {
-                    { px,      py,      0.0f, 1.0f, color },
-                    { px + pw, py,      0.0f, 1.0f, color },
-                    { px,      py + ph, 0.0f, 1.0f, color },
-                    { px + pw, py + ph, 0.0f, 1.0f, color }
-                };
-
-                g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(VERTEX));
-            }
-        }
+        if (!bits)
+            continue;
+
+        float py = y + row * ph;
+
+        int starts[3], ends[3];
+        int n = GlyphRowRuns(bits, starts, ends);
+        for (int i = 0; i < n; ++i)
+            EmitQuad(x + starts[i] * pw, py, x + ends[i] * pw, py + ph, color);
     }
 }
 
 // -----------------------------------------------------------------------------
 // Stylized char: simple drop-shadow + main glyph
 // -----------------------------------------------------------------------------
-static void DrawChar(float x, float y, char c, float scale, DWORD color)
+static void EmitChar(float x, float y, char c, float scale, DWORD color)
 {
+    const Glyph* g = FindGlyph(c);
+
     // Slight offset for the shadow (scaled so it looks good at any size)
     float off = scale * 0.9f;
     DWORD shadowColor = D3DCOLOR_XRGB(0, 0, 0);
 
     // Shadow pass (behind, down-right)
-    DrawCharRaw(x + off, y + off, c, scale, shadowColor);
+    EmitCharRaw(x + off, y + off, g, scale, shadowColor);
 
     // Main pass
-    DrawCharRaw(x, y, c, scale, color);
+    EmitCharRaw(x, y, g, scale, color);
 }
 
 // -----------------------------------------------------------------------------
@@ -179,13 +255,158 @@ static void DrawChar(float x, float y, char c, float scale, DWORD color)
 // -----------------------------------------------------------------------------
 void DrawText(float x, float y, const char* text, float scale, DWORD color)
 {
+    if (!g_pDevice || !text)
+        return;
+
     float cx = x;
     const float advance = 6.0f * scale; // 5px glyph + 1px gap
 
     while (*text)
     {
-        DrawChar(cx, y, *text, scale, color);
+        EmitChar(cx, y, *text, scale, color);
         cx += advance;
         ++text;
     }
+
+    FlushBatch();
+}
+
+// -----------------------------------------------------------------------------
+// Cached text meshes: glyph lookup and run extraction happen once in Build,
+// Draw only applies position/scale/color. Runs are in glyph-pixel units.
+// -----------------------------------------------------------------------------
+struct TextRun
+{
+    WORD x0, x1;
+    WORD y;
+    WORD pad;
+};
+
+bool TextMesh_Build(TextMesh* mesh, const char* text)
+{
+    if (!mesh)
+        return false;
+
+    mesh->runs = NULL;
+    mesh->runCount = 0;
+    mesh->charCount = 0;
+
+    if (!text)
+        return false;
+
+    int starts[3], ends[3];
+
+    // Pass 1: count
+    int count = 0;
+    int len = 0;
+    for (const char* p = text; *p; ++p, ++len)
+    {
+        const Glyph* g = FindGlyph(*p);
+        for (int row = 0; row < 7; ++row)
+            count += GlyphRowRuns(g->r[row], starts, ends);
+    }
+
+    mesh->charCount = len;
+    if (count == 0)
+        return true;
+
+    TextRun* runs = (TextRun*)malloc(sizeof(TextRun) * count);
+    if (!runs)
+    {
+        mesh->charCount = 0;
+        return false;
+    }
+
+    // Pass 2: fill
+    int k = 0;
+    for (int ci = 0; ci < len; ++ci)
+    {
+        const Glyph* g = FindGlyph(text[ci]);
+        int cellX = ci * 6; // 5px glyph + 1px gap
+
+        for (int row = 0; row < 7; ++row)
+        {
+            int n = GlyphRowRuns(g->r[row], starts, ends);
+            for (int i = 0; i < n; ++i)
+            {
+                runs[k].x0 = (WORD)(cellX + starts[i]);
+                runs[k].x1 = (WORD)(cellX + ends[i]);
+                runs[k].y = (WORD)row;
+                runs[k].pad = 0;
+                ++k;
+            }
+        }
+    }
+
+    mesh->runs = runs;
+    mesh->runCount = count;
+    return true;
+}
+
+void TextMesh_Release(TextMesh* mesh)
+{
+    if (!mesh)
+        return;
+
+    if (mesh->runs)
+        free(mesh->runs);
+
+    mesh->runs = NULL;
+    mesh->runCount = 0;
+    mesh->charCount = 0;
+}
+
+float TextMesh_Width(const TextMesh* mesh, float scale)
+{
+    if (!mesh)
+        return 0.0f;
+
+    return (float)mesh->charCount * 6.0f * scale;
+}
+
+void TextMesh_Draw(const TextMesh* mesh, float x, float y, float scale, DWORD color)
+{
+    if (!g_pDevice || !mesh || !mesh->runs || mesh->runCount <= 0)
+        return;
+
+    const TextRun* runs = mesh->runs;
+    const int count = mesh->runCount;
+
+    // Shadow quads never overlap a neighbouring cell (max 5.9px into a 6px
+    // cell), so all shadows first then all glyphs matches DrawText's output.
+    float off = scale * 0.9f;
+    float sx = x + off;
+    float sy = y + off;
+    DWORD shadowColor = D3DCOLOR_XRGB(0, 0, 0);
+
+    for (int i = 0; i < count; ++i)
+    {
+        const TextRun& r = runs[i];
+        float py = sy + (float)r.y * scale;
+        EmitQuad(sx + (float)r.x0 * scale, py, sx + (float)r.x1 * scale, py + scale, shadowColor);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const TextRun& r = runs[i];
+        float py = y + (float)r.y * scale;
+        EmitQuad(x + (float)r.x0 * scale, py, x + (float)r.x1 * scale, py + scale, color);
+    }
+
+    FlushBatch();
+}
+
+// -----------------------------------------------------------------------------
+// Stats
+// -----------------------------------------------------------------------------
+void Font_ResetStats()
+{
+    g_fontStats.drawCalls = 0;
+    g_fontStats.quads = 0;
+}
+
+void Font_GetStats(FontStats* out)
+{
+    if (out)
+        *out = g_fontStats;
 }
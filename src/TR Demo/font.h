@@ -3,4 +3,32 @@
 
 // Simple 5x7 bitmap font renderer.
 // Uses the global g_pDevice defined in main.cpp.
+// Each DrawText call submits a single triangle list (shadow + glyph runs).
 void DrawText(float x, float y, const char* text, float scale, DWORD color);
+
+// Cached text mesh for strings that never change (labels, credits).
+// Build once at scene Init (allocates), Draw each frame (no allocs, no glyph
+// lookups), Release at Shutdown. Output matches DrawText for the same args.
+struct TextRun;
+
+struct TextMesh
+{
+    TextRun* runs;
+    int      runCount;
+    int      charCount;
+};
+
+bool  TextMesh_Build(TextMesh* mesh, const char* text);
+void  TextMesh_Release(TextMesh* mesh);
+float TextMesh_Width(const TextMesh* mesh, float scale);
+void  TextMesh_Draw(const TextMesh* mesh, float x, float y, float scale, DWORD color);
+
+// Submission counters (accumulate until reset; main.cpp resets per frame).
+struct FontStats
+{
+    DWORD drawCalls;
+    DWORD quads;
+};
+
+void Font_ResetStats();
+void Font_GetStats(FontStats* out);
@@ -7,10 +7,17 @@
 
 #include <xtl.h>
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "input.h"
 #include "music.h"
+#include "font.h"
+#include "clock.h"
+#include "perf.h"
+#include "devstate.h"
+#include "vring.h"
+#include "texcache.h"
 
 #include "IntroScene.h"
 #include "PlasmaScene.h"
@@ -36,6 +43,22 @@ LPDIRECT3DDEVICE8  g_pDevice = nullptr;
 static const float SCREEN_W = 640.0f;
 static const float SCREEN_H = 480.0f;
 
+// Display rate. D3DPRESENT_INTERVAL_TWO renders at 30 Hz; scene simulation
+// stays at CLOCK_STEP_HZ either way.
+static const UINT PRESENT_INTERVAL = D3DPRESENT_INTERVAL_ONE;
+
+// Perf capture: one CSV row per frame on the debug output (see perf.h). With
+// the synthetic clock every frame is exactly one simulation step, so runs are
+// repeatable.
+static const bool PERF_CSV = false;
+static const bool PERF_SYNTHETIC_CLOCK = true;
+
+// Music read cache (see music.h): 1 MB of the ADPCM track is ~21 s read
+// ahead, a disc read every ~10 s (~5.5 s and ~2.7 s for the PCM one).
+// MUSIC_CACHE_ALL keeps the whole track resident instead (~9.8 MB ADPCM,
+// ~39 MB PCM), at the cost of reading it all during startup.
+static const DWORD MUSIC_CACHE_BYTES = 1024 * 1024;
+
 // -----------------------------------------------------------------------------
 // Scene / demo state
 // -----------------------------------------------------------------------------
@@ -114,7 +137,7 @@ static long InitD3D()
     p.AutoDepthStencilFormat = D3DFMT_D16;
 
     p.FullScreen_RefreshRateInHz = 60;
-    p.FullScreen_PresentationInterval = D3DPRESENT_INTERVAL_ONE;
+    p.FullScreen_PresentationInterval = PRESENT_INTERVAL;
 
     if (FAILED(g_pD3D->CreateDevice(
         0,
@@ -129,19 +152,25 @@ static long InitD3D()
         return -1;
     }
 
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
 
     // === FIX: enable depth testing globally ===
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+    DevState_SetRenderState(D3DRS_ZENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
+
+    // Shared dynamic geometry; without it scenes draw through the UP path
+    VRing_Init();
 
     return 0;
 }
 
 static void ShutdownD3D()
 {
+    VRing_Shutdown();
+    TexCache_Shutdown();
+
     if (g_pDevice)
     {
         g_pDevice->Release();
@@ -155,8 +184,51 @@ static void ShutdownD3D()
 }
 
 // -----------------------------------------------------------------------------
-// Scene helpers
+// Scene table
 // -----------------------------------------------------------------------------
+//
+// A scene goes through:
+//   prepare  - CPU / file work, no device access. Runs on the loader thread
+//              while the previous scene fades out. NULL if there is none.
+//   init     - Activate: device resources. Main thread, on the black frame.
+//              Does the prepare work itself if prepare has not run.
+//   shutdown - Release.
+//   update   - One fixed simulation step (CLOCK_STEP_SECONDS). May be NULL.
+
+typedef void (*SceneFn)();
+typedef void (*SceneRenderFn)(float demoTime);
+
+struct SceneDesc
+{
+    const char*   name;
+    DWORD         durationMs;
+    SceneFn       prepare;
+    SceneFn       init;
+    SceneFn       shutdown;
+    SceneFn       update;
+    SceneRenderFn render;
+};
+
+static void BallRender(float) { BallScene_Render(); }
+static void DripRender(float) { DripScene_Render(); }
+static void MazeRender(float) { MazeScene_Render(); }
+
+// Indexed by DemoSceneId
+static const SceneDesc g_scenes[SCENE_COUNT] =
+{
+    { "INTRO",   INTRO_SCENE_MS,   NULL,                IntroScene_Init,   IntroScene_Shutdown,   NULL,               IntroScene_Render   },
+    { "PLASMA",  PLASMA_SCENE_MS,  PlasmaScene_Prepare, PlasmaScene_Init,  PlasmaScene_Shutdown,  PlasmaScene_Update, PlasmaScene_Render  },
+    { "BALL",    BALL_SCENE_MS,    NULL,                BallScene_Init,    BallScene_Shutdown,    BallScene_Update,   BallRender          },
+    { "RING",    RING_SCENE_MS,    NULL,                RingScene_Init,    RingScene_Shutdown,    NULL,               RingScene_Render    },
+    { "GALAXY",  GALAXY_SCENE_MS,  GalaxyScene_Prepare, GalaxyScene_Init,  GalaxyScene_Shutdown,  NULL,               GalaxyScene_Render  },
+    { "UVRXDK",  UVRXDK_SCENE_MS,  NULL,                UVRXDKScene_Init,  UVRXDKScene_Shutdown,  NULL,               UVRXDKScene_Render  },
+    { "X",       X_SCENE_MS,       NULL,                XScene_Init,       XScene_Shutdown,       NULL,               XScene_Render       },
+    { "CUBE",    CUBE_SCENE_MS,    NULL,                CubeScene_Init,    CubeScene_Shutdown,    NULL,               CubeScene_Render    },
+    { "DRIP",    DRIP_SCENE_MS,    NULL,                DripScene_Init,    DripScene_Shutdown,    DripScene_Update,   DripRender          },
+    { "MAZE",    MAZE_SCENE_MS,    MazeScene_Prepare,   MazeScene_Init,    MazeScene_Shutdown,    MazeScene_Update,   MazeRender          },
+    { "CREDITS", CREDITS_SCENE_MS, NULL,                Credits_Init,      Credits_Shutdown,      NULL,               Credits_Render      },
+    { "CITY",    CITY_SCENE_MS,    NULL,                CityScene_Init,    CityScene_Shutdown,    NULL,               CityScene_Render    },
+};
 
 static DemoSceneId NextScene(DemoSceneId id)
 {
@@ -165,64 +237,97 @@ static DemoSceneId NextScene(DemoSceneId id)
     return (DemoSceneId)n;
 }
 
-static void InitScene(DemoSceneId id)
+// -----------------------------------------------------------------------------
+// Loader thread: the next scene's prepare, overlapped with the fade-out
+// -----------------------------------------------------------------------------
+
+static HANDLE         g_loader = NULL;
+static volatile DWORD g_loaderUs = 0;      // prepare time, written by the loader
+
+static DWORD WINAPI LoaderThreadProc(LPVOID param)
 {
-    switch (id)
-    {
-    case SCENE_INTRO:   IntroScene_Init();   break;
-    case SCENE_PLASMA:  PlasmaScene_Init();  break;
-    case SCENE_BALL:    BallScene_Init();    break;
-    case SCENE_RING:    RingScene_Init();    break;
-    case SCENE_GALAXY:  GalaxyScene_Init();  break;
-    case SCENE_UVRXDK:  UVRXDKScene_Init();  break;
-    case SCENE_X:       XScene_Init();       break;
-    case SCENE_CUBE:    CubeScene_Init();    break;
-    case SCENE_DRIP:    DripScene_Init();    break;
-    case SCENE_MAZE:    MazeScene_Init();    break;
-    case SCENE_CREDITS: Credits_Init();      break;
-    case SCENE_CITY:    CityScene_Init();    break;
-    default: break;
-    }
+    const SceneDesc* d = (const SceneDesc*)param;
+
+    // CRT rand state is per thread; without this every prepare sees seed 1
+    srand(GetTickCount());
+
+    DWORD t0 = Clock_ReadUs();
+    d->prepare();
+    g_loaderUs = Clock_ReadUs() - t0;
+    return 0;
 }
 
-static void ShutdownScene(DemoSceneId id)
+static void StartPrepare(DemoSceneId id)
 {
-    switch (id)
+    g_loaderUs = 0;
+
+    const SceneDesc* d = &g_scenes[id];
+    if (!d->prepare)
+        return;
+
+    // Synthetic clock: inline, so the frame sequence doesn't depend on how
+    // fast the loader thread happens to be
+    if (Clock_IsSynthetic())
     {
-    case SCENE_INTRO:   IntroScene_Shutdown();   break;
-    case SCENE_PLASMA:  PlasmaScene_Shutdown();  break;
-    case SCENE_BALL:    BallScene_Shutdown();    break;
-    case SCENE_RING:    RingScene_Shutdown();    break;
-    case SCENE_GALAXY:  GalaxyScene_Shutdown();  break;
-    case SCENE_UVRXDK:  UVRXDKScene_Shutdown();  break;
-    case SCENE_X:       XScene_Shutdown();       break;
-    case SCENE_CUBE:    CubeScene_Shutdown();    break;
-    case SCENE_DRIP:    DripScene_Shutdown();    break;
-    case SCENE_MAZE:    MazeScene_Shutdown();    break;
-    case SCENE_CREDITS: Credits_Shutdown();      break;
-    case SCENE_CITY:    CityScene_Shutdown();    break;
-    default: break;
+        DWORD t0 = Clock_ReadUs();
+        d->prepare();
+        g_loaderUs = Clock_ReadUs() - t0;
+        return;
     }
+
+    // If the thread can't be created, init does the work on the black frame
+    g_loader = CreateThread(NULL, 0, LoaderThreadProc, (LPVOID)d, 0, NULL);
 }
 
-static void RenderScene(DemoSceneId id, float demoTime)
+// Startup: everything the first scenes need off the disc, while main()
+// presents the display-settle frames. Runs before the demo clock starts, so
+// it is a thread even with the synthetic clock.
+static volatile bool g_musicReady = false;
+
+static DWORD WINAPI StartupThreadProc(LPVOID)
 {
-    switch (id)
-    {
-    case SCENE_INTRO:   IntroScene_Render(demoTime);   break;
-    case SCENE_PLASMA:  PlasmaScene_Render(demoTime);  break;
-    case SCENE_BALL:    BallScene_Render();            break;
-    case SCENE_RING:    RingScene_Render(demoTime);    break;
-    case SCENE_GALAXY:  GalaxyScene_Render(demoTime);  break;
-    case SCENE_UVRXDK:  UVRXDKScene_Render(demoTime);  break;
-    case SCENE_X:       XScene_Render(demoTime);       break;
-    case SCENE_CUBE:    CubeScene_Render(demoTime);    break;
-    case SCENE_DRIP:    DripScene_Render();            break;
-    case SCENE_MAZE:    MazeScene_Render();            break;
-    case SCENE_CREDITS: Credits_Render(demoTime);      break;
-    case SCENE_CITY:    CityScene_Render(demoTime);    break;
-    default: break;
-    }
+    DWORD t0 = Clock_ReadUs();
+
+    // Pre-swizzled textures from tools/texbake in one read; without the
+    // pack the scenes fall back to their .dds files
+    TexCache_LoadPack("D:\\tex\\textures.pak");
+
+    // A no-op when the pack has it
+    TexCache_Preload("D:\\tex\\tr.dds", 1);
+
+    // Header, cache and a full buffer of pre-roll. The ADPCM track from
+    // tools/adpcmenc if it's there, else the PCM original
+    g_musicReady = Music_Init("D:\\snd\\idk_adpcm.trm", MUSIC_CACHE_BYTES) ||
+                   Music_Init("D:\\snd\\idk.trm", MUSIC_CACHE_BYTES);
+
+    // Intro has nothing to prepare; Plasma's tables are the next CPU cost
+    PlasmaScene_Prepare();
+
+    g_loaderUs = Clock_ReadUs() - t0;
+    return 0;
+}
+
+static void StartStartupLoad()
+{
+    g_loaderUs = 0;
+
+    g_loader = CreateThread(NULL, 0, StartupThreadProc, NULL, 0, NULL);
+    if (!g_loader)
+        StartupThreadProc(NULL);
+}
+
+// True once nothing is being prepared.
+static bool PrepareDone()
+{
+    if (!g_loader)
+        return true;
+
+    if (WaitForSingleObject(g_loader, 0) != WAIT_OBJECT_0)
+        return false;
+
+    CloseHandle(g_loader);
+    g_loader = NULL;
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -254,32 +359,53 @@ static void DrawFadeOverlay(int alpha)
     v[2] = { 0.0f,     SCREEN_H, z, rhw, col };
     v[3] = { SCREEN_W, SCREEN_H, z, rhw, col };
 
-    g_pDevice->SetVertexShader(FADE_FVF);
-    g_pDevice->SetTexture(0, NULL);
+    DevState_SetVertexShader(FADE_FVF);
+    DevState_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    DevState_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    DevState_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
     // === FIX: overlay must NOT participate in depth ===
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
 
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    DevState_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    DevState_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(FadeVertex));
+    VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(FadeVertex));
 
     // Restore depth for scene rendering expectations
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    DevState_SetRenderState(D3DRS_ZENABLE, FALSE);
+    DevState_SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
 }
 
 // -----------------------------------------------------------------------------
 // Exit helper
 // -----------------------------------------------------------------------------
 
+static void LogStartup(int settleFrames, DWORD loadUs, DWORD firstFrameUs)
+{
+    char buf[224];
+    char* p = buf;
+
+    p = Perf_AppendStr(p, "startup: settle frames ");
+    p = Perf_AppendUInt(p, (DWORD)settleFrames);
+    p = Perf_AppendStr(p, ", load ");
+    p = Perf_AppendUInt(p, loadUs);
+    p = Perf_AppendStr(p, " us, first scene frame at ");
+    p = Perf_AppendUInt(p, firstFrameUs);
+    p = Perf_AppendStr(p, " us, music resident ");
+    p = Perf_AppendUInt(p, Music_GetResidentBytes());
+    p = Perf_AppendStr(p, " of ");
+    p = Perf_AppendUInt(p, Music_GetStreamBytes());
+    p = Perf_AppendStr(p, " bytes\n");
+    *p = 0;
+
+    OutputDebugStringA(buf);
+}
+
 static void ExitToDashboard()
 {
     Music_Shutdown();
@@ -293,6 +419,44 @@ static void ExitToDashboard()
 // Demo state update
 // -----------------------------------------------------------------------------
 
+// Per-transition timing, sent to the debug output when the fade-in ends.
+struct TransitionStats
+{
+    DemoSceneId from;
+    DemoSceneId to;
+    DWORD       prepareUs;      // loader thread, overlapped with the fade-out
+    DWORD       waitUs;         // fade held on black waiting for the loader
+    DWORD       swapUs;         // release + activate, on the black frame
+    DWORD       worstFrameUs;   // longest frame, fade-out start to fade-in end
+};
+
+static TransitionStats g_trans = {};
+static bool            g_transWaiting = false;
+static DWORD           g_transWaitStartUs = 0;
+
+static void ReportTransition()
+{
+    char buf[192];
+    char* p = buf;
+
+    p = Perf_AppendStr(p, "transition ");
+    p = Perf_AppendStr(p, g_scenes[g_trans.from].name);
+    p = Perf_AppendStr(p, " -> ");
+    p = Perf_AppendStr(p, g_scenes[g_trans.to].name);
+    p = Perf_AppendStr(p, ": prepare ");
+    p = Perf_AppendUInt(p, g_trans.prepareUs);
+    p = Perf_AppendStr(p, " us, wait ");
+    p = Perf_AppendUInt(p, g_trans.waitUs);
+    p = Perf_AppendStr(p, " us, swap ");
+    p = Perf_AppendUInt(p, g_trans.swapUs);
+    p = Perf_AppendStr(p, " us, worst frame ");
+    p = Perf_AppendUInt(p, g_trans.worstFrameUs);
+    p = Perf_AppendStr(p, " us\n");
+    *p = 0;
+
+    OutputDebugStringA(buf);
+}
+
 static void BeginTransitionTo(DemoSceneId nextScene, DWORD nowTicks)
 {
     if (g_demo.inTransition)
@@ -303,25 +467,13 @@ static void BeginTransitionTo(DemoSceneId nextScene, DWORD nowTicks)
     g_demo.next = nextScene;
     g_demo.transitionStartTicks = nowTicks;
     g_demo.overlayAlpha = 0;
-}
 
-static DWORD SceneDurationMs(DemoSceneId id)
-{
-    switch (id)
-    {
-    case SCENE_INTRO:   return INTRO_SCENE_MS;
-    case SCENE_PLASMA:  return PLASMA_SCENE_MS;
-    case SCENE_RING:    return RING_SCENE_MS;
-    case SCENE_GALAXY:  return GALAXY_SCENE_MS;
-    case SCENE_UVRXDK:  return UVRXDK_SCENE_MS;
-    case SCENE_X:       return X_SCENE_MS;
-    case SCENE_CUBE:    return CUBE_SCENE_MS;
-    case SCENE_DRIP:    return DRIP_SCENE_MS;
-    case SCENE_MAZE:    return MAZE_SCENE_MS;
-    case SCENE_CREDITS: return CREDITS_SCENE_MS;
-    case SCENE_CITY:    return CITY_SCENE_MS;
-    default:            return 20000;
-    }
+    memset(&g_trans, 0, sizeof(g_trans));
+    g_trans.from = g_demo.current;
+    g_trans.to = nextScene;
+    g_transWaiting = false;
+
+    StartPrepare(nextScene);
 }
 
 static void UpdateDemoState(DWORD nowTicks, bool requestSkip)
@@ -335,7 +487,7 @@ static void UpdateDemoState(DWORD nowTicks, bool requestSkip)
         }
 
         DWORD sceneElapsed = nowTicks - g_demo.sceneStartTicks;
-        DWORD dur = SceneDurationMs(g_demo.current);
+        DWORD dur = g_scenes[g_demo.current].durationMs;
 
         if (sceneElapsed >= dur)
             BeginTransitionTo(NextScene(g_demo.current), nowTicks);
@@ -343,6 +495,10 @@ static void UpdateDemoState(DWORD nowTicks, bool requestSkip)
         return;
     }
 
+    DWORD frameUs = (DWORD)(Clock_FrameSeconds() * 1000000.0f);
+    if (frameUs > g_trans.worstFrameUs)
+        g_trans.worstFrameUs = frameUs;
+
     DWORD elapsed = nowTicks - g_demo.transitionStartTicks;
 
     if (g_demo.transitionPhase == 0)
@@ -351,8 +507,33 @@ static void UpdateDemoState(DWORD nowTicks, bool requestSkip)
         {
             g_demo.overlayAlpha = 255;
 
-            ShutdownScene(g_demo.current);
-            InitScene(g_demo.next);
+            // Hold on black (frames keep presenting) until the loader is done
+            if (!PrepareDone())
+            {
+                if (!g_transWaiting)
+                {
+                    g_transWaiting = true;
+                    g_transWaitStartUs = Clock_ReadUs();
+                }
+                return;
+            }
+
+            if (g_transWaiting)
+                g_trans.waitUs = Clock_ReadUs() - g_transWaitStartUs;
+            g_trans.prepareUs = g_loaderUs;
+
+            DWORD swapStartUs = Clock_ReadUs();
+
+            g_scenes[g_demo.current].shutdown();
+            g_scenes[g_demo.next].init();
+
+            // The new scene's first frame sets all of its state for real
+            DevState_Invalidate();
+
+            g_trans.swapUs = Clock_ReadUs() - swapStartUs;
+
+            // Don't make the new scene catch up on its own Init time
+            Clock_ResetSteps();
 
             g_demo.current = g_demo.next;
             g_demo.sceneStartTicks = nowTicks;
@@ -372,6 +553,8 @@ static void UpdateDemoState(DWORD nowTicks, bool requestSkip)
             g_demo.overlayAlpha = 0;
             g_demo.inTransition = false;
             g_demo.transitionPhase = 0;
+
+            ReportTransition();
         }
         else
         {
@@ -391,6 +574,11 @@ static void RenderFrame(float demoTime)
     if (!g_pDevice)
         return;
 
+    Font_ResetStats();
+    DevState_ResetStats();
+    VRing_ResetStats();
+    Music_ResetStats();
+
     // === FIX: clear Z as well ===
     g_pDevice->Clear(
         0, NULL,
@@ -400,11 +588,13 @@ static void RenderFrame(float demoTime)
 
     g_pDevice->BeginScene();
 
-    RenderScene(g_demo.current, demoTime);
+    g_scenes[g_demo.current].render(demoTime);
     DrawFadeOverlay(g_demo.overlayAlpha);
 
     g_pDevice->EndScene();
-    g_pDevice->Present(NULL, NULL, NULL, NULL);
+
+    // Fence this frame's ring data
+    VRing_EndFrame();
 }
 
 // -----------------------------------------------------------------------------
@@ -419,12 +609,22 @@ void __cdecl main()
         while (1) Sleep(1000);
     }
 
+    // Before the loader (and music stream) threads start; startup timing
+    // runs from here, scene time restarts below
+    Clock_Init();
+
+    // Pack, music pre-roll and Plasma's tables load on the loader thread
+    // meanwhile
+    StartStartupLoad();
+
     // ---------------------------------------------------------------------
-    // Display settle: wait for TV to lock after mode switch
+    // Display settle: wait for TV to lock after mode switch, and for the
+    // startup load if that takes longer
     // ---------------------------------------------------------------------
     const int SETTLE_FRAMES = 90; // ~1.5s at 60Hz
 
-    for (int i = 0; i < SETTLE_FRAMES; ++i)
+    int settleFrames = 0;
+    while (settleFrames < SETTLE_FRAMES || !PrepareDone())
     {
         g_pDevice->Clear(
             0, NULL,
@@ -435,18 +635,22 @@ void __cdecl main()
         g_pDevice->BeginScene();
         g_pDevice->EndScene();
         g_pDevice->Present(NULL, NULL, NULL, NULL);
+        settleFrames++;
     }
 
-
-    Sleep(1750);
+    DWORD startupLoadUs = g_loaderUs;
 
     InitInput();
 
-    Music_Init("D:\\snd\\idk.trm");
-    Music_Play();
+    if (g_musicReady)
+        Music_Play();
     bool musicPaused = false;
 
-    DWORD startTicks = GetTickCount();
+    // Scene time starts at the first frame
+    Clock_ResetSceneTime();
+    Clock_SetSynthetic(PERF_CSV && PERF_SYNTHETIC_CLOCK);
+
+    DWORD startTicks = Clock_Ms();
 
     g_demo.current = SCENE_INTRO;
     g_demo.next = SCENE_PLASMA;
@@ -456,14 +660,21 @@ void __cdecl main()
     g_demo.transitionStartTicks = startTicks;
     g_demo.overlayAlpha = 0;
 
-    InitScene(g_demo.current);
+    g_scenes[g_demo.current].init();
 
     WORD lastButtons = 0;
+    bool firstFrame = true;
+
+    DWORD perfFrame = 0;
+    if (PERF_CSV)
+        Perf_WriteHeader();
 
     for (;;)
     {
-        DWORD now = GetTickCount();
-        float demoTime = (now - startTicks) / 1000.0f;
+        Clock_Tick();
+
+        DWORD now = Clock_Ms();
+        float demoTime = Clock_Seconds();
 
         PumpInput();
         WORD buttons = GetButtons();
@@ -482,26 +693,72 @@ void __cdecl main()
 
         bool requestSkip = (pressed & BTN_A) != 0;
 
-        Music_Update();
+        // Fixed-rate simulation: as many steps as wall time says are due,
+        // independent of how fast frames are presented. Present() paces the
+        // loop (vsync), so there is no Sleep here.
+        int steps = Clock_TakeSteps();
 
-        if (g_demo.current == SCENE_BALL && !g_demo.inTransition)
-        {
-            BallScene_Update();
-        }
+        DWORD t0 = Clock_ReadUs();
 
-        if (g_demo.current == SCENE_DRIP && !g_demo.inTransition)
+        if (!g_demo.inTransition)
         {
-            DripScene_Update();
+            SceneFn update = g_scenes[g_demo.current].update;
+            for (int i = 0; update && i < steps; ++i)
+                update();
         }
 
-        if (g_demo.current == SCENE_MAZE && !g_demo.inTransition)
-        {
-            MazeScene_Update();
-        }
+        DWORD t1 = Clock_ReadUs();
 
+        // May swap scenes; drawn is the one RenderFrame will draw
         UpdateDemoState(now, requestSkip);
+        DemoSceneId drawn = g_demo.current;
+
+        DWORD t2 = Clock_ReadUs();
         RenderFrame(demoTime);
+        DWORD t3 = Clock_ReadUs();
+
+        g_pDevice->Present(NULL, NULL, NULL, NULL);
 
-        Sleep(1);
+        // Time to first visible content, from the end of InitD3D
+        if (firstFrame)
+        {
+            LogStartup(settleFrames, startupLoadUs, Clock_ReadUs());
+            firstFrame = false;
+        }
+
+        if (PERF_CSV)
+        {
+            FontStats fs;
+            Font_GetStats(&fs);
+
+            DevStateStats ds;
+            DevState_GetStats(&ds);
+
+            VRingStats rs;
+            VRing_GetStats(&rs);
+
+            MusicStats ms;
+            Music_GetStats(&ms);
+
+            PerfFrame pf;
+            pf.frame = perfFrame++;
+            pf.scene = g_scenes[drawn].name;
+            pf.steps = steps;
+            pf.updateUs = t1 - t0;
+            pf.renderUs = t3 - t2;
+            pf.presentUs = Clock_ReadUs() - t3;
+            pf.fontDraws = fs.drawCalls;
+            pf.fontQuads = fs.quads;
+            pf.stateIssued = ds.issued;
+            pf.stateFiltered = ds.filtered;
+            pf.ringBytes = rs.bytes;
+            pf.ringWraps = rs.wraps;
+            pf.ringStalls = rs.stalls;
+            pf.ringFallbacks = rs.fallbacks;
+            pf.musicUnderruns = ms.underruns;
+            pf.musicLateReads = ms.lateReads;
+            pf.musicRefillUs = ms.maxRefillUs;
+            Perf_WriteFrame(&pf);
+        }
     }
 }
@@ -0,0 +1,187 @@
+#include "mipfilter.h"
+
+#include <math.h>
+
+unsigned int Mip_LevelCount(unsigned int w, unsigned int h)
+{
+    unsigned int levels = 1;
+    while (w > 1 || h > 1)
+    {
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+        levels++;
+    }
+    return levels;
+}
+
+// -----------------------------------------------------------------------------
+// Box
+// -----------------------------------------------------------------------------
+
+// Per-byte (a + b + 1) / 2
+static inline unsigned int Avg2(unsigned int a, unsigned int b)
+{
+    return (a | b) - (((a ^ b) >> 1) & 0x7F7F7F7F);
+}
+
+// Per-byte (a + b + c + d + 2) / 4: the top six bits of each byte are summed
+// in place (at most 4 x 63), the low two bits separately with the rounding
+// term (at most 14), so no byte carries into the next.
+static inline unsigned int Avg4(unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+{
+    unsigned int hi = ((a >> 2) & 0x3F3F3F3F) + ((b >> 2) & 0x3F3F3F3F) +
+                      ((c >> 2) & 0x3F3F3F3F) + ((d >> 2) & 0x3F3F3F3F);
+    unsigned int lo = (a & 0x03030303) + (b & 0x03030303) +
+                      (c & 0x03030303) + (d & 0x03030303) + 0x02020202;
+    return hi + ((lo >> 2) & 0x03030303);
+}
+
+void Mip_Box(const unsigned int* src, unsigned int w, unsigned int h, unsigned int* dst)
+{
+    if (w > 1 && h > 1)
+    {
+        unsigned int dw = w / 2, dh = h / 2;
+        for (unsigned int y = 0; y < dh; ++y)
+        {
+            const unsigned int* r0 = src + (2 * y) * w;
+            const unsigned int* r1 = r0 + w;
+            for (unsigned int x = 0; x < dw; ++x)
+                dst[x] = Avg4(r0[2 * x], r0[2 * x + 1], r1[2 * x], r1[2 * x + 1]);
+            dst += dw;
+        }
+    }
+    else if (w > 1)
+    {
+        for (unsigned int x = 0; x < w / 2; ++x)
+            dst[x] = Avg2(src[2 * x], src[2 * x + 1]);
+    }
+    else if (h > 1)
+    {
+        for (unsigned int y = 0; y < h / 2; ++y)
+            dst[y] = Avg2(src[2 * y], src[2 * y + 1]);
+    }
+    else
+    {
+        dst[0] = src[0];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Kaiser
+// -----------------------------------------------------------------------------
+
+static const int   KAISER_TAPS = 6;
+static const float KAISER_ALPHA = 4.0f;
+
+static float s_kaiserW[KAISER_TAPS];
+static bool  s_kaiserReady = false;
+
+// Zeroth-order modified Bessel function of the first kind
+static float BesselI0(float x)
+{
+    float sum = 1.0f, term = 1.0f;
+    for (int k = 1; k < 20; ++k)
+    {
+        float q = x / (2.0f * (float)k);
+        term *= q * q;
+        sum += term;
+    }
+    return sum;
+}
+
+// Tap i sits (i - 2.5) source texels from the destination texel's centre;
+// sinc at the halved rate, windowed over +/-3 texels, normalised to 1.
+static void BuildKaiserWeights()
+{
+    const float PI = 3.14159265f;
+    float total = 0.0f;
+
+    for (int i = 0; i < KAISER_TAPS; ++i)
+    {
+        float d = (float)i - 2.5f;
+        float x = PI * d * 0.5f;
+        float t = d / 3.0f;
+
+        float sinc = sinf(x) / x;
+        float window = BesselI0(KAISER_ALPHA * sqrtf(1.0f - t * t)) / BesselI0(KAISER_ALPHA);
+
+        s_kaiserW[i] = sinc * window;
+        total += s_kaiserW[i];
+    }
+
+    for (int i = 0; i < KAISER_TAPS; ++i)
+        s_kaiserW[i] /= total;
+
+    s_kaiserReady = true;
+}
+
+static inline unsigned int PackChannel(float v, int shift)
+{
+    int c = (int)(v + 0.5f);
+    if (c < 0) c = 0;
+    if (c > 255) c = 255;
+    return (unsigned int)c << shift;
+}
+
+unsigned int Mip_KaiserScratch(unsigned int w, unsigned int h)
+{
+    unsigned int dw = w > 1 ? w / 2 : 1;
+    return dw * h * 4;
+}
+
+void Mip_Kaiser(const unsigned int* src, unsigned int w, unsigned int h, unsigned int* dst,
+                float* scratch)
+{
+    if (!s_kaiserReady)
+        BuildKaiserWeights();
+
+    unsigned int dw = w > 1 ? w / 2 : 1;
+    unsigned int dh = h > 1 ? h / 2 : 1;
+
+    // Rows: w -> dw, channels unpacked to float (B, G, R, A)
+    for (unsigned int y = 0; y < h; ++y)
+    {
+        const unsigned int* row = src + y * w;
+        float* out = scratch + y * dw * 4;
+
+        for (unsigned int x = 0; x < dw; ++x, out += 4)
+        {
+            out[0] = out[1] = out[2] = out[3] = 0.0f;
+
+            for (int i = 0; i < KAISER_TAPS; ++i)
+            {
+                unsigned int t = w > 1 ? row[(2 * x + i - 2) & (w - 1)] : row[0];
+                float k = w > 1 ? s_kaiserW[i] : (i == 0 ? 1.0f : 0.0f);
+
+                out[0] += k * (float)(t & 255);
+                out[1] += k * (float)((t >> 8) & 255);
+                out[2] += k * (float)((t >> 16) & 255);
+                out[3] += k * (float)(t >> 24);
+            }
+        }
+    }
+
+    // Columns: h -> dh, repacked
+    for (unsigned int y = 0; y < dh; ++y)
+    {
+        for (unsigned int x = 0; x < dw; ++x)
+        {
+            float c[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            for (int i = 0; i < KAISER_TAPS; ++i)
+            {
+                unsigned int sy = h > 1 ? (2 * y + i - 2) & (h - 1) : 0;
+                float k = h > 1 ? s_kaiserW[i] : (i == 0 ? 1.0f : 0.0f);
+                const float* t = scratch + (sy * dw + x) * 4;
+
+                c[0] += k * t[0];
+                c[1] += k * t[1];
+                c[2] += k * t[2];
+                c[3] += k * t[3];
+            }
+
+            dst[y * dw + x] = PackChannel(c[0], 0) | PackChannel(c[1], 8) |
+                              PackChannel(c[2], 16) | PackChannel(c[3], 24);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Mip level downsampling for A8R8G8B8 images (0xAARRGGBB per texel, linear
+// rows). Shared by texcache (runtime, box) and tools/texbake (offline,
+// either kernel), so plain C types only; tools/mipbench times both.
+//
+// Each call halves a w x h image into max(w/2,1) x max(h/2,1). Sides are
+// powers of two; a side that is already 1 stays 1. Edges wrap, since every
+// mipped texture in the demo either tiles or has a clear border.
+
+// Levels in a full chain down to 1x1
+unsigned int Mip_LevelCount(unsigned int w, unsigned int h);
+
+// 2x2 average, exactly rounded per channel. Four channels at a time in
+// 32-bit integer math, no float or SIMD.
+void Mip_Box(const unsigned int* src, unsigned int w, unsigned int h, unsigned int* dst);
+
+// Separable 6-tap Kaiser-windowed sinc (alpha 4): sharper than the box and
+// without its aliasing, but float math at ~20x the box's cost, so texbake
+// uses it offline. scratch holds Mip_KaiserScratch(w, h) floats.
+unsigned int Mip_KaiserScratch(unsigned int w, unsigned int h);
+void Mip_Kaiser(const unsigned int* src, unsigned int w, unsigned int h, unsigned int* dst,
+                float* scratch);
@@ -1,4 +1,8 @@
 #include "music.h"
+#include "adpcm.h"
+#include "spectrum.h"
+#include "beat.h"
+#include "clock.h"
 #include <xtl.h>
 #include <string.h>
 #include <stdlib.h>
@@ -7,20 +11,42 @@
 static LPDIRECTSOUND8       s_ds = NULL;
 static LPDIRECTSOUNDBUFFER  s_buf = NULL;
 
+// Synchronous for Init's header parse and pre-roll, then reopened
+// overlapped for the stream thread
 static HANDLE s_file = INVALID_HANDLE_VALUE;
 
 static DWORD  s_dataOffset = 0;
 static DWORD  s_dataSize = 0;
-static DWORD  s_dataPos = 0;
+static DWORD  s_dataPos = 0;        // next byte to read; the stream thread's once it runs
 
-static WAVEFORMATEX s_wfx;
+static WAVEFORMATEX s_wfx;         // the buffer's: 16-bit PCM whatever the file holds
 static bool   s_ready = false;
 static bool   s_playing = false;
-static bool   s_wasPaused = false;   // NEW: distinguishes resume vs fresh start
+static bool   s_wasPaused = false;   // distinguishes resume vs fresh start
 
-// Streaming buffer
+// Streaming buffer: STREAM_SEGMENTS segments, each refilled whole once the
+// play cursor has left it. Totals are bytes since Init (wrap-safe as
+// differences).
 static DWORD  s_bufBytes = 0;
+static DWORD  s_segBytes = 0;
 static DWORD  s_writeCursor = 0;
+static DWORD  s_writtenTotal = 0;
+static DWORD  s_playedTotal = 0;
+static DWORD  s_lastPlay = 0;
+
+// Guards s_buf and the play state between the stream thread and the
+// Music_* calls
+static CRITICAL_SECTION s_lock;
+static bool             s_lockReady = false;
+
+// MusicStats, written by the stream thread only; Music_ResetStats may run on
+// the render thread while Init is still going, hence interlocked, no lock
+static volatile LONG s_statRefills = 0;
+static volatile LONG s_statUnderruns = 0;
+static volatile LONG s_statLateReads = 0;
+static volatile LONG s_statRefillUs = 0;
+static volatile LONG s_statMaxRefillUs = 0;
+static volatile LONG s_statMaxReadUs = 0;
 
 // -----------------------------------------------------------------------------
 // Startup squelch/click prevention + volume ramp (integer-only, RXDK-safe)
@@ -72,9 +98,13 @@ static void VolumeRamp_Update()
     }
 }
 
-// Keep some safety margin ahead of play cursor
-static const DWORD STREAM_CHUNK_BYTES = (32 * 1024);   // write in chunks
-static const DWORD STREAM_BUF_BYTES = (128 * 1024);  // ring buffer size
+// Buffer = STREAM_SEGMENTS x STREAM_CHUNK_BYTES (~0.7 s of 48 kHz
+// stereo); a position notification at each segment start wakes the stream
+// thread, which also polls every STREAM_POLL_MS (volume ramp, and in case a
+// notification is late).
+static const DWORD STREAM_CHUNK_BYTES = (32 * 1024);   // one segment
+static const int   STREAM_SEGMENTS = 4;
+static const DWORD STREAM_POLL_MS = 20;
 
 // --------------------------------------------------------------------------
 // Helpers
@@ -101,7 +131,7 @@ static bool ReadChunkHeader(HANDLE f, DWORD& outId, DWORD& outSize)
     return true;
 }
 
-// Minimal PCM WAV parser (RIFF/WAVE, fmt , data)
+// Minimal WAV parser (RIFF/WAVE, fmt , data): 16-bit PCM or IMA ADPCM
 static bool ParseWav(HANDLE f, WAVEFORMATEX& outFmt, DWORD& outDataOffset, DWORD& outDataSize)
 {
     SetFilePointer(f, 0, NULL, FILE_BEGIN);
@@ -166,49 +196,218 @@ static bool ParseWav(HANDLE f, WAVEFORMATEX& outFmt, DWORD& outDataOffset, DWORD
     if (!gotFmt || !gotData)
         return false;
 
-    // Only support PCM
-    if (outFmt.wFormatTag != 1)
+    if (outFmt.wFormatTag == 1)
+        return true;
+
+    // IMA ADPCM: mono or stereo, whole header + words per channel
+    if (outFmt.wFormatTag != ADPCM_FORMAT_TAG || outFmt.wBitsPerSample != 4 ||
+        outFmt.nChannels < 1 || outFmt.nChannels > 2)
+        return false;
+
+    DWORD perChannel = outFmt.nBlockAlign / outFmt.nChannels;
+    if (perChannel < 8 || (perChannel & 3) || perChannel * outFmt.nChannels != outFmt.nBlockAlign)
         return false;
 
     return true;
 }
 
 // --------------------------------------------------------------------------
-// UV analyzer (integer-only)
+// Spectrum and beats: analysed as refills write, published as the play
+// cursor gets there
 // --------------------------------------------------------------------------
 
-static volatile LONG s_uvPacked = 0; // packed 4x8-bit: low|mid|high|all
-static int s_avgFast = 0; // 0..32767-ish
-static int s_avgSlow = 0; // 0..32767-ish
+static SpectrumConfig s_specCfg = { 512, 16, 40, 16000, 0, 160, 24 };  // rate from the stream
+static Spectrum       s_spectrum;
+static BeatTracker    s_beat;
+static bool           s_specReady = false;
+static bool           s_beatReady = false;
+static DWORD          s_beatBase = 0;   // published beats when the tracker started
 
-static __forceinline int IAbsI(int v) { return (v < 0) ? -v : v; }
+// One analysis, stamped with the stream byte its window ends at
+struct SpecFrame
+{
+    DWORD         end;
+    DWORD         beats;                // s_beatBase + the tracker's, at the end
+    DWORD         phase;                // Q16
+    DWORD         periodQ8;             // frames per beat; 0 without a tempo
+    WORD          bpm;
+    BYTE          onset;                // strength; 0 for none
+    unsigned char levels[SPECTRUM_MAX_BANDS];
+};
+
+// Analyses wait here until the play cursor passes their end: refills run
+// up to a buffer (~0.7 s) ahead of what is heard. Room for a whole buffer
+// of the smallest windows (mono, 256 points); past that the oldest goes.
+static const DWORD SPEC_QUEUE = 256;
+static SpecFrame   s_specQueue[SPEC_QUEUE];
+static DWORD       s_specHead = 0;      // oldest waiting
+static DWORD       s_specTail = 0;
+
+// Published levels, four bands per LONG, read without the lock
+static volatile LONG s_bands[SPECTRUM_MAX_BANDS / 4];
+
+// Published beat state as of s_beatAtUs (Clock_ReadUs); readers carry the
+// phase on by the clock in between. Written under s_lock and read without
+// it, so bracketed by s_beatSeq, odd while a write is under way.
+static volatile LONG  s_beatSeq = 0;
+static volatile DWORD s_beatCount = 0;
+static volatile DWORD s_beatPhase = 0;      // Q16
+static volatile DWORD s_beatPeriodUs = 0;   // 0: holding (no tempo, or paused)
+static volatile DWORD s_beatAtUs = 0;
+static volatile DWORD s_beatBpm = 0;
+
+// Counts run on from the first Init, across reconfiguring
+static volatile LONG s_onsetCount = 0;
+static volatile LONG s_onsetStrength = 0;
+
+static void WriteBeat(DWORD beats, DWORD phase, DWORD periodUs, DWORD bpm)
+{
+    InterlockedIncrement(&s_beatSeq);
+    s_beatCount = beats;
+    s_beatPhase = phase;
+    s_beatPeriodUs = periodUs;
+    s_beatAtUs = Clock_ReadUs();
+    s_beatBpm = bpm;
+    InterlockedIncrement(&s_beatSeq);
+}
 
-static void UV_AnalyzePCM16(const void* data, DWORD bytes)
+// The published beat state, carried on to now
+static void ReadBeat(DWORD* beats, DWORD* phase, DWORD* bpm)
 {
-    if (!data || bytes < 4) return;
+    LONG seq;
+    DWORD count, ph, periodUs, atUs;
 
-    const short* s = (const short*)data;
-    DWORD samples = bytes / 2;
+    do
+    {
+        seq = s_beatSeq;
+        count = s_beatCount;
+        ph = s_beatPhase;
+        periodUs = s_beatPeriodUs;
+        atUs = s_beatAtUs;
+        *bpm = s_beatBpm;
+    }
+    while ((seq & 1) || seq != s_beatSeq);
 
-    int sum = 0;
-    for (DWORD i = 0; i < samples; ++i)
-        sum += IAbsI((int)s[i]);
+    // On from the last publish at the published tempo
+    LONG elapsed = (LONG)(Clock_ReadUs() - atUs);
+    if (periodUs && elapsed > 0)
+    {
+        ULONGLONG total = ph + (ULONGLONG)elapsed * 65536 / periodUs;
+        count += (DWORD)(total >> 16);
+        ph = (DWORD)total & 0xFFFF;
+    }
 
-    int avg = (samples > 0) ? (sum / (int)samples) : 0;
+    *beats = count;
+    *phase = ph;
+}
 
-    // Simple fast/slow smoothing (integer only)
-    s_avgFast = (s_avgFast * 3 + avg) / 4;
-    s_avgSlow = (s_avgSlow * 31 + avg) / 32;
+// Empties the queue and restarts the published levels; beats hold at the
+// count reached, and the tracker's go on from there
+static void ResetAnalysis()
+{
+    s_specHead = 0;
+    s_specTail = 0;
+    for (DWORD i = 0; i < SPECTRUM_MAX_BANDS / 4; ++i)
+        InterlockedExchange(&s_bands[i], 0);
+
+    DWORD beats, phase, bpm;
+    ReadBeat(&beats, &phase, &bpm);
+    s_beatBase = beats;
+    WriteBeat(beats, phase, 0, 0);
+}
+
+// Both analysers from s_specCfg (rate set); before the thread or under s_lock
+static void StartAnalysis()
+{
+    s_specReady = Spectrum_Configure(&s_spectrum, &s_specCfg);
+    s_beatReady = s_specReady && Beat_Configure(&s_beat, s_specCfg.bands, s_specCfg.sampleRate,
+                                                s_specCfg.fftSize);
+    if (!s_beatReady)
+        memset(&s_beat, 0, sizeof(s_beat));
+
+    ResetAnalysis();
+}
+
+// data holds the PCM16 going into the buffer at stream byte streamPos
+static void AnalyzePCM16(const BYTE* data, DWORD bytes, DWORD streamPos)
+{
+    if (!s_specReady)
+        return;
+
+    const short* pcm = (const short*)data;
+    DWORD frames = bytes / s_wfx.nBlockAlign;
+
+    while (frames)
+    {
+        bool analyzed = false;
+        DWORD used = Spectrum_Feed(&s_spectrum, pcm, frames, s_wfx.nChannels, &analyzed);
+
+        pcm += used * s_wfx.nChannels;
+        frames -= used;
+        streamPos += used * s_wfx.nBlockAlign;
+
+        if (!analyzed)
+            continue;
+
+        if (s_beatReady)
+            Beat_Feed(&s_beat, s_spectrum.raw);
+
+        if (s_specTail - s_specHead == SPEC_QUEUE)
+            s_specHead++;
+
+        SpecFrame* f = &s_specQueue[s_specTail++ % SPEC_QUEUE];
+        f->end = streamPos;
+        f->beats = s_beatBase + s_beat.beats;
+        f->phase = s_beat.phase;
+        f->periodQ8 = s_beat.periodQ8;
+        f->bpm = (WORD)(s_beatReady ? Beat_Bpm(&s_beat) : 0);
+        f->onset = (BYTE)s_beat.onset;
+        memcpy(f->levels, s_spectrum.levels, s_spectrum.cfg.bands);
+    }
+}
+
+// Under s_lock: publishes the newest analysis the play cursor has passed,
+// counting the onsets on the way
+static void PublishAnalysis()
+{
+    const SpecFrame* f = NULL;
+
+    while (s_specHead != s_specTail &&
+           (LONG)(s_specQueue[s_specHead % SPEC_QUEUE].end - s_playedTotal) <= 0)
+    {
+        f = &s_specQueue[s_specHead++ % SPEC_QUEUE];
+        if (f->onset)
+        {
+            InterlockedExchange(&s_onsetStrength, f->onset);
+            InterlockedIncrement(&s_onsetCount);
+        }
+    }
+
+    if (!f)
+        return;
+
+    for (DWORD i = 0; i < SPECTRUM_MAX_BANDS / 4; ++i)
+    {
+        const unsigned char* l = f->levels + i * 4;
+        InterlockedExchange(&s_bands[i], (LONG)(l[0] | (l[1] << 8) | (l[2] << 16) | ((DWORD)l[3] << 24)));
+    }
 
-    int a = s_avgFast >> 5; if (a > 255) a = 255;
-    int b = s_avgSlow >> 5; if (b > 255) b = 255;
+    // Beats as of the play cursor, a little past the window's end
+    DWORD beats = f->beats, phase = f->phase, periodUs = 0;
+    if (f->periodQ8)
+    {
+        periodUs = (DWORD)((ULONGLONG)f->periodQ8 * 1000000 / s_beat.frameRateQ8);
 
-    LONG packed = (LONG)((a & 255) | ((b & 255) << 8) | ((a & 255) << 16) | ((b & 255) << 24));
-    s_uvPacked = packed;
+        DWORD pastUs = (DWORD)((ULONGLONG)(s_playedTotal - f->end) * 1000000 / s_wfx.nAvgBytesPerSec);
+        ULONGLONG total = phase + (ULONGLONG)pastUs * 65536 / periodUs;
+        beats += (DWORD)(total >> 16);
+        phase = (DWORD)total & 0xFFFF;
+    }
+    WriteBeat(beats, phase, periodUs, f->bpm);
 }
 
 // --------------------------------------------------------------------------
-// Audio loop reader: reads from WAV data, loops seamlessly
+// Audio loop reader (Init's cache loads): reads from WAV data, loops seamlessly
 // --------------------------------------------------------------------------
 
 static DWORD ReadAudioLoop(BYTE* dst, DWORD bytes)
@@ -245,10 +444,117 @@ static DWORD ReadAudioLoop(BYTE* dst, DWORD bytes)
     return total;
 }
 
+// --------------------------------------------------------------------------
+// Read cache
+// --------------------------------------------------------------------------
+//
+// Either the whole data chunk (resident: loops in memory, and the file is
+// closed once Init has read it) or a read-ahead window the stream thread
+// keeps topped up from the disc. Only the stream thread touches it once
+// Init returns.
+
+static BYTE*  s_cache = NULL;
+static DWORD  s_cacheBytes = 0;
+static DWORD  s_cacheTail = 0;      // next byte to copy out
+static DWORD  s_cacheAvail = 0;     // bytes read ahead of the tail (window)
+static bool   s_resident = false;
+
+// Copies from the tail, wrapping at the cache end (for a resident cache,
+// the loop point); a window frees what it hands out
+static DWORD TakeCached(BYTE* dst, DWORD bytes)
+{
+    DWORD total = bytes;
+
+    while (bytes > 0)
+    {
+        DWORD run = s_cacheBytes - s_cacheTail;
+        if (run > bytes)
+            run = bytes;
+
+        memcpy(dst, s_cache + s_cacheTail, run);
+        dst += run;
+        bytes -= run;
+
+        s_cacheTail += run;
+        if (s_cacheTail == s_cacheBytes)
+            s_cacheTail = 0;
+    }
+
+    if (!s_resident)
+        s_cacheAvail -= total;
+    return total;
+}
+
+// Source coding. PCM is copied from the cache as is; IMA ADPCM is decoded
+// a block at a time, whole blocks straight into the buffer and a block
+// that only partly fits through a scratch block, the rest carried to the
+// next refill. The cache holds whole blocks, so none straddles its end.
+static bool   s_adpcm = false;
+static DWORD  s_srcBlock = 0;       // file bytes per block
+static DWORD  s_pcmBlock = 0;       // PCM bytes a block decodes to
+static BYTE*  s_pcmScratch = NULL;
+static DWORD  s_pcmAt = 0;
+static DWORD  s_pcmLeft = 0;        // decoded bytes carried in the scratch
+
+static DWORD TakeDecoded(BYTE* dst, DWORD bytes)
+{
+    DWORD total = bytes;
+
+    while (bytes > 0)
+    {
+        if (s_pcmLeft == 0)
+        {
+            const BYTE* block = s_cache + s_cacheTail;
+
+            s_cacheTail += s_srcBlock;
+            if (s_cacheTail == s_cacheBytes)
+                s_cacheTail = 0;
+            if (!s_resident)
+                s_cacheAvail -= s_srcBlock;
+
+            if (bytes >= s_pcmBlock)
+            {
+                Adpcm_DecodeBlock(block, s_srcBlock, s_wfx.nChannels, (short*)dst);
+                dst += s_pcmBlock;
+                bytes -= s_pcmBlock;
+                continue;
+            }
+
+            Adpcm_DecodeBlock(block, s_srcBlock, s_wfx.nChannels, (short*)s_pcmScratch);
+            s_pcmAt = 0;
+            s_pcmLeft = s_pcmBlock;
+        }
+
+        DWORD run = (bytes < s_pcmLeft) ? bytes : s_pcmLeft;
+        memcpy(dst, s_pcmScratch + s_pcmAt, run);
+        dst += run;
+        bytes -= run;
+        s_pcmAt += run;
+        s_pcmLeft -= run;
+    }
+
+    return total;
+}
+
+// Cache bytes the next pcmBytes of output will consume
+static DWORD SourceBytesFor(DWORD pcmBytes)
+{
+    if (!s_adpcm)
+        return pcmBytes;
+    if (pcmBytes <= s_pcmLeft)
+        return 0;
+    return (pcmBytes - s_pcmLeft + s_pcmBlock - 1) / s_pcmBlock * s_srcBlock;
+}
+
 // ------------------------------------------------------------
-// Streaming fill: write 'bytes' into buffer at s_writeCursor
+// Writes 'bytes' into the buffer at s_writeCursor from the cache
+// (TakeCached or TakeDecoded)
 // ------------------------------------------------------------
-static void FillBuffer(DWORD bytes)
+typedef DWORD (*AudioSource)(BYTE* dst, DWORD bytes);
+
+static AudioSource s_source = TakeCached;
+
+static void FillBuffer(DWORD bytes, AudioSource source)
 {
     if (!s_buf || !s_ready || bytes == 0)
         return;
@@ -264,51 +570,363 @@ static void FillBuffer(DWORD bytes)
 
     if (p1 && b1)
     {
-        ReadAudioLoop((BYTE*)p1, b1);
-        UV_AnalyzePCM16(p1, b1);
+        source((BYTE*)p1, b1);
+        AnalyzePCM16((const BYTE*)p1, b1, s_writtenTotal);
     }
     if (p2 && b2)
     {
-        ReadAudioLoop((BYTE*)p2, b2);
-        UV_AnalyzePCM16(p2, b2);
+        source((BYTE*)p2, b2);
+        AnalyzePCM16((const BYTE*)p2, b2, s_writtenTotal + b1);
     }
 
     s_buf->Unlock(p1, b1, p2, b2);
 
     s_writeCursor = (s_writeCursor + bytes) % s_bufBytes;
+    s_writtenTotal += bytes;
+}
+
+// Init only: tops the window up from the file, synchronously
+static void FillCacheSync()
+{
+    while (!s_resident && s_cacheAvail < s_cacheBytes)
+    {
+        DWORD at = (s_cacheTail + s_cacheAvail) % s_cacheBytes;
+        DWORD n = s_cacheBytes - at;
+        if (n > s_cacheBytes - s_cacheAvail)
+            n = s_cacheBytes - s_cacheAvail;
+
+        DWORD got = ReadAudioLoop(s_cache + at, n);
+        if (got < n)
+            memset(s_cache + at + got, 0, n - got);
+        s_cacheAvail += n;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Stream thread
+// --------------------------------------------------------------------------
+//
+// Refills are a memcpy from the read cache. With a window, disc reads are
+// overlapped (the thread never blocks on the drive) and large: one request
+// covers the free space up to the window end once half the window has
+// drained, so the drive idles in between. Nothing here runs on the render
+// thread.
+
+static HANDLE s_thread = NULL;
+static HANDLE s_stopEvent = NULL;
+static HANDLE s_readEvent = NULL;
+static HANDLE s_segEvents[STREAM_SEGMENTS] = { NULL, NULL, NULL, NULL };
+
+static bool       s_reading = false;
+static OVERLAPPED s_ov;
+static DWORD      s_readAt = 0;         // cache offset of the read in flight
+static DWORD      s_readBytes = 0;
+static DWORD      s_readStartUs = 0;
+static bool       s_starved = false;    // a segment is waiting for read-ahead
+
+// br of the s_readBytes requested arrived; a short or failed read is padded
+// with silence so the stream keeps time
+static void CompleteRead(DWORD br)
+{
+    if (br < s_readBytes)
+        memset(s_cache + s_readAt + br, 0, s_readBytes - br);
+
+    s_cacheAvail += s_readBytes;
+    s_dataPos += s_readBytes;
+    if (s_dataPos >= s_dataSize)
+        s_dataPos = 0;
+
+    DWORD readUs = Clock_ReadUs() - s_readStartUs;
+    if ((LONG)readUs > s_statMaxReadUs)
+        InterlockedExchange(&s_statMaxReadUs, (LONG)readUs);
+}
+
+// Issues the next read-ahead if half the window is free; false if not
+static bool StartRead()
+{
+    DWORD freeBytes = s_cacheBytes - s_cacheAvail;
+    if (freeBytes < s_cacheBytes / 2)
+        return false;
+
+    // Up to the window end and the loop point; the rest follows in the
+    // next request
+    s_readAt = (s_cacheTail + s_cacheAvail) % s_cacheBytes;
+    s_readBytes = s_cacheBytes - s_readAt;
+    if (s_readBytes > freeBytes)
+        s_readBytes = freeBytes;
+    if (s_readBytes > s_dataSize - s_dataPos)
+        s_readBytes = s_dataSize - s_dataPos;
+
+    ZeroMemory(&s_ov, sizeof(s_ov));
+    s_ov.Offset = s_dataOffset + s_dataPos;
+    s_ov.hEvent = s_readEvent;
+    s_readStartUs = Clock_ReadUs();
+
+    if (!ReadFile(s_file, s_cache + s_readAt, s_readBytes, NULL, &s_ov) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+        // Failed outright: no completion will come
+        CompleteRead(0);
+        return true;
+    }
+
+    s_reading = true;
+    return true;
+}
+
+// Collects a finished read and keeps the window topped up. Never waits.
+static void ServiceRead()
+{
+    if (s_resident)
+        return;
+
+    for (;;)
+    {
+        if (s_reading)
+        {
+            DWORD br = 0;
+            if (!GetOverlappedResult(s_file, &s_ov, &br, FALSE))
+            {
+                if (GetLastError() == ERROR_IO_INCOMPLETE)
+                    return;
+                br = 0;
+            }
+
+            s_reading = false;
+            ResetEvent(s_readEvent);
+            CompleteRead(br);
+        }
+
+        if (!StartRead())
+            return;
+    }
+}
+
+// Under s_lock, while playing: refills every segment the play cursor has
+// left, as far as staged data allows.
+static void Refill()
+{
+    DWORD play = 0, write = 0;
+    if (FAILED(s_buf->GetCurrentPosition(&play, &write)))
+        return;
+
+    // Polled far more often than once per buffer, so the cursor can't
+    // have lapped since the last look
+    s_playedTotal += (play + s_bufBytes - s_lastPlay) % s_bufBytes;
+    s_lastPlay = play;
+
+    if ((LONG)(s_playedTotal - s_writtenTotal) > 0)
+    {
+        // Played past the written data: resume at the next segment; the
+        // one under the cursor plays stale audio
+        InterlockedIncrement(&s_statUnderruns);
+        s_writeCursor = ((play / s_segBytes + 1) % STREAM_SEGMENTS) * s_segBytes;
+        s_writtenTotal = s_playedTotal + (s_writeCursor + s_bufBytes - play) % s_bufBytes;
+    }
+
+    for (;;)
+    {
+        DWORD ahead = s_writtenTotal - s_playedTotal;
+        if (ahead + s_segBytes > s_bufBytes)
+            return;
+
+        if (!s_resident && s_cacheAvail < SourceBytesFor(s_segBytes))
+        {
+            // The read completing wakes the thread again
+            if (!s_starved)
+                InterlockedIncrement(&s_statLateReads);
+            s_starved = true;
+            return;
+        }
+        s_starved = false;
+
+        // The segment came free when the cursor passed its end; how far the
+        // cursor has gone since is the refill latency
+        DWORD lateBytes = s_bufBytes - s_segBytes - ahead;
+        DWORD lateUs = (DWORD)((ULONGLONG)lateBytes * 1000000 / s_wfx.nAvgBytesPerSec);
+
+        FillBuffer(s_segBytes, s_source);
+
+        InterlockedIncrement(&s_statRefills);
+        InterlockedExchange(&s_statRefillUs, (LONG)lateUs);
+        if ((LONG)lateUs > s_statMaxRefillUs)
+            InterlockedExchange(&s_statMaxRefillUs, (LONG)lateUs);
+    }
+}
+
+static DWORD WINAPI StreamThreadProc(LPVOID)
+{
+    HANDLE waits[2 + STREAM_SEGMENTS];
+    waits[0] = s_stopEvent;
+    waits[1] = s_readEvent;
+    for (int i = 0; i < STREAM_SEGMENTS; ++i)
+        waits[2 + i] = s_segEvents[i];
+
+    for (;;)
+    {
+        DWORD r = WaitForMultipleObjects(2 + STREAM_SEGMENTS, waits, FALSE, STREAM_POLL_MS);
+        if (r == WAIT_OBJECT_0)
+            break;
+
+        ServiceRead();
+
+        EnterCriticalSection(&s_lock);
+        DirectSoundDoWork();
+        if (s_playing)
+        {
+            VolumeRamp_Update();
+            Refill();
+            PublishAnalysis();
+        }
+        LeaveCriticalSection(&s_lock);
+
+        // Refill may have freed enough of the window for the next read
+        ServiceRead();
+    }
+
+    // The cache goes after this; let a read in flight land first
+    if (s_reading)
+    {
+        DWORD br = 0;
+        GetOverlappedResult(s_file, &s_ov, &br, TRUE);
+        s_reading = false;
+    }
+    return 0;
+}
+
+static bool StartStream(const char* path)
+{
+    // A window reads on from here, overlapped; a resident cache is done
+    // with the file
+    CloseHandle(s_file);
+    s_file = INVALID_HANDLE_VALUE;
+
+    if (!s_resident)
+    {
+        s_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
+        if (s_file == INVALID_HANDLE_VALUE)
+            return false;
+    }
+
+    s_stopEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    s_readEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (!s_stopEvent || !s_readEvent)
+        return false;
+
+    DSBPOSITIONNOTIFY notify[STREAM_SEGMENTS];
+    for (int i = 0; i < STREAM_SEGMENTS; ++i)
+    {
+        s_segEvents[i] = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (!s_segEvents[i])
+            return false;
+
+        notify[i].dwOffset = (DWORD)i * s_segBytes;
+        notify[i].hEventNotify = s_segEvents[i];
+    }
+
+    if (FAILED(s_buf->SetNotificationPositions(STREAM_SEGMENTS, notify)))
+        return false;
+
+    s_reading = false;
+    s_starved = false;
+
+    s_thread = CreateThread(NULL, 0, StreamThreadProc, NULL, 0, NULL);
+    if (!s_thread)
+        return false;
+
+    SetThreadPriority(s_thread, THREAD_PRIORITY_HIGHEST);
+    return true;
+}
+
+static void StopStream()
+{
+    if (s_thread)
+    {
+        SetEvent(s_stopEvent);
+        WaitForSingleObject(s_thread, INFINITE);
+        CloseHandle(s_thread);
+        s_thread = NULL;
+    }
+
+    if (s_stopEvent) { CloseHandle(s_stopEvent); s_stopEvent = NULL; }
+    if (s_readEvent) { CloseHandle(s_readEvent); s_readEvent = NULL; }
+
+    for (int i = 0; i < STREAM_SEGMENTS; ++i)
+    {
+        if (s_segEvents[i]) { CloseHandle(s_segEvents[i]); s_segEvents[i] = NULL; }
+    }
 }
 
 // ------------------------------------------------------------
 // Public API
 // ------------------------------------------------------------
 
-bool Music_Init(const char* path)
+bool Music_Init(const char* path, DWORD cacheBytes)
 {
     Music_Shutdown();
 
     if (!path || !path[0])
         return false;
 
+    if (!s_lockReady)
+    {
+        InitializeCriticalSection(&s_lock);
+        s_lockReady = true;
+    }
+
     s_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
     if (s_file == INVALID_HANDLE_VALUE)
         return false;
 
-    if (!ParseWav(s_file, s_wfx, s_dataOffset, s_dataSize))
+    if (!ParseWav(s_file, s_wfx, s_dataOffset, s_dataSize) || s_dataSize == 0)
     {
         Music_Shutdown();
         return false;
     }
 
+    // The buffer always plays 16-bit PCM; ADPCM data is trimmed to whole
+    // blocks
+    s_adpcm = s_wfx.wFormatTag == ADPCM_FORMAT_TAG;
+    if (s_adpcm)
+    {
+        WORD channels = s_wfx.nChannels;
+
+        s_srcBlock = s_wfx.nBlockAlign;
+        s_pcmBlock = Adpcm_SamplesPerBlock(s_srcBlock, channels) * channels * 2;
+        s_dataSize = AlignDown(s_dataSize, s_srcBlock);
+
+        s_wfx.wFormatTag = 1;
+        s_wfx.wBitsPerSample = 16;
+        s_wfx.nBlockAlign = (WORD)(channels * 2);
+        s_wfx.nAvgBytesPerSec = s_wfx.nSamplesPerSec * s_wfx.nBlockAlign;
+        s_wfx.cbSize = 0;
+
+        s_pcmScratch = (BYTE*)malloc(s_pcmBlock);
+        if (s_dataSize == 0 || !s_pcmScratch)
+        {
+            Music_Shutdown();
+            return false;
+        }
+    }
+    else
+    {
+        s_srcBlock = s_wfx.nBlockAlign;
+        s_pcmBlock = s_wfx.nBlockAlign;
+    }
+    s_source = s_adpcm ? TakeDecoded : TakeCached;
+    s_pcmAt = 0;
+    s_pcmLeft = 0;
+
     if (FAILED(DirectSoundCreate(NULL, &s_ds, NULL)) || !s_ds)
     {
         Music_Shutdown();
         return false;
     }
 
-    s_bufBytes = STREAM_BUF_BYTES;
-    s_bufBytes = AlignDown(s_bufBytes, s_wfx.nBlockAlign);
-    if (s_bufBytes < (DWORD)(s_wfx.nBlockAlign * 256))
-        s_bufBytes = AlignDown(s_wfx.nBlockAlign * 256, s_wfx.nBlockAlign);
+    s_segBytes = AlignDown(STREAM_CHUNK_BYTES, s_wfx.nBlockAlign);
+    s_bufBytes = s_segBytes * STREAM_SEGMENTS;
 
     DSBUFFERDESC desc;
     ZeroMemory(&desc, sizeof(desc));
@@ -325,23 +943,72 @@ bool Music_Init(const char* path)
         return false;
     }
 
-    s_dataPos = 0;
-    s_writeCursor = 0;
+    // Read cache: the whole data chunk if the budget covers it, else a
+    // window of whole source blocks, at least two segments' worth
+    s_resident = false;
+    if (cacheBytes >= s_dataSize)
+    {
+        s_cache = (BYTE*)malloc(s_dataSize);
+        if (s_cache)
+        {
+            s_resident = true;
+            s_cacheBytes = s_dataSize;
+        }
+        else
+        {
+            cacheBytes = 0;
+        }
+    }
+    if (!s_resident)
+    {
+        DWORD minBytes = 2 * SourceBytesFor(s_segBytes);
+        if (cacheBytes < minBytes)
+            cacheBytes = minBytes;
+
+        s_cacheBytes = AlignDown(cacheBytes, s_srcBlock);
+        s_cache = (BYTE*)malloc(s_cacheBytes);
+        if (!s_cache)
+        {
+            Music_Shutdown();
+            return false;
+        }
+    }
+    s_cacheTail = 0;
+    s_cacheAvail = 0;
 
-    s_avgFast = 0;
-    s_avgSlow = 0;
-    s_uvPacked = 0;
+    // Before the pre-roll, which it analyses too
+    s_specCfg.sampleRate = s_wfx.nSamplesPerSec;
+    StartAnalysis();
 
-    // Prime ring (FillBuffer is guarded by s_ready)
+    // Prime the whole ring from the start of the stream (FillBuffer is
+    // guarded by s_ready), so the first Play needs no disc access
     s_ready = true;
 
     s_buf->Stop();
     s_buf->SetCurrentPosition(0);
-    s_writeCursor = 0;
     s_dataPos = 0;
+    s_writeCursor = 0;
+    s_writtenTotal = 0;
+    s_playedTotal = 0;
+    s_lastPlay = 0;
 
     ClearBufferToSilence();
-    FillBuffer(s_bufBytes);
+
+    if (s_resident)
+    {
+        // One pass over the chunk; the stream loops in memory from here
+        DWORD got = ReadAudioLoop(s_cache, s_cacheBytes);
+        if (got < s_cacheBytes)
+            memset(s_cache + got, 0, s_cacheBytes - got);
+    }
+
+    // A segment at a time, the window topped up in between
+    for (int i = 0; i < STREAM_SEGMENTS; ++i)
+    {
+        FillCacheSync();
+        FillBuffer(s_segBytes, s_source);
+    }
+    FillCacheSync();
 
     s_targetVol = DSBVOLUME_MAX;
     s_curVol = DSBVOLUME_MAX;
@@ -349,19 +1016,30 @@ bool Music_Init(const char* path)
     s_buf->SetVolume(s_targetVol);
 
     s_playing = false;
-    s_wasPaused = false; // NEW
+    s_wasPaused = false;
+
+    if (!StartStream(path))
+    {
+        Music_Shutdown();
+        return false;
+    }
     return true;
 }
 
 void Music_Shutdown()
 {
+    // Silence first: the thread's exit waits out any read in flight
+    if (s_buf)
+        s_buf->Stop();
+
+    StopStream();
+
     s_ready = false;
     s_playing = false;
     s_wasPaused = false;
 
     if (s_buf)
     {
-        s_buf->Stop();
         s_buf->Release();
         s_buf = NULL;
     }
@@ -377,15 +1055,34 @@ void Music_Shutdown()
         s_file = INVALID_HANDLE_VALUE;
     }
 
+    if (s_cache)
+    {
+        free(s_cache);
+        s_cache = NULL;
+    }
+    if (s_pcmScratch)
+    {
+        free(s_pcmScratch);
+        s_pcmScratch = NULL;
+    }
+    s_adpcm = false;
+    s_pcmAt = 0;
+    s_pcmLeft = 0;
+    s_cacheBytes = 0;
+    s_cacheTail = 0;
+    s_cacheAvail = 0;
+    s_resident = false;
+
     s_dataOffset = 0;
     s_dataSize = 0;
     s_dataPos = 0;
     s_bufBytes = 0;
+    s_segBytes = 0;
     s_writeCursor = 0;
 
-    s_avgFast = 0;
-    s_avgSlow = 0;
-    s_uvPacked = 0;
+    s_specReady = false;
+    s_beatReady = false;
+    ResetAnalysis();
 
     s_targetVol = DSBVOLUME_MAX;
     s_curVol = DSBVOLUME_MAX;
@@ -397,41 +1094,34 @@ void Music_Play()
     if (!s_ready || !s_buf)
         return;
 
-    // Resume from pause (do NOT reset stream/buffer)
-    if (s_wasPaused)
+    EnterCriticalSection(&s_lock);
+
+    if (!s_playing)
     {
-        s_targetVol = DSBVOLUME_MAX;
-        s_curVol = DSBVOLUME_MAX;
-        s_rampLeft = 0;
+        if (s_wasPaused)
+        {
+            // Resume from pause (do NOT reset stream/buffer)
+            s_targetVol = DSBVOLUME_MAX;
+            s_curVol = DSBVOLUME_MAX;
+            s_rampLeft = 0;
+            s_buf->SetVolume(s_targetVol);
+        }
+        else
+        {
+            // First start: the buffer holds Init's pre-roll. Gentle ramp-in
+            // to avoid any residual click at start (integer-only).
+            s_targetVol = DSBVOLUME_MAX;
+            s_curVol = -2400; // ~ -24 dB
+            s_rampLeft = 12;    // ramp over ~12 stream thread polls
+            s_buf->SetVolume(s_curVol);
+        }
 
-        s_buf->SetVolume(s_targetVol);
         s_buf->Play(0, 0, DSBPLAY_LOOPING);
-
         s_playing = true;
         s_wasPaused = false;
-        return;
     }
 
-    // Fresh start (full reset)
-    s_buf->Stop();
-    s_playing = false;
-
-    s_dataPos = 0;
-    s_writeCursor = 0;
-    s_buf->SetCurrentPosition(0);
-
-    ClearBufferToSilence();
-    FillBuffer(s_bufBytes);
-
-    // Gentle ramp-in to avoid any residual click at start (integer-only).
-    s_targetVol = DSBVOLUME_MAX;
-    s_curVol = -2400; // ~ -24 dB
-    s_rampLeft = 12;    // ramp over ~12 updates
-
-    s_buf->SetVolume(s_curVol);
-    s_buf->Play(0, 0, DSBPLAY_LOOPING);
-    s_playing = true;
-    s_wasPaused = false;
+    LeaveCriticalSection(&s_lock);
 }
 
 void Music_Pause()
@@ -439,56 +1129,171 @@ void Music_Pause()
     if (!s_ready || !s_buf)
         return;
 
+    EnterCriticalSection(&s_lock);
+
     if (s_playing)
     {
         s_buf->Stop();
+
+        // Beats hold where the music stopped
+        DWORD beats, phase, bpm;
+        ReadBeat(&beats, &phase, &bpm);
+        WriteBeat(beats, phase, 0, bpm);
+
         s_playing = false;
-        s_wasPaused = true; // NEW: allow resume
+        s_wasPaused = true;
     }
+
+    LeaveCriticalSection(&s_lock);
 }
 
-void Music_Update()
+bool Music_IsReady() { return s_ready; }
+bool Music_IsPlaying() { return s_playing; }
+
+DWORD Music_GetResidentBytes() { return s_cacheBytes; }
+DWORD Music_GetStreamBytes() { return s_dataSize; }
+
+bool Music_ConfigureSpectrum(const SpectrumConfig* cfg)
+{
+    if (!cfg)
+        return false;
+
+    SpectrumConfig c = *cfg;
+    c.sampleRate = s_ready ? s_wfx.nSamplesPerSec : 48000;
+
+    // Without a stream (no lock yet, or no thread) this only validates;
+    // Init configures from s_specCfg
+    if (s_lockReady)
+        EnterCriticalSection(&s_lock);
+
+    bool ok = Spectrum_Configure(&s_spectrum, &c);
+    if (ok)
+    {
+        s_specCfg = c;
+        if (s_ready)
+            StartAnalysis();
+        else
+            s_specReady = false;
+    }
+
+    if (s_lockReady)
+        LeaveCriticalSection(&s_lock);
+    return ok;
+}
+
+int Music_GetBands(int* out, int maxBands)
 {
-    if (!s_ready || !s_buf || !s_playing)
+    if (!out || maxBands <= 0)
+        return 0;
+
+    int n = s_specReady ? (int)s_specCfg.bands : 0;
+    if (n > maxBands)
+        n = maxBands;
+
+    for (int b = 0; b < n; ++b)
+        out[b] = (s_bands[b >> 2] >> ((b & 3) * 8)) & 255;
+    return n;
+}
+
+void Music_GetUVLevels(int out4[4])
+{
+    if (!out4) return;
+
+    int bands[SPECTRUM_MAX_BANDS];
+    int n = Music_GetBands(bands, SPECTRUM_MAX_BANDS);
+
+    out4[0] = out4[1] = out4[2] = out4[3] = 0;
+    if (n == 0)
         return;
 
-    DWORD play = 0, write = 0;
-    if (FAILED(s_buf->GetCurrentPosition(&play, &write)))
+    // Thirds of the bands (at least one each), then all of them
+    int all = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int lo = i * n / 3, hi = (i + 1) * n / 3;
+        if (lo > n - 1) lo = n - 1;
+        if (hi <= lo) hi = lo + 1;
+
+        int sum = 0;
+        for (int b = lo; b < hi; ++b)
+            sum += bands[b];
+        out4[i] = sum / (hi - lo);
+    }
+    for (int b = 0; b < n; ++b)
+        all += bands[b];
+    out4[3] = all / n;
+}
+
+void Music_GetBeat(MusicBeat* out)
+{
+    if (!out)
         return;
 
-    VolumeRamp_Update();
+    DWORD beats, phase, bpm;
+    ReadBeat(&beats, &phase, &bpm);
 
-    DWORD targetAhead = s_bufBytes / 2;
+    out->beats = beats;
+    out->phase = (int)(phase >> 8);
+    out->bpm = (int)bpm;
+    out->onsets = (DWORD)s_onsetCount;
+    out->onsetStrength = (int)s_onsetStrength;
+}
 
-    DWORD ahead = 0;
-    if (s_writeCursor >= play) ahead = s_writeCursor - play;
-    else ahead = (s_bufBytes - play) + s_writeCursor;
+int Music_GetBeatPhase()
+{
+    DWORD beats, phase, bpm;
+    ReadBeat(&beats, &phase, &bpm);
+    return (int)(phase >> 8);
+}
 
-    while (ahead < targetAhead)
-    {
-        DWORD bytes = STREAM_CHUNK_BYTES;
-        if (bytes > (targetAhead - ahead))
-            bytes = (targetAhead - ahead);
+// Counts since *cursor, which moves up to now; never backwards, so a beat
+// count pulled back by a phase correction isn't seen twice
+static int PollCount(DWORD now, DWORD* cursor)
+{
+    LONG n = (LONG)(now - *cursor);
+    if (n <= 0)
+        return 0;
 
-        bytes = AlignDown(bytes, s_wfx.nBlockAlign);
-        if (bytes == 0) break;
+    *cursor = now;
+    return (int)n;
+}
 
-        FillBuffer(bytes);
+int Music_PollBeats(DWORD* cursor)
+{
+    if (!cursor)
+        return 0;
 
-        if (s_writeCursor >= play) ahead = s_writeCursor - play;
-        else ahead = (s_bufBytes - play) + s_writeCursor;
-    }
+    DWORD beats, phase, bpm;
+    ReadBeat(&beats, &phase, &bpm);
+    return PollCount(beats, cursor);
 }
 
-bool Music_IsReady() { return s_ready; }
-bool Music_IsPlaying() { return s_playing; }
+int Music_PollOnsets(DWORD* cursor)
+{
+    if (!cursor)
+        return 0;
+    return PollCount((DWORD)s_onsetCount, cursor);
+}
 
-void Music_GetUVLevels(int out4[4])
+void Music_ResetStats()
 {
-    if (!out4) return;
-    LONG p = s_uvPacked;
-    out4[0] = (p >> 0) & 255;
-    out4[1] = (p >> 8) & 255;
-    out4[2] = (p >> 16) & 255;
-    out4[3] = (p >> 24) & 255;
+    InterlockedExchange(&s_statRefills, 0);
+    InterlockedExchange(&s_statUnderruns, 0);
+    InterlockedExchange(&s_statLateReads, 0);
+    InterlockedExchange(&s_statRefillUs, 0);
+    InterlockedExchange(&s_statMaxRefillUs, 0);
+    InterlockedExchange(&s_statMaxReadUs, 0);
+}
+
+void Music_GetStats(MusicStats* out)
+{
+    if (!out)
+        return;
+
+    out->refills = (DWORD)s_statRefills;
+    out->underruns = (DWORD)s_statUnderruns;
+    out->lateReads = (DWORD)s_statLateReads;
+    out->refillUs = (DWORD)s_statRefillUs;
+    out->maxRefillUs = (DWORD)s_statMaxRefillUs;
+    out->maxReadUs = (DWORD)s_statMaxReadUs;
 }
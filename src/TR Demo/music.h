@@ -1,29 +1,107 @@
 #pragma once
 #include <xtl.h>
+#include "spectrum.h"
 
-// Simple streamed WAV (PCM) player using DirectSound.
-// idk.trm is treated as a WAV file.
+// Streamed WAV player using DirectSound: 16-bit PCM or IMA ADPCM.
+// The .trm tracks are WAV files; main.cpp prefers idk_adpcm.trm and falls
+// back to the PCM idk.trm.
 //
 // Usage:
-//   if (Music_Init("D:\\idk.trm")) Music_Play();
-//   each frame: Music_Update();
+//   if (Music_Init("D:\\snd\\idk_adpcm.trm", MUSIC_CACHE_MIN)) Music_Play();
 //   START toggle: Music_Pause() / Music_Play();
 //   on exit: Music_Shutdown();
 
-bool Music_Init(const char* path);
+// The file may hold 16-bit PCM or IMA ADPCM (tools/adpcmenc, a quarter of
+// the size), which refills decode into the buffer; the cache holds the
+// file's data either way.
+//
+// Read cache budget for Music_Init. Refills always come from the cache; it
+// holds the whole data chunk when cacheBytes covers it (no disc I/O after
+// Init, which reads it all), otherwise a read-ahead window of cacheBytes
+// rounded down to whole blocks, at least two 32 KB segments' worth,
+// refilled by large sequential reads.
+static const DWORD MUSIC_CACHE_MIN = 0;            // two-segment window
+static const DWORD MUSIC_CACHE_ALL = 0xFFFFFFFF;   // whole chunk, any size
+
+// Parses the header, loads the cache and fills the whole stream buffer
+// (pre-roll), so the first Music_Play starts without touching the disc,
+// then starts the stream thread: it wakes on the buffer's position
+// notifications and refills from the cache, so the render loop does no
+// audio work. No other Music_* call but the stats may overlap Init;
+// main.cpp runs it on the startup loader thread.
+bool Music_Init(const char* path, DWORD cacheBytes);
 void Music_Shutdown();
 
 void Music_Play();     // start/resume
 void Music_Pause();    // pause/stop
 
-void Music_Update();   // stream refill (call once per frame)
-
 bool Music_IsReady();
 bool Music_IsPlaying();
 
+// Bytes of audio held in the read cache (besides the DirectSound buffer);
+// equal to Music_GetStreamBytes when the whole data chunk is resident
+DWORD Music_GetResidentBytes();
+DWORD Music_GetStreamBytes();
+
 // -----------------------------------------------------------------------------
-// UV Meter levels (0..255 each)
-// out[0]=low, out[1]=mid, out[2]=high, out[3]=overall
-// Safe: no float->int casts, computed from streamed PCM.
+// Spectrum (spectrum.h): band levels of what is playing, 0..255 each
+//
+// Refills analyse the PCM they write (an FFT per fftSize frames, so the
+// cost follows the refills); each analysis is published when the play
+// cursor reaches it. Default: 512 points, 16 bands over 40..16000 Hz,
+// fast attack, ~0.1 s release. Levels hold while paused.
 // -----------------------------------------------------------------------------
+
+// fftSize, bands, loHz/hiHz and attack/release as SpectrumConfig has them;
+// the sample rate comes from the stream. False (nothing changed) if
+// Spectrum_Configure rejects it. Any time but during Init; levels restart
+// from zero and the tempo is found again.
+bool Music_ConfigureSpectrum(const SpectrumConfig* cfg);
+
+// Writes up to maxBands levels, lowest band first; returns how many
+// (0 without a stream)
+int Music_GetBands(int* out, int maxBands);
+
+// UV Meter levels from the bands (0..255 each): out[0]=low, out[1]=mid,
+// out[2]=high (averages of the lower, middle and upper thirds of the
+// bands), out[3]=overall (all of them)
 void Music_GetUVLevels(int out4[4]);
+
+// -----------------------------------------------------------------------------
+// Beats (beat.h): onsets and tempo tracked on the same analyses, published
+// with them, so they line up with what is heard. The phase runs on by the
+// clock between the stream thread's updates, smooth at any frame rate.
+// -----------------------------------------------------------------------------
+struct MusicBeat
+{
+    DWORD beats;          // beats played; counts run on from the first Init
+    int   phase;          // 0..255 through the current beat, 0 on it
+    int   bpm;            // 0 without a tempo: beats and phase hold still
+    DWORD onsets;         // onsets (hits) played
+    int   onsetStrength;  // the latest one's, 1..255
+};
+
+void Music_GetBeat(MusicBeat* out);
+int  Music_GetBeatPhase();
+
+// Beats / onsets since *cursor, which moves up to now; 0 if none. Start a
+// cursor from Music_GetBeat's counts, then per update:
+//   if (Music_PollBeats(&s_beatCursor)) ...on the beat...
+int  Music_PollBeats(DWORD* cursor);
+int  Music_PollOnsets(DWORD* cursor);
+
+// -----------------------------------------------------------------------------
+// Streaming stats, accumulated by the stream thread since the last reset
+// -----------------------------------------------------------------------------
+struct MusicStats
+{
+    DWORD refills;        // segments refilled
+    DWORD underruns;      // play cursor overran the written data
+    DWORD lateReads;      // a segment came free before its read-ahead finished
+    DWORD refillUs;       // last refill: time from segment free to refilled
+    DWORD maxRefillUs;
+    DWORD maxReadUs;      // slowest read-ahead request (window cache)
+};
+
+void Music_ResetStats();
+void Music_GetStats(MusicStats* out);
@@ -0,0 +1,62 @@
+#include "perf.h"
+
+// -----------------------------------------------------------------------------
+// Formatting
+// -----------------------------------------------------------------------------
+
+char* Perf_AppendStr(char* p, const char* s)
+{
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+char* Perf_AppendUInt(char* p, DWORD v)
+{
+    char tmp[12];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+// -----------------------------------------------------------------------------
+// CSV
+// -----------------------------------------------------------------------------
+
+void Perf_WriteHeader()
+{
+    OutputDebugStringA(
+        "frame,scene,steps,update_us,render_us,present_us,"
+        "font_draws,font_quads,state_issued,state_filtered,"
+        "ring_bytes,ring_wraps,ring_stalls,ring_fallbacks,"
+        "music_underruns,music_late_reads,music_refill_us\n");
+}
+
+void Perf_WriteFrame(const PerfFrame* f)
+{
+    // 17 numeric fields of <= 10 digits + scene name + separators
+    char buf[240];
+    char* p = buf;
+
+    p = Perf_AppendUInt(p, f->frame);           *p++ = ',';
+    p = Perf_AppendStr(p, f->scene);            *p++ = ',';
+    p = Perf_AppendUInt(p, (DWORD)f->steps);    *p++ = ',';
+    p = Perf_AppendUInt(p, f->updateUs);        *p++ = ',';
+    p = Perf_AppendUInt(p, f->renderUs);        *p++ = ',';
+    p = Perf_AppendUInt(p, f->presentUs);       *p++ = ',';
+    p = Perf_AppendUInt(p, f->fontDraws);       *p++ = ',';
+    p = Perf_AppendUInt(p, f->fontQuads);       *p++ = ',';
+    p = Perf_AppendUInt(p, f->stateIssued);     *p++ = ',';
+    p = Perf_AppendUInt(p, f->stateFiltered);   *p++ = ',';
+    p = Perf_AppendUInt(p, f->ringBytes);       *p++ = ',';
+    p = Perf_AppendUInt(p, f->ringWraps);       *p++ = ',';
+    p = Perf_AppendUInt(p, f->ringStalls);      *p++ = ',';
+    p = Perf_AppendUInt(p, f->ringFallbacks);   *p++ = ',';
+    p = Perf_AppendUInt(p, f->musicUnderruns);  *p++ = ',';
+    p = Perf_AppendUInt(p, f->musicLateReads);  *p++ = ',';
+    p = Perf_AppendUInt(p, f->musicRefillUs);
+    *p++ = '\n';
+    *p = 0;
+
+    OutputDebugStringA(buf);
+}
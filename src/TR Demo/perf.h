@@ -0,0 +1,43 @@
+#pragma once
+#include <xtl.h>
+
+// Per-frame CPU / submission recorder, written as CSV to the debug output.
+//
+// main.cpp fills one PerfFrame per presented frame when PERF_CSV is on and
+// hands it to Perf_WriteFrame. Run with the synthetic clock for a repeatable
+// baseline: the scene sequence and every scene's timing then depend only on
+// the frame number, so two runs differ only in the measured times.
+//
+// Columns:
+//   frame, scene, steps, update_us, render_us, present_us,
+//   font_draws, font_quads, state_issued, state_filtered,
+//   ring_bytes, ring_wraps, ring_stalls, ring_fallbacks,
+//   music_underruns, music_late_reads, music_refill_us
+
+struct PerfFrame
+{
+    DWORD       frame;
+    const char* scene;
+    int         steps;          // fixed simulation steps run this frame
+    DWORD       updateUs;       // scene Update calls
+    DWORD       renderUs;       // Clear .. EndScene (CPU side)
+    DWORD       presentUs;      // Present (includes the vsync wait)
+    DWORD       fontDraws;
+    DWORD       fontQuads;
+    DWORD       stateIssued;    // DevState Set* calls sent to the device
+    DWORD       stateFiltered;  // ... and dropped as redundant
+    DWORD       ringBytes;      // VRing vertex + index bytes written
+    DWORD       ringWraps;
+    DWORD       ringStalls;     // fence waits for ring space
+    DWORD       ringFallbacks;  // draws that went out as UP
+    DWORD       musicUnderruns; // MusicStats over the frame (stream thread)
+    DWORD       musicLateReads;
+    DWORD       musicRefillUs;  // worst refill latency
+};
+
+void Perf_WriteHeader();
+void Perf_WriteFrame(const PerfFrame* f);
+
+// Debug-output line building without the CRT printf family
+char* Perf_AppendStr(char* p, const char* s);
+char* Perf_AppendUInt(char* p, DWORD v);
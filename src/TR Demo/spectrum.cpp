@@ -0,0 +1,270 @@
+#include "spectrum.h"
+
+// sin(2 pi k / 1024) in Q15, a quarter wave; the rest by symmetry
+static const short SIN_Q15[257] =
+{
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+     7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767
+};
+
+// k in 1024ths of a turn
+static int SinQ15(unsigned int k)
+{
+    k &= SPECTRUM_MAX_FFT - 1;
+    if (k <= 256) return SIN_Q15[k];
+    if (k <= 512) return SIN_Q15[512 - k];
+    if (k <= 768) return -SIN_Q15[k - 512];
+    return -SIN_Q15[1024 - k];
+}
+
+static int CosQ15(unsigned int k)
+{
+    return SinQ15(k + 256);
+}
+
+unsigned int Spectrum_Log2Q8(unsigned long long v)
+{
+    unsigned int msb = 63;
+    while (!(v >> msb))
+        msb--;
+
+    // Mantissa as Q31 in [1, 2); squaring it doubles the log, so each
+    // square that reaches 2 is the next fraction bit
+    unsigned int m = msb >= 31 ? (unsigned int)(v >> (msb - 31)) : (unsigned int)(v << (31 - msb));
+    unsigned int r = msb << 8;
+
+    for (unsigned int bit = 128; bit; bit >>= 1)
+    {
+        unsigned long long sq = (unsigned long long)m * m >> 31;
+        if (sq >= 0x100000000ULL)
+        {
+            r |= bit;
+            sq >>= 1;
+        }
+        m = (unsigned int)sq;
+    }
+    return r;
+}
+
+void Spectrum_Fft(int* re, int* im, unsigned int log2n)
+{
+    unsigned int n = 1u << log2n;
+
+    // Bit-reversed order
+    for (unsigned int i = 1, j = 0; i < n; ++i)
+    {
+        unsigned int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+
+        if (i < j)
+        {
+            int t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    // Butterflies, halving each stage. Values stay within the input's
+    // magnitude (<= 32767), so the Q15 products fit 32 bits.
+    for (unsigned int half = 1, stride = SPECTRUM_MAX_FFT / 2; half < n; half <<= 1, stride >>= 1)
+    {
+        for (unsigned int k = 0; k < half; ++k)
+        {
+            int wr = CosQ15(k * stride);
+            int wi = SinQ15(k * stride);
+
+            for (unsigned int i = k; i < n; i += half << 1)
+            {
+                unsigned int j = i + half;
+
+                // b * e^(-i theta)
+                int tr = (re[j] * wr + im[j] * wi) >> 15;
+                int ti = (im[j] * wr - re[j] * wi) >> 15;
+
+                re[j] = (re[i] - tr) >> 1;
+                im[j] = (im[i] - ti) >> 1;
+                re[i] = (re[i] + tr) >> 1;
+                im[i] = (im[i] + ti) >> 1;
+            }
+        }
+    }
+}
+
+bool Spectrum_Configure(Spectrum* s, const SpectrumConfig* cfg)
+{
+    unsigned int log2n = 0;
+    while ((1u << log2n) < cfg->fftSize)
+        log2n++;
+
+    if (cfg->fftSize < 256 || cfg->fftSize > SPECTRUM_MAX_FFT || (1u << log2n) != cfg->fftSize ||
+        cfg->bands < 1 || cfg->bands > SPECTRUM_MAX_BANDS ||
+        cfg->loHz < 1 || cfg->hiHz <= cfg->loHz || cfg->sampleRate == 0 ||
+        cfg->attack < 1 || cfg->attack > 256 || cfg->release < 1 || cfg->release > 256)
+        return false;
+
+    s->cfg = *cfg;
+    s->log2n = log2n;
+    s->fill = 0;
+
+    const unsigned int n = cfg->fftSize;
+    const unsigned int stride = SPECTRUM_MAX_FFT / n;
+
+    // Hann: (1 - cos) / 2
+    for (unsigned int i = 0; i < n; ++i)
+        s->window[i] = (short)((32767 - CosQ15(i * stride)) >> 1);
+
+    // Bin k (centre k * rate / n Hz) goes to band
+    //   bands * log(f / lo) / log(hi / lo)
+    // compared as log2(k * rate) against log2(lo * n), so nothing leaves
+    // integers. DC and bins outside [lo, hi) are left out.
+    const unsigned int bins = n / 2;
+    const unsigned int logLo = Spectrum_Log2Q8((unsigned long long)cfg->loHz * n);
+    const unsigned int logHi = Spectrum_Log2Q8((unsigned long long)cfg->hiHz * n);
+
+    unsigned int first = bins, last = bins;
+    for (unsigned int b = 0; b <= cfg->bands; ++b)
+        s->bandStart[b] = (unsigned short)bins;
+
+    for (unsigned int k = bins - 1; k >= 1; --k)
+    {
+        unsigned long long f = (unsigned long long)k * cfg->sampleRate;
+        if (f < (unsigned long long)cfg->loHz * n)
+            break;
+        if (f >= (unsigned long long)cfg->hiHz * n)
+        {
+            last = k;
+            continue;
+        }
+
+        unsigned int band = (Spectrum_Log2Q8(f) - logLo) * cfg->bands / (logHi - logLo);
+        if (band >= cfg->bands)
+            band = cfg->bands - 1;
+        s->bandStart[band] = (unsigned short)k;
+        first = k;
+    }
+
+    // Empty bands start where the next one does, then every band gets at
+    // least one bin, pushing upwards
+    s->bandStart[0] = (unsigned short)first;
+    s->bandStart[cfg->bands] = (unsigned short)last;
+    for (int b = (int)cfg->bands - 1; b > 0; --b)
+    {
+        if (s->bandStart[b] > s->bandStart[b + 1])
+            s->bandStart[b] = s->bandStart[b + 1];
+    }
+    for (unsigned int b = 1; b <= cfg->bands; ++b)
+    {
+        if (s->bandStart[b] <= s->bandStart[b - 1])
+            s->bandStart[b] = (unsigned short)(s->bandStart[b - 1] + 1);
+        if (s->bandStart[b] > bins)
+            s->bandStart[b] = (unsigned short)bins;
+    }
+
+    for (unsigned int b = 0; b < SPECTRUM_MAX_BANDS; ++b)
+    {
+        s->smooth[b] = 0;
+        s->raw[b] = 0;
+        s->levels[b] = 0;
+    }
+    return true;
+}
+
+// Level mapping: log2 of a band's energy (Q8), linear from LEVEL_FLOOR_Q8
+// (level 0) to LEVEL_TOP_Q8 (255). A full-scale sine reads 235..250 after
+// the halving FFT (tools/specbench); 20 log2 steps of energy are 60 dB.
+static const unsigned int LEVEL_TOP_Q8 = 27 << 8;
+static const unsigned int LEVEL_RANGE_Q8 = 20 << 8;
+static const unsigned int LEVEL_FLOOR_Q8 = LEVEL_TOP_Q8 - LEVEL_RANGE_Q8;
+
+static void Analyze(Spectrum* s)
+{
+    const unsigned int n = s->cfg.fftSize;
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        s->re[i] = (s->in[i] * s->window[i]) >> 15;
+        s->im[i] = 0;
+    }
+
+    Spectrum_Fft(s->re, s->im, s->log2n);
+
+    for (unsigned int b = 0; b < s->cfg.bands; ++b)
+    {
+        unsigned long long energy = 0;
+        for (unsigned int k = s->bandStart[b]; k < s->bandStart[b + 1]; ++k)
+            energy += (unsigned long long)(s->re[k] * s->re[k]) + (unsigned long long)(s->im[k] * s->im[k]);
+
+        int target = 0;
+        if (energy > 0)
+        {
+            unsigned int lg = Spectrum_Log2Q8(energy);
+            if (lg > LEVEL_FLOOR_Q8)
+            {
+                target = (int)((lg - LEVEL_FLOOR_Q8) * 255 / LEVEL_RANGE_Q8);
+                if (target > 255)
+                    target = 255;
+            }
+        }
+
+        s->raw[b] = (unsigned char)target;
+
+        // Q8: rise by attack/256 of the gap, fall by release/256
+        int cur = s->smooth[b];
+        int gap = (target << 8) - cur;
+        cur += gap * (int)(gap > 0 ? s->cfg.attack : s->cfg.release) / 256;
+        s->smooth[b] = cur;
+        s->levels[b] = (unsigned char)(cur >> 8);
+    }
+}
+
+unsigned int Spectrum_Feed(Spectrum* s, const short* pcm, unsigned int frames, unsigned int channels,
+                           bool* analyzed)
+{
+    *analyzed = false;
+
+    unsigned int take = s->cfg.fftSize - s->fill;
+    if (take > frames)
+        take = frames;
+
+    short* dst = s->in + s->fill;
+    if (channels == 2)
+    {
+        for (unsigned int i = 0; i < take; ++i, pcm += 2)
+            dst[i] = (short)((pcm[0] + pcm[1]) >> 1);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < take; ++i, pcm += channels)
+            dst[i] = pcm[0];
+    }
+
+    s->fill += take;
+    if (s->fill == s->cfg.fftSize)
+    {
+        Analyze(s);
+        s->fill = 0;
+        *analyzed = true;
+    }
+    return take;
+}
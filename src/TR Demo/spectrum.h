@@ -0,0 +1,63 @@
+#pragma once
+
+// Integer FFT spectrum analyzer for 16-bit PCM: log-spaced band levels with
+// attack/release smoothing. Used by music (runtime, fed from each refill)
+// and tools/specbench (host), so plain C types only, and integer math
+// throughout like the rest of the music path.
+//
+// PCM is fed in any chunk size; every fftSize frames (mixed to mono) make
+// one analysis: Hann window, radix-2 FFT in Q15 (each stage halves, so no
+// overflow), bin energies summed per band, log2 of the sum mapped to 0..255
+// over a 60 dB range, then smoothed. Windows don't overlap, so the cost is
+// one FFT per fftSize frames, spread over the feeds that complete them.
+
+static const unsigned int SPECTRUM_MAX_FFT = 1024;
+static const unsigned int SPECTRUM_MAX_BANDS = 32;
+
+struct SpectrumConfig
+{
+    unsigned int fftSize;       // 256, 512 or 1024
+    unsigned int bands;         // 1..SPECTRUM_MAX_BANDS
+    unsigned int loHz;          // band edges, log-spaced between these
+    unsigned int hiHz;
+    unsigned int sampleRate;
+    unsigned int attack;        // share of a rise taken per analysis, 1..256 of 256
+    unsigned int release;       // ... and of a fall
+};
+
+struct Spectrum
+{
+    SpectrumConfig cfg;
+    unsigned int   log2n;
+    unsigned int   fill;                            // frames gathered for the next window
+
+    short          window[SPECTRUM_MAX_FFT];        // Hann, Q15
+    short          in[SPECTRUM_MAX_FFT];
+    int            re[SPECTRUM_MAX_FFT];
+    int            im[SPECTRUM_MAX_FFT];
+
+    // Band b sums bins bandStart[b] .. bandStart[b + 1] - 1; every band has
+    // at least one bin, so at small FFT sizes the lowest bands sit higher
+    // than loHz asks
+    unsigned short bandStart[SPECTRUM_MAX_BANDS + 1];
+
+    int            smooth[SPECTRUM_MAX_BANDS];      // 0..255 << 8
+    unsigned char  raw[SPECTRUM_MAX_BANDS];         // the last analysis, unsmoothed (for beat)
+    unsigned char  levels[SPECTRUM_MAX_BANDS];      // ... smoothed
+};
+
+// False (and s unchanged) for an unsupported size or band count
+bool Spectrum_Configure(Spectrum* s, const SpectrumConfig* cfg);
+
+// Consumes frames up to the end of the current window. Returns the frames
+// consumed; *analyzed is set when that completed a window and s->levels
+// was updated.
+unsigned int Spectrum_Feed(Spectrum* s, const short* pcm, unsigned int frames, unsigned int channels,
+                           bool* analyzed);
+
+// In-place complex FFT of 1 << log2n points (Q15 twiddles, halved per
+// stage, so the result is the DFT / n); for the bench
+void Spectrum_Fft(int* re, int* im, unsigned int log2n);
+
+// log2(v) in Q8, v > 0
+unsigned int Spectrum_Log2Q8(unsigned long long v);
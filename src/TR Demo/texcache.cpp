@@ -0,0 +1,598 @@
+#include "texcache.h"
+#include "clock.h"
+#include "mipfilter.h"
+#include "perf.h"
+#include "texpack.h"
+
+#include <xgraphics.h>   // XGSwizzleRect
+#include <stdlib.h>
+#include <string.h>
+
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+static const int MAX_ENTRIES = 16;
+static const int MAX_PATH_CHARS = 64;
+
+// -----------------------------------------------------------------------------
+// DDS header (subset)
+// -----------------------------------------------------------------------------
+
+#pragma pack(push, 1)
+struct DDS_PIXELFORMAT
+{
+    DWORD size;
+    DWORD flags;
+    DWORD fourCC;
+    DWORD rgbBitCount;
+    DWORD rMask;
+    DWORD gMask;
+    DWORD bMask;
+    DWORD aMask;
+};
+
+struct DDS_HEADER
+{
+    DWORD           size;
+    DWORD           flags;
+    DWORD           height;
+    DWORD           width;
+    DWORD           pitchOrLinearSize;
+    DWORD           depth;
+    DWORD           mipMapCount;
+    DWORD           reserved1[11];
+    DDS_PIXELFORMAT ddspf;
+    DWORD           caps;
+    DWORD           caps2;
+    DWORD           caps3;
+    DWORD           caps4;
+    DWORD           reserved2;
+};
+#pragma pack(pop)
+
+static const DWORD DDS_MAGIC = 0x20534444;  // "DDS "
+
+static const DWORD DDSD_MIPMAPCOUNT = 0x20000;
+
+static const DWORD DDPF_ALPHAPIXELS = 0x1;
+static const DWORD DDPF_FOURCC = 0x4;
+static const DWORD DDPF_RGB = 0x40;
+
+#define DDS_FOURCC(a, b, c, d) \
+    ((DWORD)(a) | ((DWORD)(b) << 8) | ((DWORD)(c) << 16) | ((DWORD)(d) << 24))
+
+// -----------------------------------------------------------------------------
+// State
+// -----------------------------------------------------------------------------
+
+struct TexEntry
+{
+    char               path[MAX_PATH_CHARS];
+    LPDIRECT3DTEXTURE8 tex;
+    int                w, h;
+    int                levels;
+    DWORD              bytes;       // all levels, in their stored format
+    int                refs;
+    bool               packed;      // header in s_packTex, texels in s_packData
+};
+
+static TexEntry s_entries[MAX_ENTRIES];
+static int      s_entryCount = 0;
+
+// Linear pixels (or DXT blocks) of the last file read, every level back to
+// back; 'path' and 'request' say which file and level count were asked for
+// ('path' empty if the contents are stale)
+static BYTE*        s_staging = NULL;
+static DWORD        s_stagingCap = 0;
+static char         s_stagedPath[MAX_PATH_CHARS] = "";
+static int          s_stagedRequest = 0;
+static int          s_stagedW = 0;
+static int          s_stagedH = 0;
+static int          s_stagedLevels = 0;
+static unsigned int s_stagedFormat = TEXPACK_FMT_A8R8G8B8;
+static DWORD        s_stagedReadUs = 0;
+static DWORD        s_stagedMipUs = 0;
+
+// textures.pak: one physical allocation holding every packed texture, and
+// the headers registered onto it
+static IDirect3DTexture8 s_packTex[MAX_ENTRIES];
+static BYTE*             s_packData = NULL;
+
+static TexCacheStats s_stats = { 0, 0, 0, 0 };
+
+static D3DFORMAT ToD3DFormat(unsigned int format)
+{
+    switch (format)
+    {
+    case TEXPACK_FMT_DXT1: return D3DFMT_DXT1;
+    case TEXPACK_FMT_DXT3: return D3DFMT_DXT3;
+    case TEXPACK_FMT_DXT5: return D3DFMT_DXT5;
+    default:               return D3DFMT_A8R8G8B8;
+    }
+}
+
+static TexEntry* FindPath(const char* path)
+{
+    for (int i = 0; i < s_entryCount; ++i)
+    {
+        if (strcmp(s_entries[i].path, path) == 0)
+            return &s_entries[i];
+    }
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// File half
+// -----------------------------------------------------------------------------
+
+static bool ReadHeader(HANDLE hFile, int* outW, int* outH, unsigned int* outFormat,
+                       int* outLevels)
+{
+    DWORD bytesRead = 0;
+    DWORD magic = 0;
+
+    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
+        bytesRead != sizeof(DWORD) || magic != DDS_MAGIC)
+        return false;
+
+    DDS_HEADER hdr;
+    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
+        bytesRead != sizeof(DDS_HEADER))
+        return false;
+
+    if (hdr.size != 124 || hdr.ddspf.size != 32)
+        return false;
+
+    unsigned int format = TEXPACK_FMT_A8R8G8B8;
+
+    if (hdr.ddspf.flags & DDPF_FOURCC)
+    {
+        if (hdr.ddspf.fourCC == DDS_FOURCC('D', 'X', 'T', '1'))
+            format = TEXPACK_FMT_DXT1;
+        else if (hdr.ddspf.fourCC == DDS_FOURCC('D', 'X', 'T', '3'))
+            format = TEXPACK_FMT_DXT3;
+        else if (hdr.ddspf.fourCC == DDS_FOURCC('D', 'X', 'T', '5'))
+            format = TEXPACK_FMT_DXT5;
+        else
+            return false;
+    }
+    // Otherwise uncompressed 32-bit ARGB with the usual masks
+    else if (hdr.ddspf.rgbBitCount != 32 ||
+        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
+        hdr.ddspf.rMask != 0x00FF0000 ||
+        hdr.ddspf.gMask != 0x0000FF00 ||
+        hdr.ddspf.bMask != 0x000000FF ||
+        hdr.ddspf.aMask != 0xFF000000)
+        return false;
+
+    int w = (int)hdr.width;
+    int h = (int)hdr.height;
+
+    // Swizzled textures need power-of-two sides; DXT whole 4x4 blocks
+    if (w <= 0 || h <= 0 || w > 4096 || h > 4096 ||
+        (w & (w - 1)) != 0 || (h & (h - 1)) != 0)
+        return false;
+
+    if (format != TEXPACK_FMT_A8R8G8B8 && (w < 4 || h < 4))
+        return false;
+
+    int levels = 1;
+    if ((hdr.flags & DDSD_MIPMAPCOUNT) && hdr.mipMapCount > 1)
+    {
+        levels = (int)hdr.mipMapCount;
+        if (levels > (int)Mip_LevelCount(w, h))
+            return false;
+    }
+
+    *outW = w;
+    *outH = h;
+    *outFormat = format;
+    *outLevels = levels;
+    return true;
+}
+
+// Reads path into the staging buffer with up to 'levels' levels (0 = full
+// chain). Levels the file doesn't carry are box-filtered from the one
+// above; DXT files get only the levels they carry.
+static bool Stage(const char* path, int levels)
+{
+    if (s_stagedPath[0] && strcmp(s_stagedPath, path) == 0 && s_stagedRequest == levels)
+        return true;
+
+    DWORD t0 = Clock_ReadUs();
+    s_stagedPath[0] = 0;
+
+    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    int w, h, fileLevels;
+    unsigned int format;
+    if (!ReadHeader(hFile, &w, &h, &format, &fileLevels))
+    {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    int full = (int)Mip_LevelCount(w, h);
+    int want = (levels <= 0 || levels > full) ? full : levels;
+    int read = fileLevels < want ? fileLevels : want;
+
+    if (format != TEXPACK_FMT_A8R8G8B8)
+        want = read;
+
+    DWORD pixelBytes = TexPack_ChainBytes(format, (unsigned)w, (unsigned)h, (unsigned)read);
+    DWORD chainBytes = TexPack_ChainBytes(format, (unsigned)w, (unsigned)h, (unsigned)want);
+
+    if (chainBytes > s_stagingCap)
+    {
+        if (s_staging)
+            free(s_staging);
+
+        s_staging = (BYTE*)malloc(chainBytes);
+        s_stagingCap = s_staging ? chainBytes : 0;
+
+        if (!s_staging)
+        {
+            CloseHandle(hFile);
+            return false;
+        }
+    }
+
+    DWORD bytesRead = 0;
+    BOOL ok = ReadFile(hFile, s_staging, pixelBytes, &bytesRead, NULL);
+    CloseHandle(hFile);
+
+    if (!ok || bytesRead != pixelBytes)
+        return false;
+
+    DWORD t1 = Clock_ReadUs();
+
+    if (read < want)
+    {
+        unsigned int* src = (unsigned int*)s_staging;
+        unsigned int lw = (unsigned)w, lh = (unsigned)h;
+
+        for (int l = 1; l < want; ++l)
+        {
+            unsigned int* dst = src + lw * lh;
+            if (l >= read)
+                Mip_Box(src, lw, lh, dst);
+
+            src = dst;
+            lw = lw > 1 ? lw / 2 : 1;
+            lh = lh > 1 ? lh / 2 : 1;
+        }
+    }
+
+    strncpy(s_stagedPath, path, MAX_PATH_CHARS - 1);
+    s_stagedPath[MAX_PATH_CHARS - 1] = 0;
+    s_stagedRequest = levels;
+    s_stagedW = w;
+    s_stagedH = h;
+    s_stagedLevels = want;
+    s_stagedFormat = format;
+    s_stagedReadUs = t1 - t0;
+    s_stagedMipUs = Clock_ReadUs() - t1;
+    return true;
+}
+
+void TexCache_Preload(const char* path, int levels)
+{
+    if (!path || strlen(path) >= (size_t)MAX_PATH_CHARS)
+        return;
+
+    TexEntry* e = FindPath(path);
+    if (e && e->tex)
+        return;
+
+    Stage(path, levels);
+}
+
+// -----------------------------------------------------------------------------
+// Device half
+// -----------------------------------------------------------------------------
+
+static LPDIRECT3DTEXTURE8 CreateFromStaging()
+{
+    LPDIRECT3DTEXTURE8 tex = NULL;
+    if (FAILED(g_pDevice->CreateTexture((UINT)s_stagedW, (UINT)s_stagedH, (UINT)s_stagedLevels,
+                                        0, ToD3DFormat(s_stagedFormat), 0, &tex)))
+        return NULL;
+
+    const BYTE* src = s_staging;
+    int w = s_stagedW, h = s_stagedH;
+
+    for (int l = 0; l < s_stagedLevels; ++l)
+    {
+        D3DLOCKED_RECT lr;
+        if (FAILED(tex->LockRect((UINT)l, &lr, NULL, 0)))
+        {
+            tex->Release();
+            return NULL;
+        }
+
+        if (s_stagedFormat == TEXPACK_FMT_A8R8G8B8)
+        {
+            XGSwizzleRect(src, w * 4, NULL, lr.pBits, w, h, NULL, 4);
+        }
+        else
+        {
+            // DXT isn't swizzled: copy block rows at the surface's pitch
+            DWORD rowBytes = TexPack_LevelBytes(s_stagedFormat, (unsigned)w, 4);
+            const BYTE* row = src;
+            BYTE* dst = (BYTE*)lr.pBits;
+
+            for (int y = 0; y < h; y += 4)
+            {
+                memcpy(dst, row, rowBytes);
+                row += rowBytes;
+                dst += lr.Pitch;
+            }
+        }
+
+        tex->UnlockRect((UINT)l);
+
+        src += TexPack_LevelBytes(s_stagedFormat, (unsigned)w, (unsigned)h);
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+
+    return tex;
+}
+
+static void LogLoad(const TexEntry& e, DWORD readUs, DWORD mipUs, DWORD swizzleUs)
+{
+    char buf[192];
+    char* p = buf;
+
+    p = Perf_AppendStr(p, "texcache: ");
+    p = Perf_AppendStr(p, e.path);
+    p = Perf_AppendStr(p, " ");
+    p = Perf_AppendUInt(p, (DWORD)e.w);
+    p = Perf_AppendStr(p, "x");
+    p = Perf_AppendUInt(p, (DWORD)e.h);
+    p = Perf_AppendStr(p, " levels=");
+    p = Perf_AppendUInt(p, (DWORD)e.levels);
+    p = Perf_AppendStr(p, " bytes=");
+    p = Perf_AppendUInt(p, e.bytes);
+    p = Perf_AppendStr(p, " read_us=");
+    p = Perf_AppendUInt(p, readUs);
+    p = Perf_AppendStr(p, " mip_us=");
+    p = Perf_AppendUInt(p, mipUs);
+    p = Perf_AppendStr(p, " swizzle_us=");
+    p = Perf_AppendUInt(p, swizzleUs);
+    *p++ = '\n';
+    *p = 0;
+
+    OutputDebugStringA(buf);
+}
+
+LPDIRECT3DTEXTURE8 TexCache_Acquire(const char* path, int levels, int* outW, int* outH)
+{
+    if (outW) *outW = 0;
+    if (outH) *outH = 0;
+
+    if (!g_pDevice || !path || strlen(path) >= (size_t)MAX_PATH_CHARS)
+        return NULL;
+
+    TexEntry* e = FindPath(path);
+    if (e && e->tex)
+    {
+        e->refs++;
+        s_stats.hits++;
+    }
+    else
+    {
+        if (!e && s_entryCount == MAX_ENTRIES)
+            return NULL;
+
+        if (!Stage(path, levels))
+            return NULL;
+
+        DWORD t0 = Clock_ReadUs();
+        LPDIRECT3DTEXTURE8 tex = CreateFromStaging();
+        DWORD swizzleUs = Clock_ReadUs() - t0;
+
+        if (!tex)
+            return NULL;
+
+        if (!e)
+        {
+            e = &s_entries[s_entryCount++];
+            strcpy(e->path, path);
+        }
+
+        e->tex = tex;
+        e->w = s_stagedW;
+        e->h = s_stagedH;
+        e->levels = s_stagedLevels;
+        e->bytes = TexPack_ChainBytes(s_stagedFormat, (unsigned)e->w, (unsigned)e->h,
+                                      (unsigned)e->levels);
+        e->refs = 1;
+        e->packed = false;
+
+        s_stats.loads++;
+        s_stats.bytes += e->bytes;
+        s_stats.loadUs += s_stagedReadUs + s_stagedMipUs + swizzleUs;
+        LogLoad(*e, s_stagedReadUs, s_stagedMipUs, swizzleUs);
+    }
+
+    if (outW) *outW = e->w;
+    if (outH) *outH = e->h;
+    return e->tex;
+}
+
+void TexCache_Release(LPDIRECT3DTEXTURE8 tex)
+{
+    if (!tex)
+        return;
+
+    for (int i = 0; i < s_entryCount; ++i)
+    {
+        if (s_entries[i].tex == tex)
+        {
+            if (s_entries[i].refs > 0)
+                s_entries[i].refs--;
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Pack
+// -----------------------------------------------------------------------------
+
+static void LogPack(const char* path, int count, DWORD bytes, DWORD readUs)
+{
+    char buf[160];
+    char* p = buf;
+
+    p = Perf_AppendStr(p, "texcache: pack ");
+    p = Perf_AppendStr(p, path);
+    p = Perf_AppendStr(p, " textures=");
+    p = Perf_AppendUInt(p, (DWORD)count);
+    p = Perf_AppendStr(p, " bytes=");
+    p = Perf_AppendUInt(p, bytes);
+    p = Perf_AppendStr(p, " read_us=");
+    p = Perf_AppendUInt(p, readUs);
+    *p++ = '\n';
+    *p = 0;
+
+    OutputDebugStringA(buf);
+}
+
+bool TexCache_LoadPack(const char* path)
+{
+    if (!g_pDevice || !path || s_packData)
+        return false;
+
+    DWORD t0 = Clock_ReadUs();
+
+    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    TexPackHeader hdr;
+    TexPackEntry  index[MAX_ENTRIES];
+    DWORD bytesRead = 0;
+
+    bool ok =
+        ReadFile(hFile, &hdr, sizeof(hdr), &bytesRead, NULL) && bytesRead == sizeof(hdr) &&
+        hdr.magic == TEXPACK_MAGIC && hdr.version == TEXPACK_VERSION &&
+        hdr.count > 0 && hdr.count <= (unsigned)(MAX_ENTRIES - s_entryCount) &&
+        ReadFile(hFile, index, hdr.count * sizeof(TexPackEntry), &bytesRead, NULL) &&
+        bytesRead == hdr.count * sizeof(TexPackEntry);
+
+    // The whole data section in one sequential read, straight into memory
+    // the GPU can texture from
+    if (ok)
+    {
+        s_packData = (BYTE*)XPhysicalAlloc(hdr.dataSize, MAXULONG_PTR, TEXPACK_ALIGN,
+                                           PAGE_READWRITE | PAGE_WRITECOMBINE);
+        ok = s_packData &&
+            SetFilePointer(hFile, (LONG)hdr.dataOffset, NULL, FILE_BEGIN) == hdr.dataOffset &&
+            ReadFile(hFile, s_packData, hdr.dataSize, &bytesRead, NULL) &&
+            bytesRead == hdr.dataSize;
+    }
+
+    CloseHandle(hFile);
+
+    if (!ok)
+    {
+        if (s_packData) { XPhysicalFree(s_packData); s_packData = NULL; }
+        return false;
+    }
+
+    // Entries are keyed like Acquire paths: the pack's directory + name
+    int dirLen = 0;
+    for (int i = 0; path[i]; ++i)
+    {
+        if (path[i] == '\\')
+            dirLen = i + 1;
+    }
+
+    int added = 0;
+    for (unsigned i = 0; i < hdr.count; ++i)
+    {
+        const TexPackEntry& pe = index[i];
+
+        int nameLen = 0;
+        while (nameLen < TEXPACK_NAME_CHARS && pe.name[nameLen])
+            nameLen++;
+
+        if (pe.format > TEXPACK_FMT_DXT5 || nameLen == TEXPACK_NAME_CHARS ||
+            dirLen + nameLen >= MAX_PATH_CHARS ||
+            pe.levels < 1 || pe.levels > Mip_LevelCount(pe.width, pe.height) ||
+            pe.offset > hdr.dataSize || pe.size > hdr.dataSize - pe.offset ||
+            pe.size < TexPack_ChainBytes(pe.format, pe.width, pe.height, pe.levels))
+            continue;
+
+        char key[MAX_PATH_CHARS];
+        memcpy(key, path, dirLen);
+        memcpy(key + dirLen, pe.name, nameLen);
+        key[dirLen + nameLen] = 0;
+
+        // Already loaded from its .dds: keep that one
+        if (FindPath(key))
+            continue;
+
+        IDirect3DTexture8* tex = &s_packTex[s_entryCount];
+        XGSetTextureHeader(pe.width, pe.height, pe.levels, 0, ToD3DFormat(pe.format), 0,
+                           tex, 0, 0);
+        tex->Register(s_packData + pe.offset);
+
+        TexEntry* e = &s_entries[s_entryCount++];
+        strcpy(e->path, key);
+        e->tex = tex;
+        e->w = pe.width;
+        e->h = pe.height;
+        e->levels = pe.levels;
+        e->bytes = pe.size;
+        e->refs = 0;
+        e->packed = true;
+
+        s_stats.loads++;
+        s_stats.bytes += pe.size;
+        added++;
+    }
+
+    DWORD readUs = Clock_ReadUs() - t0;
+    s_stats.loadUs += readUs;
+    LogPack(path, added, hdr.dataSize, readUs);
+    return true;
+}
+
+void TexCache_Shutdown()
+{
+    for (int i = 0; i < s_entryCount; ++i)
+    {
+        if (s_entries[i].tex && !s_entries[i].packed)
+            s_entries[i].tex->Release();
+    }
+    s_entryCount = 0;
+    s_stats.bytes = 0;
+
+    // Packed headers aren't D3D's to free; just wait until nothing reads
+    // the texels
+    if (s_packData)
+    {
+        if (g_pDevice)
+            g_pDevice->BlockUntilIdle();
+        XPhysicalFree(s_packData);
+        s_packData = NULL;
+    }
+
+    if (s_staging) { free(s_staging); s_staging = NULL; }
+    s_stagingCap = 0;
+    s_stagedPath[0] = 0;
+}
+
+void TexCache_GetStats(TexCacheStats* out)
+{
+    if (out)
+        *out = s_stats;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <xtl.h>
+
+// Shared texture cache for the DDS files under D:\tex.
+//
+// Textures are keyed by path and reference counted. An entry whose count
+// drops to zero stays resident, so a texture that comes round again in the
+// demo loop (tr.dds in Intro and City, cloud_256.dds in Galaxy and X) is
+// loaded once per run. File data goes through a single staging buffer
+// that grows to the largest texture and is reused for every load.
+//
+// Accepted files: uncompressed A8R8G8B8 or DXT1 / DXT3 / DXT5, power-of-two
+// width and height (at least 4x4 for DXT), with or without mip levels.
+// Each load is logged to the debug output with its size and time.
+//
+// Mip levels: a texture built from a .dds gets the level count its first
+// Acquire asks for. Levels the file carries are used as they are; missing
+// A8R8G8B8 levels are box-filtered (mipfilter.h) at load, DXT files only get
+// what they carry. Packed textures have the levels texbake gave them.
+
+static const int TEXCACHE_ALL_LEVELS = 0;   // full chain down to 1x1
+
+// Returns the texture with one more reference, or NULL if the file is
+// missing or not an accepted format. levels: mip levels wanted, 1 for none
+// or TEXCACHE_ALL_LEVELS. outW / outH may be NULL.
+LPDIRECT3DTEXTURE8 TexCache_Acquire(const char* path, int levels, int* outW, int* outH);
+
+// Drops one reference (NULL is ignored). The texture stays cached.
+void TexCache_Release(LPDIRECT3DTEXTURE8 tex);
+
+// File half of a load, without touching the device: reads path into the
+// staging buffer and builds its mips, so the next Acquire of it with the
+// same levels only has to swizzle. For scene
+// Prepare functions on main.cpp's loader thread; must not overlap an
+// Acquire or Release.
+void TexCache_Preload(const char* path, int levels);
+
+// Registers every texture in a textures.pak (tools/texbake) as a cache
+// entry, keyed by the pack's directory + file name, so later Acquires of
+// those .dds paths are hits with no file access or swizzle. One read of
+// the pre-swizzled data; false if the pack is missing or invalid.
+bool TexCache_LoadPack(const char* path);
+
+// Releases every texture and the staging buffer (device shutdown).
+void TexCache_Shutdown();
+
+// Totals since startup
+struct TexCacheStats
+{
+    DWORD loads;        // textures created from a .dds or a pack
+    DWORD hits;         // Acquires served from the cache
+    DWORD bytes;        // texel bytes resident (compressed size for DXT)
+    DWORD loadUs;       // read + mip + swizzle time over all loads
+};
+
+void TexCache_GetStats(TexCacheStats* out);
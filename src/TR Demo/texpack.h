@@ -0,0 +1,77 @@
+#pragma once
+
+// textures.pak layout: written offline by tools/texbake, read by texcache.
+// Shared with the host tool, so plain C types only (all fields are
+// 32/16-bit little-endian on both sides).
+//
+//   TexPackHeader
+//   TexPackEntry[count]
+//   data section at dataOffset: every texture at a TEXPACK_ALIGN boundary,
+//   already in the layout the GPU reads (swizzled, or DXT blocks), its mip
+//   levels back to back from the largest
+//
+// The runtime reads the whole data section with one ReadFile into
+// contiguous memory and points texture headers straight at it.
+
+static const unsigned int TEXPACK_MAGIC = 0x4B505254;   // "TRPK"
+static const unsigned int TEXPACK_VERSION = 1;
+
+// Page size; also covers the GPU's texture alignment and DVD sector reads
+static const unsigned int TEXPACK_ALIGN = 4096;
+
+static const int TEXPACK_NAME_CHARS = 32;
+
+// Also the texture cache's format id for .dds files. DXT data is stored
+// as 4x4 blocks in row-major order (the GPU doesn't swizzle it).
+enum TexPackFormat
+{
+    TEXPACK_FMT_A8R8G8B8 = 0,
+    TEXPACK_FMT_DXT1 = 1,
+    TEXPACK_FMT_DXT3 = 2,
+    TEXPACK_FMT_DXT5 = 3,
+};
+
+// Bytes of one w x h level: 4 per texel, or 8 / 16 per 4x4 block
+static inline unsigned int TexPack_LevelBytes(unsigned int format, unsigned int w, unsigned int h)
+{
+    if (format == TEXPACK_FMT_A8R8G8B8)
+        return w * h * 4;
+
+    unsigned int blocks = ((w + 3) / 4) * ((h + 3) / 4);
+    return blocks * (format == TEXPACK_FMT_DXT1 ? 8 : 16);
+}
+
+// Bytes of a chain of 'levels' levels from w x h, each side halving to 1
+static inline unsigned int TexPack_ChainBytes(unsigned int format, unsigned int w, unsigned int h,
+                                              unsigned int levels)
+{
+    unsigned int bytes = 0;
+    for (unsigned int i = 0; i < levels; ++i)
+    {
+        bytes += TexPack_LevelBytes(format, w, h);
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    return bytes;
+}
+
+struct TexPackHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int count;
+    unsigned int dataOffset;        // from the start of the file
+    unsigned int dataSize;
+};
+
+struct TexPackEntry
+{
+    char           name[TEXPACK_NAME_CHARS];    // file name, e.g. "tr.dds"
+    unsigned int   format;                      // TexPackFormat
+    unsigned short width;
+    unsigned short height;
+    unsigned short levels;                      // mip levels, 1 = none
+    unsigned short reserved;
+    unsigned int   offset;                      // from dataOffset
+    unsigned int   size;                        // bytes, all levels
+};
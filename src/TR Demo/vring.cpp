@@ -0,0 +1,402 @@
+#include "vring.h"
+#include "devstate.h"
+#include <string.h>
+
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+// Sized for the galaxy's worst frame (~20k sprites as 6-vertex quads is
+// ~3.4 MB); smaller frames keep several frames in flight.
+static const UINT VRING_VB_BYTES = 4 * 1024 * 1024;
+static const UINT VRING_IB_BYTES = 128 * 1024;
+
+// Fenced segments in flight; one per frame, plus mid-frame ones when a
+// frame outgrows the ring.
+static const int MAX_SEGMENTS = 4;
+
+// Live data is [tail, head), wrapping at size. head never catches up with
+// tail, so head == tail means empty.
+struct Ring
+{
+    UINT size;
+    UINT head;
+    UINT tail;
+};
+
+struct Segment
+{
+    DWORD fence;
+    UINT  vbEnd;
+    UINT  ibEnd;
+};
+
+static IDirect3DVertexBuffer8* s_vb = NULL;
+static IDirect3DIndexBuffer8*  s_ib = NULL;
+
+static Ring s_vbRing = { 0, 0, 0 };
+static Ring s_ibRing = { 0, 0, 0 };
+
+static Segment s_seg[MAX_SEGMENTS];
+static int     s_segFirst = 0;
+static int     s_segCount = 0;
+
+// Heads at the last fence; anything past them is unfenced
+static UINT s_vbSealed = 0;
+static UINT s_ibSealed = 0;
+
+// Open BeginVerts reservation
+static bool  s_open = false;
+static bool  s_openFallback = false;
+static UINT  s_openOffset = 0;
+static UINT  s_openStride = 0;
+static BYTE* s_openPtr = NULL;
+
+// Fallback target when BeginVerts can't be served from the ring
+static BYTE  s_scratch[VRING_MAX_RESERVE];
+
+static VRingStats s_stats = { 0, 0, 0, 0, 0 };
+
+// -----------------------------------------------------------------------------
+// Segments
+// -----------------------------------------------------------------------------
+
+static void RetireOldest()
+{
+    const Segment& s = s_seg[s_segFirst];
+    s_vbRing.tail = s.vbEnd;
+    s_ibRing.tail = s.ibEnd;
+
+    s_segFirst = (s_segFirst + 1) % MAX_SEGMENTS;
+    s_segCount--;
+
+    // Drained: restart at 0 so the next frame gets the whole ring unsplit
+    if (s_segCount == 0)
+    {
+        if (s_vbRing.head == s_vbRing.tail)
+            s_vbRing.head = s_vbRing.tail = s_vbSealed = 0;
+        if (s_ibRing.head == s_ibRing.tail)
+            s_ibRing.head = s_ibRing.tail = s_ibSealed = 0;
+    }
+}
+
+static void RetireCompleted()
+{
+    while (s_segCount > 0 && !g_pDevice->IsFencePending(s_seg[s_segFirst].fence))
+        RetireOldest();
+}
+
+static void WaitOldest()
+{
+    g_pDevice->BlockOnFence(s_seg[s_segFirst].fence);
+    RetireOldest();
+    s_stats.stalls++;
+}
+
+// Fence everything written since the last seal. False if there was nothing.
+static bool Seal()
+{
+    if (s_vbRing.head == s_vbSealed && s_ibRing.head == s_ibSealed)
+        return false;
+
+    if (s_segCount == MAX_SEGMENTS)
+        WaitOldest();
+
+    Segment& s = s_seg[(s_segFirst + s_segCount) % MAX_SEGMENTS];
+    s.fence = g_pDevice->InsertFence();
+    s.vbEnd = s_vbRing.head;
+    s.ibEnd = s_ibRing.head;
+    s_segCount++;
+
+    s_vbSealed = s_vbRing.head;
+    s_ibSealed = s_ibRing.head;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Allocation
+// -----------------------------------------------------------------------------
+
+// Offset of a free, align-multiple range of 'bytes' in r (head is not
+// moved), or false if it doesn't fit right now.
+static bool TryFit(const Ring& r, UINT bytes, UINT align, UINT& off)
+{
+    UINT o = (r.head + align - 1) / align * align;
+
+    if (r.tail <= r.head)
+    {
+        if (o + bytes <= r.size)
+        {
+            off = o;
+            return true;
+        }
+
+        // Wrap; strictly below tail so head can't land on it
+        if (bytes < r.tail)
+        {
+            off = 0;
+            return true;
+        }
+        return false;
+    }
+
+    if (o + bytes < r.tail)
+    {
+        off = o;
+        return true;
+    }
+    return false;
+}
+
+// Finds space, waiting on the GPU if it has to. False only if the request
+// can never fit.
+static bool Alloc(Ring& r, UINT bytes, UINT align, UINT& off)
+{
+    if (bytes == 0 || bytes + align >= r.size)
+        return false;
+
+    for (;;)
+    {
+        if (TryFit(r, bytes, align, off))
+        {
+            if (off < r.head)
+                s_stats.wraps++;
+            return true;
+        }
+
+        // Nothing to wait for yet: this frame alone has filled the ring
+        if (s_segCount == 0 && !Seal())
+            return false;
+
+        WaitOldest();
+    }
+}
+
+static UINT VertexCount(D3DPRIMITIVETYPE type, UINT primCount)
+{
+    switch (type)
+    {
+    case D3DPT_POINTLIST:     return primCount;
+    case D3DPT_LINELIST:      return primCount * 2;
+    case D3DPT_LINESTRIP:     return primCount + 1;
+    case D3DPT_TRIANGLELIST:  return primCount * 3;
+    case D3DPT_TRIANGLESTRIP: return primCount + 2;
+    case D3DPT_TRIANGLEFAN:   return primCount + 2;
+    default:                  return 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Init / frame
+// -----------------------------------------------------------------------------
+
+bool VRing_Init()
+{
+    if (!g_pDevice)
+        return false;
+
+    if (FAILED(g_pDevice->CreateVertexBuffer(VRING_VB_BYTES, D3DUSAGE_WRITEONLY, 0,
+                                             D3DPOOL_DEFAULT, &s_vb)))
+    {
+        s_vb = NULL;
+        return false;
+    }
+
+    if (FAILED(g_pDevice->CreateIndexBuffer(VRING_IB_BYTES, D3DUSAGE_WRITEONLY,
+                                            D3DFMT_INDEX16, D3DPOOL_DEFAULT, &s_ib)))
+        s_ib = NULL;
+
+    s_vbRing.size = VRING_VB_BYTES;
+    s_vbRing.head = s_vbRing.tail = 0;
+    s_ibRing.size = s_ib ? VRING_IB_BYTES : 0;
+    s_ibRing.head = s_ibRing.tail = 0;
+    s_vbSealed = s_ibSealed = 0;
+    s_segFirst = s_segCount = 0;
+    s_open = false;
+    return true;
+}
+
+void VRing_Shutdown()
+{
+    if (g_pDevice && s_segCount > 0)
+        g_pDevice->BlockOnFence(s_seg[(s_segFirst + s_segCount - 1) % MAX_SEGMENTS].fence);
+    s_segCount = 0;
+
+    if (s_ib) { s_ib->Release(); s_ib = NULL; }
+    if (s_vb) { s_vb->Release(); s_vb = NULL; }
+}
+
+void VRing_EndFrame()
+{
+    if (!s_vb)
+        return;
+
+    Seal();
+    RetireCompleted();
+}
+
+// -----------------------------------------------------------------------------
+// Draws
+// -----------------------------------------------------------------------------
+
+void* VRing_BeginVerts(UINT maxCount, UINT stride)
+{
+    UINT bytes = maxCount * stride;
+
+    s_open = true;
+    s_openStride = stride;
+    s_openFallback = true;
+
+    if (!s_vb || bytes > VRING_MAX_RESERVE)
+        return bytes <= VRING_MAX_RESERVE ? s_scratch : NULL;
+
+    UINT off;
+    BYTE* p = NULL;
+    if (!Alloc(s_vbRing, bytes, stride, off) ||
+        FAILED(s_vb->Lock(off, bytes, &p, D3DLOCK_NOOVERWRITE)))
+        return s_scratch;
+
+    s_openFallback = false;
+    s_openOffset = off;
+    s_openPtr = p;
+    return p;
+}
+
+// Commits the used part of the open reservation. False if it was the
+// scratch buffer.
+static bool CloseVerts(UINT vertexCount)
+{
+    s_open = false;
+    if (s_openFallback)
+        return false;
+
+    s_vb->Unlock();
+    s_vbRing.head = s_openOffset + vertexCount * s_openStride;
+    s_stats.bytes += vertexCount * s_openStride;
+    return true;
+}
+
+void VRing_EndVerts(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount)
+{
+    if (!s_open)
+        return;
+
+    if (!CloseVerts(vertexCount))
+    {
+        if (primCount > 0)
+        {
+            s_stats.fallbacks++;
+            DevState_DrawPrimitiveUP(type, primCount, s_scratch, s_openStride);
+        }
+        return;
+    }
+
+    if (primCount == 0)
+        return;
+
+    DevState_SetStreamSource(0, s_vb, s_openStride);
+    g_pDevice->DrawPrimitive(type, s_openOffset / s_openStride, primCount);
+    s_stats.draws++;
+}
+
+void VRing_EndVertsIndexed(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount,
+                           const WORD* indices, UINT indexCount)
+{
+    if (!s_open)
+        return;
+
+    // Reserve the indices before committing the vertices: if they can't go
+    // in the ring, the vertices are still readable for the UP fallback.
+    UINT ibBytes = indexCount * sizeof(WORD);
+    UINT ibOff = 0;
+    BYTE* p = NULL;
+    bool indexed = !s_openFallback && primCount > 0 && s_ib &&
+        Alloc(s_ibRing, ibBytes, sizeof(WORD), ibOff) &&
+        SUCCEEDED(s_ib->Lock(ibOff, ibBytes, &p, D3DLOCK_NOOVERWRITE));
+
+    if (!indexed)
+    {
+        if (primCount > 0)
+        {
+            s_stats.fallbacks++;
+            DevState_DrawIndexedPrimitiveUP(type, 0, vertexCount, primCount,
+                                            indices, D3DFMT_INDEX16,
+                                            s_openFallback ? s_scratch : s_openPtr, s_openStride);
+        }
+        CloseVerts(0);
+        return;
+    }
+
+    memcpy(p, indices, ibBytes);
+    s_ib->Unlock();
+    s_ibRing.head = ibOff + ibBytes;
+    s_stats.bytes += ibBytes;
+
+    CloseVerts(vertexCount);
+
+    DevState_SetStreamSource(0, s_vb, s_openStride);
+    DevState_SetIndices(s_ib, s_openOffset / s_openStride);
+    g_pDevice->DrawIndexedPrimitive(type, 0, vertexCount, ibOff / sizeof(WORD), primCount);
+    s_stats.draws++;
+}
+
+void VRing_EndVertsStaticIndexed(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount,
+                                 IDirect3DIndexBuffer8* ib, const WORD* indices)
+{
+    if (!s_open)
+        return;
+
+    if (s_openFallback || !ib)
+    {
+        if (primCount > 0)
+        {
+            s_stats.fallbacks++;
+            DevState_DrawIndexedPrimitiveUP(type, 0, vertexCount, primCount,
+                                            indices, D3DFMT_INDEX16,
+                                            s_openFallback ? s_scratch : s_openPtr, s_openStride);
+        }
+        CloseVerts(0);
+        return;
+    }
+
+    CloseVerts(vertexCount);
+
+    if (primCount == 0)
+        return;
+
+    DevState_SetStreamSource(0, s_vb, s_openStride);
+    DevState_SetIndices(ib, s_openOffset / s_openStride);
+    g_pDevice->DrawIndexedPrimitive(type, 0, vertexCount, 0, primCount);
+    s_stats.draws++;
+}
+
+void VRing_DrawUP(D3DPRIMITIVETYPE type, UINT primCount, const void* verts, UINT stride)
+{
+    if (!g_pDevice || primCount == 0)
+        return;
+
+    UINT count = VertexCount(type, primCount);
+    if (count == 0 || count * stride > VRING_MAX_RESERVE || !s_vb)
+    {
+        s_stats.fallbacks++;
+        DevState_DrawPrimitiveUP(type, primCount, verts, stride);
+        return;
+    }
+
+    void* p = VRing_BeginVerts(count, stride);
+    memcpy(p, verts, count * stride);
+    VRing_EndVerts(type, count, primCount);
+}
+
+// -----------------------------------------------------------------------------
+// Stats
+// -----------------------------------------------------------------------------
+
+void VRing_ResetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void VRing_GetStats(VRingStats* out)
+{
+    if (out)
+        *out = s_stats;
+}
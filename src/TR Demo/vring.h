@@ -0,0 +1,60 @@
+#pragma once
+#include <xtl.h>
+
+// Frame-scoped dynamic vertex / index ring.
+//
+// One big write-only vertex buffer (and a smaller index buffer) handed out
+// in stride-aligned ranges, one range per draw. Ranges are locked with
+// D3DLOCK_NOOVERWRITE; reuse is made safe with GPU fences instead of
+// driver discards: main.cpp calls VRing_EndFrame() after EndScene, which
+// fences everything written that frame. Once the ring comes round to a
+// range that is still in flight, it waits on that range's fence (a
+// "stall"); a single frame bigger than the ring is fenced mid-frame.
+//
+// Usage, zero-copy (batchers fill the ring directly):
+//   Vtx* v = (Vtx*)VRing_BeginVerts(maxVerts, sizeof(Vtx));
+//   ... write up to maxVerts ...
+//   VRing_EndVerts(D3DPT_TRIANGLELIST, usedVerts, primCount);
+//
+// or copy (small one-off primitives, drop-in for DrawPrimitiveUP):
+//   VRing_DrawUP(D3DPT_TRIANGLESTRIP, 2, quad, sizeof(quad[0]));
+//
+// The caller sets the vertex shader; the ring binds stream 0 / indices
+// through DevState. Draws the ring can't take (larger than
+// VRING_MAX_RESERVE, or no ring because creation failed) fall back to the
+// UP call.
+
+// Largest single BeginVerts reservation (bytes)
+static const UINT VRING_MAX_RESERVE = 128 * 1024;
+
+bool  VRing_Init();
+void  VRing_Shutdown();
+
+// After EndScene, once per frame
+void  VRing_EndFrame();
+
+void* VRing_BeginVerts(UINT maxCount, UINT stride);
+void  VRing_EndVerts(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount);
+void  VRing_EndVertsIndexed(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount,
+                            const WORD* indices, UINT indexCount);
+
+// Same, against a static index buffer the caller owns (indices start at 0
+// and are relative to the reservation); only the vertices are written.
+// 'indices' is the same list in memory, for the UP fallback.
+void  VRing_EndVertsStaticIndexed(D3DPRIMITIVETYPE type, UINT vertexCount, UINT primCount,
+                                  IDirect3DIndexBuffer8* ib, const WORD* indices);
+
+void  VRing_DrawUP(D3DPRIMITIVETYPE type, UINT primCount, const void* verts, UINT stride);
+
+// Per frame (main.cpp resets with the other counters)
+struct VRingStats
+{
+    DWORD bytes;        // vertex + index bytes written to the rings
+    DWORD draws;
+    DWORD wraps;        // ring went back to offset 0
+    DWORD stalls;       // waited on a fence for space
+    DWORD fallbacks;    // draws that went out as UP instead
+};
+
+void VRing_ResetStats();
+void VRing_GetStats(VRingStats* out);
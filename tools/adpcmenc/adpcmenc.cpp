@@ -0,0 +1,301 @@
+// adpcmenc - converts the soundtrack from 16-bit PCM WAV to IMA ADPCM WAV
+//
+// Host tool (Linux, any C++ compiler), run from src/TR Demo/Media/snd:
+//   g++ -O2 -o adpcmenc ../../../../tools/adpcmenc/adpcmenc.cpp "../../adpcm.cpp"
+//   ./adpcmenc idk.trm idk_adpcm.trm
+//
+// Blocks are 1024 bytes per channel (2041 samples), the usual size for
+// 44.1/48 kHz. A trailing partial block is dropped rather than padded, so
+// the stream still loops without a gap (it ends at most 2040 samples
+// early). The output is decoded again with the runtime decoder and the SNR
+// printed, to judge the loss.
+
+#include "../../src/TR Demo/adpcm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+static const unsigned int BLOCK_BYTES_PER_CHANNEL = 1024;
+
+static uint32_t ReadU32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static unsigned int ReadU16(const unsigned char* p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+struct Wav
+{
+    unsigned int channels;
+    unsigned int rate;
+    unsigned int frames;
+    int16_t*     samples;       // interleaved, malloc'd
+};
+
+// Same acceptance as the runtime's ParseWav for PCM: 16-bit, 1 or 2 channels
+static bool LoadWav(const char* path, Wav* out)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "adpcmenc: can't open %s\n", path);
+        return false;
+    }
+
+    unsigned char hdr[12];
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0)
+    {
+        fprintf(stderr, "adpcmenc: %s: not a RIFF/WAVE file\n", path);
+        fclose(f);
+        return false;
+    }
+
+    bool gotFmt = false;
+    unsigned char chunk[8];
+
+    while (fread(chunk, 1, 8, f) == 8)
+    {
+        uint32_t size = ReadU32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+            unsigned char fmt[16];
+            if (fread(fmt, 1, 16, f) != 16)
+                break;
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+
+            if (ReadU16(fmt) != 1 || ReadU16(fmt + 14) != 16 ||
+                ReadU16(fmt + 2) < 1 || ReadU16(fmt + 2) > 2)
+            {
+                fprintf(stderr, "adpcmenc: %s: not 16-bit mono/stereo PCM\n", path);
+                fclose(f);
+                return false;
+            }
+
+            out->channels = ReadU16(fmt + 2);
+            out->rate = ReadU32(fmt + 4);
+            gotFmt = true;
+        }
+        else if (memcmp(chunk, "data", 4) == 0 && gotFmt)
+        {
+            out->frames = size / (2 * out->channels);
+            out->samples = (int16_t*)malloc((size_t)out->frames * out->channels * 2);
+
+            // Host is little-endian like the file
+            size_t n = out->samples ? fread(out->samples, 2 * out->channels, out->frames, f) : 0;
+            fclose(f);
+
+            if (n != out->frames)
+            {
+                fprintf(stderr, "adpcmenc: %s: short sample data\n", path);
+                free(out->samples);
+                return false;
+            }
+            return true;
+        }
+        else
+        {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "adpcmenc: %s: no fmt/data chunk\n", path);
+    fclose(f);
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Encoder
+// -----------------------------------------------------------------------------
+
+// Per channel, carried from block to block
+struct ChannelState
+{
+    int pred;
+    int index;
+};
+
+// The format's reference quantiser, tracking the decoder's own arithmetic
+// so the two never drift
+static unsigned int EncodeSample(ChannelState* s, int sample)
+{
+    int step = ADPCM_STEPS[s->index];
+    int diff = sample - s->pred;
+
+    unsigned int code = 0;
+    if (diff < 0)
+    {
+        code = 8;
+        diff = -diff;
+    }
+
+    if (diff >= step)      { code |= 4; diff -= step; }
+    if (diff >= step >> 1) { code |= 2; diff -= step >> 1; }
+    if (diff >= step >> 2) { code |= 1; }
+
+    int delta = step >> 3;
+    if (code & 4) delta += step;
+    if (code & 2) delta += step >> 1;
+    if (code & 1) delta += step >> 2;
+
+    int pred = (code & 8) ? s->pred - delta : s->pred + delta;
+    s->pred = pred < -32768 ? -32768 : (pred > 32767 ? 32767 : pred);
+
+    s->index += ADPCM_INDEX_ADJUST[code];
+    if (s->index < 0) s->index = 0;
+    if (s->index > 88) s->index = 88;
+
+    return code;
+}
+
+// One block from samplesPerBlock interleaved frames
+static void EncodeBlock(const int16_t* src, unsigned int channels, ChannelState* state,
+                        unsigned char* dst)
+{
+    unsigned int words = (BLOCK_BYTES_PER_CHANNEL - 4) / 4;
+
+    for (unsigned int ch = 0; ch < channels; ++ch)
+    {
+        ChannelState* s = &state[ch];
+        s->pred = src[ch];
+
+        unsigned char* hdr = dst + 4 * ch;
+        hdr[0] = (unsigned char)(s->pred & 255);
+        hdr[1] = (unsigned char)((s->pred >> 8) & 255);
+        hdr[2] = (unsigned char)s->index;
+        hdr[3] = 0;
+
+        const int16_t* in = src + channels + ch;
+        unsigned char* word = dst + 4 * channels + 4 * ch;
+
+        for (unsigned int w = 0; w < words; ++w, word += 4 * channels)
+        {
+            uint32_t bits = 0;
+            for (int k = 0; k < 8; ++k, in += channels)
+                bits |= (uint32_t)EncodeSample(s, *in) << (4 * k);
+
+            word[0] = (unsigned char)bits;
+            word[1] = (unsigned char)(bits >> 8);
+            word[2] = (unsigned char)(bits >> 16);
+            word[3] = (unsigned char)(bits >> 24);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Output
+// -----------------------------------------------------------------------------
+
+static void PutU16(unsigned char* p, unsigned int v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void PutU32(unsigned char* p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: adpcmenc <in.wav> <out.wav>\n");
+        return 1;
+    }
+
+    Wav wav = { 0, 0, 0, NULL };
+    if (!LoadWav(argv[1], &wav))
+        return 1;
+
+    const unsigned int channels = wav.channels;
+    const unsigned int blockAlign = BLOCK_BYTES_PER_CHANNEL * channels;
+    const unsigned int perBlock = Adpcm_SamplesPerBlock(blockAlign, channels);
+    const unsigned int blocks = wav.frames / perBlock;
+
+    if (blocks == 0)
+    {
+        fprintf(stderr, "adpcmenc: %s: shorter than one block\n", argv[1]);
+        return 1;
+    }
+
+    size_t dataBytes = (size_t)blocks * blockAlign;
+    unsigned char* data = (unsigned char*)malloc(dataBytes);
+    int16_t* check = (int16_t*)malloc((size_t)perBlock * channels * 2);
+
+    ChannelState state[2] = { { 0, 0 }, { 0, 0 } };
+    double signalSq = 0.0, errorSq = 0.0;
+
+    for (unsigned int b = 0; b < blocks; ++b)
+    {
+        const int16_t* src = wav.samples + (size_t)b * perBlock * channels;
+        unsigned char* dst = data + (size_t)b * blockAlign;
+
+        EncodeBlock(src, channels, state, dst);
+        Adpcm_DecodeBlock(dst, blockAlign, channels, check);
+
+        for (unsigned int i = 0; i < perBlock * channels; ++i)
+        {
+            double d = (double)src[i] - (double)check[i];
+            signalSq += (double)src[i] * (double)src[i];
+            errorSq += d * d;
+        }
+    }
+
+    // RIFF, fmt (WAVEFORMATEX + wSamplesPerBlock), fact, data
+    unsigned char hdr[60];
+    memcpy(hdr + 0, "RIFF", 4);
+    PutU32(hdr + 4, (uint32_t)(sizeof(hdr) - 8 + dataBytes));
+    memcpy(hdr + 8, "WAVE", 4);
+    memcpy(hdr + 12, "fmt ", 4);
+    PutU32(hdr + 16, 20);
+    PutU16(hdr + 20, ADPCM_FORMAT_TAG);
+    PutU16(hdr + 22, channels);
+    PutU32(hdr + 24, wav.rate);
+    PutU32(hdr + 28, (uint32_t)((unsigned long long)wav.rate * blockAlign / perBlock));
+    PutU16(hdr + 32, blockAlign);
+    PutU16(hdr + 34, 4);
+    PutU16(hdr + 36, 2);
+    PutU16(hdr + 38, perBlock);
+    memcpy(hdr + 40, "fact", 4);
+    PutU32(hdr + 44, 4);
+    PutU32(hdr + 48, blocks * perBlock);
+    memcpy(hdr + 52, "data", 4);
+    PutU32(hdr + 56, (uint32_t)dataBytes);
+
+    FILE* f = fopen(argv[2], "wb");
+    if (!f)
+    {
+        fprintf(stderr, "adpcmenc: can't create %s\n", argv[2]);
+        return 1;
+    }
+
+    fwrite(hdr, 1, sizeof(hdr), f);
+    fwrite(data, 1, dataBytes, f);
+
+    if (fclose(f) != 0)
+    {
+        fprintf(stderr, "adpcmenc: write failed for %s\n", argv[2]);
+        return 1;
+    }
+
+    double snr = errorSq > 0.0 ? 10.0 * log10(signalSq / errorSq) : 99.0;
+    printf("%s: %u Hz, %u ch, %u blocks of %u bytes, %u bytes (PCM %u), dropped %u frames, snr %.1f dB\n",
+           argv[2], wav.rate, channels, blocks, blockAlign, (unsigned int)(sizeof(hdr) + dataBytes),
+           wav.frames * channels * 2, wav.frames - blocks * perBlock, snr);
+
+    free(wav.samples);
+    free(data);
+    free(check);
+    return 0;
+}
@@ -0,0 +1,282 @@
+// ballbench - checks and times the BallScene physics in src/TR Demo/BallPhysics.cpp
+//
+// Host tool (Linux, any C++ compiler), run from the repository root:
+//   g++ -O2 -o ballbench tools/ballbench/ballbench.cpp "src/TR Demo/BallPhysics.cpp"
+//   ./ballbench [steps]                   default: 2000
+//
+// First the small-scene regression: the scene's spawn pattern (its four
+// opening balls, then one every 2.5 s from its random ranges, up to 16)
+// stepped with the grid broad-phase forced on and with the all-pairs sweep,
+// 5 seeds x 4000 steps, must match bit for bit after every step. Then, per
+// ball count, a pile dropped into the play area and stepped [steps] times
+// with the grid forced on and with all-pairs: steps per second for each, and
+// again they must match after every step. Loose piles land a few layers
+// deep; dense ones (balls of twice the radius) pack hard, so positional
+// correction moves balls a long way within one pass. The speedup column
+// around 64 balls is what BallPhysics.cpp's GRID_MIN_BALLS is set from.
+// Last, the scene's stress mode: its opening balls, then a D-pad burst of
+// 128 small balls every 2 s up to BALL_MAX, a few large balls among many
+// small ones, checked and timed the same way.
+
+#include "../../src/TR Demo/BallPhysics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+static const float STEP = 1.0f / 60.0f;
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static unsigned int s_rng = 1;
+
+static int Rand()
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (int)((s_rng >> 16) & 0x7FFF);
+}
+
+static Ball s_a[BALL_MAX];
+static Ball s_b[BALL_MAX];
+
+// The scene's auto-spawn, one ball at a time into both sets
+static void SpawnBoth(int* count, MaterialType mat)
+{
+    float x = 100.0f + (float)(Rand() % 440);
+    float y = 50.0f + (float)(Rand() % 100);
+    float vx = -200.0f + (float)(Rand() % 400);
+    float radius = 25.0f + (float)(Rand() % 25);
+
+    BallPhysics_InitBall(&s_a[*count], x, y, vx, 0.0f, radius, mat);
+    BallPhysics_InitBall(&s_b[*count], x, y, vx, 0.0f, radius, mat);
+    (*count)++;
+}
+
+// BallScene's opening four balls into both sets
+static void OpeningBalls(int* count)
+{
+    static const float start[4][5] =
+    {
+        { 150.0f, 80.0f, 200.0f, 0.0f, 45.0f },
+        { 400.0f, 120.0f, -150.0f, 0.0f, 40.0f },
+        { 300.0f, 50.0f, 100.0f, 0.0f, 35.0f },
+        { 500.0f, 100.0f, -100.0f, 50.0f, 30.0f },
+    };
+
+    for (int i = 0; i < 4; ++i, ++*count)
+    {
+        BallPhysics_InitBall(&s_a[i], start[i][0], start[i][1], start[i][2], start[i][3], start[i][4],
+                             (MaterialType)i);
+        BallPhysics_InitBall(&s_b[i], start[i][0], start[i][1], start[i][2], start[i][3], start[i][4],
+                             (MaterialType)i);
+    }
+}
+
+// BallScene's SpawnBurst into both sets
+static void BurstBoth(int* count)
+{
+    const float pitch = 16.0f;
+    const int cols = (int)(BALL_AREA_W / pitch);
+
+    for (int i = 0; i < 128 && *count < BALL_MAX; ++i)
+    {
+        float x = pitch * ((float)(i % cols) + 0.5f) + (float)(Rand() % 5 - 2);
+        float y = -pitch * ((float)(i / cols) + 0.5f);
+        float vx = -60.0f + (float)(Rand() % 120);
+        float radius = 4.0f + (float)(Rand() % 4);
+
+        BallPhysics_InitBall(&s_a[*count], x, y, vx, 0.0f, radius, (MaterialType)(i % MAT_COUNT));
+        BallPhysics_InitBall(&s_b[*count], x, y, vx, 0.0f, radius, (MaterialType)(i % MAT_COUNT));
+        (*count)++;
+    }
+}
+
+// Grid forced on against all-pairs, BallScene's spawns, up to 16 balls.
+// Returns the first differing step, or 0.
+static int SmallScene(unsigned int seed, int steps)
+{
+    memset(s_a, 0, sizeof(s_a));
+    memset(s_b, 0, sizeof(s_b));
+    s_rng = seed;
+
+    int count = 0;
+    OpeningBalls(&count);
+
+    int material = 0;
+    for (int s = 1; s <= steps; ++s)
+    {
+        if (count < 16 && s % 150 == 0)
+            SpawnBoth(&count, (MaterialType)(material++ % MAT_COUNT));
+
+        BallPhysics_Step(s_a, count, STEP, BALL_BROAD_GRID);
+        BallPhysics_Step(s_b, count, STEP, BALL_BROAD_ALL_PAIRS);
+
+        if (memcmp(s_a, s_b, sizeof(Ball) * count) != 0)
+            return s;
+    }
+    return 0;
+}
+
+// count balls on a jittered lattice over the top of the play area, sized so
+// they settle into a pile a few layers deep, or (dense) at twice the radius
+static void DropPile(int count, bool dense)
+{
+    memset(s_a, 0, sizeof(s_a));
+    s_rng = 0x5EED + count;
+
+    float maxR = (dense ? 50.0f : 25.0f) * sqrtf(16.0f / (float)count);
+    if (maxR > 25.0f) maxR = 25.0f;
+
+    int cols = (int)(BALL_AREA_W / (2.0f * maxR + 2.0f));
+    float pitch = BALL_AREA_W / (float)cols;
+
+    for (int i = 0; i < count; ++i)
+    {
+        float radius = maxR * (0.5f + (float)(Rand() % 50) / 100.0f);
+        float x = pitch * ((float)(i % cols) + 0.5f) + (float)(Rand() % 3 - 1);
+        float y = BALL_FLOOR_Y - pitch * ((float)(i / cols) + 0.5f) - 100.0f;
+        float vx = -100.0f + (float)(Rand() % 200);
+
+        BallPhysics_InitBall(&s_a[i], x, y, vx, 0.0f, radius, (MaterialType)(i % MAT_COUNT));
+    }
+    memcpy(s_b, s_a, sizeof(s_a));
+}
+
+int main(int argc, char** argv)
+{
+    int steps = argc > 1 ? atoi(argv[1]) : 2000;
+    if (steps < 1)
+    {
+        fprintf(stderr, "usage: ballbench [steps]\n");
+        return 1;
+    }
+
+    static const unsigned int seeds[5] = { 1, 2, 3, 0x1234, 0xC0FFEE };
+    bool ok = true;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        int bad = SmallScene(seeds[i], 4000);
+        if (bad)
+        {
+            printf("16-ball scene, seed %#x: differs at step %d\n", seeds[i], bad);
+            ok = false;
+        }
+        else
+        {
+            printf("16-ball scene, seed %#x: bit-identical over 4000 steps\n", seeds[i]);
+        }
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "ballbench: grid and all-pairs differ on a small scene\n");
+        return 2;
+    }
+
+    static const int counts[] = { 16, 32, 48, 64, 96, 128, 256, 512, 1000 };
+
+    printf("\n%6s %6s %14s %14s %8s %14s\n", "balls", "pile", "all-pairs/s", "grid/s", "speedup",
+           "same through");
+    for (unsigned int c = 0; c < 2 * sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        int n = counts[c >> 1];
+        bool dense = (c & 1) != 0;
+        DropPile(n, dense);
+
+        double usAll = 0.0, usGrid = 0.0;
+        int firstDiff = 0;
+
+        for (int s = 1; s <= steps; ++s)
+        {
+            double t0 = NowUs();
+            BallPhysics_Step(s_a, n, STEP, BALL_BROAD_ALL_PAIRS);
+            double t1 = NowUs();
+            BallPhysics_Step(s_b, n, STEP, BALL_BROAD_GRID);
+            double t2 = NowUs();
+
+            usAll += t1 - t0;
+            usGrid += t2 - t1;
+
+            if (!firstDiff && memcmp(s_a, s_b, sizeof(Ball) * n) != 0)
+                firstDiff = s;
+        }
+
+        char same[32];
+        if (firstDiff)
+        {
+            snprintf(same, sizeof(same), "step %d", firstDiff - 1);
+            ok = false;
+        }
+        else
+        {
+            snprintf(same, sizeof(same), "all %d", steps);
+        }
+
+        printf("%6d %6s %14.0f %14.0f %7.2fx %14s\n", n, dense ? "dense" : "loose",
+               steps * 1e6 / usAll, steps * 1e6 / usGrid, usAll / usGrid, same);
+    }
+
+    // Stress mode: a burst every 120 steps until BALL_MAX, then [steps] more
+    {
+        memset(s_a, 0, sizeof(s_a));
+        memset(s_b, 0, sizeof(s_b));
+        s_rng = 0xB0057;
+
+        int count = 0;
+        OpeningBalls(&count);
+
+        double usAll = 0.0, usGrid = 0.0;
+        int firstDiff = 0;
+        int total = 0;
+
+        for (int s = 1; s <= total + steps; ++s)
+        {
+            if (count < BALL_MAX && s % 120 == 0)
+            {
+                BurstBoth(&count);
+                total = s;
+            }
+
+            double t0 = NowUs();
+            BallPhysics_Step(s_a, count, STEP, BALL_BROAD_ALL_PAIRS);
+            double t1 = NowUs();
+            BallPhysics_Step(s_b, count, STEP, BALL_BROAD_AUTO);
+            double t2 = NowUs();
+
+            if (s > total)
+            {
+                usAll += t1 - t0;
+                usGrid += t2 - t1;
+            }
+
+            if (!firstDiff && memcmp(s_a, s_b, sizeof(Ball) * count) != 0)
+                firstDiff = s;
+        }
+
+        printf("\nstress bursts to %d balls, %d steps after the last: ", count, steps);
+        if (firstDiff)
+        {
+            printf("differs at step %d\n", firstDiff);
+            ok = false;
+        }
+        else
+        {
+            printf("bit-identical, %.0f vs %.0f steps/s (%.2fx)\n", steps * 1e6 / usAll,
+                   steps * 1e6 / usGrid, usAll / usGrid);
+        }
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "ballbench: grid and all-pairs differ on a pile\n");
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,282 @@
+// beatbench - checks and times the beat tracker in src/TR Demo/beat.cpp
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   g++ -O2 -o beatbench tools/beatbench/beatbench.cpp "src/TR Demo/beat.cpp" "src/TR Demo/spectrum.cpp"
+//   ./beatbench src/TR\ Demo/Media/snd/idk.trm     a 16-bit PCM WAV
+//   ./beatbench 128 [seconds]                      a synthetic track at 128 BPM
+//
+// Runs the analysis the way music.cpp does (512 points, 16 bands, the
+// demo's smoothing), fed in 32 KB refills. Every 5 s prints the tempo, beats
+// and onsets so far. The synthetic track (kicks on the beat, quieter hats
+// between, over noise) also checks the tempo found and where the beats land
+// against the kicks. Then cycles (rdtsc) per analysis frame, split into the
+// spectrum and the tracker, and per refill.
+
+#include "../../src/TR Demo/beat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <x86intrin.h>
+
+static const unsigned int REFILL_BYTES = 32 * 1024;
+
+static uint32_t ReadU32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static unsigned int ReadU16(const unsigned char* p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+struct Wav
+{
+    unsigned int channels;
+    unsigned int rate;
+    unsigned int frames;
+    int16_t*     samples;       // interleaved, malloc'd
+};
+
+// 16-bit PCM, 1 or 2 channels
+static bool LoadWav(const char* path, Wav* out)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "beatbench: can't open %s\n", path);
+        return false;
+    }
+
+    unsigned char hdr[12];
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0)
+    {
+        fprintf(stderr, "beatbench: %s: not a RIFF/WAVE file\n", path);
+        fclose(f);
+        return false;
+    }
+
+    bool gotFmt = false;
+    unsigned char chunk[8];
+
+    while (fread(chunk, 1, 8, f) == 8)
+    {
+        uint32_t size = ReadU32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+            unsigned char fmt[16];
+            if (fread(fmt, 1, 16, f) != 16)
+                break;
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+
+            if (ReadU16(fmt) != 1 || ReadU16(fmt + 14) != 16 ||
+                ReadU16(fmt + 2) < 1 || ReadU16(fmt + 2) > 2)
+            {
+                fprintf(stderr, "beatbench: %s: not 16-bit mono/stereo PCM\n", path);
+                fclose(f);
+                return false;
+            }
+
+            out->channels = ReadU16(fmt + 2);
+            out->rate = ReadU32(fmt + 4);
+            gotFmt = true;
+        }
+        else if (memcmp(chunk, "data", 4) == 0 && gotFmt)
+        {
+            out->frames = size / (2 * out->channels);
+            out->samples = (int16_t*)malloc((size_t)out->frames * out->channels * 2);
+
+            size_t n = out->samples ? fread(out->samples, 2 * out->channels, out->frames, f) : 0;
+            fclose(f);
+
+            if (n != out->frames)
+            {
+                fprintf(stderr, "beatbench: %s: short sample data\n", path);
+                free(out->samples);
+                return false;
+            }
+            return true;
+        }
+        else
+        {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "beatbench: %s: no fmt/data chunk\n", path);
+    fclose(f);
+    return false;
+}
+
+// Kick (a 120..60 Hz sweep with a 2 ms click) on each beat, a hat
+// (high-passed noise, 30 ms) half a beat later at a quarter of the level,
+// over noise 40 dB down
+static void MakeTrack(Wav* out, double bpm, double seconds)
+{
+    const double PI = 3.14159265358979323846;
+
+    out->channels = 2;
+    out->rate = 48000;
+    out->frames = (unsigned int)(seconds * out->rate);
+    out->samples = (int16_t*)malloc((size_t)out->frames * 4);
+
+    const double beat = 60.0 / bpm;
+    unsigned int rng = 0x2545F491;
+    double lastNoise = 0.0;
+
+    for (unsigned int i = 0; i < out->frames; ++i)
+    {
+        double t = (double)i / out->rate;
+        double inBeat = fmod(t, beat);
+        double inHat = fmod(t + beat * 0.5, beat);
+
+        rng = rng * 1664525u + 1013904223u;
+        double noise = ((double)(rng >> 8) / 8388608.0) - 1.0;
+
+        double hiss = (noise - lastNoise) * 0.5;
+        lastNoise = noise;
+
+        double kickPhase = 2.0 * PI * (60.0 * inBeat + 60.0 * 0.03 * (1.0 - exp(-inBeat / 0.03)));
+        double v = 0.7 * sin(kickPhase) * exp(-inBeat / 0.12);
+        v += inBeat < 0.002 ? 0.3 * noise : 0.0;
+        v += inHat < 0.03 ? 0.2 * hiss * (1.0 - inHat / 0.03) : 0.0;
+        v += 0.01 * noise;
+
+        int16_t s = (int16_t)lrint(v * 32767.0);
+        out->samples[i * 2] = s;
+        out->samples[i * 2 + 1] = s;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: beatbench <in.wav> | beatbench <bpm> [seconds]\n");
+        return 1;
+    }
+
+    Wav wav = { 0, 0, 0, NULL };
+    double synthBpm = atof(argv[1]);
+    bool synthetic = synthBpm > 0.0 && strchr(argv[1], '.') == strrchr(argv[1], '.') &&
+                     strspn(argv[1], "0123456789.") == strlen(argv[1]);
+
+    if (synthetic)
+        MakeTrack(&wav, synthBpm, argc > 2 ? atof(argv[2]) : 60.0);
+    else if (!LoadWav(argv[1], &wav))
+        return 1;
+
+    static Spectrum spec;
+    static BeatTracker beat;
+
+    SpectrumConfig cfg = { 512, 16, 40, 16000, wav.rate, 160, 24 };
+    if (!Spectrum_Configure(&spec, &cfg) || !Beat_Configure(&beat, cfg.bands, wav.rate, cfg.fftSize))
+    {
+        fprintf(stderr, "beatbench: unsupported rate %u\n", wav.rate);
+        return 1;
+    }
+
+    printf("%u Hz, %u ch, %.1f s; lags %u..%u frames, %.2f frames/s\n", wav.rate, wav.channels,
+           (double)wav.frames / wav.rate, beat.minLag, beat.maxLag, beat.frameRateQ8 / 256.0);
+
+    const unsigned int frameBytes = wav.channels * 2;
+    const unsigned int refillFrames = REFILL_BYTES / frameBytes;
+    const double frameSeconds = (double)cfg.fftSize / wav.rate;
+
+    unsigned long long specCycles = 0, beatCycles = 0;
+    unsigned int analyses = 0, onsets = 0, refills = 0;
+    unsigned int nextReport = 5;
+
+    // Synthetic: beat phase where each kick falls, over the second half
+    double errSum = 0.0, errMax = 0.0;
+    unsigned int errCount = 0;
+    unsigned int bpmAtEnd = 0;
+
+    // Any input: how many of the stronger onsets land near a tracked beat
+    unsigned int strong = 0, strongOnBeat = 0;
+
+    for (unsigned int at = 0; at < wav.frames; at += refillFrames, ++refills)
+    {
+        unsigned int left = wav.frames - at < refillFrames ? wav.frames - at : refillFrames;
+        const int16_t* pcm = wav.samples + (size_t)at * wav.channels;
+
+        while (left)
+        {
+            bool analyzed = false;
+
+            unsigned long long t0 = __rdtsc();
+            unsigned int used = Spectrum_Feed(&spec, pcm, left, wav.channels, &analyzed);
+            unsigned long long t1 = __rdtsc();
+            specCycles += t1 - t0;
+
+            pcm += used * wav.channels;
+            left -= used;
+            if (!analyzed)
+                continue;
+
+            Beat_Feed(&beat, spec.raw);
+            beatCycles += __rdtsc() - t1;
+            analyses++;
+
+            if (beat.onset)
+            {
+                onsets++;
+
+                // It peaked a frame ago
+                if (beat.onset >= 64 && beat.periodQ8)
+                {
+                    int at = (int)beat.phase - (int)((1u << 24) / beat.periodQ8);
+                    at = ((at + 32768) & 0xFFFF) - 32768;
+                    strong++;
+                    if (at > -6554 && at < 6554)
+                        strongOnBeat++;
+                }
+            }
+
+            // The frame ends at analyses * frameSeconds
+            double t = analyses * frameSeconds;
+            if (synthetic && beat.periodQ8 && t > (double)wav.frames / wav.rate * 0.5)
+            {
+                double inBeat = fmod(t, 60.0 / synthBpm) / (60.0 / synthBpm);
+                double tracked = beat.phase / 65536.0;
+                double err = tracked - inBeat;
+                err -= floor(err + 0.5);
+                errSum += fabs(err);
+                errCount++;
+                if (fabs(err) > errMax)
+                    errMax = fabs(err);
+            }
+
+            if (t >= nextReport)
+            {
+                printf("%6.1f s  %3u bpm  beats %5u  onsets %5u\n", t, Beat_Bpm(&beat), beat.beats, onsets);
+                nextReport += 5;
+            }
+            bpmAtEnd = Beat_Bpm(&beat);
+        }
+    }
+
+    printf("strong onsets %u, within a tenth of a beat %u (%.0f%%)\n", strong, strongOnBeat,
+           strong ? 100.0 * strongOnBeat / strong : 0.0);
+
+    if (synthetic)
+    {
+        printf("synthetic %.1f bpm: found %u; beat phase error mean %.3f max %.3f of a beat over %u frames\n",
+               synthBpm, bpmAtEnd, errCount ? errSum / errCount : 1.0, errMax, errCount);
+    }
+
+    printf("cycles per frame: spectrum %llu, tracker %llu; per %u KB refill %llu\n",
+           specCycles / analyses, beatCycles / analyses, REFILL_BYTES / 1024,
+           (specCycles + beatCycles) / refills);
+
+    free(wav.samples);
+
+    // Off the beat by more than an eighth on average, or the wrong tempo
+    if (synthetic && (errCount == 0 || errSum / errCount > 0.125 || fabs(bpmAtEnd - synthBpm) > 2.0))
+        return 2;
+    return 0;
+}
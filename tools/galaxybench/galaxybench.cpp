@@ -0,0 +1,494 @@
+// galaxybench - checks and times the galaxy transform + cull in src/TR Demo/GalaxyKernel.cpp
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   g++ -O2 -o galaxybench tools/galaxybench/galaxybench.cpp "src/TR Demo/GalaxyKernel.cpp"
+//   ./galaxybench [frames]                default: 1500 (the 25 s scene at 60 Hz)
+//
+// Builds GalaxyScene's five layers (15000 small stars, 1200 large, 675 dust,
+// 675 nebula, 2500 disc) with its generators: same radius bias, arm twist,
+// spread, jitter and depth, packed the way PackLayer does. The scene seeds
+// its RNG from the clock, so this runs three fixed seeds instead. Every frame
+// of the scene's camera path (sweep, zoom, roll) and per-layer spin goes
+// through GalaxyLayer_Transform (SSE) and GalaxyLayer_TransformRef (scalar).
+// Fails unless both keep the same particles in the same order with screen
+// positions and edge distances within 1/1000 px; prints whether they were
+// bit-identical (they are when the compiler does scalar float math as plain
+// SSE, as x86-64 g++ -O2 does; see GalaxyKernel.h). Then microseconds per
+// frame for each layer and all five, best of BEST_OF passes: the old
+// per-star loop GalaxyScene had before the kernel (one struct per particle,
+// angle through the sin/cos table, transform and cull only), the scalar
+// reference and the SSE path.
+
+#include "../../src/TR Demo/GalaxyKernel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// GalaxyScene
+static const unsigned SCENE_DURATION_MS = 25000;
+static const float    SCREEN_W = 640.0f;
+static const float    SCREEN_H = 480.0f;
+static const int      LUT_N = 1024;
+static const int      ARMS = 4;
+static const int      RMAX_PX = 420;
+static const int      RCORE_PX = 20;
+static const int      TWIST_MAX = 280;
+static const int      SPREAD_MAX = 48;
+static const float    ELLIPSE_Y = 0.78f;
+static const float    SWEEP_X = 140.0f;
+static const float    SWEEP_Y = 85.0f;
+static const float    ZOOM_MIN = 0.78f;
+static const float    ZOOM_MAX = 1.35f;
+static const float    ROLL_MAX = 0.18f;
+
+static const float    TOLERANCE = 1e-3f;
+static const int      BEST_OF = 5;
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static float s_sin[LUT_N];
+static float s_cos[LUT_N];
+
+static void BuildTables()
+{
+    for (int i = 0; i < LUT_N; ++i)
+    {
+        float a = (float)i * (2.0f * 3.14159265358979323846f) / (float)LUT_N;
+        s_sin[i] = sinf(a);
+        s_cos[i] = cosf(a);
+    }
+}
+
+static unsigned s_rng;
+
+static unsigned RngU32()
+{
+    s_rng = (s_rng * 1664525u + 1013904223u);
+    return s_rng;
+}
+
+static int RngRangeI(int lo, int hi)
+{
+    unsigned span = (unsigned)(hi - lo + 1);
+    return lo + (int)(RngU32() % span);
+}
+
+static int BiasedRadiusInt(int maxR)
+{
+    unsigned u = (RngU32() & 0xFFFFu);
+    unsigned long long uu = (unsigned long long)u * (unsigned long long)u;
+    int r = (int)(uu * (unsigned long long)maxR / 4294836225ULL);
+    return r > maxR ? maxR : r;
+}
+
+enum LayerKind
+{
+    LAYER_SMALL,
+    LAYER_LARGE,
+    LAYER_DUST,
+    LAYER_NEBULA,
+    LAYER_DISC,
+    LAYER_COUNT
+};
+
+static const char* const s_layerName[LAYER_COUNT] = { "small", "large", "dust", "nebula", "disc" };
+static const int s_layerCount[LAYER_COUNT] = { 15000, 1200, 675, 675, 2500 };
+
+// The old per-star layout (GalaxyScene's Star), for the baseline column
+struct AosStar
+{
+    int   rPix;
+    int   ang;        // LUT angle base index
+    int   depth;      // 0..255
+    int   tw;         // 0..255
+    int   armDist;
+    int   sprRot;
+    int   spinStep;
+    float jx, jy;     // jitter in px
+    unsigned base;
+};
+
+static AosStar* s_aos[LAYER_COUNT];
+
+// One particle of InitStars / InitDust / InitNebula / InitDisc, packed. Draws
+// from the RNG in the scene's order, colors and sprite spin included, so the
+// layers built after it see the same sequence.
+static void MakeParticle(GalaxyLayer* l, AosStar* aos, int i, LayerKind kind)
+{
+    int depth = (int)(RngU32() & 255u);
+    RngU32();                                   // twinkle phase
+
+    int rPix, ang;
+    int jitterMax = 10;
+    float jitter = 0.55f;
+
+    if (kind == LAYER_DISC)
+    {
+        rPix = BiasedRadiusInt(RMAX_PX);
+        ang = (int)(RngU32() & (LUT_N - 1));
+        jitter = 0.9f;
+    }
+    else
+    {
+        int spreadMax = SPREAD_MAX;
+
+        if (kind == LAYER_SMALL || kind == LAYER_LARGE)
+        {
+            rPix = (RngU32() & 255u) < 100u ? BiasedRadiusInt(RCORE_PX)
+                                            : RCORE_PX + BiasedRadiusInt(RMAX_PX - RCORE_PX);
+        }
+        else
+        {
+            rPix = RCORE_PX + BiasedRadiusInt(RMAX_PX - RCORE_PX);
+            if (kind == LAYER_NEBULA && rPix < 120)
+                rPix = 120 + (rPix % 40);
+        }
+
+        if (kind == LAYER_DUST)   { spreadMax = 24; jitterMax = 16; jitter = 0.6f; }
+        if (kind == LAYER_NEBULA) { spreadMax = 30; jitterMax = 22; jitter = 0.7f; }
+
+        int arm = (int)(RngU32() % (unsigned)ARMS);
+        int twist = (rPix * TWIST_MAX) / RMAX_PX;
+        int spread = RngRangeI(-spreadMax, spreadMax);
+        ang = (arm * (LUT_N / ARMS) + twist + spread) & (LUT_N - 1);
+    }
+
+    l->jx[i] = (float)RngRangeI(-jitterMax, jitterMax) * jitter;
+    l->jy[i] = (float)RngRangeI(-jitterMax, jitterMax) * jitter;
+
+    RngU32();                                   // sprite rotation
+    RngU32();                                   // spin step
+
+    l->px[i] = s_cos[ang] * (float)rPix;
+    l->py[i] = s_sin[ang] * (float)rPix;
+    l->dz[i] = 0.62f + ((float)depth) * (0.70f / 255.0f);
+
+    memset(&aos[i], 0, sizeof(AosStar));
+    aos[i].rPix = rPix;
+    aos[i].ang = ang;
+    aos[i].depth = depth;
+    aos[i].jx = l->jx[i];
+    aos[i].jy = l->jy[i];
+}
+
+static bool BuildLayers(GalaxyLayer* layers, unsigned seed)
+{
+    s_rng = seed;
+    for (int k = 0; k < LAYER_COUNT; ++k)
+    {
+        free(s_aos[k]);
+        s_aos[k] = (AosStar*)malloc(sizeof(AosStar) * s_layerCount[k]);
+        if (!s_aos[k] || !GalaxyLayer_Init(&layers[k], s_layerCount[k]))
+            return false;
+        for (int i = 0; i < s_layerCount[k]; ++i)
+            MakeParticle(&layers[k], s_aos[k], i, (LayerKind)k);
+    }
+    return true;
+}
+
+// The layer's spin, as a LUT index
+static int SpinIndex(unsigned tMs, LayerKind kind)
+{
+    unsigned div = kind == LAYER_DUST ? 31 : kind == LAYER_NEBULA ? 25 : kind == LAYER_DISC ? 22 : 19;
+    return (int)((tMs / div) & (LUT_N - 1));
+}
+
+// GalaxyScene's BuildCamera and view setup; spin for the given layer
+static GalaxyView SceneView(unsigned tMs, LayerKind kind)
+{
+    float t = (float)tMs / (float)SCENE_DURATION_MS;
+    if (t > 1.0f) t = 1.0f;
+
+    float e = 0.5f - 0.5f * cosf(t * 3.14159265358979323846f);
+
+    int phA = (int)((tMs / 16) & (LUT_N - 1));
+    int phB = (int)(((tMs / 23) + 170) & (LUT_N - 1));
+    float roll = s_sin[phB] * ROLL_MAX;
+
+    GalaxyView v;
+    v.cx = (SCREEN_W * 0.5f) + (-SWEEP_X + (2.0f * SWEEP_X) * e) + s_sin[phA] * 18.0f;
+    v.cy = (SCREEN_H * 0.5f) + (SWEEP_Y - (2.0f * SWEEP_Y) * e) + s_cos[phA] * 12.0f;
+    v.zoom = ZOOM_MIN + (ZOOM_MAX - ZOOM_MIN) * e;
+    v.cosRoll = cosf(roll);
+    v.sinRoll = sinf(roll);
+    v.ellipseY = ELLIPSE_Y;
+    v.screenW = SCREEN_W;
+    v.screenH = SCREEN_H;
+
+    int rot = SpinIndex(tMs, kind);
+    v.cosSpin = s_cos[rot];
+    v.sinSpin = s_sin[rot];
+    return v;
+}
+
+static unsigned FrameMs(int f, int frames)
+{
+    return (unsigned)((unsigned long long)f * SCENE_DURATION_MS / (unsigned)frames);
+}
+
+struct Visible
+{
+    int    n;
+    int*   idx;
+    float* x;
+    float* y;
+    float* edge;
+};
+
+// -----------------------------------------------------------------------------
+// Baseline: GalaxyScene's old RenderStars / RenderDust / ... loop up to the
+// cull (per-layer pad, then the edge fade's in-screen test), compacted into
+// the layer's vis arrays like the kernel; visEdge gets the fade (0..256).
+// -----------------------------------------------------------------------------
+
+static const float s_cullPad[LAYER_COUNT] = { 32.0f, 32.0f, 80.0f, 60.0f, 40.0f };
+
+static inline unsigned EdgeScale256_1D(float p, float minP, float maxP)
+{
+    const float FADE1 = 16.0f;
+    const float FADE2 = 32.0f;
+    const float FADE3 = 48.0f;
+
+    if (p < minP) return 0u;
+    if (p > maxP) return 0u;
+
+    float dL = p - minP;
+    if (dL < FADE3)
+    {
+        if (dL < FADE1) return 64u;
+        if (dL < FADE2) return 128u;
+        return 192u;
+    }
+
+    float dR = maxP - p;
+    if (dR < FADE3)
+    {
+        if (dR < FADE1) return 64u;
+        if (dR < FADE2) return 128u;
+        return 192u;
+    }
+
+    return 256u;
+}
+
+static int TransformAos(GalaxyLayer* l, const AosStar* stars, unsigned tMs, LayerKind kind,
+                        const GalaxyView& v)
+{
+    const int rot = SpinIndex(tMs, kind);
+    const float cr = v.cosRoll;
+    const float sr = v.sinRoll;
+    const float pad = s_cullPad[kind];
+    int n = 0;
+
+    for (int i = 0; i < l->count; ++i)
+    {
+        const AosStar& s = stars[i];
+
+        int a = (s.ang + rot) & (LUT_N - 1);
+
+        float cs = s_cos[a];
+        float sn = s_sin[a];
+
+        float gx = cs * (float)s.rPix + s.jx;
+        float gy = sn * (float)s.rPix * ELLIPSE_Y + s.jy;
+
+        float dz = 0.62f + ((float)s.depth) * (0.70f / 255.0f);
+        float scale = v.zoom * dz;
+
+        float rx = gx * cr - gy * sr;
+        float ry = gx * sr + gy * cr;
+
+        float sx = v.cx + rx * scale;
+        float sy = v.cy + ry * scale;
+
+        if (sx < -pad || sx > (SCREEN_W + pad) || sy < -pad || sy > (SCREEN_H + pad))
+            continue;
+
+        unsigned sxScale = EdgeScale256_1D(sx, 0.0f, SCREEN_W);
+        unsigned syScale = EdgeScale256_1D(sy, 0.0f, SCREEN_H);
+        unsigned scale256 = sxScale < syScale ? sxScale : syScale;
+        if (scale256 == 0u)
+            continue;
+
+        l->visIdx[n] = i;
+        l->visX[n] = sx;
+        l->visY[n] = sy;
+        l->visEdge[n] = (float)scale256;
+        n++;
+    }
+
+    l->visible = n;
+    return n;
+}
+
+static void Keep(const GalaxyLayer* l, Visible* out)
+{
+    out->n = l->visible;
+    memcpy(out->idx, l->visIdx, sizeof(int) * l->visible);
+    memcpy(out->x, l->visX, sizeof(float) * l->visible);
+    memcpy(out->y, l->visY, sizeof(float) * l->visible);
+    memcpy(out->edge, l->visEdge, sizeof(float) * l->visible);
+}
+
+// Checks every frame of every layer; returns false on the first mismatch
+static bool Check(GalaxyLayer* layers, unsigned seed, int frames)
+{
+    long long kept = 0, total = 0;
+    float worst = 0.0f;
+    bool exact = true;
+
+    for (int k = 0; k < LAYER_COUNT; ++k)
+    {
+        GalaxyLayer* l = &layers[k];
+        Visible ref;
+        ref.idx = (int*)malloc(sizeof(int) * l->cap);
+        ref.x = (float*)malloc(sizeof(float) * l->cap);
+        ref.y = (float*)malloc(sizeof(float) * l->cap);
+        ref.edge = (float*)malloc(sizeof(float) * l->cap);
+
+        bool ok = true;
+        for (int f = 0; f < frames && ok; ++f)
+        {
+            GalaxyView v = SceneView(FrameMs(f, frames), (LayerKind)k);
+
+            GalaxyLayer_TransformRef(l, &v);
+            Keep(l, &ref);
+            int n = GalaxyLayer_Transform(l, &v);
+
+            if (n != ref.n || n != l->visible || memcmp(ref.idx, l->visIdx, sizeof(int) * n) != 0)
+            {
+                fprintf(stderr, "galaxybench: seed %#x, %s, frame %d: %d visible vs %d in the reference\n",
+                        seed, s_layerName[k], f, n, ref.n);
+                ok = false;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                float d = fabsf(l->visX[i] - ref.x[i]);
+                float dy = fabsf(l->visY[i] - ref.y[i]);
+                float de = fabsf(l->visEdge[i] - ref.edge[i]);
+                if (dy > d) d = dy;
+                if (de > d) d = de;
+
+                if (d > worst) worst = d;
+                if (l->visX[i] != ref.x[i] || l->visY[i] != ref.y[i] || l->visEdge[i] != ref.edge[i])
+                    exact = false;
+            }
+
+            if (worst > TOLERANCE)
+            {
+                fprintf(stderr, "galaxybench: seed %#x, %s, frame %d: positions %g px off the reference\n",
+                        seed, s_layerName[k], f, worst);
+                ok = false;
+            }
+
+            kept += n;
+            total += l->count;
+        }
+
+        free(ref.idx);
+        free(ref.x);
+        free(ref.y);
+        free(ref.edge);
+        if (!ok)
+            return false;
+    }
+
+    printf("seed %#10x: %d frames, %.1f%% of particles on screen, same particles; %s\n", seed, frames,
+           100.0 * kept / total, exact ? "bit-identical" : "positions within 1/1000 px");
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 1500;
+    if (frames < 1)
+    {
+        fprintf(stderr, "usage: galaxybench [frames]\n");
+        return 1;
+    }
+
+    BuildTables();
+
+    static const unsigned seeds[3] = { 0x12345678u, 0xC0FFEE11u, 0xDEADBEEFu };
+    GalaxyLayer layers[LAYER_COUNT];
+
+    for (int s = 0; s < 3; ++s)
+    {
+        memset(layers, 0, sizeof(layers));
+        bool ok = BuildLayers(layers, seeds[s]) && Check(layers, seeds[s], frames);
+
+        if (s < 2 || !ok)
+        {
+            for (int k = 0; k < LAYER_COUNT; ++k)
+                GalaxyLayer_Free(&layers[k]);
+        }
+        if (!ok)
+            return 2;
+    }
+
+    // Timing on the last seed's layers, each path over the same frames
+    unsigned int sink = 0;
+    double sumAos = 0.0, sumRef = 0.0, sumSse = 0.0;
+
+    printf("\n%8s %10s %10s %10s %10s %8s %8s\n", "layer", "particles", "aos us", "ref us", "sse us",
+           "vs aos", "vs ref");
+    for (int k = 0; k < LAYER_COUNT; ++k)
+    {
+        GalaxyLayer* l = &layers[k];
+        double aos = 1e30, ref = 1e30, sse = 1e30;
+
+        for (int pass = 0; pass < BEST_OF; ++pass)
+        {
+            double t0 = NowUs();
+            for (int f = 0; f < frames; ++f)
+            {
+                unsigned tMs = FrameMs(f, frames);
+                GalaxyView v = SceneView(tMs, (LayerKind)k);
+                sink += (unsigned)TransformAos(l, s_aos[k], tMs, (LayerKind)k, v);
+            }
+            double t1 = NowUs();
+            for (int f = 0; f < frames; ++f)
+            {
+                GalaxyView v = SceneView(FrameMs(f, frames), (LayerKind)k);
+                sink += (unsigned)GalaxyLayer_TransformRef(l, &v);
+            }
+            double t2 = NowUs();
+            for (int f = 0; f < frames; ++f)
+            {
+                GalaxyView v = SceneView(FrameMs(f, frames), (LayerKind)k);
+                sink += (unsigned)GalaxyLayer_Transform(l, &v);
+            }
+            double t3 = NowUs();
+
+            if ((t1 - t0) / frames < aos) aos = (t1 - t0) / frames;
+            if ((t2 - t1) / frames < ref) ref = (t2 - t1) / frames;
+            if ((t3 - t2) / frames < sse) sse = (t3 - t2) / frames;
+        }
+
+        sumAos += aos;
+        sumRef += ref;
+        sumSse += sse;
+        printf("%8s %10d %10.1f %10.1f %10.1f %7.2fx %7.2fx\n", s_layerName[k], l->count, aos, ref, sse,
+               aos / sse, ref / sse);
+    }
+    printf("%8s %10d %10.1f %10.1f %10.1f %7.2fx %7.2fx\n", "all", 15000 + 1200 + 675 + 675 + 2500,
+           sumAos, sumRef, sumSse, sumAos / sumSse, sumRef / sumSse);
+
+    for (int k = 0; k < LAYER_COUNT; ++k)
+    {
+        GalaxyLayer_Free(&layers[k]);
+        free(s_aos[k]);
+    }
+
+    return sink == 0xFFFFFFFF ? 2 : 0;
+}
@@ -0,0 +1,137 @@
+// mipbench - times the mip downsample kernels in src/TR Demo/mipfilter.cpp
+//
+// Host tool (Linux, any C++ compiler), run from the repository root:
+//   g++ -O2 -o mipbench tools/mipbench/mipbench.cpp "src/TR Demo/mipfilter.cpp"
+//   ./mipbench [size] [reps]            defaults: 512 200
+//
+// Builds a full chain from a size x size noise image with each kernel and
+// prints the time per chain and source texels per microsecond. The box
+// kernel is first checked against a plain per-channel reference, since the
+// runtime relies on it being exact.
+
+#include "../../src/TR Demo/mipfilter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static void BoxReference(const unsigned int* src, unsigned int w, unsigned int h, unsigned int* dst)
+{
+    unsigned int dw = w > 1 ? w / 2 : 1;
+    unsigned int dh = h > 1 ? h / 2 : 1;
+
+    for (unsigned int y = 0; y < dh; ++y)
+    {
+        for (unsigned int x = 0; x < dw; ++x)
+        {
+            unsigned int x0 = w > 1 ? 2 * x : 0, x1 = w > 1 ? 2 * x + 1 : 0;
+            unsigned int y0 = h > 1 ? 2 * y : 0, y1 = h > 1 ? 2 * y + 1 : 0;
+            unsigned int n = (x0 != x1 ? 2 : 1) * (y0 != y1 ? 2 : 1);
+            unsigned int r = 0;
+
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                unsigned int sum = 0;
+                sum += (src[y0 * w + x0] >> shift) & 255;
+                if (x1 != x0) sum += (src[y0 * w + x1] >> shift) & 255;
+                if (y1 != y0) sum += (src[y1 * w + x0] >> shift) & 255;
+                if (x1 != x0 && y1 != y0) sum += (src[y1 * w + x1] >> shift) & 255;
+                r |= ((sum + n / 2) / n) << shift;
+            }
+            dst[y * dw + x] = r;
+        }
+    }
+}
+
+// Whole chain, each level from the one above; returns the last level's texel
+// so the work can't be optimised away
+static unsigned int Chain(int kernel, const unsigned int* base, unsigned int size,
+                          unsigned int* a, unsigned int* b, float* scratch)
+{
+    const unsigned int* src = base;
+    unsigned int w = size, h = size;
+
+    while (w > 1 || h > 1)
+    {
+        unsigned int* dst = src == a ? b : a;
+        if (kernel == 0)
+            Mip_Box(src, w, h, dst);
+        else
+            Mip_Kaiser(src, w, h, dst, scratch);
+
+        src = dst;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    return src[0];
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int size = argc > 1 ? (unsigned int)atoi(argv[1]) : 512;
+    int reps = argc > 2 ? atoi(argv[2]) : 200;
+
+    if (size < 2 || (size & (size - 1)) || reps < 1)
+    {
+        fprintf(stderr, "usage: mipbench [power-of-two size] [reps]\n");
+        return 1;
+    }
+
+    size_t count = (size_t)size * size;
+    unsigned int* base = (unsigned int*)malloc(count * 4);
+    unsigned int* a = (unsigned int*)malloc(count * 4);
+    unsigned int* b = (unsigned int*)malloc(count * 4);
+    unsigned int* ref = (unsigned int*)malloc(count * 4);
+    float* scratch = (float*)malloc(Mip_KaiserScratch(size, size) * sizeof(float));
+
+    unsigned int rng = 0x12345678;
+    for (size_t i = 0; i < count; ++i)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        base[i] = rng;
+    }
+
+    // Exactness, every level and the 1-wide tails
+    for (unsigned int w = size, h = size / 2; w > 1 || h > 1;)
+    {
+        Mip_Box(base, w, h, a);
+        BoxReference(base, w, h, ref);
+
+        unsigned int n = (w > 1 ? w / 2 : 1) * (h > 1 ? h / 2 : 1);
+        if (memcmp(a, ref, n * 4) != 0)
+        {
+            fprintf(stderr, "mipbench: box kernel differs from reference at %ux%u\n", w, h);
+            return 1;
+        }
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+
+    const char* names[2] = { "box", "kaiser" };
+    unsigned int sink = 0;
+
+    printf("%ux%u, %u levels, %d reps\n", size, size, Mip_LevelCount(size, size), reps);
+
+    for (int kernel = 0; kernel < 2; ++kernel)
+    {
+        sink ^= Chain(kernel, base, size, a, b, scratch);   // warm up
+
+        double t0 = NowUs();
+        for (int r = 0; r < reps; ++r)
+            sink ^= Chain(kernel, base, size, a, b, scratch);
+        double us = (NowUs() - t0) / reps;
+
+        printf("%-8s %9.1f us/chain %8.1f texels/us\n", names[kernel], us, (double)count / us);
+    }
+
+    free(base); free(a); free(b); free(ref); free(scratch);
+    return sink == 0xFFFFFFFF ? 2 : 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+// d3d8.h - Host stand-in, see xtl.h
+#include "xtl.h"
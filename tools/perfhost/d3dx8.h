@@ -0,0 +1,3 @@
+#pragma once
+// d3dx8.h - Host stand-in, see xtl.h
+#include "xtl.h"
@@ -0,0 +1,924 @@
+// hostshim.cpp - Host implementations behind tools/perfhost/xtl.h
+//
+// Single-threaded by design: CreateThread runs the thread procedure to the
+// end before it returns, so the demo's loader work happens inline and a run
+// is repeatable. The music stream thread is never started, because
+// DirectSoundCreate fails and Music_Init gives up before it.
+
+#include "hostshim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// Stats
+// -----------------------------------------------------------------------------
+
+static HostDeviceStats s_stats;
+
+void HostDevice_ResetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void HostDevice_GetStats(HostDeviceStats* out)
+{
+    *out = s_stats;
+}
+
+// -----------------------------------------------------------------------------
+// Handles
+// -----------------------------------------------------------------------------
+
+enum HandleKind
+{
+    HANDLE_FILE = 1,
+    HANDLE_EVENT,
+    HANDLE_THREAD
+};
+
+struct HostHandle
+{
+    int   kind;
+    FILE* file;
+    bool  signaled;
+    bool  manualReset;
+};
+
+static HostHandle* NewHandle(int kind)
+{
+    HostHandle* h = (HostHandle*)calloc(1, sizeof(HostHandle));
+    if (h)
+        h->kind = kind;
+    return h;
+}
+
+static HostHandle* AsHandle(HANDLE h)
+{
+    return (h && h != INVALID_HANDLE_VALUE) ? (HostHandle*)h : NULL;
+}
+
+BOOL CloseHandle(HANDLE h)
+{
+    HostHandle* hh = AsHandle(h);
+    if (!hh)
+        return FALSE;
+
+    if (hh->file)
+        fclose(hh->file);
+    free(hh);
+    return TRUE;
+}
+
+DWORD GetLastError()
+{
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Files: D:\dir\name -> <media root>dir/name
+// -----------------------------------------------------------------------------
+
+static char s_mediaRoot[512] = "src/TR Demo/Media/";
+
+void Host_SetMediaRoot(const char* dir)
+{
+    size_t n = strlen(dir);
+    if (n + 2 > sizeof(s_mediaRoot))
+        return;
+
+    memcpy(s_mediaRoot, dir, n + 1);
+    if (n && dir[n - 1] != '/')
+        strcat(s_mediaRoot, "/");
+}
+
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD, LPSECURITY_ATTRIBUTES, DWORD creation, DWORD, HANDLE)
+{
+    if ((access & GENERIC_WRITE) || creation != OPEN_EXISTING)
+        return INVALID_HANDLE_VALUE;
+
+    if ((path[0] == 'D' || path[0] == 'd') && path[1] == ':' && path[2] == '\\')
+        path += 3;
+
+    char full[1024];
+    size_t n = strlen(s_mediaRoot);
+    if (n + strlen(path) + 1 > sizeof(full))
+        return INVALID_HANDLE_VALUE;
+
+    memcpy(full, s_mediaRoot, n);
+    for (const char* s = path; *s; ++s)
+        full[n++] = (*s == '\\') ? '/' : *s;
+    full[n] = 0;
+
+    FILE* f = fopen(full, "rb");
+    if (!f)
+        return INVALID_HANDLE_VALUE;
+
+    HostHandle* h = NewHandle(HANDLE_FILE);
+    if (!h)
+    {
+        fclose(f);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    h->file = f;
+    return (HANDLE)h;
+}
+
+// Overlapped reads complete before ReadFile returns
+BOOL ReadFile(HANDLE h, LPVOID buf, DWORD bytes, LPDWORD read, LPOVERLAPPED ov)
+{
+    HostHandle* hh = AsHandle(h);
+    if (!hh || !hh->file)
+        return FALSE;
+
+    if (ov && fseek(hh->file, (long)ov->Offset, SEEK_SET) != 0)
+        return FALSE;
+
+    DWORD got = (DWORD)fread(buf, 1, bytes, hh->file);
+    if (read)
+        *read = got;
+
+    if (ov)
+    {
+        ov->Internal = 0;
+        ov->InternalHigh = got;
+        if (ov->hEvent)
+            SetEvent(ov->hEvent);
+    }
+    return TRUE;
+}
+
+BOOL GetOverlappedResult(HANDLE, LPOVERLAPPED ov, LPDWORD bytes, BOOL)
+{
+    if (bytes)
+        *bytes = (DWORD)ov->InternalHigh;
+    return TRUE;
+}
+
+DWORD SetFilePointer(HANDLE h, LONG lo, LONG* hi, DWORD method)
+{
+    HostHandle* hh = AsHandle(h);
+    if (!hh || !hh->file)
+        return INVALID_SET_FILE_POINTER;
+
+    long long off = hi ? (((long long)*hi << 32) | (DWORD)lo) : (long long)lo;
+    int whence = method == FILE_END ? SEEK_END : method == FILE_CURRENT ? SEEK_CUR : SEEK_SET;
+
+    if (fseek(hh->file, (long)off, whence) != 0)
+        return INVALID_SET_FILE_POINTER;
+
+    long long pos = ftell(hh->file);
+    if (hi)
+        *hi = (LONG)(pos >> 32);
+    return (DWORD)pos;
+}
+
+// -----------------------------------------------------------------------------
+// Threads and sync
+// -----------------------------------------------------------------------------
+
+HANDLE CreateThread(LPSECURITY_ATTRIBUTES, SIZE_T, LPTHREAD_START_ROUTINE proc, LPVOID param, DWORD,
+                    LPDWORD id)
+{
+    HostHandle* h = NewHandle(HANDLE_THREAD);
+    if (!h)
+        return NULL;
+
+    if (id)
+        *id = 1;
+
+    proc(param);
+
+    h->signaled = true;
+    h->manualReset = true;
+    return (HANDLE)h;
+}
+
+BOOL SetThreadPriority(HANDLE, int)
+{
+    return TRUE;
+}
+
+HANDLE CreateEvent(LPSECURITY_ATTRIBUTES, BOOL manualReset, BOOL initialState, LPCSTR)
+{
+    HostHandle* h = NewHandle(HANDLE_EVENT);
+    if (!h)
+        return NULL;
+
+    h->manualReset = manualReset != FALSE;
+    h->signaled = initialState != FALSE;
+    return (HANDLE)h;
+}
+
+BOOL SetEvent(HANDLE h)
+{
+    HostHandle* hh = AsHandle(h);
+    if (!hh)
+        return FALSE;
+
+    hh->signaled = true;
+    return TRUE;
+}
+
+BOOL ResetEvent(HANDLE h)
+{
+    HostHandle* hh = AsHandle(h);
+    if (!hh)
+        return FALSE;
+
+    hh->signaled = false;
+    return TRUE;
+}
+
+// Nothing else can signal anything, so waits never block
+static bool TakeSignal(HostHandle* h)
+{
+    if (!h || !h->signaled)
+        return false;
+
+    if (!h->manualReset)
+        h->signaled = false;
+    return true;
+}
+
+DWORD WaitForSingleObject(HANDLE h, DWORD)
+{
+    return TakeSignal(AsHandle(h)) ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+}
+
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* h, BOOL, DWORD)
+{
+    for (DWORD i = 0; i < count; ++i)
+    {
+        if (TakeSignal(AsHandle(h[i])))
+            return WAIT_OBJECT_0 + i;
+    }
+    return WAIT_TIMEOUT;
+}
+
+void InitializeCriticalSection(CRITICAL_SECTION*) {}
+void EnterCriticalSection(CRITICAL_SECTION*) {}
+void LeaveCriticalSection(CRITICAL_SECTION*) {}
+
+LONG InterlockedExchange(volatile LONG* target, LONG value)
+{
+    LONG old = *target;
+    *target = value;
+    return old;
+}
+
+LONG InterlockedIncrement(volatile LONG* target)
+{
+    return ++*target;
+}
+
+void Sleep(DWORD ms)
+{
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+// -----------------------------------------------------------------------------
+// Time
+// -----------------------------------------------------------------------------
+
+static LONGLONG NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (LONGLONG)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+DWORD GetTickCount()
+{
+    return (DWORD)(NowNs() / 1000000LL);
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count)
+{
+    count->QuadPart = NowNs();
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* freq)
+{
+    freq->QuadPart = 1000000000LL;
+    return TRUE;
+}
+
+// -----------------------------------------------------------------------------
+// Memory, debug output, title
+// -----------------------------------------------------------------------------
+
+LPVOID XPhysicalAlloc(SIZE_T bytes, ULONG_PTR, ULONG_PTR alignment, DWORD)
+{
+    void* p = NULL;
+    if (alignment < sizeof(void*))
+        alignment = sizeof(void*);
+    return posix_memalign(&p, alignment, bytes) == 0 ? p : NULL;
+}
+
+void XPhysicalFree(LPVOID p)
+{
+    free(p);
+}
+
+static FILE* s_debugOut = NULL;
+static bool  s_debugOutSet = false;
+
+void Host_SetDebugOutput(FILE* f)
+{
+    s_debugOut = f;
+    s_debugOutSet = true;
+}
+
+void OutputDebugStringA(LPCSTR s)
+{
+    FILE* f = s_debugOutSet ? s_debugOut : stderr;
+    if (f)
+        fputs(s, f);
+}
+
+DWORD XLaunchNewImage(LPCSTR, void*)
+{
+    exit(0);
+}
+
+// -----------------------------------------------------------------------------
+// XInput: no controllers
+// -----------------------------------------------------------------------------
+
+void XInitDevices(DWORD, void*) {}
+
+BOOL XGetDeviceChanges(void*, DWORD* inserted, DWORD* removed)
+{
+    *inserted = 0;
+    *removed = 0;
+    return FALSE;
+}
+
+HANDLE XInputOpen(void*, DWORD, DWORD, void*)
+{
+    return NULL;
+}
+
+void XInputClose(HANDLE) {}
+
+DWORD XInputGetState(HANDLE, XINPUT_STATE* state)
+{
+    memset(state, 0, sizeof(*state));
+    return ERROR_DEVICE_NOT_CONNECTED;
+}
+
+// -----------------------------------------------------------------------------
+// Resources
+// -----------------------------------------------------------------------------
+
+static UINT BlockBytes(D3DFORMAT f)
+{
+    return f == D3DFMT_DXT1 ? 8 : 16;
+}
+
+static bool IsDxt(D3DFORMAT f)
+{
+    return f == D3DFMT_DXT1 || f == D3DFMT_DXT2 || f == D3DFMT_DXT3 || f == D3DFMT_DXT4 || f == D3DFMT_DXT5;
+}
+
+static UINT PixelBytes(D3DFORMAT f)
+{
+    switch (f)
+    {
+    case D3DFMT_R5G6B5:
+    case D3DFMT_A4R4G4B4:
+    case D3DFMT_D16:
+        return 2;
+    case D3DFMT_P8:
+    case D3DFMT_L8:
+    case D3DFMT_LIN_L8:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+static UINT LevelDim(UINT d, UINT level)
+{
+    d >>= level;
+    return d ? d : 1;
+}
+
+static UINT LevelPitch(D3DFORMAT f, UINT w)
+{
+    return IsDxt(f) ? ((w + 3) / 4) * BlockBytes(f) : w * PixelBytes(f);
+}
+
+static UINT LevelBytes(D3DFORMAT f, UINT w, UINT h)
+{
+    return IsDxt(f) ? LevelPitch(f, w) * ((h + 3) / 4) : LevelPitch(f, w) * h;
+}
+
+static UINT LevelOffset(const IDirect3DBaseTexture8* t, UINT level)
+{
+    UINT off = 0;
+    for (UINT l = 0; l < level; ++l)
+        off += LevelBytes(t->format, LevelDim(t->width, l), LevelDim(t->height, l));
+    return off;
+}
+
+ULONG IDirect3DResource8::AddRef()
+{
+    return ++refs;
+}
+
+ULONG IDirect3DResource8::Release()
+{
+    if (refs > 1)
+        return --refs;
+
+    refs = 0;
+    if (!heap)
+        return 0;
+
+    free(data);
+    switch (kind)
+    {
+    case HOST_RES_TEXTURE:          delete (IDirect3DTexture8*)this; break;
+    case HOST_RES_VERTEX_BUFFER:    delete (IDirect3DVertexBuffer8*)this; break;
+    case HOST_RES_INDEX_BUFFER:     delete (IDirect3DIndexBuffer8*)this; break;
+    }
+    return 0;
+}
+
+void IDirect3DResource8::Register(void* p)
+{
+    data = (BYTE*)p;
+}
+
+HRESULT IDirect3DTexture8::LockRect(UINT level, D3DLOCKED_RECT* locked, const RECT*, DWORD flags)
+{
+    if (!data || level >= levels)
+        return E_FAIL;
+
+    UINT w = LevelDim(width, level), h = LevelDim(height, level);
+
+    locked->Pitch = (INT)LevelPitch(format, w);
+    locked->pBits = data + LevelOffset(this, level);
+
+    s_stats.locks++;
+    if (!(flags & D3DLOCK_READONLY))
+        s_stats.lockBytes += LevelBytes(format, w, h);
+    return S_OK;
+}
+
+HRESULT IDirect3DTexture8::UnlockRect(UINT)
+{
+    return S_OK;
+}
+
+static HRESULT LockRange(IDirect3DResource8* r, UINT offset, UINT size, BYTE** out, DWORD flags)
+{
+    if (!r->data || offset > r->bytes)
+        return E_FAIL;
+
+    if (size == 0 || size > r->bytes - offset)
+        size = r->bytes - offset;
+
+    *out = r->data + offset;
+
+    s_stats.locks++;
+    if (!(flags & D3DLOCK_READONLY))
+        s_stats.lockBytes += size;
+    return S_OK;
+}
+
+HRESULT IDirect3DVertexBuffer8::Lock(UINT offset, UINT size, BYTE** out, DWORD flags)
+{
+    return LockRange(this, offset, size, out, flags);
+}
+
+HRESULT IDirect3DVertexBuffer8::Unlock()
+{
+    return S_OK;
+}
+
+HRESULT IDirect3DIndexBuffer8::Lock(UINT offset, UINT size, BYTE** out, DWORD flags)
+{
+    return LockRange(this, offset, size, out, flags);
+}
+
+HRESULT IDirect3DIndexBuffer8::Unlock()
+{
+    return S_OK;
+}
+
+void XGSetTextureHeader(UINT w, UINT h, UINT levels, DWORD, D3DFORMAT format, D3DPOOL,
+                        IDirect3DTexture8* tex, UINT, UINT)
+{
+    memset(tex, 0, sizeof(*tex));
+    tex->refs = 1;
+    tex->kind = HOST_RES_TEXTURE;
+    tex->width = w;
+    tex->height = h;
+    tex->levels = levels ? levels : 1;
+    tex->format = format;
+}
+
+// NV2A swizzle: x and y bits interleaved, x first, while both sides last
+static DWORD SwizzleOffset(DWORD x, DWORD y, DWORD w, DWORD h)
+{
+    DWORD out = 0, bit = 1;
+    for (DWORD m = 1; m < w || m < h; m <<= 1)
+    {
+        if (m < w) { if (x & m) out |= bit; bit <<= 1; }
+        if (m < h) { if (y & m) out |= bit; bit <<= 1; }
+    }
+    return out;
+}
+
+void XGSwizzleRect(const void* src, int pitch, const RECT*, void* dst, UINT w, UINT h, const POINT*,
+                   UINT bytesPerPixel)
+{
+    const BYTE* s = (const BYTE*)src;
+    BYTE* d = (BYTE*)dst;
+
+    for (UINT y = 0; y < h; ++y)
+    {
+        const BYTE* row = s + (size_t)y * pitch;
+        for (UINT x = 0; x < w; ++x)
+            memcpy(d + (size_t)SwizzleOffset(x, y, w, h) * bytesPerPixel, row + (size_t)x * bytesPerPixel,
+                   bytesPerPixel);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Device
+// -----------------------------------------------------------------------------
+
+static IDirect3D8       s_d3d;
+static IDirect3DDevice8 s_device;
+static DWORD            s_fence = 0;
+
+// DripScene and MazeScene draw through g_pd3dDevice, which the Xbox build
+// gets from outside this tree; here it is the one recording device.
+IDirect3DDevice8* g_pd3dDevice = NULL;
+
+IDirect3D8* Direct3DCreate8(UINT)
+{
+    return &s_d3d;
+}
+
+ULONG IDirect3D8::Release()
+{
+    return 0;
+}
+
+HRESULT IDirect3D8::CreateDevice(UINT, D3DDEVTYPE, HANDLE, DWORD, D3DPRESENT_PARAMETERS*,
+                                 IDirect3DDevice8** out)
+{
+    *out = &s_device;
+    g_pd3dDevice = &s_device;
+    return S_OK;
+}
+
+ULONG IDirect3DDevice8::AddRef()  { return 1; }
+ULONG IDirect3DDevice8::Release() { return 0; }
+
+HRESULT IDirect3DDevice8::CreateTexture(UINT w, UINT h, UINT levels, DWORD, D3DFORMAT format, D3DPOOL,
+                                        IDirect3DTexture8** out)
+{
+    IDirect3DTexture8* t = new IDirect3DTexture8();
+    XGSetTextureHeader(w, h, levels, 0, format, 0, t, 0, 0);
+
+    t->heap = true;
+    t->bytes = LevelOffset(t, t->levels);
+    t->data = (BYTE*)calloc(1, t->bytes);
+    if (!t->data)
+    {
+        delete t;
+        return E_FAIL;
+    }
+
+    *out = t;
+    return S_OK;
+}
+
+template <class T>
+static HRESULT CreateBuffer(UINT bytes, int kind, T** out)
+{
+    T* b = new T();
+    b->refs = 1;
+    b->kind = kind;
+    b->heap = true;
+    b->bytes = bytes;
+    b->data = (BYTE*)calloc(1, bytes ? bytes : 1);
+    if (!b->data)
+    {
+        delete b;
+        return E_FAIL;
+    }
+
+    *out = b;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::CreateVertexBuffer(UINT bytes, DWORD, DWORD, D3DPOOL, IDirect3DVertexBuffer8** out)
+{
+    return CreateBuffer(bytes, HOST_RES_VERTEX_BUFFER, out);
+}
+
+HRESULT IDirect3DDevice8::CreateIndexBuffer(UINT bytes, DWORD, D3DFORMAT, D3DPOOL, IDirect3DIndexBuffer8** out)
+{
+    return CreateBuffer(bytes, HOST_RES_INDEX_BUFFER, out);
+}
+
+HRESULT IDirect3DDevice8::SetRenderState(D3DRENDERSTATETYPE, DWORD)
+{
+    s_stats.renderStates++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::SetTextureStageState(DWORD, D3DTEXTURESTAGESTATETYPE, DWORD)
+{
+    s_stats.stageStates++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::SetTexture(DWORD, IDirect3DBaseTexture8*)
+{
+    s_stats.textures++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::SetVertexShader(DWORD)
+{
+    s_stats.shaders++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::SetTransform(D3DTRANSFORMSTATETYPE, const D3DMATRIX*)
+{
+    s_stats.transforms++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::SetStreamSource(UINT, IDirect3DVertexBuffer8*, UINT) { s_stats.otherCalls++; return S_OK; }
+HRESULT IDirect3DDevice8::SetIndices(IDirect3DIndexBuffer8*, UINT)            { s_stats.otherCalls++; return S_OK; }
+HRESULT IDirect3DDevice8::SetMaterial(const D3DMATERIAL8*)                    { s_stats.otherCalls++; return S_OK; }
+HRESULT IDirect3DDevice8::SetLight(DWORD, const D3DLIGHT8*)                   { s_stats.otherCalls++; return S_OK; }
+HRESULT IDirect3DDevice8::LightEnable(DWORD, BOOL)                            { s_stats.otherCalls++; return S_OK; }
+
+HRESULT IDirect3DDevice8::Clear(DWORD, const void*, DWORD, D3DCOLOR, float, DWORD)
+{
+    s_stats.otherCalls++;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::BeginScene() { return S_OK; }
+HRESULT IDirect3DDevice8::EndScene()   { return S_OK; }
+
+HRESULT IDirect3DDevice8::Present(const RECT*, const RECT*, void*, void*)
+{
+    return S_OK;
+}
+
+// Vertices a non-indexed draw walks (indices, for an indexed one)
+static UINT PrimVertices(D3DPRIMITIVETYPE type, UINT prims)
+{
+    switch (type)
+    {
+    case D3DPT_POINTLIST:       return prims;
+    case D3DPT_LINELIST:        return prims * 2;
+    case D3DPT_LINESTRIP:       return prims ? prims + 1 : 0;
+    case D3DPT_TRIANGLELIST:    return prims * 3;
+    case D3DPT_TRIANGLESTRIP:
+    case D3DPT_TRIANGLEFAN:     return prims ? prims + 2 : 0;
+    case D3DPT_QUADLIST:        return prims * 4;
+    }
+    return 0;
+}
+
+HRESULT IDirect3DDevice8::DrawPrimitive(D3DPRIMITIVETYPE type, UINT, UINT prims)
+{
+    s_stats.draws++;
+    s_stats.primitives += prims;
+    s_stats.vertices += PrimVertices(type, prims);
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::DrawIndexedPrimitive(D3DPRIMITIVETYPE type, UINT, UINT numVertices, UINT, UINT prims)
+{
+    s_stats.draws++;
+    s_stats.primitives += prims;
+    s_stats.vertices += numVertices;
+    s_stats.indices += PrimVertices(type, prims);
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::DrawPrimitiveUP(D3DPRIMITIVETYPE type, UINT prims, const void*, UINT stride)
+{
+    UINT n = PrimVertices(type, prims);
+
+    s_stats.drawsUP++;
+    s_stats.primitives += prims;
+    s_stats.vertices += n;
+    s_stats.upBytes += n * stride;
+    return S_OK;
+}
+
+HRESULT IDirect3DDevice8::DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE type, UINT, UINT numVertices, UINT prims,
+                                                 const void*, D3DFORMAT indexFormat, const void*, UINT stride)
+{
+    UINT n = PrimVertices(type, prims);
+
+    s_stats.drawsUP++;
+    s_stats.primitives += prims;
+    s_stats.vertices += numVertices;
+    s_stats.indices += n;
+    s_stats.upBytes += numVertices * stride + n * (indexFormat == D3DFMT_INDEX32 ? 4 : 2);
+    return S_OK;
+}
+
+// The GPU is never behind
+HRESULT IDirect3DDevice8::BlockUntilIdle()      { return S_OK; }
+DWORD   IDirect3DDevice8::InsertFence()         { return ++s_fence; }
+BOOL    IDirect3DDevice8::IsFencePending(DWORD) { return FALSE; }
+void    IDirect3DDevice8::BlockOnFence(DWORD)   {}
+
+// -----------------------------------------------------------------------------
+// D3DX math (row vectors, left-handed, as D3DX)
+// -----------------------------------------------------------------------------
+
+static D3DXMATRIX* SetRows(D3DXMATRIX* out, float a11, float a12, float a13, float a14, float a21, float a22,
+                           float a23, float a24, float a31, float a32, float a33, float a34, float a41,
+                           float a42, float a43, float a44)
+{
+    out->_11 = a11; out->_12 = a12; out->_13 = a13; out->_14 = a14;
+    out->_21 = a21; out->_22 = a22; out->_23 = a23; out->_24 = a24;
+    out->_31 = a31; out->_32 = a32; out->_33 = a33; out->_34 = a34;
+    out->_41 = a41; out->_42 = a42; out->_43 = a43; out->_44 = a44;
+    return out;
+}
+
+D3DXMATRIX* D3DXMatrixIdentity(D3DXMATRIX* out)
+{
+    return SetRows(out, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+}
+
+D3DXMATRIX* D3DXMatrixMultiply(D3DXMATRIX* out, const D3DXMATRIX* a, const D3DXMATRIX* b)
+{
+    D3DMATRIX r;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            r.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                        a->m[i][2] * b->m[2][j] + a->m[i][3] * b->m[3][j];
+        }
+    }
+    memcpy(out->m, r.m, sizeof(r.m));
+    return out;
+}
+
+static D3DXVECTOR3 Normalize(const D3DXVECTOR3& v)
+{
+    float len = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+    return len > 0.0f ? v * (1.0f / len) : v;
+}
+
+static D3DXVECTOR3 Cross(const D3DXVECTOR3& a, const D3DXVECTOR3& b)
+{
+    return D3DXVECTOR3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+static float Dot(const D3DXVECTOR3& a, const D3DXVECTOR3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+D3DXMATRIX* D3DXMatrixLookAtLH(D3DXMATRIX* out, const D3DXVECTOR3* eye, const D3DXVECTOR3* at,
+                               const D3DXVECTOR3* up)
+{
+    D3DXVECTOR3 z = Normalize(*at - *eye);
+    D3DXVECTOR3 x = Normalize(Cross(*up, z));
+    D3DXVECTOR3 y = Cross(z, x);
+
+    return SetRows(out,
+                   x.x, y.x, z.x, 0.0f,
+                   x.y, y.y, z.y, 0.0f,
+                   x.z, y.z, z.z, 0.0f,
+                   -Dot(x, *eye), -Dot(y, *eye), -Dot(z, *eye), 1.0f);
+}
+
+D3DXMATRIX* D3DXMatrixPerspectiveFovLH(D3DXMATRIX* out, float fovY, float aspect, float zn, float zf)
+{
+    float ys = 1.0f / tanf(fovY * 0.5f);
+    float xs = ys / aspect;
+    float q = zf / (zf - zn);
+
+    return SetRows(out,
+                   xs, 0.0f, 0.0f, 0.0f,
+                   0.0f, ys, 0.0f, 0.0f,
+                   0.0f, 0.0f, q, 1.0f,
+                   0.0f, 0.0f, -zn * q, 0.0f);
+}
+
+D3DXMATRIX* D3DXMatrixOrthoOffCenterLH(D3DXMATRIX* out, float l, float r, float b, float t, float zn, float zf)
+{
+    return SetRows(out,
+                   2.0f / (r - l), 0.0f, 0.0f, 0.0f,
+                   0.0f, 2.0f / (t - b), 0.0f, 0.0f,
+                   0.0f, 0.0f, 1.0f / (zf - zn), 0.0f,
+                   (l + r) / (l - r), (t + b) / (b - t), zn / (zn - zf), 1.0f);
+}
+
+D3DXMATRIX* D3DXMatrixRotationX(D3DXMATRIX* out, float a)
+{
+    float c = cosf(a), s = sinf(a);
+    return SetRows(out, 1, 0, 0, 0, 0, c, s, 0, 0, -s, c, 0, 0, 0, 0, 1);
+}
+
+D3DXMATRIX* D3DXMatrixRotationY(D3DXMATRIX* out, float a)
+{
+    float c = cosf(a), s = sinf(a);
+    return SetRows(out, c, 0, -s, 0, 0, 1, 0, 0, s, 0, c, 0, 0, 0, 0, 1);
+}
+
+D3DXMATRIX* D3DXMatrixRotationZ(D3DXMATRIX* out, float a)
+{
+    float c = cosf(a), s = sinf(a);
+    return SetRows(out, c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+}
+
+// Roll about Z, then pitch about X, then yaw about Y
+D3DXMATRIX* D3DXMatrixRotationYawPitchRoll(D3DXMATRIX* out, float yaw, float pitch, float roll)
+{
+    D3DXMATRIX z, x, y;
+    D3DXMatrixRotationZ(&z, roll);
+    D3DXMatrixRotationX(&x, pitch);
+    D3DXMatrixRotationY(&y, yaw);
+
+    D3DXMatrixMultiply(out, &z, &x);
+    return D3DXMatrixMultiply(out, out, &y);
+}
+
+D3DXMATRIX* D3DXMatrixScaling(D3DXMATRIX* out, float sx, float sy, float sz)
+{
+    return SetRows(out, sx, 0, 0, 0, 0, sy, 0, 0, 0, 0, sz, 0, 0, 0, 0, 1);
+}
+
+D3DXMATRIX* D3DXMatrixTranslation(D3DXMATRIX* out, float x, float y, float z)
+{
+    return SetRows(out, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, z, 1);
+}
+
+D3DXVECTOR3* D3DXVec3TransformCoord(D3DXVECTOR3* out, const D3DXVECTOR3* v, const D3DXMATRIX* m)
+{
+    float x = v->x * m->_11 + v->y * m->_21 + v->z * m->_31 + m->_41;
+    float y = v->x * m->_12 + v->y * m->_22 + v->z * m->_32 + m->_42;
+    float z = v->x * m->_13 + v->y * m->_23 + v->z * m->_33 + m->_43;
+    float w = v->x * m->_14 + v->y * m->_24 + v->z * m->_34 + m->_44;
+
+    float k = w != 0.0f ? 1.0f / w : 0.0f;
+    *out = D3DXVECTOR3(x * k, y * k, z * k);
+    return out;
+}
+
+D3DXVECTOR3* D3DXVec3TransformNormal(D3DXVECTOR3* out, const D3DXVECTOR3* v, const D3DXMATRIX* m)
+{
+    float x = v->x * m->_11 + v->y * m->_21 + v->z * m->_31;
+    float y = v->x * m->_12 + v->y * m->_22 + v->z * m->_32;
+    float z = v->x * m->_13 + v->y * m->_23 + v->z * m->_33;
+
+    *out = D3DXVECTOR3(x, y, z);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// DirectSound: no device
+// -----------------------------------------------------------------------------
+
+HRESULT DirectSoundCreate(void*, LPDIRECTSOUND8* out, void*)
+{
+    *out = NULL;
+    return E_FAIL;
+}
+
+void DirectSoundDoWork() {}
+
+ULONG   IDirectSound::Release() { return 0; }
+HRESULT IDirectSound::CreateSoundBuffer(const DSBUFFERDESC*, LPDIRECTSOUNDBUFFER*, void*) { return E_FAIL; }
+
+ULONG   IDirectSoundBuffer::Release() { return 0; }
+HRESULT IDirectSoundBuffer::Lock(DWORD, DWORD, void**, DWORD*, void**, DWORD*, DWORD) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::Unlock(void*, DWORD, void*, DWORD) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::SetVolume(LONG) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::Play(DWORD, DWORD, DWORD) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::Stop() { return E_FAIL; }
+HRESULT IDirectSoundBuffer::SetCurrentPosition(DWORD) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::GetCurrentPosition(DWORD*, DWORD*) { return E_FAIL; }
+HRESULT IDirectSoundBuffer::SetNotificationPositions(DWORD, LPCDSBPOSITIONNOTIFY) { return E_FAIL; }
@@ -0,0 +1,39 @@
+#pragma once
+#include "xtl.h"
+
+#include <stdio.h>
+
+// What the recording device has been handed since the last reset. perfhost
+// resets it per frame; the scene code never sees it.
+//
+// vertices counts what the GPU would fetch per draw: the vertex range of an
+// indexed draw, the vertices a non-indexed one walks. bytes is what the CPU
+// wrote for the GPU: UP vertex and index data plus every Lock/LockRect range.
+
+struct HostDeviceStats
+{
+    DWORD draws;            // DrawPrimitive / DrawIndexedPrimitive
+    DWORD drawsUP;          // DrawPrimitiveUP / DrawIndexedPrimitiveUP
+    DWORD primitives;
+    DWORD vertices;
+    DWORD indices;
+    DWORD upBytes;          // vertex + index bytes passed to the UP draws
+    DWORD lockBytes;        // vertex, index and texture bytes locked
+    DWORD locks;
+    DWORD renderStates;     // SetRenderState
+    DWORD stageStates;      // SetTextureStageState
+    DWORD textures;         // SetTexture
+    DWORD shaders;          // SetVertexShader
+    DWORD transforms;       // SetTransform
+    DWORD otherCalls;       // streams, indices, material, lights, Clear ...
+};
+
+void HostDevice_ResetStats();
+void HostDevice_GetStats(HostDeviceStats* out);
+
+// Directory D:\ maps to (with a trailing '/'); "src/TR Demo/Media/" by default
+void Host_SetMediaRoot(const char* dir);
+
+// Debug output (OutputDebugStringA) goes to this stream, stderr by default;
+// NULL drops it
+void Host_SetDebugOutput(FILE* f);
@@ -0,0 +1,196 @@
+// perfhost - runs the demo's scene sequence headless and writes per-frame CPU
+// time and submission stats as CSV
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   find "src/TR Demo" -maxdepth 1 -name '*.cpp' ! -name main.cpp -print0 |
+//     xargs -0 g++ -O2 -Wno-multichar -Itools/perfhost -o perfhost tools/perfhost/perfhost.cpp tools/perfhost/hostshim.cpp
+//   ./perfhost [frames] [--media DIR] > perf.csv
+//
+// Every scene module builds unchanged against tools/perfhost/xtl.h, whose
+// IDirect3DDevice8 draws nothing and counts what it is given (hostshim.h).
+// This file compiles main.cpp itself, so the scene table, durations, fades
+// and swaps are the demo's own; the loop below is main()'s frame loop on the
+// synthetic clock (one 60 Hz step per frame) without input, music or vsync.
+// Scene time is then a pure function of the frame number and two runs differ
+// only in the measured times.
+//
+// frames: how many to run; default (0) is one pass through all the scenes,
+// fades included, back to the intro. --media: where D:\ points, default
+// "src/TR Demo/Media". There is no sound device on the host, so Music_Init
+// fails and the music-driven effects run as they do without a track.
+//
+// stdout, one row per frame:
+//   frame, scene, steps, update_us, state_us, render_us,
+//   draws, draws_up, primitives, vertices, indices, up_bytes, lock_bytes,
+//   locks, render_states, stage_states, textures, shaders, transforms,
+//   other_calls
+// update_us is the scene's fixed steps, state_us the demo state update
+// (fades, and scene shutdown/init on a swap), render_us Clear .. EndScene.
+// stderr: the demo's own debug output, then a per-scene summary.
+
+#define main DemoMain
+#include "../../src/TR Demo/main.cpp"
+#undef main
+
+#include "hostshim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+struct SceneSummary
+{
+    DWORD  frames;
+    double cpuUs;           // update + state + render
+    double worstUs;
+    double draws;
+    double vertices;
+    double bytes;
+};
+
+static SceneSummary s_summary[SCENE_COUNT];
+
+static void Summarize(DemoSceneId id, double cpuUs, const HostDeviceStats& ds)
+{
+    SceneSummary& s = s_summary[id];
+    s.frames++;
+    s.cpuUs += cpuUs;
+    if (cpuUs > s.worstUs)
+        s.worstUs = cpuUs;
+    s.draws += ds.draws + ds.drawsUP;
+    s.vertices += ds.vertices;
+    s.bytes += ds.upBytes + ds.lockBytes;
+}
+
+static void PrintSummary()
+{
+    fprintf(stderr, "\n%-8s %7s %9s %9s %8s %10s %10s\n", "scene", "frames", "cpu us", "worst us", "draws",
+            "vertices", "bytes");
+    for (int i = 0; i < SCENE_COUNT; ++i)
+    {
+        const SceneSummary& s = s_summary[i];
+        if (!s.frames)
+            continue;
+
+        fprintf(stderr, "%-8s %7u %9.1f %9.1f %8.1f %10.0f %10.0f\n", g_scenes[i].name, (unsigned)s.frames,
+                s.cpuUs / s.frames, s.worstUs, s.draws / s.frames, s.vertices / s.frames, s.bytes / s.frames);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    long frames = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--media") == 0 && i + 1 < argc)
+            Host_SetMediaRoot(argv[++i]);
+        else if (argv[i][0] != '-')
+            frames = atol(argv[i]);
+        else
+        {
+            fprintf(stderr, "usage: perfhost [frames] [--media DIR]\n");
+            return 1;
+        }
+    }
+
+    if (InitD3D() < 0)
+    {
+        fprintf(stderr, "perfhost: device creation failed\n");
+        return 1;
+    }
+
+    // main()'s startup, minus the display settle frames: the startup load
+    // runs to the end inside CreateThread
+    Clock_Init();
+    StartStartupLoad();
+    PrepareDone();
+
+    InitInput();
+
+    Clock_ResetSceneTime();
+    Clock_SetSynthetic(true);
+
+    DWORD startTicks = Clock_Ms();
+
+    g_demo.current = SCENE_INTRO;
+    g_demo.next = SCENE_PLASMA;
+    g_demo.inTransition = false;
+    g_demo.transitionPhase = 0;
+    g_demo.sceneStartTicks = startTicks;
+    g_demo.transitionStartTicks = startTicks;
+    g_demo.overlayAlpha = 0;
+
+    g_scenes[g_demo.current].init();
+
+    printf("frame,scene,steps,update_us,state_us,render_us,"
+           "draws,draws_up,primitives,vertices,indices,up_bytes,lock_bytes,"
+           "locks,render_states,stage_states,textures,shaders,transforms,other_calls\n");
+
+    bool leftIntro = false;
+
+    for (long frame = 0; frames <= 0 || frame < frames; ++frame)
+    {
+        Clock_Tick();
+
+        DWORD now = Clock_Ms();
+        float demoTime = Clock_Seconds();
+
+        int steps = Clock_TakeSteps();
+
+        HostDevice_ResetStats();
+
+        double t0 = NowUs();
+
+        if (!g_demo.inTransition)
+        {
+            SceneFn update = g_scenes[g_demo.current].update;
+            for (int i = 0; update && i < steps; ++i)
+                update();
+        }
+
+        double t1 = NowUs();
+
+        UpdateDemoState(now, false);
+        DemoSceneId drawn = g_demo.current;
+
+        double t2 = NowUs();
+        RenderFrame(demoTime);
+        double t3 = NowUs();
+
+        g_pDevice->Present(NULL, NULL, NULL, NULL);
+
+        HostDeviceStats ds;
+        HostDevice_GetStats(&ds);
+
+        printf("%ld,%s,%d,%.1f,%.1f,%.1f,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", frame,
+               g_scenes[drawn].name, steps, t1 - t0, t2 - t1, t3 - t2, (unsigned)ds.draws,
+               (unsigned)ds.drawsUP, (unsigned)ds.primitives, (unsigned)ds.vertices, (unsigned)ds.indices,
+               (unsigned)ds.upBytes, (unsigned)ds.lockBytes, (unsigned)ds.locks, (unsigned)ds.renderStates,
+               (unsigned)ds.stageStates, (unsigned)ds.textures, (unsigned)ds.shaders,
+               (unsigned)ds.transforms, (unsigned)ds.otherCalls);
+
+        Summarize(drawn, t3 - t0, ds);
+
+        // One pass: stop once the sequence wraps around to the intro
+        if (drawn != SCENE_INTRO)
+            leftIntro = true;
+        else if (leftIntro && frames <= 0)
+            break;
+    }
+
+    fflush(stdout);
+    PrintSummary();
+
+    g_scenes[g_demo.current].shutdown();
+    ShutdownD3D();
+    return 0;
+}
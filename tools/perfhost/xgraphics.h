@@ -0,0 +1,3 @@
+#pragma once
+// xgraphics.h - Host stand-in, see xtl.h
+#include "xtl.h"
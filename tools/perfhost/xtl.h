@@ -0,0 +1,672 @@
+#pragma once
+// xtl.h - Host stand-in for the parts of xtl.h / d3d8.h / d3dx8.h /
+// xgraphics.h / dsound.h the demo uses, so src/TR Demo builds on Linux.
+//
+// Only what the tree calls is declared. Types keep their XDK names and
+// fields; the D3D objects are plain classes with non-virtual methods (as
+// on Xbox), implemented in hostshim.cpp:
+//   - IDirect3DDevice8 records calls, vertices and bytes (hostshim.h) and
+//     draws nothing. Fences are never pending.
+//   - Textures, vertex and index buffers own real memory, so Lock/LockRect
+//     and XGSwizzleRect writes cost what they cost.
+//   - D3DX matrix helpers do the real math (scenes project on the CPU).
+//   - Files open under the media root (D:\ is the Media folder), threads
+//     run to completion inside CreateThread, DirectSound and XInput report
+//     no hardware.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// Compiler / Win32 basics
+// -----------------------------------------------------------------------------
+
+#define __forceinline inline __attribute__((always_inline))
+#define __cdecl
+#define WINAPI
+#define CALLBACK
+
+#define TRUE  1
+#define FALSE 0
+
+typedef uint32_t        DWORD;
+typedef uint16_t        WORD;
+typedef uint8_t         BYTE;
+typedef int             BOOL;
+typedef int32_t         LONG;
+typedef uint32_t        ULONG;
+typedef unsigned int    UINT;
+typedef int             INT;
+typedef short           SHORT;
+typedef char            CHAR;
+typedef float           FLOAT;
+typedef int32_t         HRESULT;
+typedef int64_t         LONGLONG;
+typedef uint64_t        ULONGLONG;
+typedef uintptr_t       ULONG_PTR;
+typedef size_t          SIZE_T;
+typedef void*           HANDLE;
+typedef void*           LPVOID;
+typedef const void*     LPCVOID;
+typedef const char*     LPCSTR;
+typedef char*           LPSTR;
+typedef DWORD*          LPDWORD;
+typedef BYTE*           LPBYTE;
+
+union LARGE_INTEGER
+{
+    struct { DWORD LowPart; LONG HighPart; };
+    LONGLONG QuadPart;
+};
+
+#define S_OK                    ((HRESULT)0)
+#define E_FAIL                  ((HRESULT)0x80004005L)
+#define FAILED(hr)              ((HRESULT)(hr) < 0)
+#define SUCCEEDED(hr)           ((HRESULT)(hr) >= 0)
+
+#define ERROR_SUCCESS               0
+#define ERROR_IO_INCOMPLETE         996
+#define ERROR_IO_PENDING            997
+#define ERROR_DEVICE_NOT_CONNECTED  1167
+
+#define INVALID_HANDLE_VALUE    ((HANDLE)(intptr_t)-1)
+#define INVALID_FILE_SIZE       0xFFFFFFFFu
+#define INVALID_SET_FILE_POINTER 0xFFFFFFFFu
+#define INFINITE                0xFFFFFFFFu
+#define WAIT_OBJECT_0           0
+#define WAIT_TIMEOUT            258
+
+#define GENERIC_READ            0x80000000u
+#define GENERIC_WRITE           0x40000000u
+#define FILE_SHARE_READ         0x00000001u
+#define CREATE_ALWAYS           2
+#define OPEN_EXISTING           3
+#define FILE_ATTRIBUTE_NORMAL   0x00000080u
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000u
+#define FILE_FLAG_NO_BUFFERING  0x20000000u
+#define FILE_FLAG_OVERLAPPED    0x40000000u
+#define FILE_BEGIN              0
+#define FILE_CURRENT            1
+#define FILE_END                2
+
+#define MAXULONG_PTR            (~(ULONG_PTR)0)
+#define PAGE_READWRITE          0x04
+#define PAGE_WRITECOMBINE       0x400
+
+#define THREAD_PRIORITY_BELOW_NORMAL  (-1)
+#define THREAD_PRIORITY_NORMAL        0
+#define THREAD_PRIORITY_ABOVE_NORMAL  1
+#define THREAD_PRIORITY_HIGHEST       2
+#define THREAD_PRIORITY_TIME_CRITICAL 15
+
+#define ZeroMemory(p, n)        memset((p), 0, (n))
+#define CopyMemory(d, s, n)     memcpy((d), (s), (n))
+
+#define MAKEFOURCC(a, b, c, d) \
+    ((DWORD)(BYTE)(a) | ((DWORD)(BYTE)(b) << 8) | ((DWORD)(BYTE)(c) << 16) | ((DWORD)(BYTE)(d) << 24))
+
+struct OVERLAPPED
+{
+    ULONG_PTR Internal;
+    ULONG_PTR InternalHigh;
+    DWORD     Offset;
+    DWORD     OffsetHigh;
+    HANDLE    hEvent;
+};
+typedef OVERLAPPED* LPOVERLAPPED;
+
+struct SECURITY_ATTRIBUTES;
+typedef SECURITY_ATTRIBUTES* LPSECURITY_ATTRIBUTES;
+
+struct CRITICAL_SECTION { int unused; };
+
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+
+struct RECT  { LONG left, top, right, bottom; };
+struct POINT { LONG x, y; };
+
+// Files
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD share, LPSECURITY_ATTRIBUTES sa,
+                   DWORD creation, DWORD flags, HANDLE templ);
+BOOL   ReadFile(HANDLE h, LPVOID buf, DWORD bytes, LPDWORD read, LPOVERLAPPED ov);
+BOOL   GetOverlappedResult(HANDLE h, LPOVERLAPPED ov, LPDWORD bytes, BOOL wait);
+DWORD  SetFilePointer(HANDLE h, LONG lo, LONG* hi, DWORD method);
+BOOL   CloseHandle(HANDLE h);
+DWORD  GetLastError();
+
+// Threads and sync
+HANDLE CreateThread(LPSECURITY_ATTRIBUTES sa, SIZE_T stack, LPTHREAD_START_ROUTINE proc, LPVOID param,
+                    DWORD flags, LPDWORD id);
+BOOL   SetThreadPriority(HANDLE h, int priority);
+HANDLE CreateEvent(LPSECURITY_ATTRIBUTES sa, BOOL manualReset, BOOL initialState, LPCSTR name);
+BOOL   SetEvent(HANDLE h);
+BOOL   ResetEvent(HANDLE h);
+DWORD  WaitForSingleObject(HANDLE h, DWORD ms);
+DWORD  WaitForMultipleObjects(DWORD count, const HANDLE* h, BOOL all, DWORD ms);
+void   InitializeCriticalSection(CRITICAL_SECTION* cs);
+void   EnterCriticalSection(CRITICAL_SECTION* cs);
+void   LeaveCriticalSection(CRITICAL_SECTION* cs);
+LONG   InterlockedExchange(volatile LONG* target, LONG value);
+LONG   InterlockedIncrement(volatile LONG* target);
+void   Sleep(DWORD ms);
+
+// Time
+DWORD  GetTickCount();
+BOOL   QueryPerformanceCounter(LARGE_INTEGER* count);
+BOOL   QueryPerformanceFrequency(LARGE_INTEGER* freq);
+
+// Memory, debug output, title
+LPVOID XPhysicalAlloc(SIZE_T bytes, ULONG_PTR maxAddress, ULONG_PTR alignment, DWORD protect);
+void   XPhysicalFree(LPVOID p);
+void   OutputDebugStringA(LPCSTR s);
+DWORD  XLaunchNewImage(LPCSTR path, void* data);
+
+// -----------------------------------------------------------------------------
+// XInput
+// -----------------------------------------------------------------------------
+
+#define XDEVICE_TYPE_GAMEPAD        ((void*)1)
+#define XDEVICE_NO_SLOT             0
+
+#define XINPUT_GAMEPAD_DPAD_UP      0x0001
+#define XINPUT_GAMEPAD_DPAD_DOWN    0x0002
+#define XINPUT_GAMEPAD_DPAD_LEFT    0x0004
+#define XINPUT_GAMEPAD_DPAD_RIGHT   0x0008
+#define XINPUT_GAMEPAD_START        0x0010
+#define XINPUT_GAMEPAD_BACK         0x0020
+#define XINPUT_GAMEPAD_LEFT_THUMB   0x0040
+#define XINPUT_GAMEPAD_RIGHT_THUMB  0x0080
+
+// bAnalogButtons indices
+#define XINPUT_GAMEPAD_A            0
+#define XINPUT_GAMEPAD_B            1
+#define XINPUT_GAMEPAD_X            2
+#define XINPUT_GAMEPAD_Y            3
+
+struct XINPUT_GAMEPAD
+{
+    WORD  wButtons;
+    BYTE  bAnalogButtons[8];
+    SHORT sThumbLX, sThumbLY;
+    SHORT sThumbRX, sThumbRY;
+};
+
+struct XINPUT_STATE
+{
+    DWORD          dwPacketNumber;
+    XINPUT_GAMEPAD Gamepad;
+};
+
+void   XInitDevices(DWORD count, void* types);
+BOOL   XGetDeviceChanges(void* type, DWORD* inserted, DWORD* removed);
+HANDLE XInputOpen(void* type, DWORD port, DWORD slot, void* params);
+void   XInputClose(HANDLE h);
+DWORD  XInputGetState(HANDLE h, XINPUT_STATE* state);
+
+// -----------------------------------------------------------------------------
+// D3D8 types
+// -----------------------------------------------------------------------------
+
+typedef DWORD D3DCOLOR;
+
+#define D3DCOLOR_ARGB(a, r, g, b) \
+    ((D3DCOLOR)((((a) & 0xff) << 24) | (((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff)))
+#define D3DCOLOR_XRGB(r, g, b)    D3DCOLOR_ARGB(0xff, r, g, b)
+#define D3DCOLOR_RGBA(r, g, b, a) D3DCOLOR_ARGB(a, r, g, b)
+
+#define D3D_SDK_VERSION                     220
+
+#define D3DFVF_XYZ                          0x002
+#define D3DFVF_XYZRHW                       0x004
+#define D3DFVF_NORMAL                       0x010
+#define D3DFVF_PSIZE                        0x020
+#define D3DFVF_DIFFUSE                      0x040
+#define D3DFVF_SPECULAR                     0x080
+#define D3DFVF_TEX1                         0x100
+
+#define D3DCLEAR_TARGET                     0x00000001
+#define D3DCLEAR_ZBUFFER                    0x00000002
+
+#define D3DCREATE_HARDWARE_VERTEXPROCESSING 0x00000040
+#define D3DPRESENT_INTERVAL_ONE             0x00000001
+#define D3DPRESENT_INTERVAL_TWO             0x00000002
+#define D3DPRESENT_INTERVAL_IMMEDIATE       0x80000000
+
+#define D3DUSAGE_WRITEONLY                  0x00000008
+#define D3DUSAGE_POINTS                     0x00000040
+#define D3DUSAGE_DYNAMIC                    0x00000200
+
+#define D3DLOCK_READONLY                    0x00000010
+#define D3DLOCK_NOSYSLOCK                   0x00000800
+#define D3DLOCK_NOOVERWRITE                 0x00001000
+#define D3DLOCK_DISCARD                     0x00002000
+
+enum D3DFORMAT
+{
+    D3DFMT_UNKNOWN = 0,
+    D3DFMT_A8R8G8B8,
+    D3DFMT_X8R8G8B8,
+    D3DFMT_R5G6B5,
+    D3DFMT_A4R4G4B4,
+    D3DFMT_P8,
+    D3DFMT_L8,
+    D3DFMT_DXT1,
+    D3DFMT_DXT2,
+    D3DFMT_DXT3,
+    D3DFMT_DXT4,
+    D3DFMT_DXT5,
+    D3DFMT_LIN_A8R8G8B8,
+    D3DFMT_LIN_X8R8G8B8,
+    D3DFMT_LIN_L8,
+    D3DFMT_D16,
+    D3DFMT_INDEX16,
+    D3DFMT_INDEX32
+};
+
+// A DWORD on Xbox, so the scenes pass 0
+typedef DWORD D3DPOOL;
+#define D3DPOOL_DEFAULT     0
+#define D3DPOOL_MANAGED     1
+#define D3DPOOL_SYSTEMMEM   2
+
+enum D3DDEVTYPE     { D3DDEVTYPE_HAL = 1 };
+enum D3DSWAPEFFECT  { D3DSWAPEFFECT_DISCARD = 1 };
+
+enum D3DPRIMITIVETYPE
+{
+    D3DPT_POINTLIST = 1,
+    D3DPT_LINELIST,
+    D3DPT_LINESTRIP,
+    D3DPT_TRIANGLELIST,
+    D3DPT_TRIANGLESTRIP,
+    D3DPT_TRIANGLEFAN,
+    D3DPT_QUADLIST
+};
+
+enum D3DTRANSFORMSTATETYPE
+{
+    D3DTS_VIEW = 2,
+    D3DTS_PROJECTION = 3,
+    D3DTS_TEXTURE0 = 16,
+    D3DTS_WORLD = 256
+};
+
+enum D3DRENDERSTATETYPE
+{
+    D3DRS_ZENABLE = 7,
+    D3DRS_FILLMODE,
+    D3DRS_SHADEMODE,
+    D3DRS_ZWRITEENABLE,
+    D3DRS_ALPHATESTENABLE,
+    D3DRS_SRCBLEND,
+    D3DRS_DESTBLEND,
+    D3DRS_CULLMODE,
+    D3DRS_ZFUNC,
+    D3DRS_ALPHAREF,
+    D3DRS_ALPHAFUNC,
+    D3DRS_DITHERENABLE,
+    D3DRS_ALPHABLENDENABLE,
+    D3DRS_FOGENABLE,
+    D3DRS_SPECULARENABLE,
+    D3DRS_FOGCOLOR,
+    D3DRS_FOGTABLEMODE,
+    D3DRS_FOGSTART,
+    D3DRS_FOGEND,
+    D3DRS_FOGDENSITY,
+    D3DRS_RANGEFOGENABLE,
+    D3DRS_TEXTUREFACTOR,
+    D3DRS_LIGHTING,
+    D3DRS_AMBIENT,
+    D3DRS_FOGVERTEXMODE,
+    D3DRS_COLORVERTEX,
+    D3DRS_DIFFUSEMATERIALSOURCE,
+    D3DRS_POINTSIZE,
+    D3DRS_POINTSIZE_MIN,
+    D3DRS_POINTSPRITEENABLE,
+    D3DRS_POINTSCALEENABLE,
+    D3DRS_POINTSCALE_A,
+    D3DRS_POINTSCALE_B,
+    D3DRS_POINTSCALE_C,
+    D3DRS_POINTSIZE_MAX,
+    D3DRS_BLENDOP,
+    D3DRS_MAX
+};
+
+enum D3DTEXTURESTAGESTATETYPE
+{
+    D3DTSS_COLOROP = 1,
+    D3DTSS_COLORARG1,
+    D3DTSS_COLORARG2,
+    D3DTSS_ALPHAOP,
+    D3DTSS_ALPHAARG1,
+    D3DTSS_ALPHAARG2,
+    D3DTSS_TEXCOORDINDEX,
+    D3DTSS_ADDRESSU,
+    D3DTSS_ADDRESSV,
+    D3DTSS_MAGFILTER,
+    D3DTSS_MINFILTER,
+    D3DTSS_MIPFILTER,
+    D3DTSS_MIPMAPLODBIAS,
+    D3DTSS_MAXMIPLEVEL,
+    D3DTSS_TEXTURETRANSFORMFLAGS,
+    D3DTSS_MAX
+};
+
+enum { D3DTA_DIFFUSE = 0, D3DTA_CURRENT, D3DTA_TEXTURE, D3DTA_TFACTOR };
+enum { D3DBLEND_ZERO = 1, D3DBLEND_ONE, D3DBLEND_SRCCOLOR, D3DBLEND_INVSRCCOLOR, D3DBLEND_SRCALPHA,
+       D3DBLEND_INVSRCALPHA };
+enum { D3DCULL_NONE = 1, D3DCULL_CW, D3DCULL_CCW };
+enum { D3DCMP_LESSEQUAL = 4, D3DCMP_GREATER = 5, D3DCMP_ALWAYS = 8 };
+enum { D3DFILL_POINT = 1, D3DFILL_WIREFRAME, D3DFILL_SOLID };
+enum { D3DSHADE_FLAT = 1, D3DSHADE_GOURAUD };
+enum { D3DFOG_NONE = 0, D3DFOG_EXP, D3DFOG_EXP2, D3DFOG_LINEAR };
+enum { D3DMCS_MATERIAL = 0, D3DMCS_COLOR1 };
+enum { D3DZB_FALSE = 0, D3DZB_TRUE };
+enum { D3DTADDRESS_WRAP = 1, D3DTADDRESS_MIRROR, D3DTADDRESS_CLAMP };
+enum { D3DTEXF_NONE = 0, D3DTEXF_POINT, D3DTEXF_LINEAR };
+enum { D3DTOP_DISABLE = 1, D3DTOP_SELECTARG1, D3DTOP_SELECTARG2, D3DTOP_MODULATE, D3DTOP_ADD = 7 };
+enum { D3DTTFF_DISABLE = 0, D3DTTFF_COUNT2 = 2 };
+
+#define D3DFILLMODE_SOLID       D3DFILL_SOLID
+#define D3DFILLMODE_WIREFRAME   D3DFILL_WIREFRAME
+
+enum D3DLIGHTTYPE { D3DLIGHT_POINT = 1, D3DLIGHT_SPOT, D3DLIGHT_DIRECTIONAL };
+
+struct D3DCOLORVALUE { float r, g, b, a; };
+struct D3DVECTOR     { float x, y, z; };
+
+struct D3DMATERIAL8
+{
+    D3DCOLORVALUE Diffuse, Ambient, Specular, Emissive;
+    float         Power;
+};
+
+struct D3DLIGHT8
+{
+    D3DLIGHTTYPE  Type;
+    D3DCOLORVALUE Diffuse, Specular, Ambient;
+    D3DVECTOR     Position, Direction;
+    float         Range, Falloff;
+    float         Attenuation0, Attenuation1, Attenuation2;
+    float         Theta, Phi;
+};
+
+struct D3DMATRIX
+{
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+            float _41, _42, _43, _44;
+        };
+        float m[4][4];
+    };
+};
+
+struct D3DLOCKED_RECT
+{
+    INT   Pitch;
+    void* pBits;
+};
+
+struct D3DPRESENT_PARAMETERS
+{
+    UINT          BackBufferWidth, BackBufferHeight;
+    D3DFORMAT     BackBufferFormat;
+    UINT          BackBufferCount;
+    int           MultiSampleType;
+    D3DSWAPEFFECT SwapEffect;
+    HANDLE        hDeviceWindow;
+    BOOL          Windowed;
+    BOOL          EnableAutoDepthStencil;
+    D3DFORMAT     AutoDepthStencilFormat;
+    DWORD         Flags;
+    UINT          FullScreen_RefreshRateInHz;
+    UINT          FullScreen_PresentationInterval;
+};
+
+// -----------------------------------------------------------------------------
+// D3D8 objects (hostshim.cpp)
+// -----------------------------------------------------------------------------
+
+enum HostResourceKind
+{
+    HOST_RES_TEXTURE = 1,
+    HOST_RES_VERTEX_BUFFER,
+    HOST_RES_INDEX_BUFFER
+};
+
+// Zero-initialised is a valid, unregistered texture header (texcache keeps
+// an array of them for the pack).
+struct IDirect3DResource8
+{
+    ULONG AddRef();
+    ULONG Release();
+    void  Register(void* data);
+
+    ULONG refs;
+    int   kind;             // HostResourceKind
+    bool  heap;             // created by the device: Release frees it
+    BYTE* data;
+    DWORD bytes;
+};
+
+struct IDirect3DBaseTexture8 : IDirect3DResource8
+{
+    UINT      width, height, levels;
+    D3DFORMAT format;
+};
+
+struct IDirect3DTexture8 : IDirect3DBaseTexture8
+{
+    HRESULT LockRect(UINT level, D3DLOCKED_RECT* locked, const RECT* rect, DWORD flags);
+    HRESULT UnlockRect(UINT level);
+};
+
+struct IDirect3DVertexBuffer8 : IDirect3DResource8
+{
+    HRESULT Lock(UINT offset, UINT size, BYTE** data, DWORD flags);
+    HRESULT Unlock();
+};
+
+struct IDirect3DIndexBuffer8 : IDirect3DResource8
+{
+    HRESULT Lock(UINT offset, UINT size, BYTE** data, DWORD flags);
+    HRESULT Unlock();
+};
+
+typedef IDirect3DBaseTexture8*  LPDIRECT3DBASETEXTURE8;
+typedef IDirect3DTexture8*      LPDIRECT3DTEXTURE8;
+typedef IDirect3DVertexBuffer8* LPDIRECT3DVERTEXBUFFER8;
+typedef IDirect3DIndexBuffer8*  LPDIRECT3DINDEXBUFFER8;
+
+struct IDirect3DDevice8
+{
+    ULONG   AddRef();
+    ULONG   Release();
+
+    HRESULT CreateTexture(UINT w, UINT h, UINT levels, DWORD usage, D3DFORMAT format, D3DPOOL pool,
+                          IDirect3DTexture8** out);
+    HRESULT CreateVertexBuffer(UINT bytes, DWORD usage, DWORD fvf, D3DPOOL pool, IDirect3DVertexBuffer8** out);
+    HRESULT CreateIndexBuffer(UINT bytes, DWORD usage, D3DFORMAT format, D3DPOOL pool,
+                              IDirect3DIndexBuffer8** out);
+
+    HRESULT SetRenderState(D3DRENDERSTATETYPE state, DWORD value);
+    HRESULT SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value);
+    HRESULT SetTexture(DWORD stage, IDirect3DBaseTexture8* tex);
+    HRESULT SetVertexShader(DWORD handle);
+    HRESULT SetStreamSource(UINT stream, IDirect3DVertexBuffer8* vb, UINT stride);
+    HRESULT SetIndices(IDirect3DIndexBuffer8* ib, UINT baseVertex);
+    HRESULT SetTransform(D3DTRANSFORMSTATETYPE state, const D3DMATRIX* m);
+    HRESULT SetMaterial(const D3DMATERIAL8* mat);
+    HRESULT SetLight(DWORD index, const D3DLIGHT8* light);
+    HRESULT LightEnable(DWORD index, BOOL enable);
+
+    HRESULT DrawPrimitive(D3DPRIMITIVETYPE type, UINT startVertex, UINT primCount);
+    HRESULT DrawIndexedPrimitive(D3DPRIMITIVETYPE type, UINT minIndex, UINT numVertices, UINT startIndex,
+                                 UINT primCount);
+    HRESULT DrawPrimitiveUP(D3DPRIMITIVETYPE type, UINT primCount, const void* verts, UINT stride);
+    HRESULT DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE type, UINT minIndex, UINT numVertices, UINT primCount,
+                                   const void* indices, D3DFORMAT indexFormat, const void* verts,
+                                   UINT stride);
+
+    HRESULT Clear(DWORD count, const void* rects, DWORD flags, D3DCOLOR color, float z, DWORD stencil);
+    HRESULT BeginScene();
+    HRESULT EndScene();
+    HRESULT Present(const RECT* src, const RECT* dst, void* window, void* dirty);
+
+    HRESULT BlockUntilIdle();
+    DWORD   InsertFence();
+    BOOL    IsFencePending(DWORD fence);
+    void    BlockOnFence(DWORD fence);
+};
+typedef IDirect3DDevice8* LPDIRECT3DDEVICE8;
+
+struct IDirect3D8
+{
+    ULONG   Release();
+    HRESULT CreateDevice(UINT adapter, D3DDEVTYPE type, HANDLE window, DWORD flags,
+                         D3DPRESENT_PARAMETERS* params, IDirect3DDevice8** out);
+};
+typedef IDirect3D8* LPDIRECT3D8;
+
+IDirect3D8* Direct3DCreate8(UINT sdkVersion);
+
+// -----------------------------------------------------------------------------
+// XGraphics
+// -----------------------------------------------------------------------------
+
+void XGSetTextureHeader(UINT w, UINT h, UINT levels, DWORD usage, D3DFORMAT format, D3DPOOL pool,
+                        IDirect3DTexture8* tex, UINT data, UINT pitch);
+void XGSwizzleRect(const void* src, int pitch, const RECT* rect, void* dst, UINT w, UINT h,
+                   const POINT* point, UINT bytesPerPixel);
+
+// -----------------------------------------------------------------------------
+// D3DX math
+// -----------------------------------------------------------------------------
+
+#define D3DX_PI             3.141592654f
+#define D3DXToRadian(deg)   ((deg) * (D3DX_PI / 180.0f))
+
+struct D3DXVECTOR3 : D3DVECTOR
+{
+    D3DXVECTOR3() {}
+    D3DXVECTOR3(float fx, float fy, float fz) { x = fx; y = fy; z = fz; }
+
+    D3DXVECTOR3 operator+(const D3DXVECTOR3& o) const { return D3DXVECTOR3(x + o.x, y + o.y, z + o.z); }
+    D3DXVECTOR3 operator-(const D3DXVECTOR3& o) const { return D3DXVECTOR3(x - o.x, y - o.y, z - o.z); }
+    D3DXVECTOR3 operator*(float s) const { return D3DXVECTOR3(x * s, y * s, z * s); }
+    D3DXVECTOR3 operator-() const { return D3DXVECTOR3(-x, -y, -z); }
+    D3DXVECTOR3& operator+=(const D3DXVECTOR3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+};
+
+struct D3DXMATRIX;
+
+D3DXMATRIX*  D3DXMatrixIdentity(D3DXMATRIX* out);
+D3DXMATRIX*  D3DXMatrixMultiply(D3DXMATRIX* out, const D3DXMATRIX* a, const D3DXMATRIX* b);
+D3DXMATRIX*  D3DXMatrixLookAtLH(D3DXMATRIX* out, const D3DXVECTOR3* eye, const D3DXVECTOR3* at,
+                                const D3DXVECTOR3* up);
+D3DXMATRIX*  D3DXMatrixPerspectiveFovLH(D3DXMATRIX* out, float fovY, float aspect, float zn, float zf);
+D3DXMATRIX*  D3DXMatrixOrthoOffCenterLH(D3DXMATRIX* out, float l, float r, float b, float t, float zn,
+                                        float zf);
+D3DXMATRIX*  D3DXMatrixRotationX(D3DXMATRIX* out, float angle);
+D3DXMATRIX*  D3DXMatrixRotationY(D3DXMATRIX* out, float angle);
+D3DXMATRIX*  D3DXMatrixRotationZ(D3DXMATRIX* out, float angle);
+D3DXMATRIX*  D3DXMatrixRotationYawPitchRoll(D3DXMATRIX* out, float yaw, float pitch, float roll);
+D3DXMATRIX*  D3DXMatrixScaling(D3DXMATRIX* out, float sx, float sy, float sz);
+D3DXMATRIX*  D3DXMatrixTranslation(D3DXMATRIX* out, float x, float y, float z);
+D3DXVECTOR3* D3DXVec3TransformCoord(D3DXVECTOR3* out, const D3DXVECTOR3* v, const D3DXMATRIX* m);
+D3DXVECTOR3* D3DXVec3TransformNormal(D3DXVECTOR3* out, const D3DXVECTOR3* v, const D3DXMATRIX* m);
+
+struct D3DXMATRIX : D3DMATRIX
+{
+    float& operator()(int row, int col) { return m[row][col]; }
+    float  operator()(int row, int col) const { return m[row][col]; }
+
+    D3DXMATRIX operator*(const D3DXMATRIX& o) const
+    {
+        D3DXMATRIX r;
+        D3DXMatrixMultiply(&r, this, &o);
+        return r;
+    }
+
+    D3DXMATRIX& operator*=(const D3DXMATRIX& o)
+    {
+        D3DXMatrixMultiply(this, this, &o);
+        return *this;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// DirectSound (no device on the host: DirectSoundCreate fails)
+// -----------------------------------------------------------------------------
+
+#define DSBCAPS_CTRLVOLUME          0x00000080
+#define DSBCAPS_CTRLPOSITIONNOTIFY  0x00000100
+#define DSBPLAY_LOOPING             0x00000001
+#define DSBPN_OFFSETSTOP            0xFFFFFFFFu
+#define DSBVOLUME_MIN               (-10000)
+#define DSBVOLUME_MAX               0
+
+#define WAVE_FORMAT_PCM             0x0001
+#define WAVE_FORMAT_IMA_ADPCM       0x0011
+#define WAVE_FORMAT_XBOX_ADPCM      0x0069
+
+struct WAVEFORMATEX
+{
+    WORD  wFormatTag;
+    WORD  nChannels;
+    DWORD nSamplesPerSec;
+    DWORD nAvgBytesPerSec;
+    WORD  nBlockAlign;
+    WORD  wBitsPerSample;
+    WORD  cbSize;
+};
+typedef WAVEFORMATEX* LPWAVEFORMATEX;
+
+struct DSBUFFERDESC
+{
+    DWORD          dwSize;
+    DWORD          dwFlags;
+    DWORD          dwBufferBytes;
+    LPWAVEFORMATEX lpwfxFormat;
+    void*          lpMixBins;
+    DWORD          dwInputMixBin;
+};
+
+struct DSBPOSITIONNOTIFY
+{
+    DWORD  dwOffset;
+    HANDLE hEventNotify;
+};
+typedef DSBPOSITIONNOTIFY* LPCDSBPOSITIONNOTIFY;
+
+struct IDirectSoundBuffer
+{
+    ULONG   Release();
+    HRESULT Lock(DWORD offset, DWORD bytes, void** p1, DWORD* n1, void** p2, DWORD* n2, DWORD flags);
+    HRESULT Unlock(void* p1, DWORD n1, void* p2, DWORD n2);
+    HRESULT SetVolume(LONG volume);
+    HRESULT Play(DWORD r1, DWORD r2, DWORD flags);
+    HRESULT Stop();
+    HRESULT SetCurrentPosition(DWORD pos);
+    HRESULT GetCurrentPosition(DWORD* play, DWORD* write);
+    HRESULT SetNotificationPositions(DWORD count, LPCDSBPOSITIONNOTIFY notify);
+};
+typedef IDirectSoundBuffer* LPDIRECTSOUNDBUFFER;
+
+struct IDirectSound
+{
+    ULONG   Release();
+    HRESULT CreateSoundBuffer(const DSBUFFERDESC* desc, LPDIRECTSOUNDBUFFER* out, void* outer);
+};
+typedef IDirectSound* LPDIRECTSOUND8;
+
+HRESULT DirectSoundCreate(void* guid, LPDIRECTSOUND8* out, void* outer);
+void    DirectSoundDoWork();
@@ -0,0 +1,226 @@
+// plasmabench - checks and times the plasma field kernel in src/TR Demo/PlasmaKernel.cpp
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   g++ -O2 -o plasmabench tools/plasmabench/plasmabench.cpp "src/TR Demo/PlasmaKernel.cpp"
+//   ./plasmabench [frames]                default: 600
+//
+// For the scene's 48x36 grid and the 2x and 4x grids: every frame (t steps
+// by 0.06, as PlasmaScene's does) through the SSE path, the scalar fallback
+// and PlasmaField_EvalBandsRef, the original per-vertex sinf/cosf/sqrtf and
+// 16-way ladder. Fails if any cell of either fast path is more than one band
+// off the reference; prints how many are off by one (values landing on a
+// band edge) and how many differ between SSE and scalar. Then microseconds
+// per frame for each path.
+//
+// Then PlasmaScene's texture mode at its 320x240: PlasmaTex_Eval's palette
+// index >> 4 against PlasmaField_EvalBandsRef over the first 60 frames (the
+// reference is slow at this size), failing if a pixel is more than one band
+// off, and pixels per millisecond for PlasmaTex_Eval and PlasmaTex_Expand.
+
+#include "../../src/TR Demo/PlasmaKernel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const float FRAME_T = 0.06f;
+
+// PlasmaScene's texture mode
+static const int TEX_W = 320;
+static const int TEX_H = 240;
+static const int TEX_CHECK_FRAMES = 60;
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+// Worst |a - b| over n cells; counts the cells that differ at all
+static int Compare(const unsigned char* a, const unsigned char* b, int n, long long* differing)
+{
+    int worst = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        int d = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        if (d)
+            (*differing)++;
+        if (d > worst)
+            worst = d;
+    }
+    return worst;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    if (frames < 1)
+    {
+        fprintf(stderr, "usage: plasmabench [frames]\n");
+        return 1;
+    }
+
+    static const int sizes[3][2] = { { 48, 36 }, { 96, 72 }, { 192, 144 } };
+    unsigned int sink = 0;
+    bool ok = true;
+
+    printf("%9s %10s %12s %12s %14s %10s %10s %10s\n", "grid", "cells", "sse off ref", "scalar off",
+           "sse vs scalar", "sse us", "scalar us", "ref us");
+
+    for (int g = 0; g < 3; ++g)
+    {
+        const int w = sizes[g][0], h = sizes[g][1];
+        const int cells = w * h;
+
+        PlasmaField field;
+        if (!PlasmaField_Init(&field, w, h))
+        {
+            fprintf(stderr, "plasmabench: init failed at %dx%d\n", w, h);
+            return 1;
+        }
+
+        unsigned char* sse = (unsigned char*)malloc(cells);
+        unsigned char* scalar = (unsigned char*)malloc(cells);
+        unsigned char* ref = (unsigned char*)malloc(cells);
+
+        long long offSse = 0, offScalar = 0, sseVsScalar = 0;
+        int worst = 0;
+
+        for (int f = 0; f < frames; ++f)
+        {
+            float t = (float)f * FRAME_T;
+
+            PlasmaField_EvalBands(&field, t, sse);
+            PlasmaField_EvalBandsScalar(&field, t, scalar);
+            PlasmaField_EvalBandsRef(w, h, t, ref);
+
+            int a = Compare(sse, ref, cells, &offSse);
+            int b = Compare(scalar, ref, cells, &offScalar);
+            Compare(sse, scalar, cells, &sseVsScalar);
+
+            if (a > worst) worst = a;
+            if (b > worst) worst = b;
+        }
+
+        if (worst > 1)
+        {
+            fprintf(stderr, "plasmabench: %dx%d: a cell is %d bands off the reference\n", w, h, worst);
+            ok = false;
+        }
+
+        // Timing, each path over the same frames
+        double t0 = NowUs();
+        for (int f = 0; f < frames; ++f)
+        {
+            PlasmaField_EvalBands(&field, (float)f * FRAME_T, sse);
+            sink += sse[f % cells];
+        }
+        double t1 = NowUs();
+        for (int f = 0; f < frames; ++f)
+        {
+            PlasmaField_EvalBandsScalar(&field, (float)f * FRAME_T, scalar);
+            sink += scalar[f % cells];
+        }
+        double t2 = NowUs();
+        for (int f = 0; f < frames; ++f)
+        {
+            PlasmaField_EvalBandsRef(w, h, (float)f * FRAME_T, ref);
+            sink += ref[f % cells];
+        }
+        double t3 = NowUs();
+
+        char grid[16];
+        snprintf(grid, sizeof(grid), "%dx%d", w, h);
+
+        double total = (double)cells * frames;
+        printf("%9s %10d %11.4f%% %11.4f%% %13.4f%% %10.1f %10.1f %10.1f\n", grid, cells,
+               100.0 * offSse / total, 100.0 * offScalar / total, 100.0 * sseVsScalar / total,
+               (t1 - t0) / frames, (t2 - t1) / frames, (t3 - t2) / frames);
+
+        free(sse);
+        free(scalar);
+        free(ref);
+        PlasmaField_Free(&field);
+    }
+
+    // Texture mode: integer/LUT kernel, then the palette expand
+    {
+        const int pixels = TEX_W * TEX_H;
+
+        PlasmaTexField tex;
+        if (!PlasmaTex_Init(&tex, TEX_W, TEX_H))
+        {
+            fprintf(stderr, "plasmabench: PlasmaTex init failed\n");
+            return 1;
+        }
+
+        unsigned char* index = (unsigned char*)malloc(pixels);
+        unsigned char* bands = (unsigned char*)malloc(pixels);
+        unsigned char* ref = (unsigned char*)malloc(pixels);
+        unsigned int* argb = (unsigned int*)malloc(pixels * sizeof(unsigned int));
+
+        unsigned int palette[256];
+        for (int i = 0; i < 256; ++i)
+            palette[i] = 0xFF000000u | ((unsigned)i << 16) | ((unsigned)(255 - i) << 8) | (unsigned)(i ^ 0x80);
+
+        const int checkFrames = frames < TEX_CHECK_FRAMES ? frames : TEX_CHECK_FRAMES;
+        long long off = 0;
+        int worst = 0;
+
+        for (int f = 0; f < checkFrames; ++f)
+        {
+            float t = (float)f * FRAME_T;
+
+            PlasmaTex_Eval(&tex, t, index, TEX_W);
+            PlasmaField_EvalBandsRef(TEX_W, TEX_H, t, ref);
+
+            for (int i = 0; i < pixels; ++i)
+                bands[i] = (unsigned char)(index[i] >> 4);
+
+            int d = Compare(bands, ref, pixels, &off);
+            if (d > worst) worst = d;
+        }
+
+        if (worst > 1)
+        {
+            fprintf(stderr, "plasmabench: PlasmaTex: a pixel is %d bands off the reference\n", worst);
+            ok = false;
+        }
+
+        double t0 = NowUs();
+        for (int f = 0; f < frames; ++f)
+        {
+            PlasmaTex_Eval(&tex, (float)f * FRAME_T, index, TEX_W);
+            sink += index[f % pixels];
+        }
+        double t1 = NowUs();
+        for (int f = 0; f < frames; ++f)
+        {
+            PlasmaTex_Expand(index, TEX_W, TEX_W, TEX_H, palette, argb, TEX_W * 4);
+            sink += argb[f % pixels];
+        }
+        double t2 = NowUs();
+
+        char size[16];
+        snprintf(size, sizeof(size), "%dx%d", TEX_W, TEX_H);
+
+        double px = (double)pixels * frames;
+        printf("\n%9s %10s %12s %10s %14s %14s\n", "texture", "pixels", "off ref", "worst",
+               "eval px/ms", "expand px/ms");
+        printf("%9s %10d %11.4f%% %10d %14.0f %14.0f\n", size, pixels,
+               100.0 * off / ((double)pixels * checkFrames), worst,
+               px / ((t1 - t0) / 1000.0), px / ((t2 - t1) / 1000.0));
+
+        free(index);
+        free(bands);
+        free(ref);
+        free(argb);
+        PlasmaTex_Free(&tex);
+    }
+
+    if (!ok)
+        return 2;
+    return sink == 0xFFFFFFFF ? 2 : 0;
+}
@@ -0,0 +1,250 @@
+// ripplebench - checks and times the ripple solver in src/TR Demo/RippleKernel.cpp
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   g++ -O2 -o ripplebench tools/ripplebench/ripplebench.cpp "src/TR Demo/RippleKernel.cpp"
+//   ./ripplebench [steps]                 default: 20000
+//
+// Two copies of the DripScene grid (wave buffers and splash) get the same
+// drops, the scene's pattern: its opening drop, then per update (two solver
+// steps) the random small and large drops, rain every third update for the
+// first half, plus an oversized drop every 1000 steps to push cells next to
+// the undamped border towards the int16 limits. One copy is stepped with the
+// original loops (Ripple_StepRef: (n >> 1) - prev damped by DAMP, then a
+// separate splash decay pass), the other with Ripple_Step, whole grid or 16x16
+// tile by tile as the scene calls it. Every buffer must match bit for bit
+// after every step. Then microseconds per step for each, at the scene's
+// 192x144 and at 384x288.
+
+#include "../../src/TR Demo/RippleKernel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const int DAMP = 247;                // DripScene
+static const int TILE = 16;
+
+static double NowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+struct Grid
+{
+    int    w, h;
+    int    ping;
+    short* a;
+    short* b;
+    short* splash;
+};
+
+static void GridInit(Grid* g, int w, int h)
+{
+    g->w = w;
+    g->h = h;
+    g->ping = 0;
+    g->a = (short*)calloc((size_t)w * h, sizeof(short));
+    g->b = (short*)calloc((size_t)w * h, sizeof(short));
+    g->splash = (short*)calloc((size_t)w * h, sizeof(short));
+}
+
+static void GridFree(Grid* g)
+{
+    free(g->a);
+    free(g->b);
+    free(g->splash);
+}
+
+static bool GridSame(const Grid* x, const Grid* y)
+{
+    size_t bytes = (size_t)x->w * x->h * sizeof(short);
+    return x->ping == y->ping &&
+           memcmp(x->a, y->a, bytes) == 0 &&
+           memcmp(x->b, y->b, bytes) == 0 &&
+           memcmp(x->splash, y->splash, bytes) == 0;
+}
+
+// DripScene's AddDrop, without the tile wake-up
+static void AddDrop(Grid* g, int cx, int cy, int radius, int strength)
+{
+    int r2 = radius * radius;
+    short* cur = g->ping == 0 ? g->a : g->b;
+
+    for (int y = cy - radius; y <= cy + radius; ++y)
+    {
+        if ((unsigned)(y - 1) >= (unsigned)(g->h - 2)) continue;
+        int dy = y - cy;
+
+        for (int x = cx - radius; x <= cx + radius; ++x)
+        {
+            if ((unsigned)(x - 1) >= (unsigned)(g->w - 2)) continue;
+            int dx = x - cx;
+            int d2 = dx * dx + dy * dy;
+            if (d2 > r2) continue;
+
+            int i = y * g->w + x;
+            cur[i] = (short)((int)cur[i] + (strength * (r2 - d2)) / (r2 ? r2 : 1));
+
+            if (dx == 0 && dy == 0)
+                g->splash[i] = 2400;
+        }
+    }
+}
+
+enum Path { PATH_REF, PATH_WHOLE, PATH_TILES };
+
+static void Step(Grid* g, Path path, RippleStats* stats)
+{
+    const short* cur = g->ping == 0 ? g->a : g->b;
+    short* prev = g->ping == 0 ? g->b : g->a;
+
+    if (path == PATH_REF)
+    {
+        Ripple_StepRef(cur, prev, g->splash, g->w, g->h, DAMP);
+    }
+    else if (path == PATH_WHOLE)
+    {
+        Ripple_Step(cur, prev, g->splash, g->w, g->h, DAMP, 0, 0, g->w, g->h, NULL, stats);
+    }
+    else
+    {
+        for (int y0 = 0; y0 < g->h; y0 += TILE)
+            for (int x0 = 0; x0 < g->w; x0 += TILE)
+                Ripple_Step(cur, prev, g->splash, g->w, g->h, DAMP,
+                            x0, y0, x0 + TILE, y0 + TILE, NULL, stats);
+    }
+
+    g->ping ^= 1;
+}
+
+// Drops for one scene update (two solver steps), the same into every grid
+static unsigned int s_rng;
+
+static void SceneDrops(Grid** grids, int count, int update, bool rain, bool oversized)
+{
+    const int w = grids[0]->w, h = grids[0]->h;
+
+    if (rain && update % 3 == 0)
+    {
+        s_rng = s_rng * 1664525u + 1013904223u;
+        for (int k = 0; k < count; ++k)
+            AddDrop(grids[k], s_rng % w, (s_rng >> 8) % h, 2, -1200);
+    }
+
+    s_rng = s_rng * 1664525u + 1013904223u;
+    unsigned int r = s_rng;
+    for (int k = 0; k < count; ++k)
+    {
+        if ((r & 31) == 0)
+            AddDrop(grids[k], r % w, (r >> 8) % h, 4, -2400);
+        if ((r & 255) == 0)
+            AddDrop(grids[k], r % w, (r >> 16) % h, 7, -4200);
+        if (oversized)
+            AddDrop(grids[k], r % w, (r >> 12) % h, 12, -30000);
+    }
+}
+
+static bool Check(int w, int h, int steps)
+{
+    Grid ref, whole, tiles;
+    GridInit(&ref, w, h);
+    GridInit(&whole, w, h);
+    GridInit(&tiles, w, h);
+    Grid* grids[3] = { &ref, &whole, &tiles };
+
+    s_rng = 0x12345678;
+    for (int k = 0; k < 3; ++k)
+        AddDrop(grids[k], w / 2, h / 2, 7, -3600);
+
+    RippleStats stats = { 0, 0 };
+    bool ok = true;
+
+    for (int s = 0; s < steps && ok; ++s)
+    {
+        if ((s & 1) == 0)
+            SceneDrops(grids, 3, s / 2, s < steps / 2, s % 1000 == 500);
+
+        Step(&ref, PATH_REF, NULL);
+        Step(&whole, PATH_WHOLE, &stats);
+        Step(&tiles, PATH_TILES, NULL);
+
+        if (!GridSame(&ref, &whole) || !GridSame(&ref, &tiles))
+        {
+            fprintf(stderr, "ripplebench: %dx%d: %s differs from the reference at step %d\n", w, h,
+                    GridSame(&ref, &whole) ? "tile by tile" : "whole grid", s + 1);
+            ok = false;
+        }
+    }
+
+    if (ok)
+    {
+        printf("%dx%d: bit-exact over %d steps (whole grid and by tile), %.2f%% of cells scalar\n",
+               w, h, steps, stats.cells ? 100.0 * stats.scalarCells / stats.cells : 0.0);
+    }
+
+    GridFree(&ref);
+    GridFree(&whole);
+    GridFree(&tiles);
+    return ok;
+}
+
+// Microseconds per step for one path, from the same state
+static double TimeStep(int w, int h, Path path, int steps, unsigned int* sink)
+{
+    Grid g;
+    GridInit(&g, w, h);
+    Grid* grids[1] = { &g };
+
+    s_rng = 0x12345678;
+    AddDrop(&g, w / 2, h / 2, 7, -3600);
+
+    double us = 0.0;
+    for (int s = 0; s < steps; ++s)
+    {
+        if ((s & 1) == 0)
+            SceneDrops(grids, 1, s / 2, true, false);
+
+        double t0 = NowUs();
+        Step(&g, path, NULL);
+        us += NowUs() - t0;
+    }
+
+    *sink += (unsigned short)g.a[(w + 1) * (h / 2)];
+    GridFree(&g);
+    return us / steps;
+}
+
+int main(int argc, char** argv)
+{
+    int steps = argc > 1 ? atoi(argv[1]) : 20000;
+    if (steps < 2)
+    {
+        fprintf(stderr, "usage: ripplebench [steps]\n");
+        return 1;
+    }
+
+    if (!Check(192, 144, steps) || !Check(384, 288, steps / 4))
+        return 2;
+
+    unsigned int sink = 0;
+    const int timed = steps / 4 < 2000 ? steps / 4 : 2000;
+
+    printf("\n%9s %12s %12s %12s %8s\n", "grid", "ref us", "whole us", "tiles us", "speedup");
+    for (int g = 0; g < 2; ++g)
+    {
+        const int w = 192 << g, h = 144 << g;
+
+        double ref = TimeStep(w, h, PATH_REF, timed, &sink);
+        double whole = TimeStep(w, h, PATH_WHOLE, timed, &sink);
+        double tiles = TimeStep(w, h, PATH_TILES, timed, &sink);
+
+        char grid[16];
+        snprintf(grid, sizeof(grid), "%dx%d", w, h);
+        printf("%9s %12.1f %12.1f %12.1f %7.2fx\n", grid, ref, whole, tiles, ref / whole);
+    }
+
+    return sink == 0xFFFFFFFF ? 2 : 0;
+}
@@ -0,0 +1,180 @@
+// specbench - checks and times the spectrum analyzer in src/TR Demo/spectrum.cpp
+//
+// Host tool (Linux, x86, any C++ compiler), run from the repository root:
+//   g++ -O2 -o specbench tools/specbench/specbench.cpp "src/TR Demo/spectrum.cpp"
+//   ./specbench [bands] [reps]            defaults: 16 2000
+//
+// For each FFT size: the integer FFT's SNR against a double DFT (scaled by
+// 1/n like the integer one) on random full-scale input, then cycles (rdtsc)
+// per FFT and per analysis block (window, FFT, bands, smoothing). Then, at
+// 512 points with the demo's settings, the band edges in Hz and the level
+// each band reaches for a full-scale and a -60 dB sine at its centre.
+
+#include "../../src/TR Demo/spectrum.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+
+static const double PI = 3.14159265358979323846;
+
+static unsigned int s_rng = 0x12345678;
+
+static int RandomSample()
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return (int)(s_rng >> 16) - 32768 + ((s_rng >> 16) == 0 ? 1 : 0);
+}
+
+static double FftSnr(unsigned int log2n)
+{
+    unsigned int n = 1u << log2n;
+    static int re[SPECTRUM_MAX_FFT], im[SPECTRUM_MAX_FFT];
+    static double x[SPECTRUM_MAX_FFT];
+
+    double signal = 0.0, noise = 0.0;
+
+    for (int trial = 0; trial < 8; ++trial)
+    {
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            re[i] = RandomSample();
+            im[i] = 0;
+            x[i] = re[i];
+        }
+
+        Spectrum_Fft(re, im, log2n);
+
+        for (unsigned int k = 0; k < n; ++k)
+        {
+            double sr = 0.0, si = 0.0;
+            for (unsigned int i = 0; i < n; ++i)
+            {
+                double a = -2.0 * PI * (double)((unsigned long long)k * i % n) / n;
+                sr += x[i] * cos(a);
+                si += x[i] * sin(a);
+            }
+            sr /= n;
+            si /= n;
+
+            signal += sr * sr + si * si;
+            noise += (sr - re[k]) * (sr - re[k]) + (si - im[k]) * (si - im[k]);
+        }
+    }
+    return 10.0 * log10(signal / noise);
+}
+
+static void Configure(Spectrum* s, unsigned int fftSize, unsigned int bands)
+{
+    SpectrumConfig cfg;
+    cfg.fftSize = fftSize;
+    cfg.bands = bands;
+    cfg.loHz = 40;
+    cfg.hiHz = 16000;
+    cfg.sampleRate = 48000;
+    cfg.attack = 256;
+    cfg.release = 256;
+
+    if (!Spectrum_Configure(s, &cfg))
+    {
+        fprintf(stderr, "specbench: config rejected (%u points, %u bands)\n", fftSize, bands);
+        exit(1);
+    }
+}
+
+// One analysis of a mono sine at hz, amplitude amp; returns band levels
+static void SineLevels(Spectrum* s, double hz, double amp, short* pcm)
+{
+    for (unsigned int i = 0; i < s->cfg.fftSize; ++i)
+        pcm[i] = (short)lrint(amp * sin(2.0 * PI * hz * i / s->cfg.sampleRate));
+
+    bool analyzed = false;
+    Spectrum_Feed(s, pcm, s->cfg.fftSize, 1, &analyzed);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int bands = argc > 1 ? (unsigned int)atoi(argv[1]) : 16;
+    int reps = argc > 2 ? atoi(argv[2]) : 2000;
+
+    if (bands < 1 || bands > SPECTRUM_MAX_BANDS || reps < 1)
+    {
+        fprintf(stderr, "usage: specbench [bands 1..%u] [reps]\n", SPECTRUM_MAX_BANDS);
+        return 1;
+    }
+
+    // log2 helper, against the real thing
+    double worst = 0.0;
+    for (unsigned long long v = 1; v < (1ULL << 40); v = v * 3 / 2 + 1)
+    {
+        double err = fabs(Spectrum_Log2Q8(v) / 256.0 - log2((double)v));
+        if (err > worst)
+            worst = err;
+    }
+    printf("log2 Q8: worst error %.4f\n", worst);
+
+    static Spectrum spec;
+    static short pcm[SPECTRUM_MAX_FFT * 2];
+    static int re[SPECTRUM_MAX_FFT], im[SPECTRUM_MAX_FFT];
+    unsigned int sink = 0;
+
+    printf("%5s %8s %12s %14s\n", "n", "snr dB", "cycles/fft", "cycles/block");
+
+    for (unsigned int log2n = 8; log2n <= 10; ++log2n)
+    {
+        unsigned int n = 1u << log2n;
+        double snr = FftSnr(log2n);
+
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            re[i] = RandomSample();
+            im[i] = 0;
+        }
+
+        unsigned long long t0 = __rdtsc();
+        for (int r = 0; r < reps; ++r)
+        {
+            Spectrum_Fft(re, im, log2n);
+            sink ^= (unsigned int)re[r & (n - 1)];
+        }
+        unsigned long long fftCycles = (__rdtsc() - t0) / reps;
+
+        // Stereo feed, one block per analysis
+        Configure(&spec, n, bands);
+        for (unsigned int i = 0; i < n * 2; ++i)
+            pcm[i] = (short)RandomSample();
+
+        t0 = __rdtsc();
+        for (int r = 0; r < reps; ++r)
+        {
+            bool analyzed = false;
+            Spectrum_Feed(&spec, pcm, n, 2, &analyzed);
+            sink ^= spec.levels[r % bands];
+        }
+        unsigned long long blockCycles = (__rdtsc() - t0) / reps;
+
+        printf("%5u %8.1f %12llu %14llu\n", n, snr, fftCycles, blockCycles);
+    }
+
+    // Band layout and level calibration at the demo's settings
+    Configure(&spec, 512, bands);
+    printf("\n512 points, %u bands, 48 kHz: band, bins, Hz, level at full scale / -60 dB\n", bands);
+
+    for (unsigned int b = 0; b < bands; ++b)
+    {
+        unsigned int k0 = spec.bandStart[b], k1 = spec.bandStart[b + 1];
+        double lo = (double)k0 * 48000.0 / 512.0, hi = (double)k1 * 48000.0 / 512.0;
+        double centre = (lo + hi) * 0.5;
+
+        SineLevels(&spec, centre, 32767.0, pcm);
+        int full = spec.levels[b];
+        SineLevels(&spec, centre, 32.767, pcm);
+        int quiet = spec.levels[b];
+
+        printf("%3u %4u-%-4u %6.0f-%-6.0f %4d %4d\n", b, k0, k1 - 1, lo, hi, full, quiet);
+    }
+
+    return sink == 0xFFFFFFFF ? 2 : 0;
+}
@@ -0,0 +1,476 @@
+#include "dxt.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Colors
+// -----------------------------------------------------------------------------
+
+struct Rgb
+{
+    float r, g, b;
+};
+
+static Rgb ToRgb(uint32_t argb)
+{
+    Rgb c = { (float)((argb >> 16) & 255), (float)((argb >> 8) & 255), (float)(argb & 255) };
+    return c;
+}
+
+static float Dist2(const Rgb& a, const Rgb& b)
+{
+    float dr = a.r - b.r, dg = a.g - b.g, db = a.b - b.b;
+    return dr * dr + dg * dg + db * db;
+}
+
+static int Clamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static uint16_t Pack565(const Rgb& c)
+{
+    int r = Clamp((int)(c.r * 31.0f / 255.0f + 0.5f), 0, 31);
+    int g = Clamp((int)(c.g * 63.0f / 255.0f + 0.5f), 0, 63);
+    int b = Clamp((int)(c.b * 31.0f / 255.0f + 0.5f), 0, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Bit replication, as the hardware expands them
+static void Unpack565(uint16_t v, int rgb[3])
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Four palette entries; entry 3 of a three-color block is transparent black
+static void ColorPalette(uint16_t c0, uint16_t c1, int pal[4][3])
+{
+    Unpack565(c0, pal[0]);
+    Unpack565(c1, pal[1]);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        if (c0 > c1)
+        {
+            pal[2][k] = (2 * pal[0][k] + pal[1][k]) / 3;
+            pal[3][k] = (pal[0][k] + 2 * pal[1][k]) / 3;
+        }
+        else
+        {
+            pal[2][k] = (pal[0][k] + pal[1][k]) / 2;
+            pal[3][k] = 0;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Color block
+// -----------------------------------------------------------------------------
+
+// Weight of endpoint 0 for each index, four- and three-color modes
+static const float W4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+static const float W3[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+
+struct ColorFit
+{
+    uint16_t c0, c1;
+    uint32_t indices;
+    float    err;
+};
+
+// Indices and error of endpoints (c0, c1) over the texels in 'use'; in
+// three-color mode the 'clear' texels take index 3.
+static ColorFit Evaluate(uint16_t c0, uint16_t c1, const Rgb px[16], const bool use[16],
+                         const bool clear[16], bool threeColor)
+{
+    ColorFit f;
+    f.c0 = c0;
+    f.c1 = c1;
+    f.indices = 0;
+    f.err = 0.0f;
+
+    int pal[4][3];
+    ColorPalette(c0, c1, pal);
+
+    Rgb p[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        p[i].r = (float)pal[i][0];
+        p[i].g = (float)pal[i][1];
+        p[i].b = (float)pal[i][2];
+    }
+
+    const int choices = threeColor ? 3 : 4;
+
+    for (int t = 0; t < 16; ++t)
+    {
+        uint32_t best = 0;
+
+        if (threeColor && clear[t])
+            best = 3;
+        else if (use[t])
+        {
+            float bestD = Dist2(px[t], p[0]);
+            for (int i = 1; i < choices; ++i)
+            {
+                float d = Dist2(px[t], p[i]);
+                if (d < bestD) { bestD = d; best = (uint32_t)i; }
+            }
+            f.err += bestD;
+        }
+
+        f.indices |= best << (2 * t);
+    }
+
+    return f;
+}
+
+// Endpoints minimizing squared error for fixed indices; false if singular
+static bool LeastSquares(const ColorFit& f, const Rgb px[16], const bool use[16],
+                         const float* w, Rgb* e0, Rgb* e1)
+{
+    float aa = 0, ab = 0, bb = 0;
+    Rgb ax = { 0, 0, 0 }, bx = { 0, 0, 0 };
+
+    for (int t = 0; t < 16; ++t)
+    {
+        uint32_t idx = (f.indices >> (2 * t)) & 3;
+        if (!use[t] || (w == W3 && idx == 3))
+            continue;
+
+        float a = w[idx], b = 1.0f - a;
+        aa += a * a; ab += a * b; bb += b * b;
+        ax.r += a * px[t].r; ax.g += a * px[t].g; ax.b += a * px[t].b;
+        bx.r += b * px[t].r; bx.g += b * px[t].g; bx.b += b * px[t].b;
+    }
+
+    float det = aa * bb - ab * ab;
+    if (det < 1e-6f && det > -1e-6f)
+        return false;
+
+    float inv = 1.0f / det;
+    e0->r = (bb * ax.r - ab * bx.r) * inv;
+    e0->g = (bb * ax.g - ab * bx.g) * inv;
+    e0->b = (bb * ax.b - ab * bx.b) * inv;
+    e1->r = (aa * bx.r - ab * ax.r) * inv;
+    e1->g = (aa * bx.g - ab * ax.g) * inv;
+    e1->b = (aa * bx.b - ab * ax.b) * inv;
+    return true;
+}
+
+// Orders the endpoints for the mode (c0 > c1 selects four colors) and
+// picks the indices for that order. DXT3/5 color blocks are kept in this order
+// too: the spec says they always decode four colors, but NV parts apply
+// the DXT1 rule to them as well.
+static ColorFit Order(uint16_t a, uint16_t b, const Rgb px[16], const bool use[16],
+                      const bool clear[16], bool threeColor)
+{
+    if (threeColor)
+        return Evaluate(a < b ? a : b, a < b ? b : a, px, use, clear, true);
+
+    // Equal endpoints can't express four colors; every texel gets c0 anyway
+    if (a == b)
+    {
+        ColorFit f = Evaluate(a, b, px, use, clear, false);
+        f.indices = 0;
+        return f;
+    }
+
+    return Evaluate(a > b ? a : b, a > b ? b : a, px, use, clear, false);
+}
+
+static void EncodeColor(const uint32_t texels[16], const bool use[16], const bool clear[16],
+                        bool threeColor, uint8_t out[8])
+{
+    Rgb px[16];
+    int n = 0;
+    Rgb mean = { 0, 0, 0 };
+
+    for (int t = 0; t < 16; ++t)
+    {
+        px[t] = ToRgb(texels[t]);
+        if (!use[t])
+            continue;
+        mean.r += px[t].r; mean.g += px[t].g; mean.b += px[t].b;
+        n++;
+    }
+
+    ColorFit best;
+    best.c0 = best.c1 = 0;
+    best.indices = threeColor ? 0xFFFFFFFFu : 0;    // all clear / all black
+    best.err = 0.0f;
+
+    if (n > 0)
+    {
+        mean.r /= n; mean.g /= n; mean.b /= n;
+
+        // Principal axis of the covariance by power iteration
+        float cov[6] = { 0, 0, 0, 0, 0, 0 };
+        for (int t = 0; t < 16; ++t)
+        {
+            if (!use[t])
+                continue;
+            float r = px[t].r - mean.r, g = px[t].g - mean.g, b = px[t].b - mean.b;
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+
+        Rgb axis = { 1.0f, 1.0f, 1.0f };
+        for (int it = 0; it < 8; ++it)
+        {
+            Rgb v;
+            v.r = cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b;
+            v.g = cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b;
+            v.b = cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b;
+
+            float m = v.r > v.g ? v.r : v.g;
+            if (v.b > m) m = v.b;
+            if (-v.r > m) m = -v.r;
+            if (-v.g > m) m = -v.g;
+            if (-v.b > m) m = -v.b;
+            if (m < 1e-6f)
+                break;
+
+            axis.r = v.r / m; axis.g = v.g / m; axis.b = v.b / m;
+        }
+
+        // Extremes along the axis
+        float lo = 1e30f, hi = -1e30f;
+        Rgb e0 = mean, e1 = mean;
+        for (int t = 0; t < 16; ++t)
+        {
+            if (!use[t])
+                continue;
+            float d = (px[t].r - mean.r) * axis.r + (px[t].g - mean.g) * axis.g +
+                      (px[t].b - mean.b) * axis.b;
+            if (d < lo) { lo = d; e1 = px[t]; }
+            if (d > hi) { hi = d; e0 = px[t]; }
+        }
+
+        best = Order(Pack565(e0), Pack565(e1), px, use, clear, threeColor);
+
+        // A few rounds of least squares on the chosen indices
+        const float* w = threeColor ? W3 : W4;
+        for (int it = 0; it < 3; ++it)
+        {
+            Rgb l0, l1;
+            if (!LeastSquares(best, px, use, w, &l0, &l1))
+                break;
+
+            ColorFit f = Order(Pack565(l0), Pack565(l1), px, use, clear, threeColor);
+            if (f.err >= best.err)
+                break;
+            best = f;
+        }
+    }
+
+    out[0] = (uint8_t)(best.c0 & 255);
+    out[1] = (uint8_t)(best.c0 >> 8);
+    out[2] = (uint8_t)(best.c1 & 255);
+    out[3] = (uint8_t)(best.c1 >> 8);
+    out[4] = (uint8_t)(best.indices & 255);
+    out[5] = (uint8_t)((best.indices >> 8) & 255);
+    out[6] = (uint8_t)((best.indices >> 16) & 255);
+    out[7] = (uint8_t)(best.indices >> 24);
+}
+
+// -----------------------------------------------------------------------------
+// Alpha blocks
+// -----------------------------------------------------------------------------
+
+static void AlphaPalette(int a0, int a1, int pal[8])
+{
+    pal[0] = a0;
+    pal[1] = a1;
+
+    if (a0 > a1)
+    {
+        for (int i = 2; i < 8; ++i)
+            pal[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    }
+    else
+    {
+        for (int i = 2; i < 6; ++i)
+            pal[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        pal[6] = 0;
+        pal[7] = 255;
+    }
+}
+
+static int FitAlpha(int a0, int a1, const int alpha[16], uint64_t* bits)
+{
+    int pal[8];
+    AlphaPalette(a0, a1, pal);
+
+    int err = 0;
+    *bits = 0;
+
+    for (int t = 0; t < 16; ++t)
+    {
+        int best = 0, bestD = 1 << 30;
+        for (int i = 0; i < 8; ++i)
+        {
+            int d = (alpha[t] - pal[i]) * (alpha[t] - pal[i]);
+            if (d < bestD) { bestD = d; best = i; }
+        }
+        err += bestD;
+        *bits |= (uint64_t)best << (3 * t);
+    }
+    return err;
+}
+
+static void EncodeAlpha5(const int alpha[16], uint8_t out[8])
+{
+    // Eight-value ramp over the full range
+    int lo = 255, hi = 0;
+    for (int t = 0; t < 16; ++t)
+    {
+        if (alpha[t] < lo) lo = alpha[t];
+        if (alpha[t] > hi) hi = alpha[t];
+    }
+
+    int a0 = hi, a1 = lo;
+    uint64_t bits;
+    int err = FitAlpha(a0, a1, alpha, &bits);
+
+    // Six-value ramp between the inner values, with exact 0 and 255
+    int ilo = 255, ihi = 0;
+    for (int t = 0; t < 16; ++t)
+    {
+        if (alpha[t] == 0 || alpha[t] == 255)
+            continue;
+        if (alpha[t] < ilo) ilo = alpha[t];
+        if (alpha[t] > ihi) ihi = alpha[t];
+    }
+    if (ilo > ihi)
+        ilo = ihi = 0;
+
+    uint64_t bits6;
+    int err6 = FitAlpha(ilo, ihi, alpha, &bits6);
+    if (err6 < err)
+    {
+        a0 = ilo;
+        a1 = ihi;
+        bits = bits6;
+    }
+
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (uint8_t)((bits >> (8 * i)) & 255);
+}
+
+static void EncodeAlpha3(const int alpha[16], uint8_t out[8])
+{
+    memset(out, 0, 8);
+    for (int t = 0; t < 16; ++t)
+    {
+        int v = (alpha[t] * 15 + 127) / 255;
+        out[t / 2] |= (uint8_t)(v << (4 * (t & 1)));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Images
+// -----------------------------------------------------------------------------
+
+unsigned int Dxt_BlockBytes(DxtFormat fmt)
+{
+    return fmt == DXT_1 ? 8u : 16u;
+}
+
+void Dxt_Encode(DxtFormat fmt, const uint32_t* texels, unsigned int w, unsigned int h,
+                uint8_t* out)
+{
+    const unsigned int bw = w / 4, bh = h / 4;
+
+    for (unsigned int by = 0; by < bh; ++by)
+    {
+        for (unsigned int bx = 0; bx < bw; ++bx)
+        {
+            uint32_t block[16];
+            int alpha[16];
+            bool use[16], clear[16];
+            bool anyClear = false;
+
+            for (int t = 0; t < 16; ++t)
+            {
+                block[t] = texels[(size_t)(by * 4 + t / 4) * w + bx * 4 + (t & 3)];
+                alpha[t] = (int)(block[t] >> 24);
+
+                // DXT1 keys alpha at 50%; otherwise fully clear texels'
+                // colors are never seen, so they don't pull the fit
+                clear[t] = fmt == DXT_1 ? alpha[t] < 128 : alpha[t] == 0;
+                use[t] = !clear[t];
+                anyClear |= clear[t];
+            }
+
+            uint8_t* dst = out + ((size_t)by * bw + bx) * Dxt_BlockBytes(fmt);
+
+            if (fmt == DXT_1)
+            {
+                EncodeColor(block, use, clear, anyClear, dst);
+                continue;
+            }
+
+            if (fmt == DXT_3)
+                EncodeAlpha3(alpha, dst);
+            else
+                EncodeAlpha5(alpha, dst);
+
+            EncodeColor(block, use, clear, false, dst + 8);
+        }
+    }
+}
+
+void Dxt_Decode(DxtFormat fmt, const uint8_t* blocks, unsigned int w, unsigned int h,
+                uint32_t* out)
+{
+    const unsigned int bw = w / 4, bh = h / 4;
+
+    for (unsigned int by = 0; by < bh; ++by)
+    {
+        for (unsigned int bx = 0; bx < bw; ++bx)
+        {
+            const uint8_t* src = blocks + ((size_t)by * bw + bx) * Dxt_BlockBytes(fmt);
+            const uint8_t* color = fmt == DXT_1 ? src : src + 8;
+
+            uint16_t c0 = (uint16_t)(color[0] | (color[1] << 8));
+            uint16_t c1 = (uint16_t)(color[2] | (color[3] << 8));
+            uint32_t idx = (uint32_t)color[4] | ((uint32_t)color[5] << 8) |
+                           ((uint32_t)color[6] << 16) | ((uint32_t)color[7] << 24);
+
+            int pal[4][3];
+            ColorPalette(c0, c1, pal);
+
+            int apal[8];
+            uint64_t abits = 0;
+            if (fmt == DXT_5)
+            {
+                AlphaPalette(src[0], src[1], apal);
+                for (int i = 0; i < 6; ++i)
+                    abits |= (uint64_t)src[2 + i] << (8 * i);
+            }
+
+            for (int t = 0; t < 16; ++t)
+            {
+                uint32_t i = (idx >> (2 * t)) & 3;
+                int a = 255;
+
+                if (fmt == DXT_1)
+                    a = (c0 <= c1 && i == 3) ? 0 : 255;
+                else if (fmt == DXT_3)
+                    a = ((src[t / 2] >> (4 * (t & 1))) & 15) * 17;
+                else
+                    a = apal[(abits >> (3 * t)) & 7];
+
+                out[(size_t)(by * 4 + t / 4) * w + bx * 4 + (t & 3)] =
+                    ((uint32_t)a << 24) | ((uint32_t)pal[i][0] << 16) |
+                    ((uint32_t)pal[i][1] << 8) | (uint32_t)pal[i][2];
+            }
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+
+// DXT1 / DXT3 / DXT5 block encoder for texbake, plus a decoder so the
+// baker can report the error it introduced.
+//
+// Texels are A8R8G8B8 as stored in the DDS files (0xAARRGGBB in a uint32).
+// Images are w x h with both sides multiples of 4; output blocks are in
+// row-major block order, the layout the GPU reads.
+
+enum DxtFormat
+{
+    DXT_1,      // 8 bytes per block, 1-bit alpha
+    DXT_3,      // 16 bytes, explicit 4-bit alpha
+    DXT_5,      // 16 bytes, interpolated alpha
+};
+
+unsigned int Dxt_BlockBytes(DxtFormat fmt);
+
+void Dxt_Encode(DxtFormat fmt, const uint32_t* texels, unsigned int w, unsigned int h,
+                uint8_t* out);
+void Dxt_Decode(DxtFormat fmt, const uint8_t* blocks, unsigned int w, unsigned int h,
+                uint32_t* out);
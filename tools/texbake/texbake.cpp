@@ -0,0 +1,493 @@
+// texbake - packs the demo's DDS textures into textures.pak
+//
+// Host tool (Linux, any C++ compiler), run from src/TR Demo/Media/tex:
+//   T=../../../../tools/texbake
+//   g++ -O2 -o texbake $T/texbake.cpp $T/dxt.cpp "../../mipfilter.cpp"
+//   ./texbake textures.pak cloud_256.dds:dxt5:mips tr.dds:dxt5 xbs.dds:dxt5 metal.dds:argb:mips
+//
+// Each input is validated the same way the runtime loader does (uncompressed
+// A8R8G8B8, power-of-two sides). Options follow the name, ':'-separated:
+//   argb | dxt1 | dxt3 | dxt5   storage format (argb if none)
+//   mips                        full mip chain down to 1x1
+//   mips=N                      at most N levels (1 = none, the default)
+// argb is swizzled into the NV2A layout that XGSwizzleRect produces, level
+// by level; DXT is block-compressed (not swizzled). Mip levels are built
+// from the linear image with the Kaiser kernel in mipfilter.cpp, or the
+// runtime's box kernel with --kernel=box before the pack name. Every
+// texture starts at a TEXPACK_ALIGN boundary, so the Xbox reads the data
+// section once and textures from it in place. Layout in
+// src/TR Demo/texpack.h.
+//
+// For DXT the baker prints the PSNR of the decoded top level (color over
+// texels that aren't fully clear, and alpha) to judge the format choice.
+
+#include "../../src/TR Demo/texpack.h"
+#include "../../src/TR Demo/mipfilter.h"
+#include "dxt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// DDS
+// -----------------------------------------------------------------------------
+
+struct Image
+{
+    unsigned int w, h;
+    uint32_t*    texels;        // linear A8R8G8B8, malloc'd
+};
+
+static uint32_t ReadU32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool LoadDDS(const char* path, Image* out)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "texbake: can't open %s\n", path);
+        return false;
+    }
+
+    // magic + 124-byte header
+    unsigned char hdr[128];
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr))
+    {
+        fprintf(stderr, "texbake: %s: short header\n", path);
+        fclose(f);
+        return false;
+    }
+
+    const uint32_t DDPF_ALPHAPIXELS = 0x1;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDPF_RGB = 0x40;
+
+    uint32_t magic = ReadU32(hdr + 0);
+    uint32_t size = ReadU32(hdr + 4);
+    uint32_t h = ReadU32(hdr + 12);
+    uint32_t w = ReadU32(hdr + 16);
+    const unsigned char* pf = hdr + 76;
+
+    bool ok = magic == 0x20534444 && size == 124 && ReadU32(pf + 0) == 32 &&
+        !(ReadU32(pf + 4) & DDPF_FOURCC) &&
+        (ReadU32(pf + 4) & (DDPF_RGB | DDPF_ALPHAPIXELS)) == (DDPF_RGB | DDPF_ALPHAPIXELS) &&
+        ReadU32(pf + 12) == 32 &&
+        ReadU32(pf + 16) == 0x00FF0000 && ReadU32(pf + 20) == 0x0000FF00 &&
+        ReadU32(pf + 24) == 0x000000FF && ReadU32(pf + 28) == 0xFF000000;
+
+    if (!ok)
+    {
+        fprintf(stderr, "texbake: %s: not an uncompressed A8R8G8B8 DDS\n", path);
+        fclose(f);
+        return false;
+    }
+
+    if (w == 0 || h == 0 || w > 4096 || h > 4096 || (w & (w - 1)) || (h & (h - 1)))
+    {
+        fprintf(stderr, "texbake: %s: %ux%u is not power-of-two\n", path, w, h);
+        fclose(f);
+        return false;
+    }
+
+    size_t count = (size_t)w * h;
+
+    out->w = w;
+    out->h = h;
+    out->texels = (uint32_t*)malloc(count * 4);
+
+    // Host is little-endian like the file
+    size_t n = out->texels ? fread(out->texels, 4, count, f) : 0;
+    fclose(f);
+
+    if (n != count)
+    {
+        fprintf(stderr, "texbake: %s: short pixel data\n", path);
+        free(out->texels);
+        out->texels = NULL;
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Swizzle
+// -----------------------------------------------------------------------------
+
+// Address bit masks for u and v: bits interleave (u first) while both sides
+// have bits left, then the longer side's remaining bits follow.
+static void SwizzleMasks(unsigned int w, unsigned int h, uint32_t* maskU, uint32_t* maskV)
+{
+    uint32_t mu = 0, mv = 0, bit = 1;
+
+    for (unsigned int side = 1; side < w || side < h; side <<= 1)
+    {
+        if (side < w) { mu |= bit; bit <<= 1; }
+        if (side < h) { mv |= bit; bit <<= 1; }
+    }
+
+    *maskU = mu;
+    *maskV = mv;
+}
+
+// Spreads the low bits of v over the set bits of mask
+static uint32_t Deposit(uint32_t v, uint32_t mask)
+{
+    uint32_t r = 0;
+    for (uint32_t bit = 1; mask; bit <<= 1)
+    {
+        uint32_t low = mask & (0u - mask);
+        if (v & bit)
+            r |= low;
+        mask &= mask - 1;
+    }
+    return r;
+}
+
+static void Swizzle(const Image& img, uint32_t* out)
+{
+    uint32_t mu, mv;
+    SwizzleMasks(img.w, img.h, &mu, &mv);
+
+    for (unsigned int y = 0; y < img.h; ++y)
+    {
+        uint32_t rowOff = Deposit(y, mv);
+        for (unsigned int x = 0; x < img.w; ++x)
+            out[rowOff | Deposit(x, mu)] = img.texels[(size_t)y * img.w + x];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Mips
+// -----------------------------------------------------------------------------
+
+static bool s_boxKernel = false;
+
+// Next level down from img (malloc'd texels)
+static Image Downsample(const Image& img)
+{
+    Image out;
+    out.w = img.w > 1 ? img.w / 2 : 1;
+    out.h = img.h > 1 ? img.h / 2 : 1;
+    out.texels = (uint32_t*)malloc((size_t)out.w * out.h * 4);
+
+    if (s_boxKernel)
+    {
+        Mip_Box(img.texels, img.w, img.h, out.texels);
+    }
+    else
+    {
+        float* scratch = (float*)malloc(Mip_KaiserScratch(img.w, img.h) * sizeof(float));
+        Mip_Kaiser(img.texels, img.w, img.h, out.texels, scratch);
+        free(scratch);
+    }
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Pack
+// -----------------------------------------------------------------------------
+
+struct FormatName
+{
+    const char*  name;
+    unsigned int format;
+};
+
+static const FormatName FORMATS[] =
+{
+    { "argb", TEXPACK_FMT_A8R8G8B8 },
+    { "dxt1", TEXPACK_FMT_DXT1 },
+    { "dxt3", TEXPACK_FMT_DXT3 },
+    { "dxt5", TEXPACK_FMT_DXT5 },
+};
+
+static bool ParseFormat(const char* s, unsigned int* format)
+{
+    for (size_t i = 0; i < sizeof(FORMATS) / sizeof(FORMATS[0]); ++i)
+    {
+        if (strcmp(s, FORMATS[i].name) == 0)
+        {
+            *format = FORMATS[i].format;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "mips" (0 = full chain) or "mips=N"
+static bool ParseMips(const char* s, unsigned int* levels)
+{
+    if (strcmp(s, "mips") == 0)
+    {
+        *levels = 0;
+        return true;
+    }
+    if (strncmp(s, "mips=", 5) != 0)
+        return false;
+
+    int n = atoi(s + 5);
+    if (n < 1)
+        return false;
+    *levels = (unsigned int)n;
+    return true;
+}
+
+// Splits "file.dds:opt:opt" in place into the path and its options
+static bool ParseInput(char* arg, unsigned int* format, unsigned int* levels)
+{
+    *format = TEXPACK_FMT_A8R8G8B8;
+    *levels = 1;
+
+    char* opt = strchr(arg, ':');
+    while (opt)
+    {
+        *opt++ = 0;
+        char* next = strchr(opt, ':');
+        if (next)
+            *next = 0;
+
+        if (!ParseFormat(opt, format) && !ParseMips(opt, levels))
+        {
+            fprintf(stderr, "texbake: %s: unknown option '%s'\n", arg, opt);
+            return false;
+        }
+
+        if (next)
+            *next = ':';
+        opt = next;
+    }
+    return true;
+}
+
+static double Psnr(double sumSq, double count)
+{
+    if (count <= 0.0 || sumSq <= 0.0)
+        return 99.0;
+    return 10.0 * log10(255.0 * 255.0 * count / sumSq);
+}
+
+static DxtFormat ToDxt(unsigned int format)
+{
+    return format == TEXPACK_FMT_DXT1 ? DXT_1 :
+           format == TEXPACK_FMT_DXT3 ? DXT_3 : DXT_5;
+}
+
+// Encodes one level; levels under 4x4 are tiled out to a single block
+static void EncodeDxt(const Image& img, unsigned int format, uint8_t* out)
+{
+    if (img.w >= 4 && img.h >= 4)
+    {
+        Dxt_Encode(ToDxt(format), img.texels, img.w, img.h, out);
+        return;
+    }
+
+    uint32_t block[16];
+    for (unsigned int y = 0; y < 4; ++y)
+    {
+        for (unsigned int x = 0; x < 4; ++x)
+            block[y * 4 + x] = img.texels[(y % img.h) * img.w + (x % img.w)];
+    }
+    Dxt_Encode(ToDxt(format), block, 4, 4, out);
+}
+
+// Decodes the top level in out and reports the error against img
+static void ReportDxt(const Image& img, unsigned int format, const uint8_t* out, const char* name)
+{
+    DxtFormat fmt = ToDxt(format);
+
+    size_t count = (size_t)img.w * img.h;
+    uint32_t* check = (uint32_t*)malloc(count * 4);
+    Dxt_Decode(fmt, out, img.w, img.h, check);
+
+    double colorSq = 0.0, colorN = 0.0, alphaSq = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t a = img.texels[i], b = check[i];
+        double da = (double)(a >> 24) - (double)(b >> 24);
+        alphaSq += da * da;
+
+        if ((a >> 24) == 0)
+            continue;
+
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            double d = (double)((a >> shift) & 255) - (double)((b >> shift) & 255);
+            colorSq += d * d;
+        }
+        colorN += 3.0;
+    }
+
+    printf("%-24s psnr color %.1f dB, alpha %.1f dB\n", name,
+           Psnr(colorSq, colorN), Psnr(alphaSq, (double)count));
+    free(check);
+}
+
+static unsigned int AlignUp(unsigned int v)
+{
+    return (v + TEXPACK_ALIGN - 1) / TEXPACK_ALIGN * TEXPACK_ALIGN;
+}
+
+static const char* BaseName(const char* path)
+{
+    const char* name = path;
+    for (const char* p = path; *p; ++p)
+    {
+        if (*p == '/' || *p == '\\')
+            name = p + 1;
+    }
+    return name;
+}
+
+int main(int argc, char** argv)
+{
+    int first = 1;
+    if (argc > 1 && strncmp(argv[1], "--kernel=", 9) == 0)
+    {
+        if (strcmp(argv[1] + 9, "box") == 0)
+            s_boxKernel = true;
+        else if (strcmp(argv[1] + 9, "kaiser") != 0)
+            argc = 0;
+        first = 2;
+    }
+
+    if (argc < first + 2)
+    {
+        fprintf(stderr, "usage: texbake [--kernel=kaiser|box] <out.pak> "
+                        "<in.dds>[:argb|dxt1|dxt3|dxt5][:mips[=N]]...\n");
+        return 1;
+    }
+
+    const char* outPath = argv[first];
+    const int count = argc - first - 1;
+
+    TexPackEntry* index = (TexPackEntry*)calloc(count, sizeof(TexPackEntry));
+    uint8_t**     blobs = (uint8_t**)calloc(count, sizeof(uint8_t*));
+
+    unsigned int dataSize = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        static char path[4096];
+        strncpy(path, argv[first + 1 + i], sizeof(path) - 1);
+
+        unsigned int format, levels;
+        if (!ParseInput(path, &format, &levels))
+            return 1;
+
+        const char* name = BaseName(path);
+
+        if (strlen(name) >= (size_t)TEXPACK_NAME_CHARS)
+        {
+            fprintf(stderr, "texbake: %s: name longer than %d chars\n", path, TEXPACK_NAME_CHARS - 1);
+            return 1;
+        }
+
+        Image img;
+        if (!LoadDDS(path, &img))
+            return 1;
+
+        if (format != TEXPACK_FMT_A8R8G8B8 && (img.w < 4 || img.h < 4))
+        {
+            fprintf(stderr, "texbake: %s: DXT needs at least 4x4\n", path);
+            return 1;
+        }
+
+        unsigned int full = Mip_LevelCount(img.w, img.h);
+        if (levels == 0 || levels > full)
+            levels = full;
+
+        TexPackEntry& e = index[i];
+        strcpy(e.name, name);
+        e.format = format;
+        e.width = (unsigned short)img.w;
+        e.height = (unsigned short)img.h;
+        e.levels = (unsigned short)levels;
+        e.offset = dataSize;
+        e.size = TexPack_ChainBytes(format, img.w, img.h, levels);
+
+        blobs[i] = (uint8_t*)malloc(e.size);
+
+        // Each level from the linear one above it, then swizzled / encoded
+        // into place
+        Image level = img;
+        uint8_t* at = blobs[i];
+
+        for (unsigned int l = 0; l < levels; ++l)
+        {
+            if (format == TEXPACK_FMT_A8R8G8B8)
+                Swizzle(level, (uint32_t*)at);
+            else
+                EncodeDxt(level, format, at);
+
+            if (l == 0 && format != TEXPACK_FMT_A8R8G8B8)
+                ReportDxt(img, format, at, name);
+
+            at += TexPack_LevelBytes(format, level.w, level.h);
+
+            if (l + 1 < levels)
+            {
+                Image next = Downsample(level);
+                if (level.texels != img.texels)
+                    free(level.texels);
+                level = next;
+            }
+        }
+
+        if (level.texels != img.texels)
+            free(level.texels);
+        free(img.texels);
+
+        dataSize = AlignUp(dataSize + e.size);
+    }
+
+    TexPackHeader hdr;
+    hdr.magic = TEXPACK_MAGIC;
+    hdr.version = TEXPACK_VERSION;
+    hdr.count = (unsigned int)count;
+    hdr.dataOffset = AlignUp((unsigned int)(sizeof(TexPackHeader) + sizeof(TexPackEntry) * count));
+    hdr.dataSize = dataSize;
+
+    FILE* f = fopen(outPath, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "texbake: can't create %s\n", outPath);
+        return 1;
+    }
+
+    // Header, index, then zero padding up to each aligned offset
+    static unsigned char pad[TEXPACK_ALIGN];
+    unsigned int pos = 0;
+
+    fwrite(&hdr, sizeof(hdr), 1, f);
+    fwrite(index, sizeof(TexPackEntry), count, f);
+    pos = (unsigned int)(sizeof(hdr) + sizeof(TexPackEntry) * count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        unsigned int at = hdr.dataOffset + index[i].offset;
+        fwrite(pad, 1, at - pos, f);
+        fwrite(blobs[i], 1, index[i].size, f);
+        pos = at + index[i].size;
+
+        printf("%-24s %4ux%-4u %s %2u levels %8u bytes at %u\n", index[i].name,
+               index[i].width, index[i].height, FORMATS[index[i].format].name,
+               index[i].levels, index[i].size, at);
+    }
+
+    fwrite(pad, 1, hdr.dataOffset + dataSize - pos, f);
+
+    if (fclose(f) != 0)
+    {
+        fprintf(stderr, "texbake: write failed for %s\n", outPath);
+        return 1;
+    }
+
+    printf("%s: %d textures, %u bytes\n", outPath, count, hdr.dataOffset + dataSize);
+    return 0;
+}